@@ -1,10 +1,71 @@
+// Interleaved vertex layout for DrawTextureSide(), NULL keeps the rlgl batch (separate arrays)
+static StreamBatch *textureSideBatch = NULL;
+
+// Deferred state-sorted draws for DrawTextureSide(), takes precedence over the batch
+static DeferredQueue *textureSideQueue = NULL;
+
+void SetTextureSideBatch(StreamBatch *batch)
+{
+    textureSideBatch = batch;
+}
+
+void SetTextureSideQueue(DeferredQueue *queue)
+{
+    textureSideQueue = queue;
+}
+
 void DrawTextureSide(Texture2D texture, Vector2 size, Color tint)
 {
-    rlSetTexture(texture.id);
     SetTextureWrap(texture, RL_TEXTURE_WRAP_REPEAT);
 
     float halfWidth = size.x * 0.5f;
     float halfHeight = size.y * 0.5f;
+
+    if (textureSideQueue != NULL) {
+        DeferredQueue *queue = textureSideQueue;
+        DeferredSetTexture(queue, texture.id);
+        DeferredBegin(queue, RL_QUADS);
+        DeferredColor4ub(queue, tint.r, tint.g, tint.b, tint.a);
+
+        DeferredTexCoord2f(queue, 0.0f, 0.0f);
+        DeferredVertex3f(queue, -halfWidth, 0.0f, halfHeight); // Top-left corner
+
+        DeferredTexCoord2f(queue, 2.0f, 0.0f);
+        DeferredVertex3f(queue, halfWidth, 0.0f, halfHeight); // Top-right corner
+
+        DeferredTexCoord2f(queue, 2.0f, 2.0f);
+        DeferredVertex3f(queue, halfWidth, 0.0f, -halfHeight); // Bottom-right corner
+
+        DeferredTexCoord2f(queue, 0.0f, 2.0f);
+        DeferredVertex3f(queue, -halfWidth, 0.0f, -halfHeight); // Bottom-left corner
+
+        DeferredEnd(queue);
+        return;
+    }
+
+    if (textureSideBatch != NULL) {
+        StreamBatch *batch = textureSideBatch;
+        StreamSetTexture(batch, texture.id);
+        StreamBegin(batch, RL_QUADS);
+        StreamColor4ub(batch, tint.r, tint.g, tint.b, tint.a);
+
+        StreamTexCoord2f(batch, 0.0f, 0.0f);
+        StreamVertex3f(batch, -halfWidth, 0.0f, halfHeight); // Top-left corner
+
+        StreamTexCoord2f(batch, 2.0f, 0.0f);
+        StreamVertex3f(batch, halfWidth, 0.0f, halfHeight); // Top-right corner
+
+        StreamTexCoord2f(batch, 2.0f, 2.0f);
+        StreamVertex3f(batch, halfWidth, 0.0f, -halfHeight); // Bottom-right corner
+
+        StreamTexCoord2f(batch, 0.0f, 2.0f);
+        StreamVertex3f(batch, -halfWidth, 0.0f, -halfHeight); // Bottom-left corner
+
+        StreamEnd(batch);
+        return;
+    }
+
+    rlSetTexture(texture.id);
     rlBegin(RL_QUADS);
     rlColor4ub(tint.r, tint.g, tint.b, tint.a);
 
@@ -22,4 +83,4 @@ void DrawTextureSide(Texture2D texture, Vector2 size, Color tint)
 
     rlEnd();
     rlSetTexture(0);
-}
\ No newline at end of file
+}
@@ -13,12 +13,67 @@
 
 #include "raylib.h"
 #include "rlgl.h"
+
+#define RSTREAM_IMPLEMENTATION
+#include "rstream.h"
+#define RDEFERRED_IMPLEMENTATION
+#include "rdeferred.h"
+#define RJOBS_IMPLEMENTATION
+#include "rjobs.h"
+#define RMIPMAPS_IMPLEMENTATION
+#include "rmipmaps.h"
+#define RIMAGE_IMPLEMENTATION
+#include "rimage.h"
+#define RTEXTFMT_IMPLEMENTATION
+#include "rtextfmt.h"
+
 #include "functions.h"
+
+#include <string.h>
+
+//------------------------------------------------------------------------------------
+// Benchmarks: lab4 --bench <name>
+//------------------------------------------------------------------------------------
+int runBenchmark(const char *name)
+{
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(800, 450, "lab4 benchmark");
+
+    if (strcmp(name, "stream") == 0) {
+        BenchmarkStreamBatch(10000, 200);
+        BenchmarkStreamBatch(100000, 100);
+    }
+    else if (strcmp(name, "layout") == 0) {
+        BenchmarkStreamLayout(1000000);
+    }
+    else if (strcmp(name, "deferred") == 0) {
+        BenchmarkDeferredQueue(10000, 8, 100);
+        BenchmarkDeferredQueue(10000, 64, 100);
+    }
+    else if (strcmp(name, "texarray") == 0) {
+        BenchmarkTextureArray(50000, 64, 100);
+    }
+    else if (strcmp(name, "mipmaps") == 0) {
+        BenchmarkImageMipmaps(4096, 5);
+        BenchmarkImageMipmaps(8192, 3);
+    }
+    else if (strcmp(name, "imageops") == 0) {
+        BenchmarkImageOps(1920, 1080, 10);
+        BenchmarkImageOps(4096, 4096, 3);
+    }
+    else TraceLog(LOG_WARNING, "BENCH: Unknown benchmark: %s", name);
+
+    CloseWindow();
+    return 0;
+}
+
 //------------------------------------------------------------------------------------
 // Program main entry point
 //------------------------------------------------------------------------------------
-int main(void)
+int main(int argc, char **argv)
 {
+    if (argc > 2 && strcmp(argv[1], "--bench") == 0) return runBenchmark(argv[2]);
+
     // Initialization
     //--------------------------------------------------------------------------------------
     const int screenWidth = 800;
@@ -52,18 +107,30 @@ int main(void)
     SetWindowState(FLAG_WINDOW_RESIZABLE);
     DisableCursor();
 
-    Texture heliTexture = LoadTexture("..\\helicopter.png");
-    GenTextureMipmaps(&heliTexture);
+    Texture heliTexture = LoadTextureMipmapped("..\\helicopter.png", MIPMAP_FILTER_KAISER);
 
-    Texture bombTexture = LoadTexture("..\\bomb.png");
-    GenTextureMipmaps(&bombTexture);
+    Texture bombTexture = LoadTextureMipmapped("..\\bomb.png", MIPMAP_FILTER_KAISER);
 
-    Texture lessssgooTexture = LoadTexture("..\\img.png");
-    GenTextureMipmaps(&lessssgooTexture);
+    Texture lessssgooTexture = LoadTextureMipmapped("..\\img.png", MIPMAP_FILTER_KAISER);
 
     Model sphere = LoadModelFromMesh(GenMeshSphere(1.0f, 20, 10));
     sphere.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = bombTexture;
 
+    // Interleaved streaming batch for the textured sides, [L] switches back to rlgl arrays
+    StreamBatch sideBatch = LoadStreamBatch(STREAM_DEFAULT_VERTICES, STREAM_DEFAULT_BUFFERS);
+    bool interleavedLayout = (sideBatch.vboId != 0);
+    SetTextureSideBatch(interleavedLayout? &sideBatch : NULL);
+
+    // Deferred state-sorted sides on top of the streaming batch, [R] toggles
+    DeferredQueue sideQueue = LoadDeferredQueue(DEFERRED_DEFAULT_COMMANDS, DEFERRED_DEFAULT_VERTICES);
+    bool deferredDraws = false;
+
+    // Lab textures as layers of one array, sides merge in one draw, [T] toggles
+    TextureArray sideArray = LoadTextureArray(256, 256, 3);
+    AddTextureArrayTexture(&sideArray, heliTexture);
+    AddTextureArrayTexture(&sideArray, bombTexture);
+    AddTextureArrayTexture(&sideArray, lessssgooTexture);
+    bool textureArray = false;
 
     //--------------------------------------------------------------------------------------
 
@@ -132,6 +199,22 @@ int main(void)
             globalPositionX-=.25;
         }
 
+        //Vertex layout toggle
+        if (IsKeyPressed(KEY_L) && sideBatch.vboId != 0) {
+            interleavedLayout = !interleavedLayout;
+            SetTextureSideBatch(interleavedLayout? &sideBatch : NULL);
+        }
+
+        //Deferred draws toggle (needs the streaming batch)
+        if (IsKeyPressed(KEY_R) && sideBatch.vboId != 0)
+            deferredDraws = !deferredDraws;
+
+        //Texture array toggle
+        if (IsKeyPressed(KEY_T) && sideArray.id != 0) {
+            textureArray = !textureArray;
+            StreamSetTextureArray(&sideBatch, textureArray? &sideArray : NULL);
+        }
+
         //Enable\Disable cursor
         if(IsKeyDown(KEY_BACKSPACE)) {
             EnableCursor();
@@ -150,6 +233,13 @@ int main(void)
 
         BeginMode3D(camera);
 
+        ResetStreamBatchStats(&sideBatch);
+
+        if (deferredDraws) {
+            BeginDeferred(&sideQueue, &sideBatch);
+            SetTextureSideQueue(&sideQueue);
+        }
+
         if(cameraMode == 3)
             DrawCube(camera.target, 1.0f, 1.0f, 1.0f, PURPLE);
 
@@ -219,17 +309,38 @@ int main(void)
 
         rlPopMatrix();
 
+        if (deferredDraws) {
+            SetTextureSideQueue(NULL);
+            EndDeferred(&sideQueue);
+        }
+
+        DrawStreamBatch(&sideBatch);
+
         EndMode3D();
 
+        DrawText(interleavedLayout? "Layout: interleaved ([L] toggle)" : "Layout: rlgl separate arrays ([L] toggle)", 10, 10, 20, DARKGRAY);
+        if (deferredDraws) {
+            DeferredStats deferredStats = GetDeferredStats(&sideQueue);
+            DrawText(TextFormatLocal("Deferred: on ([R] toggle), %i commands, draw calls %i -> %i", deferredStats.commands,
+                                deferredStats.drawCallsBefore, deferredStats.drawCallsAfter), 10, 35, 20, DARKGRAY);
+        }
+        else DrawText("Deferred: off ([R] toggle)", 10, 35, 20, DARKGRAY);
+        DrawText(TextFormatLocal("Texture array: %s ([T] toggle), %i draw calls", textureArray? "on" : "off",
+                            sideBatch.stats.drawCalls), 10, 60, 20, DARKGRAY);
+
         EndDrawing();
         //----------------------------------------------------------------------------------
     }
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
+    StreamSetTextureArray(&sideBatch, NULL);
+    UnloadTextureArray(&sideArray);
     UnloadTexture(heliTexture);
     UnloadTexture(bombTexture);
     UnloadTexture(lessssgooTexture);
+    UnloadDeferredQueue(&sideQueue);
+    UnloadStreamBatch(&sideBatch);
 
     CloseWindow();        // Close window and OpenGL context
     //--------------------------------------------------------------------------------------
@@ -0,0 +1,598 @@
+/**********************************************************************************************
+*
+*   raylib.deferred - State-sorted deferred draws on top of the streaming batch
+*
+*   DESCRIPTION:
+*       rlgl starts a new draw call every time the texture changes (and flushes the whole batch
+*       at RL_DEFAULT_BATCH_DRAWCALLS), so code alternating textures ends up with many tiny
+*       draws. Here primitives between DeferredBegin()/DeferredEnd() are recorded as commands
+*       with a sort key instead of being drawn; EndDeferred() sorts them and submits them to
+*       a StreamBatch, one draw per state run.
+*
+*       Sort key, most significant first:
+*         - Opaque commands: shader, texture, blend mode, primitive mode, depth front to back
+*         - Translucent commands, after all opaque ones: depth back to front, recording order
+*
+*       A command is opaque when drawn with BLEND_ALPHA and every vertex color has alpha 255.
+*       Texture alpha is not looked at: textures with soft alpha edges drawn opaque can show
+*       different edges once reordered, same as drawing them in a different order in rlgl.
+*
+*       Vertices go through the rlgl transform at record time, depth is the view space
+*       distance of the command center (modelview at DeferredEnd()).
+*
+*       rlgl can't be asked for its blend mode: submits switch modes as commands need them and
+*       restore the one set with SetDeferredCallerBlendMode() (BLEND_ALPHA by default).
+*
+*   CONFIGURATION:
+*
+*   #define RDEFERRED_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+*   NOTE: Requires rstream.h (with its implementation somewhere in the program)
+*
+**********************************************************************************************/
+
+#ifndef RDEFERRED_H
+#define RDEFERRED_H
+
+#include "raylib.h"
+#include "rstream.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define DEFERRED_DEFAULT_COMMANDS   4096        // Commands recorded before an early submit
+#define DEFERRED_DEFAULT_VERTICES   (4*8192)    // Vertices recorded before an early submit
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Recorded primitives sharing one state
+typedef struct {
+    unsigned long long key;     // Sort key
+    int order;                  // Recording order, ties keep it
+    Shader shader;
+    unsigned int textureId;
+    int blendMode;
+    int mode;                   // RL_LINES, RL_TRIANGLES or RL_QUADS
+    int vertexOffset;
+    int vertexCount;
+    float depth;                // View space distance
+    bool opaque;
+} DeferredCommand;
+
+// Draw calls of the last submit, in recording order vs sorted
+typedef struct {
+    int commands;
+    int drawCallsBefore;        // State runs in recording order (draws rlgl would issue)
+    int drawCallsAfter;         // Draws issued after sorting
+    int stateChangesBefore;     // Shader, texture or blend changes in recording order
+    int stateChangesAfter;
+    double sortTime;            // Seconds sorting
+} DeferredStats;
+
+// Deferred queue
+typedef struct {
+    DeferredCommand *commands;
+    int commandCount;
+    int commandCapacity;
+    StreamVertex *vertices;
+    int vertexCount;
+    int vertexCapacity;
+
+    StreamBatch *batch;         // Submit target, set by BeginDeferred()
+    bool sorting;               // false submits in recording order
+
+    Shader shader;              // State for next commands
+    unsigned int textureId;
+    int blendMode;
+    int callerBlendMode;        // Blend mode around the queue, restored after every submit
+    StreamVertex current;       // Texcoord and color for next vertices
+    Matrix transform;
+    bool transformRequired;
+    int recording;              // Index of the command being recorded, -1 if none
+
+    DeferredStats stats;        // Accumulated since BeginDeferred()
+} DeferredQueue;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+DeferredQueue LoadDeferredQueue(int commandCount, int vertexCount);                    // Load deferred queue
+void UnloadDeferredQueue(DeferredQueue *queue);                                         // Unload deferred queue
+void BeginDeferred(DeferredQueue *queue, StreamBatch *batch);                           // Begin recording, commands go to batch at EndDeferred()
+void EndDeferred(DeferredQueue *queue);                                                 // Sort and submit recorded commands, draws the batch
+void SetDeferredSorting(DeferredQueue *queue, bool enabled);                            // Enable sorting (default), disabled keeps recording order
+void SetDeferredCallerBlendMode(DeferredQueue *queue, int mode);                        // Set blend mode active around the queue, restored after submits (default BLEND_ALPHA)
+DeferredStats GetDeferredStats(const DeferredQueue *queue);                             // Get draw call stats since BeginDeferred()
+
+void DeferredSetShader(DeferredQueue *queue, Shader shader);                            // Set shader for next commands
+void DeferredSetTexture(DeferredQueue *queue, unsigned int id);                         // Set texture for next commands, 0 is the default white texture
+void DeferredSetBlendMode(DeferredQueue *queue, int mode);                              // Set blend mode for next commands
+void DeferredBegin(DeferredQueue *queue, int mode);                                     // Begin command (RL_LINES, RL_TRIANGLES, RL_QUADS)
+void DeferredEnd(DeferredQueue *queue);                                                 // End command
+void DeferredVertex3f(DeferredQueue *queue, float x, float y, float z);                 // Add vertex with current texcoord and color
+void DeferredTexCoord2f(DeferredQueue *queue, float u, float v);                        // Set texcoord for next vertices
+void DeferredColor4ub(DeferredQueue *queue, unsigned char r, unsigned char g, unsigned char b, unsigned char a);   // Set color for next vertices
+
+void BenchmarkDeferredQueue(int quadCount, int textureCount, int frames);               // Benchmark draw calls and time, recording order vs sorted
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RDEFERRED_H
+
+
+/***********************************************************************************
+*
+*   RDEFERRED IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RDEFERRED_IMPLEMENTATION) && !defined(RDEFERRED_IMPLEMENTATION_DEFINED)
+#define RDEFERRED_IMPLEMENTATION_DEFINED
+
+#include "raymath.h"
+#include "rlgl.h"
+
+#include <stdlib.h>             // Required for: malloc(), free(), qsort()
+#include <string.h>             // Required for: memcmp(), memmove()
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static void SubmitDeferredCommands(DeferredQueue *queue);
+static int CountDeferredRuns(const DeferredQueue *queue, const int *order, bool stateOnly);
+static int CompareDeferredCommands(const void *a, const void *b);
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Load deferred queue
+DeferredQueue LoadDeferredQueue(int commandCount, int vertexCount)
+{
+    DeferredQueue queue = { 0 };
+
+    queue.commandCapacity = commandCount;
+    queue.vertexCapacity = vertexCount;
+    queue.commands = (DeferredCommand *)malloc(commandCount*sizeof(DeferredCommand));
+    queue.vertices = (StreamVertex *)malloc(vertexCount*sizeof(StreamVertex));
+    queue.sorting = true;
+    queue.blendMode = BLEND_ALPHA;
+    queue.callerBlendMode = BLEND_ALPHA;
+    queue.current.r = queue.current.g = queue.current.b = queue.current.a = 255;
+    queue.transform = MatrixIdentity();
+    queue.recording = -1;
+
+    return queue;
+}
+
+// Unload deferred queue
+void UnloadDeferredQueue(DeferredQueue *queue)
+{
+    free(queue->commands);
+    free(queue->vertices);
+
+    *queue = (DeferredQueue){ 0 };
+}
+
+// Begin recording, commands go to batch at EndDeferred()
+void BeginDeferred(DeferredQueue *queue, StreamBatch *batch)
+{
+    queue->batch = batch;
+    queue->commandCount = 0;
+    queue->vertexCount = 0;
+    queue->recording = -1;
+    queue->stats = (DeferredStats){ 0 };
+}
+
+// Sort and submit recorded commands, draws the batch
+void EndDeferred(DeferredQueue *queue)
+{
+    SubmitDeferredCommands(queue);
+    queue->batch = NULL;
+}
+
+// Enable sorting (default), disabled keeps recording order
+void SetDeferredSorting(DeferredQueue *queue, bool enabled)
+{
+    queue->sorting = enabled;
+}
+
+// Set blend mode active around the queue, restored after submits
+// NOTE: Restored with BeginBlendMode(), BLEND_CUSTOM factors must be set again by the caller
+void SetDeferredCallerBlendMode(DeferredQueue *queue, int mode)
+{
+    queue->callerBlendMode = mode;
+}
+
+// Get draw call stats since BeginDeferred()
+DeferredStats GetDeferredStats(const DeferredQueue *queue)
+{
+    return queue->stats;
+}
+
+// Set shader for next commands
+void DeferredSetShader(DeferredQueue *queue, Shader shader)
+{
+    if (shader.id == rlGetShaderIdDefault()) shader.id = 0;
+    queue->shader = shader;
+}
+
+// Set texture for next commands
+void DeferredSetTexture(DeferredQueue *queue, unsigned int id)
+{
+    queue->textureId = id;
+}
+
+// Set blend mode for next commands
+void DeferredSetBlendMode(DeferredQueue *queue, int mode)
+{
+    queue->blendMode = mode;
+}
+
+// Begin command
+void DeferredBegin(DeferredQueue *queue, int mode)
+{
+    if (queue->commandCount >= queue->commandCapacity) SubmitDeferredCommands(queue);
+
+    DeferredCommand *command = &queue->commands[queue->commandCount];
+    command->order = queue->commandCount;
+    command->shader = queue->shader;
+    command->textureId = queue->textureId;
+    command->blendMode = queue->blendMode;
+    command->mode = mode;
+    command->vertexOffset = queue->vertexCount;
+    command->vertexCount = 0;
+    command->opaque = (queue->blendMode == BLEND_ALPHA);
+
+    queue->recording = queue->commandCount;
+    queue->commandCount++;
+
+    Matrix identity = MatrixIdentity();
+    queue->transform = rlGetMatrixTransform();
+    queue->transformRequired = (memcmp(&queue->transform, &identity, sizeof(Matrix)) != 0);
+}
+
+// End command
+void DeferredEnd(DeferredQueue *queue)
+{
+    if (queue->recording < 0) return;
+
+    DeferredCommand *command = &queue->commands[queue->recording];
+    queue->recording = -1;
+
+    if (command->vertexCount == 0)
+    {
+        queue->commandCount--;
+        return;
+    }
+
+    // Depth of the center in view space, vertices are already in world space
+    Vector3 center = { 0 };
+    for (int i = 0; i < command->vertexCount; i++)
+    {
+        StreamVertex *vertex = &queue->vertices[command->vertexOffset + i];
+        center.x += vertex->x;
+        center.y += vertex->y;
+        center.z += vertex->z;
+        if (vertex->a < 255) command->opaque = false;
+    }
+    center = Vector3Scale(center, 1.0f/command->vertexCount);
+    command->depth = -Vector3Transform(center, rlGetMatrixModelview()).z;
+}
+
+// Add vertex with current texcoord and color
+void DeferredVertex3f(DeferredQueue *queue, float x, float y, float z)
+{
+    if (queue->recording < 0) return;
+
+    if (queue->vertexCount >= queue->vertexCapacity)
+    {
+        // Queue full: the command being recorded is split after its last complete primitive,
+        // that part is submitted with the rest and the incomplete primitive moves to the front
+        DeferredCommand *command = &queue->commands[queue->recording];
+        int primitiveVertices = (command->mode == RL_LINES)? 2 : (command->mode == RL_TRIANGLES)? 3 : 4;
+        int tail = command->vertexCount%primitiveVertices;
+        DeferredCommand partial = *command;
+
+        command->vertexCount -= tail;
+        DeferredEnd(queue);
+        SubmitDeferredCommands(queue);
+
+        memmove(queue->vertices, queue->vertices + partial.vertexOffset + partial.vertexCount - tail, tail*sizeof(StreamVertex));
+
+        partial.order = 0;
+        partial.vertexOffset = 0;
+        partial.vertexCount = tail;
+        queue->commands[0] = partial;
+        queue->commandCount = 1;
+        queue->vertexCount = tail;
+        queue->recording = 0;
+    }
+
+    StreamVertex *vertex = &queue->vertices[queue->vertexCount];
+    *vertex = queue->current;
+
+    if (queue->transformRequired)
+    {
+        Matrix m = queue->transform;
+        vertex->x = m.m0*x + m.m4*y + m.m8*z + m.m12;
+        vertex->y = m.m1*x + m.m5*y + m.m9*z + m.m13;
+        vertex->z = m.m2*x + m.m6*y + m.m10*z + m.m14;
+    }
+    else
+    {
+        vertex->x = x;
+        vertex->y = y;
+        vertex->z = z;
+    }
+
+    queue->vertexCount++;
+    queue->commands[queue->recording].vertexCount++;
+}
+
+// Set texcoord for next vertices
+void DeferredTexCoord2f(DeferredQueue *queue, float u, float v)
+{
+    queue->current.u = u;
+    queue->current.v = v;
+}
+
+// Set color for next vertices
+void DeferredColor4ub(DeferredQueue *queue, unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+{
+    queue->current.r = r;
+    queue->current.g = g;
+    queue->current.b = b;
+    queue->current.a = a;
+}
+
+// Benchmark draw calls and time, recording order vs sorted
+// NOTE: Needs a window, textures are picked at random per quad like interleaved sprites
+void BenchmarkDeferredQueue(int quadCount, int textureCount, int frames)
+{
+    Texture2D *textures = (Texture2D *)malloc(textureCount*sizeof(Texture2D));
+    for (int i = 0; i < textureCount; i++)
+    {
+        Image image = GenImageColor(16, 16, ColorFromHSV(360.0f*i/textureCount, 0.8f, 0.9f));
+        textures[i] = LoadTextureFromImage(image);
+        UnloadImage(image);
+    }
+
+    int *picks = (int *)malloc(quadCount*sizeof(int));
+    SetRandomSeed(1);
+    for (int i = 0; i < quadCount; i++) picks[i] = GetRandomValue(0, textureCount - 1);
+
+    StreamBatch batch = LoadStreamBatch(STREAM_DEFAULT_VERTICES, STREAM_DEFAULT_BUFFERS);
+    DeferredQueue queue = LoadDeferredQueue(quadCount, 4*quadCount);
+    if (batch.vboId == 0)
+    {
+        UnloadDeferredQueue(&queue);
+        free(picks);
+        for (int i = 0; i < textureCount; i++) UnloadTexture(textures[i]);
+        free(textures);
+        return;
+    }
+
+    int columns = 1;
+    while (columns*columns < quadCount) columns++;
+    float size = (float)GetScreenWidth()/columns;
+
+    for (int test = 0; test < 3; test++)
+    {
+        const char *label = (test == 0)? "rlgl" : (test == 1)? "deferred unsorted" : "deferred sorted";
+        SetDeferredSorting(&queue, (test == 2));
+
+        DeferredStats stats = { 0 };
+        double start = 0.0;
+
+        for (int frame = -2; frame < frames; frame++)
+        {
+            if (frame == 0) start = GetTime();
+
+            BeginDrawing();
+            ClearBackground(BLACK);
+            if (test > 0) BeginDeferred(&queue, &batch);
+
+            for (int i = 0; i < quadCount; i++)
+            {
+                float x = (i%columns)*size;
+                float y = (i/columns)*size;
+                unsigned int id = textures[picks[i]].id;
+
+                if (test == 0)
+                {
+                    rlSetTexture(id);
+                    rlBegin(RL_QUADS);
+                    rlColor4ub(255, 255, 255, 255);
+                    rlTexCoord2f(0.0f, 0.0f); rlVertex2f(x, y);
+                    rlTexCoord2f(0.0f, 1.0f); rlVertex2f(x, y + size);
+                    rlTexCoord2f(1.0f, 1.0f); rlVertex2f(x + size, y + size);
+                    rlTexCoord2f(1.0f, 0.0f); rlVertex2f(x + size, y);
+                    rlEnd();
+                }
+                else
+                {
+                    DeferredSetTexture(&queue, id);
+                    DeferredBegin(&queue, RL_QUADS);
+                    DeferredColor4ub(&queue, 255, 255, 255, 255);
+                    DeferredTexCoord2f(&queue, 0.0f, 0.0f); DeferredVertex3f(&queue, x, y, 0.0f);
+                    DeferredTexCoord2f(&queue, 0.0f, 1.0f); DeferredVertex3f(&queue, x, y + size, 0.0f);
+                    DeferredTexCoord2f(&queue, 1.0f, 1.0f); DeferredVertex3f(&queue, x + size, y + size, 0.0f);
+                    DeferredTexCoord2f(&queue, 1.0f, 0.0f); DeferredVertex3f(&queue, x + size, y, 0.0f);
+                    DeferredEnd(&queue);
+                }
+            }
+
+            if (test == 0) rlSetTexture(0);
+            else
+            {
+                EndDeferred(&queue);
+                if (frame >= 0)
+                {
+                    DeferredStats frameStats = GetDeferredStats(&queue);
+                    stats.commands = frameStats.commands;
+                    stats.drawCallsBefore = frameStats.drawCallsBefore;
+                    stats.drawCallsAfter = frameStats.drawCallsAfter;
+                    stats.sortTime += frameStats.sortTime;
+                }
+            }
+
+            EndDrawing();
+        }
+
+        double elapsed = GetTime() - start;
+
+        if (test == 0) TraceLog(LOG_INFO, "BENCH: [%i quads, %i textures] %-17s %8.3f ms/frame", quadCount, textureCount, label, elapsed*1000.0/frames);
+        else TraceLog(LOG_INFO, "BENCH: [%i quads, %i textures] %-17s %8.3f ms/frame, draw calls %i -> %i, sort %.3f ms/frame", quadCount, textureCount, label,
+                      elapsed*1000.0/frames, stats.drawCallsBefore, stats.drawCallsAfter, stats.sortTime*1000.0/frames);
+    }
+
+    UnloadDeferredQueue(&queue);
+    UnloadStreamBatch(&batch);
+    free(picks);
+    for (int i = 0; i < textureCount; i++) UnloadTexture(textures[i]);
+    free(textures);
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Sort recorded commands and stream them, one draw per state run
+static void SubmitDeferredCommands(DeferredQueue *queue)
+{
+    StreamBatch *batch = queue->batch;
+    int count = queue->commandCount;
+    if (count == 0) return;
+
+    if (batch == NULL)
+    {
+        TraceLog(LOG_WARNING, "DEFERRED: Commands recorded outside BeginDeferred()/EndDeferred(), discarded");
+        queue->commandCount = 0;
+        queue->vertexCount = 0;
+        return;
+    }
+
+    double start = GetTime();
+
+    // Depth range for key quantization
+    float minDepth = queue->commands[0].depth, maxDepth = minDepth;
+    for (int i = 1; i < count; i++)
+    {
+        if (queue->commands[i].depth < minDepth) minDepth = queue->commands[i].depth;
+        if (queue->commands[i].depth > maxDepth) maxDepth = queue->commands[i].depth;
+    }
+    float depthScale = (maxDepth > minDepth)? 4194303.0f/(maxDepth - minDepth) : 0.0f;
+
+    // Key: translucent:1 | opaque: shader:12 texture:20 blend:4 mode:4 depth:22 (front to back)
+    //                    | translucent: depth:22 (back to front), order keeps the rest
+    int *order = (int *)malloc(count*sizeof(int));
+    for (int i = 0; i < count; i++)
+    {
+        DeferredCommand *command = &queue->commands[i];
+        unsigned long long depth = (unsigned long long)((command->depth - minDepth)*depthScale);
+        order[i] = i;
+
+        if (command->opaque)
+        {
+            command->key = ((unsigned long long)(command->shader.id & 0xfff) << 50) |
+                           ((unsigned long long)(command->textureId & 0xfffff) << 30) |
+                           ((unsigned long long)(command->blendMode & 0xf) << 26) |
+                           ((unsigned long long)(command->mode & 0xf) << 22) | depth;
+        }
+        else command->key = (1ull << 63) | ((4194303ull - depth) << 40);
+    }
+
+    queue->stats.commands += count;
+    queue->stats.drawCallsBefore += CountDeferredRuns(queue, order, false);
+    queue->stats.stateChangesBefore += CountDeferredRuns(queue, order, true);
+
+    if (queue->sorting)
+    {
+        // Sort indices, the command array stays in recording order for the vertex offsets
+        DeferredCommand *commands = queue->commands;
+        DeferredCommand **sorted = (DeferredCommand **)malloc(count*sizeof(DeferredCommand *));
+        for (int i = 0; i < count; i++) sorted[i] = &commands[i];
+        qsort(sorted, count, sizeof(DeferredCommand *), CompareDeferredCommands);
+        for (int i = 0; i < count; i++) order[i] = sorted[i]->order;
+        free(sorted);
+    }
+
+    queue->stats.stateChangesAfter += CountDeferredRuns(queue, order, true);
+    queue->stats.sortTime += GetTime() - start;
+
+    // Submit, the batch starts a new draw on texture or mode change, shader and blend need a flush
+    int drawCalls = batch->stats.drawCalls;
+    int blendMode = queue->callerBlendMode;
+    DrawStreamBatch(batch);         // Vertices streamed before the queue go first, in the caller blend mode
+
+    for (int i = 0; i < count; i++)
+    {
+        DeferredCommand *command = &queue->commands[order[i]];
+
+        StreamSetShader(batch, command->shader);
+        if (command->blendMode != blendMode)
+        {
+            DrawStreamBatch(batch);
+            blendMode = command->blendMode;
+            BeginBlendMode(blendMode);
+        }
+
+        StreamSetTexture(batch, command->textureId);
+        StreamBegin(batch, command->mode);
+        StreamPushVertices(batch, queue->vertices + command->vertexOffset, command->vertexCount);
+        StreamEnd(batch);
+    }
+
+    DrawStreamBatch(batch);
+    if (blendMode != queue->callerBlendMode) BeginBlendMode(queue->callerBlendMode);
+    StreamSetShader(batch, (Shader){ 0 });
+
+    queue->stats.drawCallsAfter += batch->stats.drawCalls - drawCalls;
+
+    free(order);
+    queue->commandCount = 0;
+    queue->vertexCount = 0;
+}
+
+// Count state runs in submit order, draw calls or only shader/texture/blend changes
+static int CountDeferredRuns(const DeferredQueue *queue, const int *order, bool stateOnly)
+{
+    int runs = 0;
+    const DeferredCommand *previous = NULL;
+
+    for (int i = 0; i < queue->commandCount; i++)
+    {
+        const DeferredCommand *command = &queue->commands[order[i]];
+
+        if ((previous == NULL) || (command->shader.id != previous->shader.id) || (command->textureId != previous->textureId) ||
+            (command->blendMode != previous->blendMode) || (!stateOnly && (command->mode != previous->mode))) runs++;
+
+        previous = command;
+    }
+
+    return runs;
+}
+
+// Compare sort keys, recording order breaks ties
+static int CompareDeferredCommands(const void *a, const void *b)
+{
+    const DeferredCommand *commandA = *(const DeferredCommand **)a;
+    const DeferredCommand *commandB = *(const DeferredCommand **)b;
+
+    if (commandA->key != commandB->key) return (commandA->key < commandB->key)? -1 : 1;
+    return commandA->order - commandB->order;
+}
+
+#endif // RDEFERRED_IMPLEMENTATION
@@ -0,0 +1,641 @@
+/**********************************************************************************************
+*
+*   raylib.image - Parallel image resize and direct format conversion
+*
+*   DESCRIPTION:
+*       Job based versions of ImageFormat(), ImageResize() and LoadImageColors():
+*         - ImageFormat() expands every pixel to a Vector4 (LoadImageDataNormalized()) and
+*           packs it back, on one thread. ImageFormatParallel() converts common pairs directly
+*           (RGBA8 <-> RGB8, RGBA8 <-> R5G6B5, RGBA8 <-> R32G32B32A32) with integer/SIMD
+*           kernels, in tiles of pixels split across the rjobs.h pool
+*         - ImageResize() runs stb_image_resize2 on one thread. ImageResizeParallel() runs the
+*           same resizer split in bands of output rows (stbir_resize_extended_split()), one
+*           band per pool thread
+*       Results are bit-identical to the raylib functions: the direct kernels reproduce the
+*       float round trip with exact integer math (x/255*255 truncates back to x, R5G6B5 is
+*       (x*31 + 127)/255 packed and v*255/31 expanded) and stbir splits don't change output.
+*       Other format pairs fall back to the raylib functions.
+*
+*       Differences: ImageFormatParallel() converts existing mipmap levels instead of
+*       regenerating them, ImageResizeParallel() drops mipmaps (ImageResize() keeps a stale
+*       count) and float to 8 bit conversions clamp to [0..1] first. LoadImageColors() expands
+*       R5G6B5 with integer 255/31 (= 8, white is 248), LoadImageColorsParallel() gives the
+*       full range ImageFormat() gives. ImageResizeParallel() decodes with LoadImageColors()
+*       like ImageResize(), so resized R5G6B5 images still match.
+*
+*   CONFIGURATION:
+*
+*   #define RIMAGE_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+*   NOTE: Requires rjobs.h, its implementation must be in the same or another translation unit.
+*   SSE2 kernels are used on x86, RGB8 shuffles also need SSSE3 (-mssse3), scalar otherwise
+*
+**********************************************************************************************/
+
+#ifndef RIMAGE_H
+#define RIMAGE_H
+
+#include "raylib.h"
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+bool IsImageFormatDirect(int format, int newFormat);                    // Check format pair has a direct conversion kernel
+void ImageFormatParallel(Image *image, int newFormat);                  // Convert image format, direct kernels in parallel
+void ImageResizeParallel(Image *image, int newWidth, int newHeight);    // Resize image (stb bicubic), bands in parallel
+Color *LoadImageColorsParallel(Image image);                            // Load color data from image as a Color array (RGBA - 32bit)
+void BenchmarkImageOps(int width, int height, int runs);                // Compare against ImageFormat()/ImageResize()/LoadImageColors()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RIMAGE_H
+
+
+/***********************************************************************************
+*
+*   RIMAGE IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RIMAGE_IMPLEMENTATION) && !defined(RIMAGE_IMPLEMENTATION_DEFINED)
+#define RIMAGE_IMPLEMENTATION_DEFINED
+
+#include "rjobs.h"
+#include "external/stb_image_resize2.h"     // Required for: stbir_resize_init(), stbir_resize_extended_split(), implemented in rtextures.c
+
+#include <chrono>               // Required for: std::chrono::steady_clock
+#include <stdlib.h>             // Required for: malloc(), free()
+#include <string.h>             // Required for: memcpy(), memcmp()
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define RIMAGE_SSE2
+    #include <emmintrin.h>
+#endif
+#if defined(RIMAGE_SSE2) && defined(__SSSE3__)
+    #define RIMAGE_SSSE3
+    #include <tmmintrin.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define IMAGE_JOB_PIXELS        65536       // Pixels per conversion tile
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Direct conversion kernels
+typedef enum {
+    IMAGE_CONVERT_NONE = 0,
+    IMAGE_CONVERT_RGBA8_RGB8,
+    IMAGE_CONVERT_RGB8_RGBA8,
+    IMAGE_CONVERT_RGBA8_R5G6B5,
+    IMAGE_CONVERT_R5G6B5_RGBA8,
+    IMAGE_CONVERT_RGBA8_RGBA32,
+    IMAGE_CONVERT_RGBA32_RGBA8
+} ImageConversion;
+
+// Conversion of a pixel array, shared by the tile jobs
+typedef struct {
+    int conversion;             // ImageConversion
+    const unsigned char *src;
+    unsigned char *dst;
+    int srcPixelSize;
+    int dstPixelSize;
+    bool simd;                  // false runs the scalar reference kernels
+} ImageConvertJob;
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static double GetImageOpsTime(void);
+static int GetImageConversion(int format, int newFormat);
+static int GetImageChainPixels(Image image);
+static void ConvertPixels(const void *src, void *dst, int count, int format, int newFormat, bool simd);
+static void ConvertPixelsJob(int begin, int end, void *userData);
+static void ResizeSplitJob(int begin, int end, void *userData);
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Check format pair has a direct conversion kernel
+bool IsImageFormatDirect(int format, int newFormat)
+{
+    return (GetImageConversion(format, newFormat) != IMAGE_CONVERT_NONE);
+}
+
+// Convert image format, direct kernels in parallel
+// NOTE: Mipmap levels are converted as they are, ImageFormat() regenerates them from the base level
+void ImageFormatParallel(Image *image, int newFormat)
+{
+    if ((image->data == NULL) || (image->width == 0) || (image->height == 0)) return;
+    if ((newFormat == 0) || (image->format == newFormat)) return;
+
+    if (!IsImageFormatDirect(image->format, newFormat))
+    {
+        ImageFormat(image, newFormat);
+        return;
+    }
+
+    // Levels are contiguous in both formats, the whole chain converts as one pixel array
+    int pixelCount = GetImageChainPixels(*image);
+    void *data = malloc((size_t)pixelCount*GetPixelDataSize(1, 1, newFormat));
+    if (data == NULL)
+    {
+        TraceLog(LOG_WARNING, "IMAGE: Format conversion memory could not be allocated");
+        return;
+    }
+
+    ConvertPixels(image->data, data, pixelCount, image->format, newFormat, true);
+
+    free(image->data);
+    image->data = data;
+    image->format = newFormat;
+}
+
+// Resize image (stb bicubic), bands in parallel
+// NOTE: Same filters and output as ImageResize(), mipmaps are dropped
+void ImageResizeParallel(Image *image, int newWidth, int newHeight)
+{
+    if ((image->data == NULL) || (image->width == 0) || (image->height == 0)) return;
+    if ((newWidth <= 0) || (newHeight <= 0)) return;
+
+    // 8 bit formats resize as they are, the rest as RGBA8 and back (like ImageResize())
+    // NOTE: Decoded with LoadImageColors() as ImageResize() does, LoadImageColorsParallel() expands R5G6B5 differently
+    int format = image->format;
+    bool direct = ((format == PIXELFORMAT_UNCOMPRESSED_GRAYSCALE) || (format == PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA) ||
+                   (format == PIXELFORMAT_UNCOMPRESSED_R8G8B8) || (format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8));
+
+    const void *input = direct? image->data : (const void *)LoadImageColors(*image);
+    int pixelFormat = direct? format : PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+    int bytesPerPixel = GetPixelDataSize(1, 1, pixelFormat);
+    unsigned char *output = (unsigned char *)malloc((size_t)newWidth*newHeight*bytesPerPixel);
+
+    STBIR_RESIZE resize;
+    stbir_resize_init(&resize, input, image->width, image->height, 0, output, newWidth, newHeight, 0, (stbir_pixel_layout)bytesPerPixel, STBIR_TYPE_UINT8);
+
+    int splits = stbir_build_samplers_with_splits(&resize, GetJobsThreadCount());
+    if (splits > 0) RunJobsParallel(splits, 1, ResizeSplitJob, &resize);
+    else TraceLog(LOG_WARNING, "IMAGE: Resize samplers could not be built");
+    stbir_free_samplers(&resize);
+
+    if (!direct) UnloadImageColors((Color *)input);
+    free(image->data);
+
+    image->data = output;
+    image->width = newWidth;
+    image->height = newHeight;
+    image->mipmaps = 1;
+
+    if (!direct)
+    {
+        image->format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+        ImageFormatParallel(image, format);     // Reformat 32bit RGBA image to original format
+    }
+}
+
+// Load color data from image as a Color array (RGBA - 32bit)
+// NOTE: Memory allocated should be freed using UnloadImageColors()
+Color *LoadImageColorsParallel(Image image)
+{
+    if ((image.data == NULL) || (image.width == 0) || (image.height == 0)) return NULL;
+
+    int pixelCount = image.width*image.height;
+
+    if (image.format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+    {
+        Color *pixels = (Color *)malloc((size_t)pixelCount*sizeof(Color));
+        if (pixels != NULL) memcpy(pixels, image.data, (size_t)pixelCount*sizeof(Color));
+        return pixels;
+    }
+
+    if (!IsImageFormatDirect(image.format, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)) return LoadImageColors(image);
+
+    Color *pixels = (Color *)malloc((size_t)pixelCount*sizeof(Color));
+    if (pixels != NULL) ConvertPixels(image.data, pixels, pixelCount, image.format, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, true);
+
+    return pixels;
+}
+
+// Compare against ImageFormat()/ImageResize()/LoadImageColors()
+void BenchmarkImageOps(int width, int height, int runs)
+{
+    // Hashed noise over gradients, every value of every channel shows up
+    Image base = GenImageColor(width, height, BLANK);
+    Color *colors = (Color *)base.data;
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            unsigned int h = (unsigned int)(x*73856093) ^ (unsigned int)(y*19349663);
+            h = (h ^ (h >> 13))*0x5bd1e995u;
+            colors[y*width + x] = (Color){ (unsigned char)(x*255/width), (unsigned char)(h & 255), (unsigned char)(y*255/height), (unsigned char)((h >> 8) & 255) };
+        }
+    }
+
+    int threadCount = GetJobsThreadCount();
+    const int pairs[6][2] = {
+        { PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, PIXELFORMAT_UNCOMPRESSED_R8G8B8 },
+        { PIXELFORMAT_UNCOMPRESSED_R8G8B8, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 },
+        { PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, PIXELFORMAT_UNCOMPRESSED_R5G6B5 },
+        { PIXELFORMAT_UNCOMPRESSED_R5G6B5, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 },
+        { PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32 },
+        { PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 }
+    };
+    const char *names[6] = { "RGBA8 -> RGB8", "RGB8 -> RGBA8", "RGBA8 -> R5G6B5", "R5G6B5 -> RGBA8", "RGBA8 -> RGBA32F", "RGBA32F -> RGBA8" };
+
+    TraceLog(LOG_INFO, "BENCH: [%ix%i] %i threads, %i runs, ms per call", width, height, threadCount, runs);
+    TraceLog(LOG_INFO, "BENCH: %-18s | %10s | %10s | %10s | %7s | %s", "operation", "raylib", "1 thread", "pool", "speedup", "output");
+
+    // Times: raylib, direct on 1 thread, direct on the pool
+    for (int p = 0; p < 10; p++)
+    {
+        double times[3] = { 0 };
+        bool identical = true;
+        bool scalarMatch = true;
+        const char *name = NULL;
+
+        for (int test = 0; test < 3; test++)
+        {
+            InitJobs((test == 1)? 1 : threadCount);
+
+            for (int run = 0; run < runs; run++)
+            {
+                Image source = ImageCopy(base);
+                Image result = { 0 };
+                double start = 0.0;
+
+                if (p < 6)
+                {
+                    name = names[p];
+                    ImageFormat(&source, pairs[p][0]);
+
+                    result = ImageCopy(source);
+                    start = GetImageOpsTime();
+                    if (test == 0) ImageFormat(&result, pairs[p][1]);
+                    else ImageFormatParallel(&result, pairs[p][1]);
+                    times[test] += GetImageOpsTime() - start;
+                }
+                else
+                {
+                    // Resize: half size down (Mitchell), 1.5x up (Catmull-Rom), then 0.5x on
+                    // R5G6B5 (RGBA8 round trip) and GRAY_ALPHA (direct 2 channels)
+                    const char *resizeNames[4] = { "resize 0.5x", "resize 1.5x", "resize R5G6B5", "resize GRAY_ALPHA" };
+                    name = resizeNames[p - 6];
+                    if (p == 8) ImageFormat(&source, PIXELFORMAT_UNCOMPRESSED_R5G6B5);
+                    else if (p == 9) ImageFormat(&source, PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA);
+
+                    int newWidth = (p == 7)? width*3/2 : width/2;
+                    int newHeight = (p == 7)? height*3/2 : height/2;
+
+                    result = ImageCopy(source);
+                    start = GetImageOpsTime();
+                    if (test == 0) ImageResize(&result, newWidth, newHeight);
+                    else ImageResizeParallel(&result, newWidth, newHeight);
+                    times[test] += GetImageOpsTime() - start;
+                }
+
+                if (run == 0)
+                {
+                    // Compare against the raylib result, and the SIMD kernels against the scalar ones
+                    Image reference = ImageCopy(source);
+                    if (p < 6) ImageFormat(&reference, pairs[p][1]);
+                    else ImageResize(&reference, result.width, result.height);
+
+                    int size = GetPixelDataSize(result.width, result.height, result.format);
+                    if ((reference.format != result.format) || (memcmp(reference.data, result.data, size) != 0)) identical = false;
+
+                    if (p < 6)
+                    {
+                        unsigned char *scalar = (unsigned char *)malloc(size);
+                        ConvertPixels(source.data, scalar, source.width*source.height, pairs[p][0], pairs[p][1], false);
+                        if (memcmp(scalar, result.data, size) != 0) scalarMatch = false;
+                        free(scalar);
+                    }
+
+                    UnloadImage(reference);
+                }
+
+                UnloadImage(result);
+                UnloadImage(source);
+            }
+        }
+
+        TraceLog(LOG_INFO, "BENCH: %-18s | %10.2f | %10.2f | %10.2f | %6.1fx | %s", name, times[0]*1000.0/runs, times[1]*1000.0/runs,
+                 times[2]*1000.0/runs, times[0]/times[2], (identical && scalarMatch)? "identical" : (identical? "SIMD != scalar" : "DIFFERENT"));
+    }
+
+    // Color arrays from a non RGBA8 format, compared with ImageFormat() (see R5G6B5 NOTE on top)
+    Image source = ImageCopy(base);
+    ImageFormat(&source, PIXELFORMAT_UNCOMPRESSED_R5G6B5);
+    Image expected = ImageCopy(source);
+    ImageFormat(&expected, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    double times[2] = { 0 };
+    bool identical = true;
+
+    for (int run = 0; run < runs; run++)
+    {
+        double start = GetImageOpsTime();
+        Color *reference = LoadImageColors(source);
+        times[0] += GetImageOpsTime() - start;
+
+        start = GetImageOpsTime();
+        Color *pixels = LoadImageColorsParallel(source);
+        times[1] += GetImageOpsTime() - start;
+
+        if (memcmp(expected.data, pixels, (size_t)width*height*sizeof(Color)) != 0) identical = false;
+        UnloadImageColors(reference);
+        UnloadImageColors(pixels);
+    }
+
+    TraceLog(LOG_INFO, "BENCH: %-18s | %10.2f | %10s | %10.2f | %6.1fx | %s", "colors <- R5G6B5", times[0]*1000.0/runs, "-",
+             times[1]*1000.0/runs, times[0]/times[1], identical? "identical" : "DIFFERENT");
+
+    UnloadImage(expected);
+    UnloadImage(source);
+    UnloadImage(base);
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Monotonic time in seconds, works without a window
+static double GetImageOpsTime(void)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Get direct kernel for a format pair
+static int GetImageConversion(int format, int newFormat)
+{
+    if (format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+    {
+        switch (newFormat)
+        {
+            case PIXELFORMAT_UNCOMPRESSED_R8G8B8: return IMAGE_CONVERT_RGBA8_RGB8;
+            case PIXELFORMAT_UNCOMPRESSED_R5G6B5: return IMAGE_CONVERT_RGBA8_R5G6B5;
+            case PIXELFORMAT_UNCOMPRESSED_R32G32B32A32: return IMAGE_CONVERT_RGBA8_RGBA32;
+            default: break;
+        }
+    }
+    else if (newFormat == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+    {
+        switch (format)
+        {
+            case PIXELFORMAT_UNCOMPRESSED_R8G8B8: return IMAGE_CONVERT_RGB8_RGBA8;
+            case PIXELFORMAT_UNCOMPRESSED_R5G6B5: return IMAGE_CONVERT_R5G6B5_RGBA8;
+            case PIXELFORMAT_UNCOMPRESSED_R32G32B32A32: return IMAGE_CONVERT_RGBA32_RGBA8;
+            default: break;
+        }
+    }
+
+    return IMAGE_CONVERT_NONE;
+}
+
+// Get pixels of all mipmap levels
+static int GetImageChainPixels(Image image)
+{
+    int pixelCount = 0;
+    int width = image.width;
+    int height = image.height;
+
+    for (int i = 0; i < ((image.mipmaps > 0)? image.mipmaps : 1); i++)
+    {
+        pixelCount += width*height;
+        width = (width > 1)? width/2 : 1;
+        height = (height > 1)? height/2 : 1;
+    }
+
+    return pixelCount;
+}
+
+// Convert a pixel array, tiles split across the job pool
+static void ConvertPixels(const void *src, void *dst, int count, int format, int newFormat, bool simd)
+{
+    ImageConvertJob job = { 0 };
+
+    job.conversion = GetImageConversion(format, newFormat);
+    job.src = (const unsigned char *)src;
+    job.dst = (unsigned char *)dst;
+    job.srcPixelSize = GetPixelDataSize(1, 1, format);
+    job.dstPixelSize = GetPixelDataSize(1, 1, newFormat);
+    job.simd = simd;
+
+    RunJobsParallel(count, IMAGE_JOB_PIXELS, ConvertPixelsJob, &job);
+}
+
+// Convert pixels [begin, end)
+// NOTE: Kernels match ImageFormat() exactly: its float round trip (byte/255.0f)*255.0f truncates
+// back to byte, round(byte/255.0f*31.0f) is (byte*31 + 127)/255 and (v*(1.0f/31))*255.0f
+// truncates to v*255/31 for every input (checked exhaustively)
+static void ConvertPixelsJob(int begin, int end, void *userData)
+{
+    const ImageConvertJob *job = (const ImageConvertJob *)userData;
+    const unsigned char *src = job->src + (size_t)begin*job->srcPixelSize;
+    unsigned char *dst = job->dst + (size_t)begin*job->dstPixelSize;
+    int count = end - begin;
+    int i = 0;
+
+    switch (job->conversion)
+    {
+        case IMAGE_CONVERT_RGBA8_RGB8:
+        {
+#if defined(RIMAGE_SSSE3)
+            if (job->simd)
+            {
+                // 4 pixels per shuffle, the 16 byte store overlaps the next 4 bytes
+                __m128i mask = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+                for (; i + 6 <= count; i += 4) _mm_storeu_si128((__m128i *)(dst + 3*i), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src + 4*i)), mask));
+            }
+#endif
+            for (; i < count; i++)
+            {
+                dst[3*i] = src[4*i];
+                dst[3*i + 1] = src[4*i + 1];
+                dst[3*i + 2] = src[4*i + 2];
+            }
+        } break;
+        case IMAGE_CONVERT_RGB8_RGBA8:
+        {
+#if defined(RIMAGE_SSSE3)
+            if (job->simd)
+            {
+                // 16 byte load reads 4 bytes past the 4 pixels, stays inside while 6 pixels remain
+                __m128i mask = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+                __m128i alpha = _mm_set1_epi32((int)0xff000000);
+                for (; i + 6 <= count; i += 4) _mm_storeu_si128((__m128i *)(dst + 4*i), _mm_or_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src + 3*i)), mask), alpha));
+            }
+#endif
+            for (; i < count; i++)
+            {
+                dst[4*i] = src[3*i];
+                dst[4*i + 1] = src[3*i + 1];
+                dst[4*i + 2] = src[3*i + 2];
+                dst[4*i + 3] = 255;
+            }
+        } break;
+        case IMAGE_CONVERT_RGBA8_R5G6B5:
+        {
+#if defined(RIMAGE_SSE2)
+            if (job->simd)
+            {
+                __m128i zero = _mm_setzero_si128();
+                __m128i scale = _mm_setr_epi16(31, 63, 31, 0, 31, 63, 31, 0);
+                __m128i bias = _mm_set1_epi16(127);
+                __m128i one = _mm_set1_epi16(1);
+                __m128i shifts = _mm_setr_epi16(2048, 32, 1, 0, 2048, 32, 1, 0);
+                __m128i offset32 = _mm_set1_epi32(32768);
+                __m128i offset16 = _mm_set1_epi16((short)0x8000);
+
+                for (; i + 4 <= count; i += 4)
+                {
+                    __m128i bytes = _mm_loadu_si128((const __m128i *)(src + 4*i));
+                    __m128i halves[2] = { _mm_unpacklo_epi8(bytes, zero), _mm_unpackhi_epi8(bytes, zero) };
+
+                    for (int h = 0; h < 2; h++)
+                    {
+                        // (x*31 + 127)/255, n/255 as (n + 1 + (n >> 8)) >> 8 (exact below 65535)
+                        __m128i n = _mm_add_epi16(_mm_mullo_epi16(halves[h], scale), bias);
+                        __m128i q = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(n, one), _mm_srli_epi16(n, 8)), 8);
+
+                        // r << 11 | g << 5 | b: pair sums in 32 bit, then add the pairs of each pixel
+                        __m128i m = _mm_madd_epi16(q, shifts);
+                        m = _mm_add_epi32(m, _mm_srli_epi64(m, 32));
+                        halves[h] = _mm_shuffle_epi32(m, _MM_SHUFFLE(3, 1, 2, 0));
+                    }
+
+                    // 4 x 32 bit (up to 65535) to 16 bit, packs is signed so shift the range
+                    __m128i packed = _mm_sub_epi32(_mm_unpacklo_epi64(halves[0], halves[1]), offset32);
+                    packed = _mm_xor_si128(_mm_packs_epi32(packed, packed), offset16);
+                    _mm_storel_epi64((__m128i *)(dst + 2*i), packed);
+                }
+            }
+#endif
+            unsigned short *out = (unsigned short *)dst;
+            for (; i < count; i++)
+            {
+                unsigned short r = (unsigned short)((src[4*i]*31 + 127)/255);
+                unsigned short g = (unsigned short)((src[4*i + 1]*63 + 127)/255);
+                unsigned short b = (unsigned short)((src[4*i + 2]*31 + 127)/255);
+                out[i] = (unsigned short)(r << 11 | g << 5 | b);
+            }
+        } break;
+        case IMAGE_CONVERT_R5G6B5_RGBA8:
+        {
+            const unsigned short *in = (const unsigned short *)src;
+#if defined(RIMAGE_SSE2)
+            if (job->simd)
+            {
+                __m128i mask5 = _mm_set1_epi16(31);
+                __m128i mask6 = _mm_set1_epi16(63);
+                __m128i full = _mm_set1_epi16(255);
+                __m128i alpha = _mm_set1_epi16((short)0xff00);
+
+                for (; i + 8 <= count; i += 8)
+                {
+                    __m128i pixels = _mm_loadu_si128((const __m128i *)(in + i));
+
+                    // v*255/31 and v*255/63 by reciprocal multiply, exact for these ranges
+                    __m128i r = _mm_mullo_epi16(_mm_srli_epi16(pixels, 11), full);
+                    __m128i g = _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(pixels, 5), mask6), full);
+                    __m128i b = _mm_mullo_epi16(_mm_and_si128(pixels, mask5), full);
+                    r = _mm_srli_epi16(_mm_mulhi_epu16(r, _mm_set1_epi16(8457)), 2);
+                    g = _mm_srli_epi16(_mm_mulhi_epu16(g, _mm_set1_epi16(16645)), 4);
+                    b = _mm_srli_epi16(_mm_mulhi_epu16(b, _mm_set1_epi16(8457)), 2);
+
+                    __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+                    __m128i ba = _mm_or_si128(b, alpha);
+                    _mm_storeu_si128((__m128i *)(dst + 4*i), _mm_unpacklo_epi16(rg, ba));
+                    _mm_storeu_si128((__m128i *)(dst + 4*i + 16), _mm_unpackhi_epi16(rg, ba));
+                }
+            }
+#endif
+            for (; i < count; i++)
+            {
+                dst[4*i] = (unsigned char)((in[i] >> 11)*255/31);
+                dst[4*i + 1] = (unsigned char)(((in[i] >> 5) & 63)*255/63);
+                dst[4*i + 2] = (unsigned char)((in[i] & 31)*255/31);
+                dst[4*i + 3] = 255;
+            }
+        } break;
+        case IMAGE_CONVERT_RGBA8_RGBA32:
+        {
+            float *out = (float *)dst;
+#if defined(RIMAGE_SSE2)
+            if (job->simd)
+            {
+                // Division, not a reciprocal multiply, to round like byte/255.0f
+                __m128i zero = _mm_setzero_si128();
+                __m128 divisor = _mm_set1_ps(255.0f);
+
+                for (; i + 4 <= count; i += 4)
+                {
+                    __m128i bytes = _mm_loadu_si128((const __m128i *)(src + 4*i));
+                    __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+                    __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+                    _mm_storeu_ps(out + 4*i, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), divisor));
+                    _mm_storeu_ps(out + 4*i + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), divisor));
+                    _mm_storeu_ps(out + 4*i + 8, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), divisor));
+                    _mm_storeu_ps(out + 4*i + 12, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), divisor));
+                }
+            }
+#endif
+            for (; i < count; i++)
+            {
+                for (int c = 0; c < 4; c++) out[4*i + c] = (float)src[4*i + c]/255.0f;
+            }
+        } break;
+        case IMAGE_CONVERT_RGBA32_RGBA8:
+        {
+            const float *in = (const float *)src;
+#if defined(RIMAGE_SSE2)
+            if (job->simd)
+            {
+                __m128 zero = _mm_setzero_ps();
+                __m128 one = _mm_set1_ps(1.0f);
+                __m128 scale = _mm_set1_ps(255.0f);
+
+                for (; i + 4 <= count; i += 4)
+                {
+                    __m128i values[4];
+                    for (int k = 0; k < 4; k++) values[k] = _mm_cvttps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + 4*(i + k)), zero), one), scale));
+
+                    __m128i lo = _mm_packs_epi32(values[0], values[1]);
+                    __m128i hi = _mm_packs_epi32(values[2], values[3]);
+                    _mm_storeu_si128((__m128i *)(dst + 4*i), _mm_packus_epi16(lo, hi));
+                }
+            }
+#endif
+            for (; i < count; i++)
+            {
+                for (int c = 0; c < 4; c++)
+                {
+                    float value = in[4*i + c];
+                    value = (value < 0.0f)? 0.0f : ((value > 1.0f)? 1.0f : value);
+                    dst[4*i + c] = (unsigned char)(value*255.0f);
+                }
+            }
+        } break;
+        default: break;
+    }
+}
+
+// Run stbir splits [begin, end), each split is a band of output rows
+static void ResizeSplitJob(int begin, int end, void *userData)
+{
+    stbir_resize_extended_split((STBIR_RESIZE *)userData, begin, end - begin);
+}
+
+#endif // RIMAGE_IMPLEMENTATION
@@ -0,0 +1,222 @@
+/**********************************************************************************************
+*
+*   raylib.jobs - Minimal persistent worker pool for data-parallel loops
+*
+*   DESCRIPTION:
+*       RunJobsParallel() splits an index range in chunks and runs them on a pool of worker
+*       threads created once. The calling thread takes chunks too and returns when the
+*       whole range is done. Calls made from inside a job run serially on that thread.
+*       Only one thread at a time may start jobs.
+*
+*   CONFIGURATION:
+*
+*   #define RJOBS_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+*   NOTE: Implementation uses C++11 <thread>, link with Threads::Threads
+*
+**********************************************************************************************/
+
+#ifndef RJOBS_H
+#define RJOBS_H
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Job callback, processes indices [begin, end)
+typedef void (*JobFunc)(int begin, int end, void *userData);
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+void InitJobs(int threadCount);                     // Start pool with threadCount threads including the caller (<= 0: all cores)
+void CloseJobs(void);                               // Stop and join pool threads
+int GetJobsThreadCount(void);                       // Get threads taking part in RunJobsParallel()
+void RunJobsParallel(int count, int grainSize, JobFunc func, void *userData);  // Run func over [0, count) in chunks of grainSize
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RJOBS_H
+
+
+/***********************************************************************************
+*
+*   RJOBS IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RJOBS_IMPLEMENTATION) && !defined(RJOBS_IMPLEMENTATION_DEFINED)
+#define RJOBS_IMPLEMENTATION_DEFINED    // Other modules include this header from their implementation
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Worker pool state, workers are joined on program exit if CloseJobs() was not called
+struct JobPool {
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    // Current job, published under mutex with a new generation
+    JobFunc func = nullptr;
+    void *userData = nullptr;
+    int count = 0;
+    int grainSize = 1;
+    std::atomic<int> nextChunk { 0 };
+    int busyWorkers = 0;
+    unsigned int generation = 0;
+    bool quit = false;
+
+    ~JobPool() { Stop(); }
+
+    void Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        wake.notify_all();
+        for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+        workers.clear();
+        quit = false;
+    }
+};
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static JobPool jobPool;
+static bool jobsReady = false;
+static thread_local bool insideJob = false;    // Nested calls run serially
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Take chunks of the current job until none are left
+static void JobsDrain(JobFunc func, void *userData, int count, int grainSize)
+{
+    insideJob = true;
+
+    for (;;)
+    {
+        int begin = jobPool.nextChunk.fetch_add(1)*grainSize;
+        if (begin >= count) break;
+
+        int end = (begin + grainSize < count)? begin + grainSize : count;
+        func(begin, end, userData);
+    }
+
+    insideJob = false;
+}
+
+// NOTE: Workers start from the generation current at creation, so a restarted pool never replays an old job
+static void JobsWorkerLoop(unsigned int seen)
+{
+    for (;;)
+    {
+        JobFunc func = nullptr;
+        void *userData = nullptr;
+        int count = 0, grainSize = 1;
+
+        {
+            std::unique_lock<std::mutex> lock(jobPool.mutex);
+            jobPool.wake.wait(lock, [&]{ return jobPool.quit || (jobPool.generation != seen); });
+            if (jobPool.quit) return;
+
+            seen = jobPool.generation;
+            func = jobPool.func;
+            userData = jobPool.userData;
+            count = jobPool.count;
+            grainSize = jobPool.grainSize;
+        }
+
+        JobsDrain(func, userData, count, grainSize);
+
+        {
+            std::lock_guard<std::mutex> lock(jobPool.mutex);
+            jobPool.busyWorkers--;
+        }
+        jobPool.done.notify_one();
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Start pool with threadCount threads including the caller
+void InitJobs(int threadCount)
+{
+    if (jobsReady) CloseJobs();
+
+    if (threadCount <= 0) threadCount = (int)std::thread::hardware_concurrency();
+    if (threadCount <= 0) threadCount = 1;
+
+    for (int i = 0; i < threadCount - 1; i++) jobPool.workers.push_back(std::thread(JobsWorkerLoop, jobPool.generation));
+    jobsReady = true;
+}
+
+// Stop and join pool threads
+void CloseJobs(void)
+{
+    jobPool.Stop();
+    jobsReady = false;
+}
+
+// Get threads taking part in RunJobsParallel()
+int GetJobsThreadCount(void)
+{
+    if (!jobsReady) InitJobs(0);
+    return (int)jobPool.workers.size() + 1;
+}
+
+// Run func over [0, count) in chunks of grainSize
+void RunJobsParallel(int count, int grainSize, JobFunc func, void *userData)
+{
+    if (count <= 0) return;
+    if (grainSize < 1) grainSize = 1;
+    if (!jobsReady) InitJobs(0);
+
+    if (insideJob || jobPool.workers.empty() || (count <= grainSize))
+    {
+        func(0, count, userData);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(jobPool.mutex);
+        jobPool.func = func;
+        jobPool.userData = userData;
+        jobPool.count = count;
+        jobPool.grainSize = grainSize;
+        jobPool.nextChunk.store(0);
+        jobPool.busyWorkers = (int)jobPool.workers.size();
+        jobPool.generation++;
+    }
+    jobPool.wake.notify_all();
+
+    JobsDrain(func, userData, count, grainSize);
+
+    std::unique_lock<std::mutex> lock(jobPool.mutex);
+    jobPool.done.wait(lock, []{ return jobPool.busyWorkers == 0; });
+}
+
+#endif // RJOBS_IMPLEMENTATION
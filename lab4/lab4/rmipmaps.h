@@ -0,0 +1,655 @@
+/**********************************************************************************************
+*
+*   raylib.mipmaps - Parallel SIMD mipmap generation for images
+*
+*   DESCRIPTION:
+*       ImageMipmapsParallel() is ImageMipmaps() with a dedicated 2x downsampler: every level
+*       is filtered straight from the previous one into a single buffer allocated once for the
+*       whole chain, rows of each level split across the rjobs.h thread pool. ImageMipmaps()
+*       resizes a full copy per level with the generic stb resizer on one thread.
+*
+*       Filters:
+*         - MIPMAP_FILTER_BOX: average of the 2x2 source pixels, exact integer rounding
+*         - MIPMAP_FILTER_KAISER: separable 8 tap Kaiser windowed sinc (alpha 4), sharper
+*           levels with less aliasing, close to the Mitchell filter ImageMipmaps() uses
+*
+*       Formats: R8G8B8A8, R8G8B8, GRAYSCALE (R8) and R32, R32G32B32, R32G32B32A32 floats.
+*       Others go through ImageMipmaps(). Level sizes match ImageMipmaps() (halved, at least 1),
+*       so the result uploads with LoadTextureFromImage() like any mipmapped image.
+*
+*       SSE2 kernels cover box RGBA8/R8/RGBA32/R32 and Kaiser 4 channel formats, scalar code
+*       the rest. Both paths give the same bytes.
+*
+*   CONFIGURATION:
+*
+*   #define RMIPMAPS_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+*   NOTE: Requires rjobs.h, its implementation must be in the same or another translation unit
+*
+**********************************************************************************************/
+
+#ifndef RMIPMAPS_H
+#define RMIPMAPS_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Mipmap downsampling filter
+typedef enum {
+    MIPMAP_FILTER_BOX = 0,          // 2x2 average
+    MIPMAP_FILTER_KAISER            // 8 tap Kaiser windowed sinc
+} MipmapFilter;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+bool IsMipmapFormatSupported(int format);                               // Check format has a dedicated downsampler
+long long GetMipmapChainSize(int width, int height, int format, int *levels);   // Get bytes for all levels, levels count optional
+void ImageMipmapsParallel(Image *image, int filter);                    // Generate all mipmap levels (MipmapFilter), in parallel
+void GenImageMipmapLevel(const void *src, int width, int height, void *dst, int format, int filter);    // Downsample one level into dst (halved size)
+Texture2D LoadTextureMipmapped(const char *fileName, int filter);       // Load texture with CPU generated mipmaps, trilinear filtering
+void BenchmarkImageMipmaps(int size, int runs);                         // Compare against ImageMipmaps() on a size x size RGBA image
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RMIPMAPS_H
+
+
+/***********************************************************************************
+*
+*   RMIPMAPS IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RMIPMAPS_IMPLEMENTATION) && !defined(RMIPMAPS_IMPLEMENTATION_DEFINED)
+#define RMIPMAPS_IMPLEMENTATION_DEFINED
+
+#include "rjobs.h"
+
+#include <chrono>               // Required for: std::chrono::steady_clock
+#include <math.h>               // Required for: sqrt(), sin(), fabs()
+#include <stdlib.h>             // Required for: malloc(), realloc(), free()
+#include <string.h>             // Required for: memcpy()
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define RMIPMAPS_SSE2
+    #include <emmintrin.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MIPMAP_KAISER_TAPS          8       // Source taps per destination pixel and axis
+#define MIPMAP_KAISER_ALPHA      4.0
+#define MIPMAP_JOB_PIXELS       16384       // Destination pixels per job chunk (rows rounded up)
+
+// Pairwise sum of the 8 weighted taps, shorter dependency chain than a running sum and the
+// same order for SIMD and scalar, so both round identically
+#define MIPMAP_ADD(a, b) ((a) + (b))
+#define MIPMAP_KAISER_SUM(add, p) add(add(add(p[0], p[1]), add(p[2], p[3])), add(add(p[4], p[5]), add(p[6], p[7])))
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// One level downsample, shared by the row jobs
+typedef struct {
+    const unsigned char *src;
+    unsigned char *dst;
+    int srcWidth, srcHeight;
+    int dstWidth, dstHeight;
+    int channels;
+    bool isFloat;
+    bool simd;                  // false runs the scalar reference kernels
+} MipmapLevelJob;
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static float mipmapKaiserWeights[MIPMAP_KAISER_TAPS] = { 0 };
+static bool mipmapKaiserReady = false;
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static double GetMipmapTime(void);
+static bool GetMipmapFormatLayout(int format, int *channels, bool *isFloat);
+static void InitKaiserWeights(void);
+static void GenMipmapLevel(const void *src, int srcWidth, int srcHeight, void *dst, int format, int filter, bool simd);
+static void BoxRowsJob(int begin, int end, void *userData);
+static void KaiserHorizontal(const MipmapLevelJob *job, int sy, float *line, float *out);
+static void KaiserRowsJob(int begin, int end, void *userData);
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Check format has a dedicated downsampler
+bool IsMipmapFormatSupported(int format)
+{
+    int channels = 0;
+    bool isFloat = false;
+
+    return GetMipmapFormatLayout(format, &channels, &isFloat);
+}
+
+// Get bytes for all levels, levels count optional
+// NOTE: Same level sizes as ImageMipmaps(), the sum can pass INT_MAX when the base level doesn't
+long long GetMipmapChainSize(int width, int height, int format, int *levels)
+{
+    int count = 1;
+    long long size = GetPixelDataSize(width, height, format);
+
+    while ((width != 1) || (height != 1))
+    {
+        width = (width > 1)? width/2 : 1;
+        height = (height > 1)? height/2 : 1;
+        size += GetPixelDataSize(width, height, format);
+        count++;
+    }
+
+    if (levels != NULL) *levels = count;
+    return size;
+}
+
+// Generate all mipmap levels (MipmapFilter), in parallel
+void ImageMipmapsParallel(Image *image, int filter)
+{
+    if ((image->data == NULL) || (image->width == 0) || (image->height == 0)) return;
+
+    if (!IsMipmapFormatSupported(image->format))
+    {
+        TraceLog(LOG_WARNING, "MIPMAPS: Format %i not supported, using ImageMipmaps()", image->format);
+        ImageMipmaps(image);
+        return;
+    }
+
+    int levels = 0;
+    long long chainSize = GetMipmapChainSize(image->width, image->height, image->format, &levels);
+    if (image->mipmaps >= levels)
+    {
+        TraceLog(LOG_WARNING, "MIPMAPS: Mipmaps already available");
+        return;
+    }
+
+    void *data = realloc(image->data, (size_t)chainSize);
+    if (data == NULL)
+    {
+        TraceLog(LOG_WARNING, "MIPMAPS: Mipmaps required memory could not be allocated");
+        return;
+    }
+    image->data = data;
+
+    unsigned char *src = (unsigned char *)image->data;
+    int width = image->width;
+    int height = image->height;
+
+    for (int i = 1; i < levels; i++)
+    {
+        unsigned char *dst = src + GetPixelDataSize(width, height, image->format);
+        GenMipmapLevel(src, width, height, dst, image->format, filter, true);
+
+        src = dst;
+        width = (width > 1)? width/2 : 1;
+        height = (height > 1)? height/2 : 1;
+    }
+
+    image->mipmaps = levels;
+}
+
+// Downsample one level into dst (halved size)
+void GenImageMipmapLevel(const void *src, int width, int height, void *dst, int format, int filter)
+{
+    if (IsMipmapFormatSupported(format)) GenMipmapLevel(src, width, height, dst, format, filter, true);
+}
+
+// Load texture with CPU generated mipmaps, trilinear filtering
+// NOTE: Replaces LoadTexture() + GenTextureMipmaps(), levels are uploaded with the base level
+Texture2D LoadTextureMipmapped(const char *fileName, int filter)
+{
+    Image image = LoadImage(fileName);
+    ImageMipmapsParallel(&image, filter);
+
+    Texture2D texture = LoadTextureFromImage(image);
+    if (texture.mipmaps > 1) SetTextureFilter(texture, TEXTURE_FILTER_TRILINEAR);
+
+    UnloadImage(image);
+    return texture;
+}
+
+// Compare against ImageMipmaps() on a size x size RGBA image
+void BenchmarkImageMipmaps(int size, int runs)
+{
+    // Hashed value noise, detail at every level like a photo texture
+    Image base = GenImageColor(size, size, BLANK);
+    Color *pixels = (Color *)base.data;
+    for (int y = 0; y < size; y++)
+    {
+        for (int x = 0; x < size; x++)
+        {
+            unsigned int h = (unsigned int)(x*73856093) ^ (unsigned int)(y*19349663);
+            h = (h ^ (h >> 13))*0x5bd1e995u;
+            int smooth = (((x >> 4) ^ (y >> 4)) & 1)*96;
+            pixels[y*size + x] = (Color){ (unsigned char)(smooth + (h & 127)), (unsigned char)((h >> 8) & 255), (unsigned char)(x*255/size), (unsigned char)(192 + ((h >> 16) & 63)) };
+        }
+    }
+
+    int threadCount = GetJobsThreadCount();
+    const char *names[4] = { "ImageMipmaps()", "box, 1 thread", "box", "Kaiser" };
+    double times[4] = { 0 };
+    Image results[4] = { 0 };
+
+    for (int test = 0; test < 4; test++)
+    {
+        if (test == 1) InitJobs(1);
+        if (test == 2) InitJobs(threadCount);
+
+        for (int run = 0; run < runs; run++)
+        {
+            Image image = ImageCopy(base);
+
+            double start = GetMipmapTime();
+            if (test == 0) ImageMipmaps(&image);
+            else ImageMipmapsParallel(&image, (test == 3)? MIPMAP_FILTER_KAISER : MIPMAP_FILTER_BOX);
+            times[test] += GetMipmapTime() - start;
+
+            if (run == 0) results[test] = image;
+            else UnloadImage(image);
+        }
+    }
+
+    // SIMD and scalar kernels must agree, check on the first level
+    int levelSize = GetPixelDataSize(size/2, size/2, base.format);
+    unsigned char *reference = (unsigned char *)malloc(levelSize);
+    int mismatches = 0;
+    for (int filter = MIPMAP_FILTER_BOX; filter <= MIPMAP_FILTER_KAISER; filter++)
+    {
+        GenMipmapLevel(base.data, size, size, reference, base.format, filter, false);
+        const unsigned char *level = (const unsigned char *)results[(filter == MIPMAP_FILTER_BOX)? 2 : 3].data + GetPixelDataSize(size, size, base.format);
+        for (int i = 0; i < levelSize; i++) mismatches += (reference[i] != level[i]);
+    }
+
+    TraceLog(LOG_INFO, "BENCH: [%ix%i RGBA8] %i levels, %i threads, SIMD vs scalar mismatches: %i", size, size, results[2].mipmaps, threadCount, mismatches);
+    for (int test = 0; test < 4; test++)
+    {
+        // Mean difference to ImageMipmaps() over the first level
+        double error = 0.0;
+        const unsigned char *a = (const unsigned char *)results[0].data + GetPixelDataSize(size, size, base.format);
+        const unsigned char *b = (const unsigned char *)results[test].data + GetPixelDataSize(size, size, base.format);
+        for (int i = 0; i < levelSize; i++) error += abs((int)a[i] - (int)b[i]);
+
+        TraceLog(LOG_INFO, "BENCH: [%ix%i RGBA8] %-16s %9.2f ms (%5.1fx), mean diff to ImageMipmaps() %.2f", size, size, names[test],
+                 times[test]*1000.0/runs, times[0]/times[test], error/levelSize);
+    }
+
+    free(reference);
+    for (int test = 0; test < 4; test++) UnloadImage(results[test]);
+    UnloadImage(base);
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Monotonic time in seconds, works without a window
+static double GetMipmapTime(void)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Channels and component type of supported formats
+static bool GetMipmapFormatLayout(int format, int *channels, bool *isFloat)
+{
+    switch (format)
+    {
+        case PIXELFORMAT_UNCOMPRESSED_GRAYSCALE: *channels = 1; *isFloat = false; break;
+        case PIXELFORMAT_UNCOMPRESSED_R8G8B8: *channels = 3; *isFloat = false; break;
+        case PIXELFORMAT_UNCOMPRESSED_R8G8B8A8: *channels = 4; *isFloat = false; break;
+        case PIXELFORMAT_UNCOMPRESSED_R32: *channels = 1; *isFloat = true; break;
+        case PIXELFORMAT_UNCOMPRESSED_R32G32B32: *channels = 3; *isFloat = true; break;
+        case PIXELFORMAT_UNCOMPRESSED_R32G32B32A32: *channels = 4; *isFloat = true; break;
+        default: return false;
+    }
+
+    return true;
+}
+
+// Kaiser windowed sinc for 2x decimation, taps at source offsets -3..4 around 2*x
+static void InitKaiserWeights(void)
+{
+    if (mipmapKaiserReady) return;
+
+    // Bessel I0 by its series, converges in a few terms for alpha 4
+    #define MIPMAP_BESSEL_I0(x, result) { double sum = 1.0, term = 1.0; for (int k = 1; k < 20; k++) { term *= ((x)/(2.0*k))*((x)/(2.0*k)); sum += term; } result = sum; }
+
+    double weights[MIPMAP_KAISER_TAPS];
+    double total = 0.0;
+    double i0Alpha = 0.0;
+    MIPMAP_BESSEL_I0(MIPMAP_KAISER_ALPHA, i0Alpha);
+
+    for (int i = 0; i < MIPMAP_KAISER_TAPS; i++)
+    {
+        // Distance to the destination pixel center, in destination pixels
+        double x = ((i - 3) - 0.5)*0.5;
+        double sinc = (x == 0.0)? 1.0 : sin(PI*x)/(PI*x);
+        double r = x/2.0;           // Window covers 2 destination pixels each side
+        double window = 0.0;
+        if (fabs(r) < 1.0) MIPMAP_BESSEL_I0(MIPMAP_KAISER_ALPHA*sqrt(1.0 - r*r), window);
+
+        weights[i] = sinc*window/i0Alpha;
+        total += weights[i];
+    }
+
+    for (int i = 0; i < MIPMAP_KAISER_TAPS; i++) mipmapKaiserWeights[i] = (float)(weights[i]/total);
+
+    #undef MIPMAP_BESSEL_I0
+    mipmapKaiserReady = true;
+}
+
+// Downsample one level, rows split across the job pool
+static void GenMipmapLevel(const void *src, int srcWidth, int srcHeight, void *dst, int format, int filter, bool simd)
+{
+    MipmapLevelJob job = { 0 };
+
+    job.src = (const unsigned char *)src;
+    job.dst = (unsigned char *)dst;
+    job.srcWidth = srcWidth;
+    job.srcHeight = srcHeight;
+    job.dstWidth = (srcWidth > 1)? srcWidth/2 : 1;
+    job.dstHeight = (srcHeight > 1)? srcHeight/2 : 1;
+    job.simd = simd;
+    GetMipmapFormatLayout(format, &job.channels, &job.isFloat);
+
+    int grain = MIPMAP_JOB_PIXELS/job.dstWidth;
+    if (grain < 1) grain = 1;
+
+    if (filter == MIPMAP_FILTER_KAISER)
+    {
+        InitKaiserWeights();
+        RunJobsParallel(job.dstHeight, grain, KaiserRowsJob, &job);
+    }
+    else RunJobsParallel(job.dstHeight, grain, BoxRowsJob, &job);
+}
+
+// Box filter destination rows [begin, end)
+static void BoxRowsJob(int begin, int end, void *userData)
+{
+    const MipmapLevelJob *job = (const MipmapLevelJob *)userData;
+    int channels = job->channels;
+    int pixelSize = channels*(job->isFloat? 4 : 1);
+
+    for (int y = begin; y < end; y++)
+    {
+        // Odd or 1 pixel sizes clamp to the last row/column, like sampling with clamp to edge
+        int y0 = 2*y;
+        int y1 = (2*y + 1 < job->srcHeight)? 2*y + 1 : job->srcHeight - 1;
+        const unsigned char *row0 = job->src + (size_t)y0*job->srcWidth*pixelSize;
+        const unsigned char *row1 = job->src + (size_t)y1*job->srcWidth*pixelSize;
+        unsigned char *out = job->dst + (size_t)y*job->dstWidth*pixelSize;
+        int x = 0;
+
+#if defined(RMIPMAPS_SSE2)
+        if (job->simd)
+        {
+            if (!job->isFloat && (channels == 4))
+            {
+                __m128i zero = _mm_setzero_si128();
+                __m128i two = _mm_set1_epi16(2);
+
+                for (; 2*x + 8 <= job->srcWidth; x += 4)
+                {
+                    __m128i out01, out23;
+                    for (int half = 0; half < 2; half++)
+                    {
+                        __m128i a = _mm_loadu_si128((const __m128i *)(row0 + 4*(2*x + 4*half)));
+                        __m128i b = _mm_loadu_si128((const __m128i *)(row1 + 4*(2*x + 4*half)));
+
+                        // 16 bit sums of the two rows, pixels 0,1 low and 2,3 high
+                        __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+                        __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+                        lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+                        hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+
+                        __m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), two), 2);
+                        if (half == 0) out01 = sum;
+                        else out23 = sum;
+                    }
+                    _mm_storeu_si128((__m128i *)(out + 4*x), _mm_packus_epi16(out01, out23));
+                }
+            }
+            else if (!job->isFloat && (channels == 1))
+            {
+                __m128i mask = _mm_set1_epi16(0x00ff);
+                __m128i two = _mm_set1_epi16(2);
+
+                for (; 2*x + 16 <= job->srcWidth; x += 8)
+                {
+                    __m128i a = _mm_loadu_si128((const __m128i *)(row0 + 2*x));
+                    __m128i b = _mm_loadu_si128((const __m128i *)(row1 + 2*x));
+                    __m128i sa = _mm_add_epi16(_mm_and_si128(a, mask), _mm_srli_epi16(a, 8));
+                    __m128i sb = _mm_add_epi16(_mm_and_si128(b, mask), _mm_srli_epi16(b, 8));
+                    __m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(sa, sb), two), 2);
+                    _mm_storel_epi64((__m128i *)(out + x), _mm_packus_epi16(sum, sum));
+                }
+            }
+            else if (job->isFloat && (channels == 4))
+            {
+                const float *r0 = (const float *)row0;
+                const float *r1 = (const float *)row1;
+                __m128 quarter = _mm_set1_ps(0.25f);
+
+                for (; 2*x + 2 <= job->srcWidth; x++)
+                {
+                    __m128 top = _mm_add_ps(_mm_loadu_ps(r0 + 8*x), _mm_loadu_ps(r0 + 8*x + 4));
+                    __m128 bottom = _mm_add_ps(_mm_loadu_ps(r1 + 8*x), _mm_loadu_ps(r1 + 8*x + 4));
+                    _mm_storeu_ps((float *)out + 4*x, _mm_mul_ps(_mm_add_ps(top, bottom), quarter));
+                }
+            }
+            else if (job->isFloat && (channels == 1))
+            {
+                const float *r0 = (const float *)row0;
+                const float *r1 = (const float *)row1;
+                __m128 quarter = _mm_set1_ps(0.25f);
+
+                for (; 2*x + 8 <= job->srcWidth; x += 4)
+                {
+                    __m128 a0 = _mm_loadu_ps(r0 + 2*x), a1 = _mm_loadu_ps(r0 + 2*x + 4);
+                    __m128 b0 = _mm_loadu_ps(r1 + 2*x), b1 = _mm_loadu_ps(r1 + 2*x + 4);
+                    __m128 top = _mm_add_ps(_mm_shuffle_ps(a0, a1, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(3, 1, 3, 1)));
+                    __m128 bottom = _mm_add_ps(_mm_shuffle_ps(b0, b1, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(b0, b1, _MM_SHUFFLE(3, 1, 3, 1)));
+                    _mm_storeu_ps((float *)out + x, _mm_mul_ps(_mm_add_ps(top, bottom), quarter));
+                }
+            }
+        }
+#endif
+        // Scalar kernels: reference, tails and 3 channel formats
+        for (; x < job->dstWidth; x++)
+        {
+            int x0 = 2*x;
+            int x1 = (2*x + 1 < job->srcWidth)? 2*x + 1 : job->srcWidth - 1;
+
+            if (job->isFloat)
+            {
+                const float *r0 = (const float *)row0;
+                const float *r1 = (const float *)row1;
+                float *o = (float *)out;
+
+                for (int c = 0; c < channels; c++)
+                {
+                    float top = r0[x0*channels + c] + r0[x1*channels + c];
+                    float bottom = r1[x0*channels + c] + r1[x1*channels + c];
+                    o[x*channels + c] = (top + bottom)*0.25f;
+                }
+            }
+            else
+            {
+                for (int c = 0; c < channels; c++)
+                {
+                    int sum = row0[x0*channels + c] + row0[x1*channels + c] + row1[x0*channels + c] + row1[x1*channels + c];
+                    out[x*channels + c] = (unsigned char)((sum + 2) >> 2);
+                }
+            }
+        }
+    }
+}
+
+// Kaiser horizontal pass of source row sy (clamped) into dstWidth float pixels
+// NOTE: line holds the row as floats with 3 edge pixels replicated left and 4 right, so every
+// destination pixel reads its 8 taps unclamped and each source pixel is converted only once
+static void KaiserHorizontal(const MipmapLevelJob *job, int sy, float *line, float *out)
+{
+    const float *w = mipmapKaiserWeights;
+    int channels = job->channels;
+    int srcWidth = job->srcWidth;
+
+    sy = (sy < 0)? 0 : ((sy >= job->srcHeight)? job->srcHeight - 1 : sy);
+    float *pixels = line + 3*channels;
+
+    if (job->isFloat) memcpy(pixels, (const float *)job->src + (size_t)sy*srcWidth*channels, (size_t)srcWidth*channels*sizeof(float));
+    else
+    {
+        const unsigned char *row = job->src + (size_t)sy*srcWidth*channels;
+        int i = 0;
+#if defined(RMIPMAPS_SSE2)
+        __m128i zero = _mm_setzero_si128();
+        for (; i + 16 <= srcWidth*channels; i += 16)
+        {
+            __m128i bytes = _mm_loadu_si128((const __m128i *)(row + i));
+            __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+            __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+            _mm_storeu_ps(pixels + i, _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)));
+            _mm_storeu_ps(pixels + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)));
+            _mm_storeu_ps(pixels + i + 8, _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)));
+            _mm_storeu_ps(pixels + i + 12, _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)));
+        }
+#endif
+        for (; i < srcWidth*channels; i++) pixels[i] = (float)row[i];
+    }
+
+    for (int c = 0; c < channels; c++)
+    {
+        for (int i = 1; i <= 3; i++) pixels[-i*channels + c] = pixels[c];
+        for (int i = 0; i < 4; i++) pixels[(srcWidth + i)*channels + c] = pixels[(srcWidth - 1)*channels + c];
+    }
+
+#if defined(RMIPMAPS_SSE2)
+    if (job->simd && (channels == 4))
+    {
+        __m128 weights[MIPMAP_KAISER_TAPS];
+        for (int i = 0; i < MIPMAP_KAISER_TAPS; i++) weights[i] = _mm_set1_ps(w[i]);
+
+        for (int x = 0; x < job->dstWidth; x++)
+        {
+            // Taps 2x-3..2x+4 start at line pixel 2x
+            const float *taps = line + 8*x;
+            __m128 p[MIPMAP_KAISER_TAPS];
+            for (int i = 0; i < MIPMAP_KAISER_TAPS; i++) p[i] = _mm_mul_ps(weights[i], _mm_loadu_ps(taps + 4*i));
+            _mm_storeu_ps(out + 4*x, MIPMAP_KAISER_SUM(_mm_add_ps, p));
+        }
+        return;
+    }
+#endif
+    for (int x = 0; x < job->dstWidth; x++)
+    {
+        const float *taps = line + 2*x*channels;
+
+        for (int c = 0; c < channels; c++)
+        {
+            float p[MIPMAP_KAISER_TAPS];
+            for (int i = 0; i < MIPMAP_KAISER_TAPS; i++) p[i] = w[i]*taps[i*channels + c];
+            out[x*channels + c] = MIPMAP_KAISER_SUM(MIPMAP_ADD, p);
+        }
+    }
+}
+
+// Kaiser filter destination rows [begin, end)
+// NOTE: Horizontally filtered source rows live in a ring of 8, each destination row adds 2
+static void KaiserRowsJob(int begin, int end, void *userData)
+{
+    const MipmapLevelJob *job = (const MipmapLevelJob *)userData;
+    const float *w = mipmapKaiserWeights;
+    int channels = job->channels;
+    int stride = job->dstWidth*channels;
+
+    float *ring = (float *)malloc(((size_t)MIPMAP_KAISER_TAPS*stride + (size_t)(job->srcWidth + 7)*channels)*sizeof(float));
+    if (ring == NULL) return;
+    float *line = ring + (size_t)MIPMAP_KAISER_TAPS*stride;
+
+    // Ring slot of unclamped source row sy (sy >= -3)
+    #define MIPMAP_RING_ROW(sy) (ring + (size_t)(((sy) + MIPMAP_KAISER_TAPS) % MIPMAP_KAISER_TAPS)*stride)
+
+    for (int sy = 2*begin - 3; sy < 2*begin + 3; sy++) KaiserHorizontal(job, sy, line, MIPMAP_RING_ROW(sy));
+
+    for (int y = begin; y < end; y++)
+    {
+        KaiserHorizontal(job, 2*y + 3, line, MIPMAP_RING_ROW(2*y + 3));
+        KaiserHorizontal(job, 2*y + 4, line, MIPMAP_RING_ROW(2*y + 4));
+
+        const float *rows[MIPMAP_KAISER_TAPS];
+        for (int i = 0; i < MIPMAP_KAISER_TAPS; i++) rows[i] = MIPMAP_RING_ROW(2*y + i - 3);
+
+        int x = 0;
+        unsigned char *out = job->dst + (size_t)y*stride*(job->isFloat? 4 : 1);
+
+#if defined(RMIPMAPS_SSE2)
+        if (job->simd && (channels == 4))
+        {
+            __m128 weights[MIPMAP_KAISER_TAPS];
+            for (int i = 0; i < MIPMAP_KAISER_TAPS; i++) weights[i] = _mm_set1_ps(w[i]);
+            __m128 half = _mm_set1_ps(0.5f);
+            __m128 zero = _mm_setzero_ps();
+            __m128 max = _mm_set1_ps(255.0f);
+
+            for (; x < job->dstWidth; x++)
+            {
+                __m128 p[MIPMAP_KAISER_TAPS];
+                for (int i = 0; i < MIPMAP_KAISER_TAPS; i++) p[i] = _mm_mul_ps(weights[i], _mm_loadu_ps(rows[i] + 4*x));
+                __m128 sum = MIPMAP_KAISER_SUM(_mm_add_ps, p);
+
+                if (job->isFloat) _mm_storeu_ps((float *)out + 4*x, sum);
+                else
+                {
+                    // Same rounding as the scalar path: +0.5, clamp, truncate
+                    __m128i value = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_add_ps(sum, half), zero), max));
+                    value = _mm_packs_epi32(value, value);
+                    *(int *)(out + 4*x) = _mm_cvtsi128_si32(_mm_packus_epi16(value, value));
+                }
+            }
+        }
+#endif
+        for (; x < job->dstWidth; x++)
+        {
+            for (int c = 0; c < channels; c++)
+            {
+                float p[MIPMAP_KAISER_TAPS];
+                for (int i = 0; i < MIPMAP_KAISER_TAPS; i++) p[i] = w[i]*rows[i][x*channels + c];
+                float sum = MIPMAP_KAISER_SUM(MIPMAP_ADD, p);
+
+                if (job->isFloat) ((float *)out)[x*channels + c] = sum;
+                else
+                {
+                    float value = sum + 0.5f;
+                    value = (value < 0.0f)? 0.0f : ((value > 255.0f)? 255.0f : value);
+                    out[x*channels + c] = (unsigned char)value;
+                }
+            }
+        }
+    }
+
+    #undef MIPMAP_RING_ROW
+    free(ring);
+}
+
+#endif // RMIPMAPS_IMPLEMENTATION
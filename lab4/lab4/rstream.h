@@ -0,0 +1,1329 @@
+/**********************************************************************************************
+*
+*   raylib.stream - Streaming vertex batch, multi-buffered with persistent mapping
+*
+*   DESCRIPTION:
+*       Immediate mode batch like the rlgl one (StreamBegin()/StreamVertex3f()/StreamEnd()),
+*       streamed to the GPU differently:
+*         - One interleaved vertex per write (position, texcoord, color, layer: 28 bytes),
+*           one upload per flush instead of one per attribute
+*         - The buffer is split in a ring of regions, a flush draws one region and the next
+*           vertices go to the next region while the GPU still reads the previous ones
+*         - With OpenGL 4.4 (or ARB_buffer_storage) the buffer is persistently mapped and
+*           vertices are written straight into it, a fence per region tells when the GPU
+*           is done with it; otherwise vertices are staged on the CPU and uploaded with
+*           glBufferSubData(), orphaning the buffer every time the ring wraps
+*
+*       Vertices go through the rlgl transform (rlPushMatrix()/rlTranslatef()...) like rlgl
+*       immediate mode, captured at StreamBegin(). DrawStreamBatch() flushes the rlgl batch
+*       first so drawing order is kept, call it before EndMode3D()/EndDrawing().
+*
+*       rlgl keeps position, texcoord and color in separate arrays, so every rlVertex3f()
+*       writes three distant places; here a vertex is a single 28 byte store. lab4 switches
+*       DrawTextureSide() between both layouts at runtime (SetTextureSideBatch(), [L] key).
+*
+*       Textures added to a TextureArray (one GL_TEXTURE_2D_ARRAY, all layers resized to the
+*       same size) and attached with StreamSetTextureArray() don't start new draws: the layer
+*       goes in the vertex and StreamSetTexture() only changes it, so quads with different
+*       textures merge in one draw. Layered draws use their own shader, the one set with
+*       StreamSetShader() applies to the rest. Wrapping works per layer (unlike an atlas).
+*       OpenGL reuses texture ids: RemoveTextureArrayTexture() must go before UnloadTexture(),
+*       or a new texture with the same id would draw the old layer.
+*
+*   CONFIGURATION:
+*
+*   #define RSTREAM_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+*   NOTE: Requires OpenGL 3.3 (glDrawElementsBaseVertex, texture arrays), persistent mapping needs 4.4.
+*   Texture array layers are converted with rimage.h, its implementation must be in the same or another translation unit
+*
+**********************************************************************************************/
+
+#ifndef RSTREAM_H
+#define RSTREAM_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define STREAM_DEFAULT_VERTICES     (4*8192)    // Vertices per ring region, same as the rlgl batch
+#define STREAM_DEFAULT_BUFFERS      3           // Ring regions, frames the GPU can lag behind
+#define STREAM_MAX_DRAWS            256         // Draw calls per region before a flush
+#define STREAM_LAYER_ATTRIB_LOCATION    5       // Layer attribute, free slot of rlgl (vertexTexCoord2)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Interleaved vertex, 28 bytes
+typedef struct {
+    float x, y, z;
+    float u, v;
+    unsigned char r, g, b, a;
+    unsigned short layer;       // Texture array layer, only read by layered draws
+    unsigned short reserved;
+} StreamVertex;
+
+// Texture array, textures drawn from it share one draw
+typedef struct {
+    unsigned int id;            // OpenGL GL_TEXTURE_2D_ARRAY id
+    int width;                  // Layer size, images are resized to it
+    int height;
+    int layerCount;
+    int layerCapacity;
+    int *textureLayers;         // Layer + 1 by source texture id, 0 if not in the array
+    int textureLayersSize;
+    bool mipmapsDirty;          // Layers changed, mipmaps generated at next draw
+    Shader shader;              // Layered draw shader
+} TextureArray;
+
+// Vertices sharing mode and texture
+typedef struct {
+    int mode;                   // RL_LINES, RL_TRIANGLES or RL_QUADS
+    unsigned int textureId;
+    int vertexOffset;           // First vertex in the region
+    int vertexCount;
+} StreamDraw;
+
+// Streaming statistics, since load or ResetStreamBatchStats()
+typedef struct {
+    long long bytesStreamed;    // Vertex bytes written for the GPU
+    int flushes;                // Regions drawn
+    int drawCalls;
+    int fenceWaits;             // Regions still in use by the GPU when reused
+    double fenceWaitTime;       // Seconds blocked on fences
+    int orphans;                // Buffer orphaned on ring wrap (no persistent mapping)
+} StreamStats;
+
+// Streaming batch
+typedef struct {
+    unsigned int vaoId;
+    unsigned int vboId;
+    unsigned int eboId;         // Quad indices, shared by all regions
+    int vertexCapacity;         // Vertices per region
+    int bufferCount;            // Ring regions
+    int currentBuffer;
+    bool persistent;            // Buffer storage persistently mapped
+
+    StreamVertex *mapped;       // Whole persistent mapping, NULL otherwise
+    StreamVertex *staging;      // CPU copy of one region, NULL when persistent
+    StreamVertex *vertices;     // Region being written
+    int vertexCount;
+    void **fences;              // GLsync per region, NULL when free
+
+    StreamDraw draws[STREAM_MAX_DRAWS];
+    int drawCount;
+
+    StreamVertex current;       // Texcoord and color for the next vertices
+    Matrix transform;           // rlgl transform captured by StreamBegin()
+    bool transformRequired;
+    Shader shader;              // Shader for the pending draws, id 0 is the default shader
+    TextureArray *array;        // Textures merged by layer, NULL if none
+
+    StreamStats stats;
+} StreamBatch;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+StreamBatch LoadStreamBatch(int vertexCount, int bufferCount);                          // Load streaming batch, persistent mapping when supported
+StreamBatch LoadStreamBatchEx(int vertexCount, int bufferCount, bool persistent);       // Load streaming batch, persistent false forces orphaning
+void UnloadStreamBatch(StreamBatch *batch);                                             // Unload streaming batch
+void DrawStreamBatch(StreamBatch *batch);                                               // Draw pending vertices and move to next ring region
+void ResetStreamBatchStats(StreamBatch *batch);                                         // Reset streaming statistics
+void BenchmarkStreamBatch(int quadCount, int frames);                                   // Benchmark rlgl batch vs streaming batch (persistent and orphaning)
+void BenchmarkStreamLayout(int quadCount);                                              // Benchmark vertex writes, rlgl separate arrays vs interleaved
+
+void StreamBegin(StreamBatch *batch, int mode);                                         // Begin primitives (RL_LINES, RL_TRIANGLES, RL_QUADS)
+void StreamEnd(StreamBatch *batch);                                                     // End primitives
+void StreamSetTexture(StreamBatch *batch, unsigned int id);                             // Set texture for next vertices, 0 is the default white texture
+void StreamVertex3f(StreamBatch *batch, float x, float y, float z);                     // Add vertex with current texcoord and color
+void StreamTexCoord2f(StreamBatch *batch, float u, float v);                            // Set texcoord for next vertices
+void StreamColor4ub(StreamBatch *batch, unsigned char r, unsigned char g, unsigned char b, unsigned char a);   // Set color for next vertices
+void StreamSetShader(StreamBatch *batch, Shader shader);                                // Set shader for next vertices, draws pending ones if it changes
+void StreamPushVertices(StreamBatch *batch, const StreamVertex *vertices, int count);   // Add whole primitives already transformed (current mode and texture)
+void StreamSetTextureArray(StreamBatch *batch, TextureArray *array);                    // Set texture array for next vertices, NULL draws every texture on its own
+
+TextureArray LoadTextureArray(int width, int height, int layerCapacity);                // Load empty texture array (RGBA8, repeat wrap, mipmapped)
+void UnloadTextureArray(TextureArray *array);                                           // Unload texture array
+int AddTextureArrayImage(TextureArray *array, Image image);                             // Add image as a new layer, returns layer or -1
+int AddTextureArrayTexture(TextureArray *array, Texture2D texture);                     // Add texture contents as a new layer, StreamSetTexture() maps its id to it
+int GetTextureArrayLayer(const TextureArray *array, unsigned int textureId);            // Get layer of a texture id, -1 if not in the array
+bool UpdateTextureArrayImage(TextureArray *array, int layer, Image image);              // Replace layer contents, texture ids mapped to the layer are forgotten
+void RemoveTextureArrayTexture(TextureArray *array, unsigned int textureId);            // Forget texture id mapping, call before UnloadTexture() (ids get reused)
+void BenchmarkTextureArray(int spriteCount, int textureCount, int frames);              // Benchmark sprites from many textures, per texture draws vs texture array
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RSTREAM_H
+
+
+/***********************************************************************************
+*
+*   RSTREAM IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RSTREAM_IMPLEMENTATION) && !defined(RSTREAM_IMPLEMENTATION_DEFINED)
+#define RSTREAM_IMPLEMENTATION_DEFINED      // Other modules include this header too
+
+#include "raymath.h"
+#include "rlgl.h"
+#include "rimage.h"             // Required for: ImageFormatParallel(), ImageResizeParallel()
+
+#include <stddef.h>             // Required for: ptrdiff_t, offsetof()
+#include <stdlib.h>             // Required for: malloc(), calloc(), realloc(), free()
+#include <string.h>             // Required for: memcpy(), memcmp(), memset(), strcmp()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#if defined(_WIN32) && !defined(_WIN64)
+    #define RSTREAM_APIENTRY __stdcall
+#else
+    #define RSTREAM_APIENTRY
+#endif
+
+#define RSTREAM_GL_ARRAY_BUFFER             0x8892
+#define RSTREAM_GL_STREAM_DRAW              0x88E0
+#define RSTREAM_GL_MAP_WRITE_BIT            0x0002
+#define RSTREAM_GL_MAP_PERSISTENT_BIT       0x0040
+#define RSTREAM_GL_MAP_COHERENT_BIT         0x0080
+#define RSTREAM_GL_SYNC_GPU_COMMANDS_COMPLETE   0x9117
+#define RSTREAM_GL_SYNC_FLUSH_COMMANDS_BIT  0x0001
+#define RSTREAM_GL_TIMEOUT_EXPIRED          0x911B
+#define RSTREAM_GL_WAIT_FAILED              0x911D
+#define RSTREAM_GL_MAJOR_VERSION            0x821B
+#define RSTREAM_GL_MINOR_VERSION            0x821C
+#define RSTREAM_GL_NUM_EXTENSIONS           0x821D
+#define RSTREAM_GL_EXTENSIONS               0x1F03
+#define RSTREAM_GL_UNSIGNED_INT             0x1405
+#define RSTREAM_GL_UNSIGNED_SHORT           0x1403
+#define RSTREAM_GL_UNSIGNED_BYTE            0x1401
+#define RSTREAM_GL_TEXTURE_2D_ARRAY         0x8C1A
+#define RSTREAM_GL_RGBA                     0x1908
+#define RSTREAM_GL_RGBA8                    0x8058
+#define RSTREAM_GL_TEXTURE_MAG_FILTER       0x2800
+#define RSTREAM_GL_TEXTURE_MIN_FILTER       0x2801
+#define RSTREAM_GL_TEXTURE_WRAP_S           0x2802
+#define RSTREAM_GL_TEXTURE_WRAP_T           0x2803
+#define RSTREAM_GL_LINEAR                   0x2601
+#define RSTREAM_GL_LINEAR_MIPMAP_LINEAR     0x2703
+#define RSTREAM_GL_REPEAT                   0x2901
+
+#define RSTREAM_FENCE_TIMEOUT               1000000ull      // Nanoseconds per wait, retried until signaled
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef void (*RstreamGLProc)(void);
+
+typedef void (RSTREAM_APIENTRY *RstreamGenBuffersProc)(int n, unsigned int *buffers);
+typedef void (RSTREAM_APIENTRY *RstreamDeleteBuffersProc)(int n, const unsigned int *buffers);
+typedef void (RSTREAM_APIENTRY *RstreamBindBufferProc)(unsigned int target, unsigned int buffer);
+typedef void (RSTREAM_APIENTRY *RstreamBufferDataProc)(unsigned int target, ptrdiff_t size, const void *data, unsigned int usage);
+typedef void (RSTREAM_APIENTRY *RstreamBufferSubDataProc)(unsigned int target, ptrdiff_t offset, ptrdiff_t size, const void *data);
+typedef void (RSTREAM_APIENTRY *RstreamBufferStorageProc)(unsigned int target, ptrdiff_t size, const void *data, unsigned int flags);
+typedef void *(RSTREAM_APIENTRY *RstreamMapBufferRangeProc)(unsigned int target, ptrdiff_t offset, ptrdiff_t length, unsigned int access);
+typedef unsigned char (RSTREAM_APIENTRY *RstreamUnmapBufferProc)(unsigned int target);
+typedef void *(RSTREAM_APIENTRY *RstreamFenceSyncProc)(unsigned int condition, unsigned int flags);
+typedef unsigned int (RSTREAM_APIENTRY *RstreamClientWaitSyncProc)(void *sync, unsigned int flags, unsigned long long timeout);
+typedef void (RSTREAM_APIENTRY *RstreamDeleteSyncProc)(void *sync);
+typedef void (RSTREAM_APIENTRY *RstreamGetIntegervProc)(unsigned int pname, int *data);
+typedef const unsigned char *(RSTREAM_APIENTRY *RstreamGetStringiProc)(unsigned int name, unsigned int index);
+typedef void (RSTREAM_APIENTRY *RstreamDrawArraysProc)(unsigned int mode, int first, int count);
+typedef void (RSTREAM_APIENTRY *RstreamDrawElementsBaseVertexProc)(unsigned int mode, int count, unsigned int type, const void *indices, int basevertex);
+typedef void (RSTREAM_APIENTRY *RstreamGenTexturesProc)(int n, unsigned int *textures);
+typedef void (RSTREAM_APIENTRY *RstreamDeleteTexturesProc)(int n, const unsigned int *textures);
+typedef void (RSTREAM_APIENTRY *RstreamBindTextureProc)(unsigned int target, unsigned int texture);
+typedef void (RSTREAM_APIENTRY *RstreamTexParameteriProc)(unsigned int target, unsigned int pname, int param);
+typedef void (RSTREAM_APIENTRY *RstreamTexImage3DProc)(unsigned int target, int level, int internalformat, int width, int height, int depth, int border, unsigned int format, unsigned int type, const void *pixels);
+typedef void (RSTREAM_APIENTRY *RstreamTexSubImage3DProc)(unsigned int target, int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, unsigned int format, unsigned int type, const void *pixels);
+typedef void (RSTREAM_APIENTRY *RstreamGenerateMipmapProc)(unsigned int target);
+
+#ifdef __cplusplus
+extern "C" RstreamGLProc glfwGetProcAddress(const char *procname);     // Provided by GLFW inside raylib
+#else
+RstreamGLProc glfwGetProcAddress(const char *procname);
+#endif
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static RstreamGenBuffersProc streamGenBuffers = NULL;
+static RstreamDeleteBuffersProc streamDeleteBuffers = NULL;
+static RstreamBindBufferProc streamBindBuffer = NULL;
+static RstreamBufferDataProc streamBufferData = NULL;
+static RstreamBufferSubDataProc streamBufferSubData = NULL;
+static RstreamBufferStorageProc streamBufferStorage = NULL;
+static RstreamMapBufferRangeProc streamMapBufferRange = NULL;
+static RstreamUnmapBufferProc streamUnmapBuffer = NULL;
+static RstreamFenceSyncProc streamFenceSync = NULL;
+static RstreamClientWaitSyncProc streamClientWaitSync = NULL;
+static RstreamDeleteSyncProc streamDeleteSync = NULL;
+static RstreamGetIntegervProc streamGetIntegerv = NULL;
+static RstreamGetStringiProc streamGetStringi = NULL;
+static RstreamDrawArraysProc streamDrawArrays = NULL;
+static RstreamDrawElementsBaseVertexProc streamDrawElementsBaseVertex = NULL;
+static RstreamGenTexturesProc streamGenTextures = NULL;
+static RstreamDeleteTexturesProc streamDeleteTextures = NULL;
+static RstreamBindTextureProc streamBindTexture = NULL;
+static RstreamTexParameteriProc streamTexParameteri = NULL;
+static RstreamTexImage3DProc streamTexImage3D = NULL;
+static RstreamTexSubImage3DProc streamTexSubImage3D = NULL;
+static RstreamGenerateMipmapProc streamGenerateMipmap = NULL;
+static int streamState = 0;             // 0: not loaded, 1: ready, -1: not supported
+static bool streamPersistentSupported = false;
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static bool LoadStreamFunctions(void);
+static void WaitStreamRegion(StreamBatch *batch, int region);
+static void AddStreamDraw(StreamBatch *batch, int mode, unsigned int textureId);
+static int GetStreamPrimitiveSize(int mode);
+static void EnableStreamShader(Shader shader);
+static void UploadTextureArrayLayer(TextureArray *array, int layer, Image image);
+static void PushSeparateVertex(float x, float y, float z);
+static void PushInterleavedVertex(float x, float y, float z);
+static double PushBenchQuads(int quadCount, Matrix transform, bool interleaved);
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Load streaming batch, persistent mapping when supported
+StreamBatch LoadStreamBatch(int vertexCount, int bufferCount)
+{
+    return LoadStreamBatchEx(vertexCount, bufferCount, true);
+}
+
+// Load streaming batch, persistent false forces orphaning
+StreamBatch LoadStreamBatchEx(int vertexCount, int bufferCount, bool persistent)
+{
+    StreamBatch batch = { 0 };
+
+    if (!LoadStreamFunctions()) return batch;
+
+    vertexCount -= vertexCount%4;       // Whole quads per region
+    if (bufferCount < 1) bufferCount = 1;
+
+    batch.vertexCapacity = vertexCount;
+    batch.bufferCount = bufferCount;
+    batch.persistent = persistent && streamPersistentSupported;
+    batch.fences = (void **)calloc(bufferCount, sizeof(void *));
+    batch.current.u = 0.0f;
+    batch.current.v = 0.0f;
+    batch.current.r = batch.current.g = batch.current.b = batch.current.a = 255;
+    batch.transform = MatrixIdentity();
+
+    ptrdiff_t size = (ptrdiff_t)vertexCount*bufferCount*sizeof(StreamVertex);
+
+    batch.vaoId = rlLoadVertexArray();
+    rlEnableVertexArray(batch.vaoId);
+
+    streamGenBuffers(1, &batch.vboId);
+    streamBindBuffer(RSTREAM_GL_ARRAY_BUFFER, batch.vboId);
+
+    if (batch.persistent)
+    {
+        unsigned int flags = RSTREAM_GL_MAP_WRITE_BIT | RSTREAM_GL_MAP_PERSISTENT_BIT | RSTREAM_GL_MAP_COHERENT_BIT;
+        streamBufferStorage(RSTREAM_GL_ARRAY_BUFFER, size, NULL, flags);
+        batch.mapped = (StreamVertex *)streamMapBufferRange(RSTREAM_GL_ARRAY_BUFFER, 0, size, flags);
+
+        if (batch.mapped == NULL)
+        {
+            // Immutable storage can't be orphaned, start over with a mutable buffer
+            TraceLog(LOG_WARNING, "STREAM: Failed to map buffer persistently, falling back to orphaning");
+            streamDeleteBuffers(1, &batch.vboId);
+            streamGenBuffers(1, &batch.vboId);
+            streamBindBuffer(RSTREAM_GL_ARRAY_BUFFER, batch.vboId);
+            batch.persistent = false;
+        }
+    }
+
+    if (!batch.persistent)
+    {
+        streamBufferData(RSTREAM_GL_ARRAY_BUFFER, size, NULL, RSTREAM_GL_STREAM_DRAW);
+        batch.staging = (StreamVertex *)malloc(vertexCount*sizeof(StreamVertex));
+    }
+
+    // Attributes at the default shader locations, region offset goes in the draw calls
+    int *locs = rlGetShaderLocsDefault();
+    rlSetVertexAttribute(locs[SHADER_LOC_VERTEX_POSITION], 3, RL_FLOAT, false, sizeof(StreamVertex), (void *)offsetof(StreamVertex, x));
+    rlEnableVertexAttribute(locs[SHADER_LOC_VERTEX_POSITION]);
+    rlSetVertexAttribute(locs[SHADER_LOC_VERTEX_TEXCOORD01], 2, RL_FLOAT, false, sizeof(StreamVertex), (void *)offsetof(StreamVertex, u));
+    rlEnableVertexAttribute(locs[SHADER_LOC_VERTEX_TEXCOORD01]);
+    rlSetVertexAttribute(locs[SHADER_LOC_VERTEX_COLOR], 4, RL_UNSIGNED_BYTE, true, sizeof(StreamVertex), (void *)offsetof(StreamVertex, r));
+    rlEnableVertexAttribute(locs[SHADER_LOC_VERTEX_COLOR]);
+    rlSetVertexAttribute(STREAM_LAYER_ATTRIB_LOCATION, 1, RSTREAM_GL_UNSIGNED_SHORT, false, sizeof(StreamVertex), (void *)offsetof(StreamVertex, layer));
+    rlEnableVertexAttribute(STREAM_LAYER_ATTRIB_LOCATION);
+
+    // Quad indices for one region, base vertex selects region and draw
+    unsigned int *indices = (unsigned int *)malloc(vertexCount/4*6*sizeof(unsigned int));
+    for (int i = 0, k = 0; i < vertexCount; i += 4, k += 6)
+    {
+        indices[k] = i;
+        indices[k + 1] = i + 1;
+        indices[k + 2] = i + 2;
+        indices[k + 3] = i;
+        indices[k + 4] = i + 2;
+        indices[k + 5] = i + 3;
+    }
+    batch.eboId = rlLoadVertexBufferElement(indices, vertexCount/4*6*sizeof(unsigned int), false);
+    free(indices);
+
+    rlDisableVertexArray();
+    streamBindBuffer(RSTREAM_GL_ARRAY_BUFFER, 0);
+
+    batch.vertices = batch.persistent? batch.mapped : batch.staging;
+
+    TraceLog(LOG_INFO, "STREAM: [ID %i] Streaming batch loaded: %i x %i vertices (%s)", batch.vboId, bufferCount, vertexCount,
+             batch.persistent? "persistent mapping" : "orphaning");
+
+    return batch;
+}
+
+// Unload streaming batch
+void UnloadStreamBatch(StreamBatch *batch)
+{
+    if (batch->vboId == 0) return;
+
+    for (int i = 0; i < batch->bufferCount; i++) if (batch->fences[i] != NULL) streamDeleteSync(batch->fences[i]);
+
+    if (batch->persistent)
+    {
+        streamBindBuffer(RSTREAM_GL_ARRAY_BUFFER, batch->vboId);
+        streamUnmapBuffer(RSTREAM_GL_ARRAY_BUFFER);
+        streamBindBuffer(RSTREAM_GL_ARRAY_BUFFER, 0);
+    }
+
+    streamDeleteBuffers(1, &batch->vboId);
+    rlUnloadVertexBuffer(batch->eboId);
+    rlUnloadVertexArray(batch->vaoId);
+
+    free(batch->fences);
+    free(batch->staging);
+
+    *batch = (StreamBatch){ 0 };
+}
+
+// Draw pending vertices and move to next ring region
+void DrawStreamBatch(StreamBatch *batch)
+{
+    if ((batch->vboId == 0) || (batch->vertexCount == 0)) return;
+
+    rlDrawRenderBatchActive();          // Previous rlgl geometry goes first
+
+    int region = batch->currentBuffer;
+    int base = region*batch->vertexCapacity;
+    int bytes = batch->vertexCount*(int)sizeof(StreamVertex);
+
+    if (!batch->persistent)
+    {
+        streamBindBuffer(RSTREAM_GL_ARRAY_BUFFER, batch->vboId);
+        if (region == 0)
+        {
+            // New storage for the whole ring, regions still read by the GPU keep the old one
+            streamBufferData(RSTREAM_GL_ARRAY_BUFFER, (ptrdiff_t)batch->vertexCapacity*batch->bufferCount*sizeof(StreamVertex), NULL, RSTREAM_GL_STREAM_DRAW);
+            batch->stats.orphans++;
+        }
+        streamBufferSubData(RSTREAM_GL_ARRAY_BUFFER, (ptrdiff_t)base*sizeof(StreamVertex), bytes, batch->staging);
+        streamBindBuffer(RSTREAM_GL_ARRAY_BUFFER, 0);
+    }
+
+    batch->stats.bytesStreamed += bytes;
+
+    // Layered draws are the ones using the array id as texture
+    TextureArray *array = batch->array;
+    unsigned int arrayId = (array != NULL)? array->id : 0;
+    if ((arrayId != 0) && array->mipmapsDirty)
+    {
+        streamBindTexture(RSTREAM_GL_TEXTURE_2D_ARRAY, arrayId);
+        streamGenerateMipmap(RSTREAM_GL_TEXTURE_2D_ARRAY);
+        streamBindTexture(RSTREAM_GL_TEXTURE_2D_ARRAY, 0);
+        array->mipmapsDirty = false;
+    }
+
+    rlEnableVertexArray(batch->vaoId);
+    rlActiveTextureSlot(0);
+
+    int layeredShader = -1;             // Shader enabled: -1 none, 0 batch shader, 1 array shader
+    for (int i = 0; i < batch->drawCount; i++)
+    {
+        StreamDraw *draw = &batch->draws[i];
+        if (draw->vertexCount == 0) continue;
+
+        int layered = ((arrayId != 0) && (draw->textureId == arrayId))? 1 : 0;
+        if (layered != layeredShader)
+        {
+            if (layeredShader == 1) streamBindTexture(RSTREAM_GL_TEXTURE_2D_ARRAY, 0);
+            EnableStreamShader(layered? array->shader : batch->shader);
+            layeredShader = layered;
+        }
+
+        if (layered) streamBindTexture(RSTREAM_GL_TEXTURE_2D_ARRAY, arrayId);
+        else rlEnableTexture((draw->textureId == 0)? rlGetTextureIdDefault() : draw->textureId);
+
+        if (draw->mode == RL_QUADS) streamDrawElementsBaseVertex(RL_TRIANGLES, draw->vertexCount/4*6, RSTREAM_GL_UNSIGNED_INT, NULL, base + draw->vertexOffset);
+        else streamDrawArrays(draw->mode, base + draw->vertexOffset, draw->vertexCount);
+
+        batch->stats.drawCalls++;
+    }
+
+    if (layeredShader == 1) streamBindTexture(RSTREAM_GL_TEXTURE_2D_ARRAY, 0);
+    else rlDisableTexture();
+    rlDisableVertexArray();
+    rlDisableShader();
+
+    if (batch->persistent) batch->fences[region] = streamFenceSync(RSTREAM_GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    batch->stats.flushes++;
+
+    // Next region, waits if the GPU still reads it
+    batch->currentBuffer = (region + 1)%batch->bufferCount;
+    if (batch->persistent)
+    {
+        WaitStreamRegion(batch, batch->currentBuffer);
+        batch->vertices = batch->mapped + batch->currentBuffer*batch->vertexCapacity;
+    }
+
+    // Keep mode and texture for vertices coming after the flush
+    StreamDraw last = batch->draws[batch->drawCount - 1];
+    batch->vertexCount = 0;
+    batch->drawCount = 1;
+    batch->draws[0] = (StreamDraw){ last.mode, last.textureId, 0, 0 };
+}
+
+// Reset streaming statistics
+void ResetStreamBatchStats(StreamBatch *batch)
+{
+    batch->stats = (StreamStats){ 0 };
+}
+
+// Begin primitives
+void StreamBegin(StreamBatch *batch, int mode)
+{
+    unsigned int textureId = (batch->drawCount > 0)? batch->draws[batch->drawCount - 1].textureId : 0;
+    AddStreamDraw(batch, mode, textureId);
+
+    // Same CPU transform rlVertex3f() applies inside rlPushMatrix()
+    Matrix identity = MatrixIdentity();
+    batch->transform = rlGetMatrixTransform();
+    batch->transformRequired = (memcmp(&batch->transform, &identity, sizeof(Matrix)) != 0);
+}
+
+// End primitives
+void StreamEnd(StreamBatch *batch)
+{
+    (void)batch;
+}
+
+// Set texture for next vertices
+void StreamSetTexture(StreamBatch *batch, unsigned int id)
+{
+    int mode = (batch->drawCount > 0)? batch->draws[batch->drawCount - 1].mode : RL_QUADS;
+
+    // Texture in the array: same draw, only the vertex layer changes
+    int layer = (batch->array != NULL)? GetTextureArrayLayer(batch->array, id) : -1;
+    if (layer >= 0)
+    {
+        batch->current.layer = (unsigned short)layer;
+        id = batch->array->id;
+    }
+    else batch->current.layer = 0;
+
+    AddStreamDraw(batch, mode, id);
+}
+
+// Add vertex with current texcoord and color
+void StreamVertex3f(StreamBatch *batch, float x, float y, float z)
+{
+    if (batch->vertexCount >= batch->vertexCapacity)
+    {
+        // Region full: a primitive cut in the middle moves to the next region
+        StreamDraw *draw = &batch->draws[batch->drawCount - 1];
+        int partial = draw->vertexCount%GetStreamPrimitiveSize(draw->mode);
+        StreamVertex carried[3];
+
+        memcpy(carried, batch->vertices + batch->vertexCount - partial, partial*sizeof(StreamVertex));
+        draw->vertexCount -= partial;
+        batch->vertexCount -= partial;
+
+        DrawStreamBatch(batch);
+
+        memcpy(batch->vertices, carried, partial*sizeof(StreamVertex));
+        batch->vertexCount = partial;
+        batch->draws[0].vertexCount = partial;
+    }
+
+    StreamVertex *vertex = &batch->vertices[batch->vertexCount];
+    *vertex = batch->current;
+
+    if (batch->transformRequired)
+    {
+        Matrix m = batch->transform;
+        vertex->x = m.m0*x + m.m4*y + m.m8*z + m.m12;
+        vertex->y = m.m1*x + m.m5*y + m.m9*z + m.m13;
+        vertex->z = m.m2*x + m.m6*y + m.m10*z + m.m14;
+    }
+    else
+    {
+        vertex->x = x;
+        vertex->y = y;
+        vertex->z = z;
+    }
+
+    batch->vertexCount++;
+    batch->draws[batch->drawCount - 1].vertexCount++;
+}
+
+// Set texcoord for next vertices
+void StreamTexCoord2f(StreamBatch *batch, float u, float v)
+{
+    batch->current.u = u;
+    batch->current.v = v;
+}
+
+// Set color for next vertices
+void StreamColor4ub(StreamBatch *batch, unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+{
+    batch->current.r = r;
+    batch->current.g = g;
+    batch->current.b = b;
+    batch->current.a = a;
+}
+
+// Set shader for next vertices, draws pending ones if it changes
+void StreamSetShader(StreamBatch *batch, Shader shader)
+{
+    if (shader.id == rlGetShaderIdDefault()) shader.id = 0;
+    if (shader.id == batch->shader.id) return;
+
+    DrawStreamBatch(batch);
+    batch->shader = shader;
+}
+
+// Add whole primitives already transformed, with current mode and texture
+// NOTE: Vertices are not transformed, count should be a multiple of the primitive size
+void StreamPushVertices(StreamBatch *batch, const StreamVertex *vertices, int count)
+{
+    if (batch->drawCount == 0) AddStreamDraw(batch, RL_QUADS, 0);
+
+    int size = GetStreamPrimitiveSize(batch->draws[batch->drawCount - 1].mode);
+
+    while (count > 0)
+    {
+        int space = batch->vertexCapacity - batch->vertexCount;
+        space -= space%size;
+        if (space == 0)
+        {
+            DrawStreamBatch(batch);
+            continue;
+        }
+
+        int copied = (count < space)? count : space;
+        StreamVertex *target = batch->vertices + batch->vertexCount;
+        memcpy(target, vertices, copied*sizeof(StreamVertex));
+
+        // Layer comes from the texture set on the batch, not from the recorded vertices
+        if ((batch->array != NULL) && (batch->draws[batch->drawCount - 1].textureId == batch->array->id))
+        {
+            for (int i = 0; i < copied; i++) target[i].layer = batch->current.layer;
+        }
+
+        batch->vertexCount += copied;
+        batch->draws[batch->drawCount - 1].vertexCount += copied;
+        vertices += copied;
+        count -= copied;
+    }
+}
+
+// Set texture array for next vertices, NULL draws every texture on its own
+void StreamSetTextureArray(StreamBatch *batch, TextureArray *array)
+{
+    if (array == batch->array) return;
+
+    DrawStreamBatch(batch);         // Pending layered draws need the array they were recorded with
+
+    // Texture of the next vertices resets to default if it was a layer of the previous array
+    unsigned int textureId = (batch->drawCount > 0)? batch->draws[batch->drawCount - 1].textureId : 0;
+    if ((batch->array != NULL) && (textureId == batch->array->id)) textureId = 0;
+
+    batch->array = array;
+    StreamSetTexture(batch, textureId);
+}
+
+// Load empty texture array (RGBA8, repeat wrap, mipmapped)
+TextureArray LoadTextureArray(int width, int height, int layerCapacity)
+{
+    TextureArray array = { 0 };
+
+    if (!LoadStreamFunctions() || (streamTexImage3D == NULL) || (streamGenerateMipmap == NULL))
+    {
+        TraceLog(LOG_WARNING, "STREAM: Texture arrays not supported (OpenGL 3.0 required)");
+        return array;
+    }
+
+    // Layered draw shader, default shader with a sampler2DArray
+    const char *vsCode =
+        "#version 330\n"
+        "in vec3 vertexPosition;\n"
+        "in vec2 vertexTexCoord;\n"
+        "in vec4 vertexColor;\n"
+        "layout(location = 5) in float vertexLayer;\n"
+        "uniform mat4 mvp;\n"
+        "out vec2 fragTexCoord;\n"
+        "out vec4 fragColor;\n"
+        "flat out float fragLayer;\n"
+        "void main()\n"
+        "{\n"
+        "    fragTexCoord = vertexTexCoord;\n"
+        "    fragColor = vertexColor;\n"
+        "    fragLayer = vertexLayer;\n"
+        "    gl_Position = mvp*vec4(vertexPosition, 1.0);\n"
+        "}\n";
+    const char *fsCode =
+        "#version 330\n"
+        "in vec2 fragTexCoord;\n"
+        "in vec4 fragColor;\n"
+        "flat in float fragLayer;\n"
+        "uniform sampler2DArray texture0;\n"
+        "uniform vec4 colDiffuse;\n"
+        "out vec4 finalColor;\n"
+        "void main()\n"
+        "{\n"
+        "    finalColor = texture(texture0, vec3(fragTexCoord, fragLayer))*colDiffuse*fragColor;\n"
+        "}\n";
+
+    array.shader = LoadShaderFromMemory(vsCode, fsCode);
+    if (array.shader.id == rlGetShaderIdDefault())
+    {
+        TraceLog(LOG_WARNING, "STREAM: Failed to load texture array shader");
+        return (TextureArray){ 0 };
+    }
+
+    array.width = width;
+    array.height = height;
+    array.layerCapacity = layerCapacity;
+
+    streamGenTextures(1, &array.id);
+    streamBindTexture(RSTREAM_GL_TEXTURE_2D_ARRAY, array.id);
+    streamTexImage3D(RSTREAM_GL_TEXTURE_2D_ARRAY, 0, RSTREAM_GL_RGBA8, width, height, layerCapacity, 0, RSTREAM_GL_RGBA, RSTREAM_GL_UNSIGNED_BYTE, NULL);
+    streamTexParameteri(RSTREAM_GL_TEXTURE_2D_ARRAY, RSTREAM_GL_TEXTURE_WRAP_S, RSTREAM_GL_REPEAT);
+    streamTexParameteri(RSTREAM_GL_TEXTURE_2D_ARRAY, RSTREAM_GL_TEXTURE_WRAP_T, RSTREAM_GL_REPEAT);
+    streamTexParameteri(RSTREAM_GL_TEXTURE_2D_ARRAY, RSTREAM_GL_TEXTURE_MAG_FILTER, RSTREAM_GL_LINEAR);
+    streamTexParameteri(RSTREAM_GL_TEXTURE_2D_ARRAY, RSTREAM_GL_TEXTURE_MIN_FILTER, RSTREAM_GL_LINEAR_MIPMAP_LINEAR);
+    streamBindTexture(RSTREAM_GL_TEXTURE_2D_ARRAY, 0);
+
+    TraceLog(LOG_INFO, "STREAM: [ID %i] Texture array loaded: %i x %i, %i layers", array.id, width, height, layerCapacity);
+
+    return array;
+}
+
+// Unload texture array
+void UnloadTextureArray(TextureArray *array)
+{
+    if (array->id == 0) return;
+
+    streamDeleteTextures(1, &array->id);
+    UnloadShader(array->shader);
+    free(array->textureLayers);
+
+    *array = (TextureArray){ 0 };
+}
+
+// Add image as a new layer, returns layer or -1
+int AddTextureArrayImage(TextureArray *array, Image image)
+{
+    if ((array->id == 0) || (array->layerCount >= array->layerCapacity))
+    {
+        TraceLog(LOG_WARNING, "STREAM: Texture array full, layer not added");
+        return -1;
+    }
+
+    UploadTextureArrayLayer(array, array->layerCount, image);
+
+    return array->layerCount++;
+}
+
+// Add texture contents as a new layer, StreamSetTexture() maps its id to it
+int AddTextureArrayTexture(TextureArray *array, Texture2D texture)
+{
+    int existing = GetTextureArrayLayer(array, texture.id);
+    if (existing >= 0) return existing;
+
+    Image image = LoadImageFromTexture(texture);
+    int layer = AddTextureArrayImage(array, image);
+    UnloadImage(image);
+    if (layer < 0) return -1;
+
+    if ((int)texture.id >= array->textureLayersSize)
+    {
+        int size = 2*texture.id + 16;
+        array->textureLayers = (int *)realloc(array->textureLayers, size*sizeof(int));
+        memset(array->textureLayers + array->textureLayersSize, 0, (size - array->textureLayersSize)*sizeof(int));
+        array->textureLayersSize = size;
+    }
+    array->textureLayers[texture.id] = layer + 1;
+
+    return layer;
+}
+
+// Get layer of a texture id, -1 if not in the array
+int GetTextureArrayLayer(const TextureArray *array, unsigned int textureId)
+{
+    if ((int)textureId >= array->textureLayersSize) return -1;
+    return array->textureLayers[textureId] - 1;
+}
+
+// Replace layer contents, texture ids mapped to the layer are forgotten
+// NOTE: Vertices already streamed with the layer draw the new contents
+bool UpdateTextureArrayImage(TextureArray *array, int layer, Image image)
+{
+    if ((array->id == 0) || (layer < 0) || (layer >= array->layerCount))
+    {
+        TraceLog(LOG_WARNING, "STREAM: Texture array layer %i not found, not updated", layer);
+        return false;
+    }
+
+    UploadTextureArrayLayer(array, layer, image);
+
+    for (int i = 0; i < array->textureLayersSize; i++)
+    {
+        if (array->textureLayers[i] == layer + 1) array->textureLayers[i] = 0;
+    }
+
+    return true;
+}
+
+// Forget texture id mapping, call before UnloadTexture() (ids get reused)
+// NOTE: The layer stays in use, UpdateTextureArrayImage() can fill it again
+void RemoveTextureArrayTexture(TextureArray *array, unsigned int textureId)
+{
+    if ((int)textureId < array->textureLayersSize) array->textureLayers[textureId] = 0;
+}
+
+// Benchmark sprites from many textures, per texture draws vs texture array
+// NOTE: Needs a window, sprites are small so the test is bound by draw submission
+void BenchmarkTextureArray(int spriteCount, int textureCount, int frames)
+{
+    Texture2D *textures = (Texture2D *)malloc(textureCount*sizeof(Texture2D));
+    for (int i = 0; i < textureCount; i++)
+    {
+        Image image = GenImageChecked(32, 32, 8, 8, ColorFromHSV(360.0f*i/textureCount, 0.8f, 0.9f), WHITE);
+        textures[i] = LoadTextureFromImage(image);
+        UnloadImage(image);
+    }
+
+    StreamBatch batch = LoadStreamBatch(STREAM_DEFAULT_VERTICES, STREAM_DEFAULT_BUFFERS);
+    TextureArray array = LoadTextureArray(32, 32, textureCount);
+    for (int i = 0; i < textureCount; i++) AddTextureArrayTexture(&array, textures[i]);
+
+    int *picks = (int *)malloc(spriteCount*sizeof(int));
+    Vector2 *positions = (Vector2 *)malloc(spriteCount*sizeof(Vector2));
+    SetRandomSeed(1);
+    for (int i = 0; i < spriteCount; i++)
+    {
+        picks[i] = GetRandomValue(0, textureCount - 1);
+        positions[i] = (Vector2){ (float)GetRandomValue(0, GetScreenWidth() - 16), (float)GetRandomValue(0, GetScreenHeight() - 16) };
+    }
+
+    for (int test = 0; test < 3; test++)
+    {
+        const char *label = (test == 0)? "rlgl" : (test == 1)? "stream" : "stream array";
+        if ((test > 0) && (batch.vboId == 0)) break;
+        if ((test == 2) && (array.id == 0)) break;
+
+        StreamSetTextureArray(&batch, (test == 2)? &array : NULL);
+        ResetStreamBatchStats(&batch);
+
+        double start = 0.0;
+        for (int frame = -2; frame < frames; frame++)
+        {
+            if (frame == 0)
+            {
+                start = GetTime();
+                ResetStreamBatchStats(&batch);
+            }
+
+            BeginDrawing();
+            ClearBackground(BLACK);
+
+            for (int i = 0; i < spriteCount; i++)
+            {
+                float x = positions[i].x, y = positions[i].y;
+                unsigned int id = textures[picks[i]].id;
+
+                if (test == 0)
+                {
+                    rlSetTexture(id);
+                    rlBegin(RL_QUADS);
+                    rlColor4ub(255, 255, 255, 255);
+                    rlTexCoord2f(0.0f, 0.0f); rlVertex2f(x, y);
+                    rlTexCoord2f(0.0f, 1.0f); rlVertex2f(x, y + 16.0f);
+                    rlTexCoord2f(1.0f, 1.0f); rlVertex2f(x + 16.0f, y + 16.0f);
+                    rlTexCoord2f(1.0f, 0.0f); rlVertex2f(x + 16.0f, y);
+                    rlEnd();
+                }
+                else
+                {
+                    StreamSetTexture(&batch, id);
+                    StreamBegin(&batch, RL_QUADS);
+                    StreamTexCoord2f(&batch, 0.0f, 0.0f); StreamVertex3f(&batch, x, y, 0.0f);
+                    StreamTexCoord2f(&batch, 0.0f, 1.0f); StreamVertex3f(&batch, x, y + 16.0f, 0.0f);
+                    StreamTexCoord2f(&batch, 1.0f, 1.0f); StreamVertex3f(&batch, x + 16.0f, y + 16.0f, 0.0f);
+                    StreamTexCoord2f(&batch, 1.0f, 0.0f); StreamVertex3f(&batch, x + 16.0f, y, 0.0f);
+                    StreamEnd(&batch);
+                }
+            }
+
+            if (test == 0) rlSetTexture(0);
+            else DrawStreamBatch(&batch);
+
+            EndDrawing();
+        }
+        double elapsed = GetTime() - start;
+
+        if (test == 0) TraceLog(LOG_INFO, "BENCH: [%i sprites, %i textures] %-12s %8.3f ms/frame", spriteCount, textureCount, label, elapsed*1000.0/frames);
+        else TraceLog(LOG_INFO, "BENCH: [%i sprites, %i textures] %-12s %8.3f ms/frame, %i draws/frame", spriteCount, textureCount, label,
+                      elapsed*1000.0/frames, batch.stats.drawCalls/frames);
+    }
+
+    StreamSetTextureArray(&batch, NULL);
+    UnloadTextureArray(&array);
+    UnloadStreamBatch(&batch);
+    free(picks);
+    free(positions);
+    for (int i = 0; i < textureCount; i++) UnloadTexture(textures[i]);
+    free(textures);
+}
+
+// Benchmark rlgl batch vs streaming batch (persistent and orphaning)
+// NOTE: Needs a window, quads cover the screen in 2D so fill rate stays low
+void BenchmarkStreamBatch(int quadCount, int frames)
+{
+    int width = GetScreenWidth();
+    int height = GetScreenHeight();
+    int columns = 1;
+    while (columns*columns < quadCount) columns++;
+    float size = (float)width/columns;
+
+    for (int test = 0; test < 3; test++)
+    {
+        StreamBatch batch = { 0 };
+        const char *label = "rlgl batch";
+
+        if (test > 0)
+        {
+            batch = LoadStreamBatchEx(STREAM_DEFAULT_VERTICES, STREAM_DEFAULT_BUFFERS, (test == 1));
+            if (batch.vboId == 0) break;
+            if ((test == 1) && !batch.persistent)
+            {
+                UnloadStreamBatch(&batch);
+                TraceLog(LOG_INFO, "BENCH: [%i quads] stream persistent: not supported", quadCount);
+                continue;
+            }
+            label = batch.persistent? "stream persistent" : "stream orphaning";
+        }
+
+        double start = 0.0;
+        for (int frame = -2; frame < frames; frame++)
+        {
+            if (frame == 0)
+            {
+                start = GetTime();
+                ResetStreamBatchStats(&batch);
+            }
+
+            BeginDrawing();
+            ClearBackground(BLACK);
+
+            if (test == 0) rlBegin(RL_QUADS);
+            else StreamBegin(&batch, RL_QUADS);
+
+            for (int i = 0; i < quadCount; i++)
+            {
+                float x = (i%columns)*size;
+                float y = (i/columns)*size*width/height;
+                unsigned char shade = (unsigned char)(i + frame);
+
+                if (test == 0)
+                {
+                    rlColor4ub(shade, 128, 255, 255);
+                    rlTexCoord2f(0.0f, 0.0f); rlVertex2f(x, y);
+                    rlTexCoord2f(0.0f, 1.0f); rlVertex2f(x, y + size);
+                    rlTexCoord2f(1.0f, 1.0f); rlVertex2f(x + size, y + size);
+                    rlTexCoord2f(1.0f, 0.0f); rlVertex2f(x + size, y);
+                }
+                else
+                {
+                    StreamColor4ub(&batch, shade, 128, 255, 255);
+                    StreamTexCoord2f(&batch, 0.0f, 0.0f); StreamVertex3f(&batch, x, y, 0.0f);
+                    StreamTexCoord2f(&batch, 0.0f, 1.0f); StreamVertex3f(&batch, x, y + size, 0.0f);
+                    StreamTexCoord2f(&batch, 1.0f, 1.0f); StreamVertex3f(&batch, x + size, y + size, 0.0f);
+                    StreamTexCoord2f(&batch, 1.0f, 0.0f); StreamVertex3f(&batch, x + size, y, 0.0f);
+                }
+            }
+
+            if (test == 0) rlEnd();
+            else
+            {
+                StreamEnd(&batch);
+                DrawStreamBatch(&batch);
+            }
+
+            EndDrawing();
+        }
+        double elapsed = GetTime() - start;
+
+        if (test == 0) TraceLog(LOG_INFO, "BENCH: [%i quads] %-17s %8.3f ms/frame", quadCount, label, elapsed*1000.0/frames);
+        else
+        {
+            StreamStats stats = batch.stats;
+            TraceLog(LOG_INFO, "BENCH: [%i quads] %-17s %8.3f ms/frame, %.1f MB/frame, %i draws/frame, %i fence waits (%.3f ms), %i orphans",
+                     quadCount, label, elapsed*1000.0/frames, stats.bytesStreamed/(1024.0*1024.0)/frames, stats.drawCalls/frames,
+                     stats.fenceWaits, stats.fenceWaitTime*1000.0, stats.orphans);
+            UnloadStreamBatch(&batch);
+        }
+    }
+}
+
+// Benchmark vertex writes, rlgl separate arrays vs interleaved
+// NOTE: Write tests are CPU only, same work as rlVertex3f() per call without the flushes;
+// rlBegin()/StreamBegin() tests push the same quads through the real batches (needs a window)
+void BenchmarkStreamLayout(int quadCount)
+{
+    Matrix transform = MatrixMultiply(MatrixRotateXYZ((Vector3){ 0.3f, 0.2f, 0.1f }), MatrixTranslate(1.0f, 2.0f, 3.0f));
+    double vertexCount = 4.0*quadCount;
+
+    double separate = 0.0, interleaved = 0.0;
+    PushBenchQuads(quadCount/10, transform, false);         // Warm up
+    PushBenchQuads(quadCount/10, transform, true);
+    for (int run = 0; run < 3; run++)
+    {
+        double time = PushBenchQuads(quadCount, transform, false);
+        if ((run == 0) || (time < separate)) separate = time;
+        time = PushBenchQuads(quadCount, transform, true);
+        if ((run == 0) || (time < interleaved)) interleaved = time;
+    }
+
+    TraceLog(LOG_INFO, "BENCH: [%i quads] write separate     %8.3f ms, %5.2f ns/vertex", quadCount, separate*1000.0, separate*1e9/vertexCount);
+    TraceLog(LOG_INFO, "BENCH: [%i quads] write interleaved  %8.3f ms, %5.2f ns/vertex (%.2fx)", quadCount, interleaved*1000.0, interleaved*1e9/vertexCount, separate/interleaved);
+
+    // Same quads through the real batches, rlgl uploads three arrays per flush
+    StreamBatch batch = LoadStreamBatch(STREAM_DEFAULT_VERTICES, STREAM_DEFAULT_BUFFERS);
+    if (batch.vboId == 0) return;
+
+    for (int test = 0; test < 2; test++)
+    {
+        double start = GetTime();
+        BeginDrawing();
+        rlPushMatrix();
+        rlMultMatrixf(MatrixToFloat(transform));
+
+        if (test == 0) rlBegin(RL_QUADS);
+        else StreamBegin(&batch, RL_QUADS);
+
+        for (int i = 0; i < quadCount; i++)
+        {
+            float x = (float)(i & 1023);
+            float y = (float)(i >> 10);
+
+            if (test == 0)
+            {
+                rlColor4ub(255, 255, 255, 255);
+                rlTexCoord2f(0.0f, 0.0f); rlVertex3f(x, 0.0f, y);
+                rlTexCoord2f(1.0f, 0.0f); rlVertex3f(x + 1.0f, 0.0f, y);
+                rlTexCoord2f(1.0f, 1.0f); rlVertex3f(x + 1.0f, 0.0f, y + 1.0f);
+                rlTexCoord2f(0.0f, 1.0f); rlVertex3f(x, 0.0f, y + 1.0f);
+            }
+            else
+            {
+                StreamColor4ub(&batch, 255, 255, 255, 255);
+                StreamTexCoord2f(&batch, 0.0f, 0.0f); StreamVertex3f(&batch, x, 0.0f, y);
+                StreamTexCoord2f(&batch, 1.0f, 0.0f); StreamVertex3f(&batch, x + 1.0f, 0.0f, y);
+                StreamTexCoord2f(&batch, 1.0f, 1.0f); StreamVertex3f(&batch, x + 1.0f, 0.0f, y + 1.0f);
+                StreamTexCoord2f(&batch, 0.0f, 1.0f); StreamVertex3f(&batch, x, 0.0f, y + 1.0f);
+            }
+        }
+
+        if (test == 0) rlEnd();
+        else StreamEnd(&batch);
+        rlPopMatrix();
+
+        if (test == 0) rlDrawRenderBatchActive();
+        else DrawStreamBatch(&batch);
+        EndDrawing();
+        double time = GetTime() - start;
+
+        TraceLog(LOG_INFO, "BENCH: [%i quads] %-18s %8.3f ms, %5.2f ns/vertex", quadCount,
+                 (test == 0)? "rlBegin separate" : "Stream interleaved", time*1000.0, time*1e9/vertexCount);
+    }
+
+    UnloadStreamBatch(&batch);
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Load GL entry points, needs a current context (after InitWindow())
+static bool LoadStreamFunctions(void)
+{
+    if (streamState != 0) return (streamState == 1);
+
+    streamGenBuffers = (RstreamGenBuffersProc)glfwGetProcAddress("glGenBuffers");
+    streamDeleteBuffers = (RstreamDeleteBuffersProc)glfwGetProcAddress("glDeleteBuffers");
+    streamBindBuffer = (RstreamBindBufferProc)glfwGetProcAddress("glBindBuffer");
+    streamBufferData = (RstreamBufferDataProc)glfwGetProcAddress("glBufferData");
+    streamBufferSubData = (RstreamBufferSubDataProc)glfwGetProcAddress("glBufferSubData");
+    streamBufferStorage = (RstreamBufferStorageProc)glfwGetProcAddress("glBufferStorage");
+    streamMapBufferRange = (RstreamMapBufferRangeProc)glfwGetProcAddress("glMapBufferRange");
+    streamUnmapBuffer = (RstreamUnmapBufferProc)glfwGetProcAddress("glUnmapBuffer");
+    streamFenceSync = (RstreamFenceSyncProc)glfwGetProcAddress("glFenceSync");
+    streamClientWaitSync = (RstreamClientWaitSyncProc)glfwGetProcAddress("glClientWaitSync");
+    streamDeleteSync = (RstreamDeleteSyncProc)glfwGetProcAddress("glDeleteSync");
+    streamGetIntegerv = (RstreamGetIntegervProc)glfwGetProcAddress("glGetIntegerv");
+    streamGetStringi = (RstreamGetStringiProc)glfwGetProcAddress("glGetStringi");
+    streamDrawArrays = (RstreamDrawArraysProc)glfwGetProcAddress("glDrawArrays");
+    streamDrawElementsBaseVertex = (RstreamDrawElementsBaseVertexProc)glfwGetProcAddress("glDrawElementsBaseVertex");
+    streamGenTextures = (RstreamGenTexturesProc)glfwGetProcAddress("glGenTextures");
+    streamDeleteTextures = (RstreamDeleteTexturesProc)glfwGetProcAddress("glDeleteTextures");
+    streamBindTexture = (RstreamBindTextureProc)glfwGetProcAddress("glBindTexture");
+    streamTexParameteri = (RstreamTexParameteriProc)glfwGetProcAddress("glTexParameteri");
+    streamTexImage3D = (RstreamTexImage3DProc)glfwGetProcAddress("glTexImage3D");
+    streamTexSubImage3D = (RstreamTexSubImage3DProc)glfwGetProcAddress("glTexSubImage3D");
+    streamGenerateMipmap = (RstreamGenerateMipmapProc)glfwGetProcAddress("glGenerateMipmap");
+
+    bool ready = (streamGenBuffers != NULL) && (streamDeleteBuffers != NULL) && (streamBindBuffer != NULL) &&
+                 (streamBufferData != NULL) && (streamBufferSubData != NULL) && (streamGetIntegerv != NULL) &&
+                 (streamDrawArrays != NULL) && (streamDrawElementsBaseVertex != NULL) && (streamGenTextures != NULL) &&
+                 (streamDeleteTextures != NULL) && (streamBindTexture != NULL) && (streamTexParameteri != NULL) && (streamTexSubImage3D != NULL);
+
+    if (!ready)
+    {
+        TraceLog(LOG_WARNING, "STREAM: Streaming batch not supported (OpenGL 3.3 required)");
+        streamState = -1;
+        return false;
+    }
+
+    // Persistent mapping: OpenGL 4.4 or ARB_buffer_storage, plus fences (3.2)
+    int major = 0, minor = 0, extensionCount = 0;
+    streamGetIntegerv(RSTREAM_GL_MAJOR_VERSION, &major);
+    streamGetIntegerv(RSTREAM_GL_MINOR_VERSION, &minor);
+
+    bool bufferStorage = (major > 4) || ((major == 4) && (minor >= 4));
+    if (!bufferStorage && (streamGetStringi != NULL))
+    {
+        streamGetIntegerv(RSTREAM_GL_NUM_EXTENSIONS, &extensionCount);
+        for (int i = 0; (i < extensionCount) && !bufferStorage; i++)
+        {
+            const char *extension = (const char *)streamGetStringi(RSTREAM_GL_EXTENSIONS, i);
+            if ((extension != NULL) && (strcmp(extension, "GL_ARB_buffer_storage") == 0)) bufferStorage = true;
+        }
+    }
+
+    streamPersistentSupported = bufferStorage && (streamBufferStorage != NULL) && (streamMapBufferRange != NULL) && (streamUnmapBuffer != NULL) &&
+                                (streamFenceSync != NULL) && (streamClientWaitSync != NULL) && (streamDeleteSync != NULL);
+
+    TraceLog(LOG_INFO, "STREAM: OpenGL %i.%i, persistent mapping %s", major, minor, streamPersistentSupported? "supported" : "not supported");
+
+    streamState = 1;
+    return true;
+}
+
+// Wait until the GPU is done with a ring region
+static void WaitStreamRegion(StreamBatch *batch, int region)
+{
+    void *fence = batch->fences[region];
+    if (fence == NULL) return;
+
+    // Already signaled is the common case, no flush needed to find out
+    unsigned int status = streamClientWaitSync(fence, 0, 0);
+    if (status == RSTREAM_GL_TIMEOUT_EXPIRED)
+    {
+        double start = GetTime();
+        batch->stats.fenceWaits++;
+
+        do status = streamClientWaitSync(fence, RSTREAM_GL_SYNC_FLUSH_COMMANDS_BIT, RSTREAM_FENCE_TIMEOUT);
+        while (status == RSTREAM_GL_TIMEOUT_EXPIRED);
+
+        batch->stats.fenceWaitTime += GetTime() - start;
+    }
+
+    if (status == RSTREAM_GL_WAIT_FAILED) TraceLog(LOG_WARNING, "STREAM: Fence wait failed on region %i", region);
+
+    streamDeleteSync(fence);
+    batch->fences[region] = NULL;
+}
+
+// Start new draw if mode or texture changed
+static void AddStreamDraw(StreamBatch *batch, int mode, unsigned int textureId)
+{
+    if (batch->drawCount > 0)
+    {
+        StreamDraw *draw = &batch->draws[batch->drawCount - 1];
+
+        if ((draw->mode == mode) && (draw->textureId == textureId)) return;
+        if (draw->vertexCount == 0)
+        {
+            // Nothing drawn with previous state, reuse the draw
+            draw->mode = mode;
+            draw->textureId = textureId;
+            return;
+        }
+    }
+
+    if (batch->drawCount >= STREAM_MAX_DRAWS) DrawStreamBatch(batch);
+    if ((batch->drawCount > 0) && (batch->draws[batch->drawCount - 1].vertexCount == 0)) batch->drawCount--;   // Left by the flush
+
+    batch->draws[batch->drawCount] = (StreamDraw){ mode, textureId, batch->vertexCount, 0 };
+    batch->drawCount++;
+}
+
+// Enable shader with the uniforms the rlgl batch sets, id 0 is the default shader
+static void EnableStreamShader(Shader shader)
+{
+    bool defaultShader = (shader.id == 0);
+    int *locs = defaultShader? rlGetShaderLocsDefault() : shader.locs;
+    float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    int textureSlot = 0;
+
+    rlEnableShader(defaultShader? rlGetShaderIdDefault() : shader.id);
+    rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_MVP], MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection()));
+    rlSetUniform(locs[SHADER_LOC_COLOR_DIFFUSE], white, RL_SHADER_UNIFORM_VEC4, 1);
+    rlSetUniform(locs[SHADER_LOC_MAP_DIFFUSE], &textureSlot, RL_SHADER_UNIFORM_SAMPLER2D, 1);
+}
+
+// Vertices per primitive
+static int GetStreamPrimitiveSize(int mode)
+{
+    switch (mode)
+    {
+        case RL_LINES: return 2;
+        case RL_TRIANGLES: return 3;
+        default: return 4;
+    }
+}
+
+// Vertex writer state for the layout benchmark, same fields rlgl keeps
+static struct {
+    float *vertices;            // Separate arrays, rlVertexBuffer layout
+    float *texcoords;
+    unsigned char *colors;
+    StreamVertex *interleaved;  // One interleaved array
+    int counter;
+    int capacity;
+    Matrix transform;
+    float u, v;
+    unsigned char r, g, b, a;
+} streamBench = { 0 };
+
+// Write vertex like rlVertex3f() does: transform, then position, texcoord and color to three arrays
+static void PushSeparateVertex(float x, float y, float z)
+{
+    if (streamBench.counter > streamBench.capacity - 4) streamBench.counter = 0;   // Flush point, no upload
+
+    Matrix m = streamBench.transform;
+    int i = streamBench.counter;
+
+    streamBench.vertices[3*i] = m.m0*x + m.m4*y + m.m8*z + m.m12;
+    streamBench.vertices[3*i + 1] = m.m1*x + m.m5*y + m.m9*z + m.m13;
+    streamBench.vertices[3*i + 2] = m.m2*x + m.m6*y + m.m10*z + m.m14;
+    streamBench.texcoords[2*i] = streamBench.u;
+    streamBench.texcoords[2*i + 1] = streamBench.v;
+    streamBench.colors[4*i] = streamBench.r;
+    streamBench.colors[4*i + 1] = streamBench.g;
+    streamBench.colors[4*i + 2] = streamBench.b;
+    streamBench.colors[4*i + 3] = streamBench.a;
+    streamBench.counter++;
+}
+
+// Same vertex as one interleaved write
+static void PushInterleavedVertex(float x, float y, float z)
+{
+    if (streamBench.counter > streamBench.capacity - 4) streamBench.counter = 0;
+
+    Matrix m = streamBench.transform;
+    StreamVertex vertex;
+
+    vertex.x = m.m0*x + m.m4*y + m.m8*z + m.m12;
+    vertex.y = m.m1*x + m.m5*y + m.m9*z + m.m13;
+    vertex.z = m.m2*x + m.m6*y + m.m10*z + m.m14;
+    vertex.u = streamBench.u;
+    vertex.v = streamBench.v;
+    vertex.r = streamBench.r;
+    vertex.g = streamBench.g;
+    vertex.b = streamBench.b;
+    vertex.a = streamBench.a;
+    vertex.layer = 0;
+    vertex.reserved = 0;
+    streamBench.interleaved[streamBench.counter] = vertex;
+    streamBench.counter++;
+}
+
+// Convert image to the array format and size, upload it to a layer
+static void UploadTextureArrayLayer(TextureArray *array, int layer, Image image)
+{
+    Image data = ImageCopy(image);
+    ImageFormatParallel(&data, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    if ((data.width != array->width) || (data.height != array->height)) ImageResizeParallel(&data, array->width, array->height);
+
+    streamBindTexture(RSTREAM_GL_TEXTURE_2D_ARRAY, array->id);
+    streamTexSubImage3D(RSTREAM_GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, array->width, array->height, 1, RSTREAM_GL_RGBA, RSTREAM_GL_UNSIGNED_BYTE, data.data);
+    streamBindTexture(RSTREAM_GL_TEXTURE_2D_ARRAY, 0);
+    UnloadImage(data);
+
+    array->mipmapsDirty = true;
+}
+
+// Push quads one vertex call at a time, returns seconds
+static double PushBenchQuads(int quadCount, Matrix transform, bool interleaved)
+{
+    // Called through a pointer like the library calls of rlgl, so the writer doesn't get inlined in the loop
+    void (*volatile pushVertex)(float, float, float) = interleaved? PushInterleavedVertex : PushSeparateVertex;
+    void (*push)(float, float, float) = pushVertex;
+
+    streamBench.capacity = STREAM_DEFAULT_VERTICES;
+    streamBench.vertices = (float *)malloc(streamBench.capacity*3*sizeof(float));
+    streamBench.texcoords = (float *)malloc(streamBench.capacity*2*sizeof(float));
+    streamBench.colors = (unsigned char *)malloc(streamBench.capacity*4);
+    streamBench.interleaved = (StreamVertex *)malloc(streamBench.capacity*sizeof(StreamVertex));
+    streamBench.counter = 0;
+    streamBench.transform = transform;
+    streamBench.r = streamBench.g = streamBench.b = streamBench.a = 255;
+
+    double start = GetTime();
+
+    for (int i = 0; i < quadCount; i++)
+    {
+        float x = (float)(i & 1023);
+        float y = (float)(i >> 10);
+
+        streamBench.u = 0.0f; streamBench.v = 0.0f; push(x, 0.0f, y);
+        streamBench.u = 1.0f; push(x + 1.0f, 0.0f, y);
+        streamBench.v = 1.0f; push(x + 1.0f, 0.0f, y + 1.0f);
+        streamBench.u = 0.0f; push(x, 0.0f, y + 1.0f);
+    }
+
+    double time = GetTime() - start;
+
+    free(streamBench.vertices);
+    free(streamBench.texcoords);
+    free(streamBench.colors);
+    free(streamBench.interleaved);
+    return time;
+}
+
+#endif // RSTREAM_IMPLEMENTATION
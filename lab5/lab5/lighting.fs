@@ -0,0 +1,89 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec3 fragPosition;
+in vec2 fragTexCoord;
+//in vec4 fragColor;
+in vec3 fragNormal;
+
+// Input uniform values
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+
+// Output fragment color
+out vec4 finalColor;
+
+#define     MAX_LIGHTS              256
+#define     MAX_MATERIALS           64
+#define     LIGHT_DIRECTIONAL       0
+#define     LIGHT_POINT             1
+
+// NOTE: Member order matters, std140 layout is mirrored by LightData and MaterialData in rlights.h
+struct Light {
+    vec3 position;
+    int type;
+    vec3 target;
+    int enabled;
+    vec4 color;
+};
+
+struct Material {
+    vec3 ambient;
+    float shininess;
+    vec3 diffuse;
+    float transparency;
+    vec3 specular;
+};
+
+// Input lighting values, all lights and materials in two uniform blocks (see UpdateLightBlock())
+layout(std140) uniform LightBlock {
+    int lightsCount;
+    Light lights[MAX_LIGHTS];
+};
+layout(std140) uniform MaterialBlock {
+    int materialsCount;
+    Material materials[MAX_MATERIALS];
+};
+uniform int materialIndex;
+uniform vec4 ambient;
+uniform vec3 viewPos;
+
+void main()
+{
+    // Texel color fetching from texture sampler
+    vec4 texelColor = texture(texture0, fragTexCoord);
+    Material material = materials[clamp(materialIndex, 0, materialsCount - 1)];
+    vec3 normal = normalize(fragNormal);
+    vec3 viewD = normalize(viewPos - fragPosition);
+    vec3 result = ambient.rgb*material.ambient;
+
+    for (int i = 0; i < lightsCount; i++)
+    {
+        if (lights[i].enabled == 1)
+        {
+            vec3 light = vec3(0.0);
+
+            if (lights[i].type == LIGHT_DIRECTIONAL)
+            {
+                light = -normalize(lights[i].target - lights[i].position);
+            }
+
+            if (lights[i].type == LIGHT_POINT)
+            {
+                light = normalize(lights[i].position - fragPosition);
+            }
+
+            float NdotL = max(dot(normal, light), 0.0);
+            result += lights[i].color.rgb*NdotL*material.diffuse;
+
+            float specCo = 0.0;
+            if (NdotL > 0.0) specCo = pow(max(0.0, dot(viewD, reflect(-(light), normal))), material.shininess);
+            result += lights[i].color.rgb*specCo*material.specular;
+        }
+    }
+
+    finalColor = texelColor*colDiffuse*vec4(result, material.transparency);
+
+    // Gamma correction
+    finalColor = pow(finalColor, vec4(1.0/2.2));
+}
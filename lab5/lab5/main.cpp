@@ -22,8 +22,18 @@
 
 #include "raymath.h"
 
+#define RUNIFORMS_IMPLEMENTATION
+#include "runiforms.h"
+#define RUBO_IMPLEMENTATION
+#include "rubo.h"
 #define RLIGHTS_IMPLEMENTATION
 #include "rlights.h"
+#define RGLYPHS_IMPLEMENTATION
+#include "rglyphs.h"
+#define RTEXTRUN_IMPLEMENTATION
+#include "rtextrun.h"
+#define RTEXTFMT_IMPLEMENTATION
+#include "rtextfmt.h"
 
 #if defined(PLATFORM_DESKTOP)
 #define GLSL_VERSION            330
@@ -57,14 +67,22 @@ int main(void)
     Model cube = LoadModelFromMesh(GenMeshCube(2.0f, 4.0f, 2.0f));
     Model sphere = LoadModelFromMesh(GenMeshSphere(1.0f, 16.0f, 12.0f));
 
-    // Load basic lighting shader
-    Shader shader = LoadShader(TextFormat("D:\\Tools\\raylib\\examples\\shaders\\resources\\shaders\\glsl330\\lighting.vs", GLSL_VERSION),
-                               TextFormat("D:\\Tools\\raylib\\examples\\shaders\\resources\\shaders\\glsl330\\lighting.fs", GLSL_VERSION));
+    // Load basic lighting shader, lights and materials come from uniform blocks (see rlights.h)
+    Shader shader = LoadShader("../lighting.vs", "../lighting.fs");
 
-    MyMaterial obsidian {0.05375, 0.05, 0.06625, 0.18275, 0.17, 0.22525, 0.332741, 0.328634, 0.346435, 1};
-    MyMaterial emerald {0.0215, 0.1745, 0.0215, 0.07568, 0.61424, 0.07568, 0.633, 0.727811, 0.633, 0.1};
+    // Both materials go up once, keys only switch materialIndex
+    MyMaterial materials[2] = {
+        {0.05375, 0.05, 0.06625, 0.18275, 0.17, 0.22525, 0.332741, 0.328634, 0.346435, 1, 1},     // Obsidian
+        {0.0215, 0.1745, 0.0215, 0.07568, 0.61424, 0.07568, 0.633, 0.727811, 0.633, 0.1, 1}       // Emerald
+    };
+    MaterialBlock materialBlock = LoadMaterialBlock(shader, 1);
+    UpdateMaterialBlock(&materialBlock, materials, 2);
 
-    MyMaterial* currentMaterial = &obsidian;
+    int materialIndex = 0;
+    int materialIndexLoc = GetShaderLocation(shader, "materialIndex");
+
+    // Uniforms go through the cache, unchanged values are not sent again
+    UniformCache uniforms = LoadUniformCache(shader);
     // Get some required shader locations
     shader.locs[SHADER_LOC_VECTOR_VIEW] = GetShaderLocation(shader, "viewPos");
     // NOTE: "matModel" location name is automatically assigned on shader loading,
@@ -74,7 +92,7 @@ int main(void)
     // Ambient light level (some basic lighting)
     float val[4] = { 0.1f, 0.1f, 0.1f, 1.0f };
     int ambientLoc = GetShaderLocation(shader, "ambient");
-    SetShaderValue(shader, ambientLoc, val, SHADER_UNIFORM_VEC4);
+    SetCachedShaderValue(&uniforms, ambientLoc, val, SHADER_UNIFORM_VEC4);
 
     auto texture1 = LoadTexture("..\\img.png");
     auto texture2 = LoadTexture("..\\bomb.png");
@@ -90,6 +108,11 @@ int main(void)
     // Create light
     Vector3 lightPos = { -2, 1, -2 };
     Light light = CreateLight(LIGHT_POINT, lightPos, Vector3Zero(), WHITE, shader);
+    LightBlock lightBlock = LoadLightBlock(shader, 0);
+
+    // HUD text shaped once, the uploads line only reshapes its numbers
+    TextRun helpText = LoadTextRunDefault("Use Tab to toggle light\n\nUse [W][A][S][D][Shift][Ctrl] to move the light\n\nUse [R][G][B][F] to change light color", 20);
+    TextRun uploadsText = LoadTextRunDefault("", 20);
 
     SetTargetFPS(60);                   // Set our game to run at 60 frames-per-second
     //--------------------------------------------------------------------------------------
@@ -119,28 +142,34 @@ int main(void)
             DisableCursor();
         }
 
+        ResetUniformCacheStats(&uniforms);
+
         // Update the shader with the camera view vector (points towards { 0.0f, 0.0f, 0.0f })
         float cameraPos[3] = { camera.position.x, camera.position.y, camera.position.z };
-        SetShaderValue(shader, shader.locs[SHADER_LOC_VECTOR_VIEW], cameraPos, SHADER_UNIFORM_VEC3);
+        SetCachedShaderValue(&uniforms, shader.locs[SHADER_LOC_VECTOR_VIEW], cameraPos, SHADER_UNIFORM_VEC3);
 
         // Check key inputs
-        if (IsKeyPressed(KEY_TAB)) { light.enabled = !light.enabled; }
-        if (IsKeyDown(KEY_A)) { light.position.x += .1f; }
-        if (IsKeyDown(KEY_D)) { light.position.x -= .1f; }
-        if (IsKeyDown(KEY_S)) { light.position.z -= .1f; }
-        if (IsKeyDown(KEY_W)) { light.position.z += .1f; }
-        if (IsKeyDown(KEY_LEFT_SHIFT)) { light.position.y += .1f; }
-        if (IsKeyDown(KEY_LEFT_CONTROL)) { light.position.y -= .1f; }
-        if(IsKeyPressed(KEY_R)) { light.color = RED; }
-        if(IsKeyPressed(KEY_G)) { light.color = GREEN; }
-        if(IsKeyPressed(KEY_B)) { light.color = BLUE; }
-        if(IsKeyPressed(KEY_F)) { light.color = WHITE; }
-        if(IsKeyPressed(KEY_ONE)) {currentMaterial = &obsidian; }
-        if(IsKeyPressed(KEY_TWO)) {currentMaterial = &emerald; }
-
-        // Update light/material values
-        UpdateLightValues(shader, light);
-        UpdateMaterialValues(*currentMaterial, shader);
+        if (IsKeyPressed(KEY_TAB)) { light.enabled = !light.enabled; light.dirty = true; }
+        if (IsKeyDown(KEY_A)) { light.position.x += .1f; light.dirty = true; }
+        if (IsKeyDown(KEY_D)) { light.position.x -= .1f; light.dirty = true; }
+        if (IsKeyDown(KEY_S)) { light.position.z -= .1f; light.dirty = true; }
+        if (IsKeyDown(KEY_W)) { light.position.z += .1f; light.dirty = true; }
+        if (IsKeyDown(KEY_LEFT_SHIFT)) { light.position.y += .1f; light.dirty = true; }
+        if (IsKeyDown(KEY_LEFT_CONTROL)) { light.position.y -= .1f; light.dirty = true; }
+        if(IsKeyPressed(KEY_R)) { light.color = RED; light.dirty = true; }
+        if(IsKeyPressed(KEY_G)) { light.color = GREEN; light.dirty = true; }
+        if(IsKeyPressed(KEY_B)) { light.color = BLUE; light.dirty = true; }
+        if(IsKeyPressed(KEY_F)) { light.color = WHITE; light.dirty = true; }
+        if(IsKeyPressed(KEY_ONE)) materialIndex = 0;
+        if(IsKeyPressed(KEY_TWO)) materialIndex = 1;
+
+        // Update light block only when the light changed, material is one cached int
+        if (light.dirty)
+        {
+            UpdateLightBlock(&lightBlock, &light, 1);
+            light.dirty = false;
+        }
+        SetCachedShaderValue(&uniforms, materialIndexLoc, &materialIndex, SHADER_UNIFORM_INT);
         //----------------------------------------------------------------------------------
 
         // Draw
@@ -165,7 +194,10 @@ int main(void)
 
         DrawFPS(10, 10);
 
-        DrawText("Use Tab to toggle light\n\nUse [W][A][S][D][Shift][Ctrl] to move the light\n\nUse [R][G][B][F] to change light color", 10, 40, 20, DARKGRAY);
+        SetTextRunText(&uploadsText, TextFormatLocal("Uniform uploads: %i issued, %i skipped", uniforms.uploadsIssued, uniforms.uploadsSkipped));
+        DrawTextRun(uploadsText, Vector2{10, 180}, DARKGRAY);
+
+        DrawTextRun(helpText, Vector2{10, 40}, DARKGRAY);
 
         EndDrawing();
         //----------------------------------------------------------------------------------
@@ -175,6 +207,11 @@ int main(void)
     //--------------------------------------------------------------------------------------
     UnloadModel(model);     // Unload the model
     UnloadModel(cube);      // Unload the model
+    UnloadLightBlock(&lightBlock);
+    UnloadMaterialBlock(&materialBlock);
+    UnloadUniformCache(&uniforms);
+    UnloadTextRun(&helpText);
+    UnloadTextRun(&uploadsText);
     UnloadShader(shader);   // Unload shader
 
     CloseWindow();          // Close window and OpenGL context
@@ -0,0 +1,444 @@
+/**********************************************************************************************
+*
+*   raylib.textrun - Cached text layout, glyph runs drawn in one submission
+*
+*   DESCRIPTION:
+*       DrawTextEx() decodes UTF-8, searches the glyph of every codepoint and goes through
+*       DrawTextCodepoint()/DrawTexturePro() per character, every frame, for text that mostly
+*       never changes. A TextRun shapes the string once into a glyph run (pen positions, scaled
+*       glyph quads, atlas texcoords) and DrawTextRun() submits all quads in a single
+*       rlBegin()/rlEnd() with one texture set.
+*
+*       SetTextRunText() only lays out again from the first changed byte: every codepoint keeps
+*       the layout state it starts with, so "Frame time: 16.67 ms" keeps "Frame time: " and
+*       shapes the digits only. Unchanged text costs one string compare.
+*
+*       Vertices are the ones DrawTextEx() gives, computed in the same order (positions are
+*       stored relative to the pen and added to the draw position the way rtext does), and
+*       MeasureTextRun() gives MeasureTextEx(). Glyphs are found with the font lookup of rglyphs.h
+*       and line spacing comes from SetGlyphLineSpacing(), which sets rtext's as well.
+*
+*           TextRun help = LoadTextRunDefault("Use Tab to toggle light", 20);     // DrawText() sizes
+*           TextRun stats = LoadTextRunDefault("", 20);
+*           ...
+*           SetTextRunText(&stats, TextFormatLocal("Uploads: %i", uploads));      // Digits only
+*           DrawTextRun(help, (Vector2){ 10, 40 }, DARKGRAY);
+*           DrawTextRun(stats, (Vector2){ 10, 60 }, DARKGRAY);
+*
+*   CONFIGURATION:
+*
+*   #define RTEXTRUN_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+*   NOTE: The run keeps a copy of the Font struct, not of its data: unload runs before their font
+*
+**********************************************************************************************/
+
+#ifndef RTEXTRUN_H
+#define RTEXTRUN_H
+
+#include "raylib.h"
+#include "rglyphs.h"            // Required for: GetFontGlyphIndex(), GetGlyphLineSpacing()
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Glyph quad, positions relative to the pen (scaled), texcoords final
+typedef struct {
+    float penX, penY;           // Pen position, relative to the run position
+    float offsetX, offsetY;     // Scaled glyph offset
+    float width, height;        // Scaled quad size, padding included
+    float u0, v0, u1, v1;       // Atlas texcoords
+} TextRunGlyph;
+
+// Layout state at the start of a codepoint, relayout resumes from it
+typedef struct {
+    int byteOffset;             // Codepoint position in text
+    int firstGlyph;             // Glyphs emitted before it
+    float offsetX;              // DrawTextEx() pen
+    int offsetY;
+    float lineWidth;            // MeasureTextEx() accumulators
+    float maxWidth;
+    int lineCount;
+    int maxCount;
+    float height;
+} TextRunPen;
+
+// Shaped text
+typedef struct {
+    Font font;                  // Font used for shaping (not owned)
+    float fontSize;
+    float spacing;
+    int lineSpacing;
+
+    char *text;                 // Shaped text copy
+    int length;
+    int textCapacity;
+
+    TextRunPen *pens;           // One per codepoint plus the end state
+    int codepointCount;
+    int penCapacity;
+
+    TextRunGlyph *glyphs;       // Visible glyphs
+    int glyphCount;
+    int glyphCapacity;
+
+    Vector2 size;               // MeasureTextEx() result
+    int shapedCodepoints;       // Codepoints shaped by the last update (0 when unchanged)
+} TextRun;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+TextRun LoadTextRun(Font font, const char *text, float fontSize, float spacing);    // Shape text with font
+TextRun LoadTextRunDefault(const char *text, int fontSize);             // Shape text like DrawText() (default font, size and spacing)
+void UnloadTextRun(TextRun *run);                                       // Unload run data
+void SetTextRunText(TextRun *run, const char *text);                    // Change text, shapes from the first changed byte
+void DrawTextRun(TextRun run, Vector2 position, Color tint);            // Draw run, one texture set and one quad batch
+Vector2 MeasureTextRun(TextRun run);                                    // Get run size, like MeasureTextEx()
+void BenchmarkTextRuns(int labelCount, int frames);                     // Compare DrawText() against cached and updated runs
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RTEXTRUN_H
+
+
+/***********************************************************************************
+*
+*   RTEXTRUN IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RTEXTRUN_IMPLEMENTATION) && !defined(RTEXTRUN_IMPLEMENTATION_DEFINED)
+#define RTEXTRUN_IMPLEMENTATION_DEFINED
+
+#include "rlgl.h"
+
+#include <chrono>               // Required for: std::chrono::steady_clock
+#include <stdio.h>              // Required for: snprintf()
+#include <stdlib.h>             // Required for: malloc(), realloc(), free()
+#include <string.h>             // Required for: memcpy(), strlen()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define TEXTRUN_DRAW_CHUNK      1024        // Glyphs per rlBegin()/rlEnd(), below the rlgl batch size
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static double GetTextRunTime(void);
+static void ShapeTextRun(TextRun *run, int fromCodepoint);
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Shape text with font
+TextRun LoadTextRun(Font font, const char *text, float fontSize, float spacing)
+{
+    TextRun run = { 0 };
+
+    run.font = (font.texture.id == 0)? GetFontDefault() : font;     // Same fallback as DrawTextEx()
+    run.fontSize = fontSize;
+    run.spacing = spacing;
+    run.lineSpacing = GetGlyphLineSpacing();
+
+    SetTextRunText(&run, (text != NULL)? text : "");
+
+    return run;
+}
+
+// Shape text like DrawText() (default font, size and spacing)
+TextRun LoadTextRunDefault(const char *text, int fontSize)
+{
+    int defaultFontSize = 10;   // Default Font chars height in pixel
+    if (fontSize < defaultFontSize) fontSize = defaultFontSize;
+    int spacing = fontSize/defaultFontSize;
+
+    return LoadTextRun(GetFontDefault(), text, (float)fontSize, (float)spacing);
+}
+
+// Unload run data
+void UnloadTextRun(TextRun *run)
+{
+    free(run->text);
+    free(run->pens);
+    free(run->glyphs);
+
+    *run = (TextRun){ 0 };
+}
+
+// Change text, shapes from the first changed byte
+void SetTextRunText(TextRun *run, const char *text)
+{
+    if (text == NULL) text = "";
+
+    int length = (int)strlen(text);
+    int prefix = 0;
+    int common = (length < run->length)? length : run->length;
+    while ((prefix < common) && (run->text[prefix] == text[prefix])) prefix++;
+
+    run->shapedCodepoints = 0;
+    if ((prefix == length) && (length == run->length) && (run->pens != NULL)) return;
+
+    if (length + 1 > run->textCapacity)
+    {
+        run->textCapacity = 2*(length + 1);
+        run->text = (char *)realloc(run->text, run->textCapacity);
+    }
+    memcpy(run->text + prefix, text + prefix, length - prefix + 1);
+    run->length = length;
+
+    // Resume from the last codepoint starting at or before the first changed byte
+    int from = 0;
+    if (run->pens != NULL)
+    {
+        int low = 0;
+        int high = run->codepointCount;
+        while (low < high)
+        {
+            int mid = (low + high + 1)/2;
+            if (run->pens[mid].byteOffset <= prefix) low = mid;
+            else high = mid - 1;
+        }
+        from = low;
+    }
+
+    ShapeTextRun(run, from);
+}
+
+// Draw run, one texture set and one quad batch
+void DrawTextRun(TextRun run, Vector2 position, Color tint)
+{
+    if ((run.glyphCount == 0) || (run.font.texture.id == 0)) return;
+
+    float padding = (float)run.font.glyphPadding*(run.fontSize/run.font.baseSize);
+
+    for (int start = 0; start < run.glyphCount; start += TEXTRUN_DRAW_CHUNK)
+    {
+        int end = (start + TEXTRUN_DRAW_CHUNK < run.glyphCount)? start + TEXTRUN_DRAW_CHUNK : run.glyphCount;
+
+        rlCheckRenderBatchLimit(4*(end - start));
+        rlSetTexture(run.font.texture.id);
+        rlBegin(RL_QUADS);
+
+            rlColor4ub(tint.r, tint.g, tint.b, tint.a);
+            rlNormal3f(0.0f, 0.0f, 1.0f);                          // Normal vector pointing towards viewer
+
+            for (int i = start; i < end; i++)
+            {
+                const TextRunGlyph *glyph = &run.glyphs[i];
+
+                // Same operations as DrawTextEx() -> DrawTextCodepoint() -> DrawTexturePro()
+                float x = (position.x + glyph->penX) + glyph->offsetX - padding;
+                float y = (position.y + glyph->penY) + glyph->offsetY - padding;
+
+                rlTexCoord2f(glyph->u0, glyph->v0);
+                rlVertex2f(x, y);
+                rlTexCoord2f(glyph->u0, glyph->v1);
+                rlVertex2f(x, y + glyph->height);
+                rlTexCoord2f(glyph->u1, glyph->v1);
+                rlVertex2f(x + glyph->width, y + glyph->height);
+                rlTexCoord2f(glyph->u1, glyph->v0);
+                rlVertex2f(x + glyph->width, y);
+            }
+
+        rlEnd();
+        rlSetTexture(0);
+    }
+}
+
+// Get run size, like MeasureTextEx()
+Vector2 MeasureTextRun(TextRun run)
+{
+    return run.size;
+}
+
+// Compare DrawText() against cached and updated runs
+// NOTE: Needs a window, labels are drawn in a hidden frame each iteration
+void BenchmarkTextRuns(int labelCount, int frames)
+{
+    TextRun *runs = (TextRun *)malloc(labelCount*sizeof(TextRun));
+    char label[64] = { 0 };
+
+    for (int i = 0; i < labelCount; i++)
+    {
+        snprintf(label, sizeof(label), "Label %05i: pos %i, %i [static]", i, (i*37)%1000, (i*91)%1000);
+        runs[i] = LoadTextRunDefault(label, 10);
+    }
+
+    const char *names[3] = { "DrawText()", "TextRun cached", "TextRun updated" };
+    double times[3] = { 0 };
+    int shaped = 0;
+
+    for (int mode = 0; mode < 3; mode++)
+    {
+        for (int frame = 0; frame < frames; frame++)
+        {
+            BeginDrawing();
+            ClearBackground(RAYWHITE);
+
+            double start = GetTextRunTime();
+            for (int i = 0; i < labelCount; i++)
+            {
+                Vector2 position = { (float)((i*37)%1000), (float)((i*91)%1000) };
+
+                if (mode == 0)
+                {
+                    snprintf(label, sizeof(label), "Label %05i: pos %i, %i [static]", i, (i*37)%1000, (i*91)%1000);
+                    DrawText(label, (int)position.x, (int)position.y, 10, DARKGRAY);
+                }
+                else
+                {
+                    // Updated: a frame counter at the end of every label, rest of the text unchanged
+                    if (mode == 2)
+                    {
+                        snprintf(label, sizeof(label), "Label %05i: pos %i, %i [%i]", i, (i*37)%1000, (i*91)%1000, frame);
+                        SetTextRunText(&runs[i], label);
+                        shaped += runs[i].shapedCodepoints;
+                    }
+
+                    DrawTextRun(runs[i], position, DARKGRAY);
+                }
+            }
+            rlDrawRenderBatchActive();
+            times[mode] += GetTextRunTime() - start;
+
+            EndDrawing();
+        }
+    }
+
+    for (int mode = 0; mode < 3; mode++)
+    {
+        TraceLog(LOG_INFO, "BENCH: [%i labels] %-16s %8.3f ms/frame (%5.1fx)", labelCount, names[mode], times[mode]*1000.0/frames, times[0]/times[mode]);
+    }
+    TraceLog(LOG_INFO, "BENCH: [%i labels] updated runs shaped %.1f codepoints per label per frame", labelCount, (double)shaped/labelCount/frames);
+
+    for (int i = 0; i < labelCount; i++) UnloadTextRun(&runs[i]);
+    free(runs);
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Monotonic time in seconds
+static double GetTextRunTime(void)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Shape text from codepoint fromCodepoint, earlier pens and glyphs are kept
+// NOTE: Layout follows DrawTextEx(), measurement follows MeasureTextEx()
+static void ShapeTextRun(TextRun *run, int fromCodepoint)
+{
+    Font font = run->font;
+    float scaleFactor = run->fontSize/font.baseSize;        // Character quad scaling factor
+    float padding = (float)font.glyphPadding;
+    float textureWidth = (float)font.texture.width;
+    float textureHeight = (float)font.texture.height;
+
+    TextRunPen state = { 0 };
+    if ((run->pens != NULL) && (fromCodepoint > 0)) state = run->pens[fromCodepoint];
+    else
+    {
+        fromCodepoint = 0;
+        state.height = (float)font.baseSize;
+    }
+
+    int count = fromCodepoint;
+    run->glyphCount = state.firstGlyph;
+
+    for (int i = state.byteOffset; i <= run->length;)
+    {
+        state.firstGlyph = run->glyphCount;
+
+        if (count + 1 > run->penCapacity)
+        {
+            run->penCapacity = 2*(count + 1);
+            run->pens = (TextRunPen *)realloc(run->pens, run->penCapacity*sizeof(TextRunPen));
+        }
+        run->pens[count] = state;
+
+        if (i == run->length) break;    // End state stored, it gives the size
+
+        int codepointByteCount = 0;
+        int codepoint = GetCodepointNext(&run->text[i], &codepointByteCount);
+        int index = GetFontGlyphIndex(font, codepoint);
+
+        // MeasureTextEx()
+        state.lineCount++;
+        if (codepoint != '\n')
+        {
+            if (font.glyphs[index].advanceX != 0) state.lineWidth += font.glyphs[index].advanceX;
+            else state.lineWidth += (font.recs[index].width + font.glyphs[index].offsetX);
+        }
+        else
+        {
+            if (state.maxWidth < state.lineWidth) state.maxWidth = state.lineWidth;
+            state.lineCount = 0;
+            state.lineWidth = 0;
+            state.height += (float)run->lineSpacing;
+        }
+        if (state.maxCount < state.lineCount) state.maxCount = state.lineCount;
+
+        // DrawTextEx()
+        if (codepoint == '\n')
+        {
+            state.offsetY += run->lineSpacing;
+            state.offsetX = 0.0f;
+        }
+        else
+        {
+            if ((codepoint != ' ') && (codepoint != '\t'))
+            {
+                if (run->glyphCount + 1 > run->glyphCapacity)
+                {
+                    run->glyphCapacity = (run->glyphCapacity > 0)? 2*run->glyphCapacity : 16;
+                    run->glyphs = (TextRunGlyph *)realloc(run->glyphs, run->glyphCapacity*sizeof(TextRunGlyph));
+                }
+
+                Rectangle rec = font.recs[index];
+                Rectangle source = { rec.x - padding, rec.y - padding, rec.width + 2.0f*padding, rec.height + 2.0f*padding };
+                TextRunGlyph *glyph = &run->glyphs[run->glyphCount++];
+
+                glyph->penX = state.offsetX;
+                glyph->penY = (float)state.offsetY;
+                glyph->offsetX = font.glyphs[index].offsetX*scaleFactor;
+                glyph->offsetY = font.glyphs[index].offsetY*scaleFactor;
+                glyph->width = (rec.width + 2.0f*font.glyphPadding)*scaleFactor;
+                glyph->height = (rec.height + 2.0f*font.glyphPadding)*scaleFactor;
+                glyph->u0 = source.x/textureWidth;
+                glyph->v0 = source.y/textureHeight;
+                glyph->u1 = (source.x + source.width)/textureWidth;
+                glyph->v1 = (source.y + source.height)/textureHeight;
+            }
+
+            if (font.glyphs[index].advanceX == 0) state.offsetX += ((float)font.recs[index].width*scaleFactor + run->spacing);
+            else state.offsetX += ((float)font.glyphs[index].advanceX*scaleFactor + run->spacing);
+        }
+
+        state.byteOffset = i + codepointByteCount;
+        i += codepointByteCount;
+        count++;
+    }
+
+    run->codepointCount = count;
+    run->shapedCodepoints = count - fromCodepoint;
+
+    float maxWidth = (state.maxWidth < state.lineWidth)? state.lineWidth : state.maxWidth;
+    run->size.x = maxWidth*scaleFactor + (float)((state.maxCount - 1)*run->spacing);
+    run->size.y = state.height*scaleFactor;
+}
+
+#endif // RTEXTRUN_IMPLEMENTATION
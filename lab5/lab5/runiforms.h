@@ -0,0 +1,193 @@
+/**********************************************************************************************
+*
+*   raylib.uniforms - Shader uniform cache, skips uploads of unchanged values
+*
+*   DESCRIPTION:
+*       A cache per shader keeps a CPU copy of the last value sent to every uniform location.
+*       SetCachedShaderValue() compares against it and only calls SetShaderValueV() when the
+*       value, type or count changed. Counters tell how many uploads were issued and skipped.
+*
+*       Values set with SetShaderValue() directly bypass the cache, call InvalidateUniformCache()
+*       afterwards so the next cached set uploads again.
+*
+*   CONFIGURATION:
+*
+*   #define RUNIFORMS_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+**********************************************************************************************/
+
+#ifndef RUNIFORMS_H
+#define RUNIFORMS_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define UNIFORM_CACHE_VALUE_SIZE    64      // Max bytes cached per location, bigger values always upload
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Last value sent to a uniform location
+typedef struct {
+    int type;                               // ShaderUniformDataType, -1 if nothing cached
+    int count;
+    unsigned char value[UNIFORM_CACHE_VALUE_SIZE];
+} UniformSlot;
+
+// Uniform cache for one shader
+typedef struct {
+    Shader shader;
+    UniformSlot *slots;                     // Indexed by uniform location
+    int slotCount;
+
+    int uploadsIssued;                      // Values sent to the shader
+    int uploadsSkipped;                     // Values equal to the cached ones
+} UniformCache;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+UniformCache LoadUniformCache(Shader shader);                                                   // Create empty uniform cache for shader
+void UnloadUniformCache(UniformCache *cache);                                                   // Unload uniform cache (shader is not owned)
+bool SetCachedShaderValue(UniformCache *cache, int locIndex, const void *value, int uniformType);   // Set uniform if changed, returns true if uploaded
+bool SetCachedShaderValueV(UniformCache *cache, int locIndex, const void *value, int uniformType, int count); // Set uniform array if changed, returns true if uploaded
+void InvalidateUniformCache(UniformCache *cache);                                               // Forget cached values, next sets upload
+void ResetUniformCacheStats(UniformCache *cache);                                               // Reset issued/skipped counters
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RUNIFORMS_H
+
+
+/***********************************************************************************
+*
+*   RUNIFORMS IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RUNIFORMS_IMPLEMENTATION) && !defined(RUNIFORMS_IMPLEMENTATION_DEFINED)
+#define RUNIFORMS_IMPLEMENTATION_DEFINED    // Other modules include this header too
+
+#include <stdlib.h>             // Required for: realloc(), free()
+#include <string.h>             // Required for: memcmp(), memcpy()
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static int GetUniformTypeSize(int uniformType);
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Create empty uniform cache for shader
+UniformCache LoadUniformCache(Shader shader)
+{
+    UniformCache cache = { 0 };
+    cache.shader = shader;
+
+    return cache;
+}
+
+// Unload uniform cache
+void UnloadUniformCache(UniformCache *cache)
+{
+    free(cache->slots);
+
+    cache->slots = NULL;
+    cache->slotCount = 0;
+}
+
+// Set uniform if changed, returns true if uploaded
+bool SetCachedShaderValue(UniformCache *cache, int locIndex, const void *value, int uniformType)
+{
+    return SetCachedShaderValueV(cache, locIndex, value, uniformType, 1);
+}
+
+// Set uniform array if changed, returns true if uploaded
+// NOTE: Missing locations (-1) are ignored and not counted
+bool SetCachedShaderValueV(UniformCache *cache, int locIndex, const void *value, int uniformType, int count)
+{
+    if (locIndex < 0) return false;
+
+    int size = GetUniformTypeSize(uniformType)*count;
+
+    if (size <= UNIFORM_CACHE_VALUE_SIZE)
+    {
+        if (locIndex >= cache->slotCount)
+        {
+            int slotCount = (cache->slotCount == 0)? 16 : cache->slotCount;
+            while (slotCount <= locIndex) slotCount *= 2;
+
+            cache->slots = (UniformSlot *)realloc(cache->slots, slotCount*sizeof(UniformSlot));
+            for (int i = cache->slotCount; i < slotCount; i++) cache->slots[i].type = -1;
+            cache->slotCount = slotCount;
+        }
+
+        UniformSlot *slot = &cache->slots[locIndex];
+
+        if ((slot->type == uniformType) && (slot->count == count) && (memcmp(slot->value, value, size) == 0))
+        {
+            cache->uploadsSkipped++;
+            return false;
+        }
+
+        slot->type = uniformType;
+        slot->count = count;
+        memcpy(slot->value, value, size);
+    }
+
+    SetShaderValueV(cache->shader, locIndex, value, uniformType, count);
+    cache->uploadsIssued++;
+
+    return true;
+}
+
+// Forget cached values, next sets upload
+void InvalidateUniformCache(UniformCache *cache)
+{
+    for (int i = 0; i < cache->slotCount; i++) cache->slots[i].type = -1;
+}
+
+// Reset issued/skipped counters
+void ResetUniformCacheStats(UniformCache *cache)
+{
+    cache->uploadsIssued = 0;
+    cache->uploadsSkipped = 0;
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Get size in bytes of one uniform value
+static int GetUniformTypeSize(int uniformType)
+{
+    switch (uniformType)
+    {
+        case SHADER_UNIFORM_FLOAT: return 4;
+        case SHADER_UNIFORM_VEC2: return 8;
+        case SHADER_UNIFORM_VEC3: return 12;
+        case SHADER_UNIFORM_VEC4: return 16;
+        case SHADER_UNIFORM_INT: return 4;
+        case SHADER_UNIFORM_IVEC2: return 8;
+        case SHADER_UNIFORM_IVEC3: return 12;
+        case SHADER_UNIFORM_IVEC4: return 16;
+        case SHADER_UNIFORM_SAMPLER2D: return 4;
+        default: return 4;
+    }
+}
+
+#endif // RUNIFORMS_IMPLEMENTATION
@@ -24,6 +24,12 @@
 
 #define RLIGHTS_IMPLEMENTATION
 #include "rlights.h"
+#define RGLYPHS_IMPLEMENTATION
+#include "rglyphs.h"
+#define RTEXTRUN_IMPLEMENTATION
+#include "rtextrun.h"
+#define RTEXTFMT_IMPLEMENTATION
+#include "rtextfmt.h"
 
 #if defined(PLATFORM_DESKTOP)
 #define GLSL_VERSION            330
@@ -58,8 +64,8 @@ int main(void)
     Model sphere = LoadModelFromMesh(GenMeshSphere(1.0f, 16.0f, 12.0f));
     //model;
 
-    Shader shader = LoadShader(TextFormat("D:\\Tools\\raylib\\examples\\shaders\\resources\\shaders\\glsl%i\\lighting.vs", GLSL_VERSION),
-                               TextFormat("D:\\Tools\\raylib\\examples\\shaders\\resources\\shaders\\glsl%i\\fog.fs", GLSL_VERSION));
+    Shader shader = LoadShader(TextFormatLocal("D:\\Tools\\raylib\\examples\\shaders\\resources\\shaders\\glsl%i\\lighting.vs", GLSL_VERSION),
+                               TextFormatLocal("D:\\Tools\\raylib\\examples\\shaders\\resources\\shaders\\glsl%i\\fog.fs", GLSL_VERSION));
     shader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocation(shader, "matModel");
     shader.locs[SHADER_LOC_VECTOR_VIEW] = GetShaderLocation(shader, "viewPos");
 
@@ -89,6 +95,9 @@ int main(void)
 
     auto blendType = BLEND_ALPHA;
 
+    // Help text shaped once, only the fog density at its end is shaped again when it changes
+    TextRun helpText = LoadTextRunDefault("", 14);
+
     SetTargetFPS(60);                   // Set our game to run at 60 frames-per-second
     //--------------------------------------------------------------------------------------
 
@@ -180,7 +189,8 @@ int main(void)
 
         DrawFPS(10, 10);
 
-        DrawText(TextFormat("Use Tab to toggle light\n\nUse [W][A][S][D][Shift][Ctrl] to move the light\n\nUse [R][G][B][F] to change light color\nUse KEY_MINUS/KEY_EQUAL to change fog density [%.2f]", fogDensity), 10, 40, 14, DARKGRAY);
+        SetTextRunText(&helpText, TextFormatLocal("Use Tab to toggle light\n\nUse [W][A][S][D][Shift][Ctrl] to move the light\n\nUse [R][G][B][F] to change light color\nUse KEY_MINUS/KEY_EQUAL to change fog density [%.2f]", fogDensity));
+        DrawTextRun(helpText, Vector2{10, 40}, DARKGRAY);
 
         EndDrawing();
         //----------------------------------------------------------------------------------
@@ -191,6 +201,7 @@ int main(void)
     UnloadModel(model);     // Unload the model
     UnloadModel(cube);      // Unload the model
     UnloadModel(sphere);
+    UnloadTextRun(&helpText);
     UnloadShader(shader);   // Unload shader
     UnloadTexture(texture1);
     UnloadTexture(texture2);
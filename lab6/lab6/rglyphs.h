@@ -0,0 +1,484 @@
+/**********************************************************************************************
+*
+*   raylib.glyphs - O(1) glyph lookup for fonts
+*
+*   DESCRIPTION:
+*       GetGlyphIndex() scans font.glyphs for every character MeasureTextEx(), DrawTextEx() and
+*       DrawTextCodepoints() handle, so text cost grows with the font: 95 glyphs for ASCII,
+*       thousands for CJK. A GlyphLookup is built once per font:
+*         - Direct table for codepoints 0..255 (ASCII and Latin-1), one load
+*         - Open addressing hash (multiplicative hash, linear probing, load <= 0.5) for the rest
+*       Results are the ones GetGlyphIndex() gives: first glyph with the codepoint, else the last
+*       '?' glyph, else 0.
+*
+*       Fonts keep their lookup in a small registry keyed by the glyphs array, built when the font
+*       is loaded with LoadFontIndexed() or registered (or on first use). The *Indexed() text
+*       functions are the rtext ones going through it, and rtextrun.h shapes with it.
+*
+*       Line spacing: rtext keeps it in a static with no getter, SetGlyphLineSpacing() sets it
+*       there (SetTextLineSpacing()) and keeps the copy *Indexed() functions and text runs use.
+*
+*   CONFIGURATION:
+*
+*   #define RGLYPHS_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+*   NOTE: Lookups are found by glyphs pointer, unload registered fonts with UnloadFontIndexed()
+*   (or UnregisterFontLookup() before UnloadFont()) so a new font at the same address can't hit it
+*
+**********************************************************************************************/
+
+#ifndef RGLYPHS_H
+#define RGLYPHS_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define GLYPH_LOOKUP_DIRECT      256        // Codepoints with a direct table entry
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Codepoint to glyph index lookup for one font
+typedef struct {
+    const GlyphInfo *glyphs;    // Glyphs the lookup was built for
+    int glyphCount;
+    int fallbackIndex;          // Index returned for missing codepoints
+    int direct[GLYPH_LOOKUP_DIRECT];    // Index per codepoint below 256, -1 if missing
+    int *keys;                  // Hash codepoints, -1 for empty slots
+    int *values;                // Hash glyph indices
+    int hashMask;               // Slots - 1 (power of two)
+    int hashShift;              // 32 - log2(slots)
+} GlyphLookup;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+GlyphLookup LoadGlyphLookup(Font font);                                 // Build lookup for font glyphs
+void UnloadGlyphLookup(GlyphLookup *lookup);                            // Unload lookup data
+int GetGlyphLookupIndex(const GlyphLookup *lookup, int codepoint);      // Get glyph index, same result as GetGlyphIndex()
+
+Font LoadFontIndexed(const char *fileName, int fontSize, int *codepoints, int codepointCount);   // LoadFontEx() and register its lookup
+void UnloadFontIndexed(Font font);                                      // Unregister lookup and UnloadFont()
+void RegisterFontLookup(Font font);                                     // Build and register lookup for a loaded font
+void UnregisterFontLookup(Font font);                                   // Unload registered lookup of font
+int GetFontGlyphIndex(Font font, int codepoint);                        // GetGlyphIndex() through the registered lookup (registered on first use)
+
+void SetGlyphLineSpacing(int spacing);                                  // Set line spacing, rtext (SetTextLineSpacing()) and this module
+int GetGlyphLineSpacing(void);                                          // Get line spacing set with SetGlyphLineSpacing() (default 15)
+Vector2 MeasureTextExIndexed(Font font, const char *text, float fontSize, float spacing);        // MeasureTextEx() with the lookup
+void DrawTextExIndexed(Font font, const char *text, Vector2 position, float fontSize, float spacing, Color tint);    // DrawTextEx() with the lookup
+void DrawTextCodepointIndexed(Font font, int codepoint, Vector2 position, float fontSize, Color tint);              // DrawTextCodepoint() with the lookup
+void DrawTextCodepointsIndexed(Font font, const int *codepoints, int codepointCount, Vector2 position, float fontSize, float spacing, Color tint);  // DrawTextCodepoints() with the lookup
+
+void BenchmarkGlyphLookup(int glyphCount, int lookups);                 // Compare GetGlyphIndex() and the lookup on a glyphCount font
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RGLYPHS_H
+
+
+/***********************************************************************************
+*
+*   RGLYPHS IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RGLYPHS_IMPLEMENTATION) && !defined(RGLYPHS_IMPLEMENTATION_DEFINED)
+#define RGLYPHS_IMPLEMENTATION_DEFINED
+
+#include <chrono>               // Required for: std::chrono::steady_clock
+#include <stdlib.h>             // Required for: malloc(), calloc(), free()
+#include <string.h>             // Required for: memset()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define GLYPH_LOOKUP_MAX_FONTS      16      // Registered fonts
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static GlyphLookup glyphLookups[GLYPH_LOOKUP_MAX_FONTS] = { 0 };
+static int glyphLookupLast = 0;             // Last registry hit, text is drawn font by font
+static int glyphLineSpacing = 15;           // Same default as rtext textLineSpacing
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static double GetGlyphsTime(void);
+static const GlyphLookup *FindFontLookup(Font font);
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Build lookup for font glyphs
+GlyphLookup LoadGlyphLookup(Font font)
+{
+    GlyphLookup lookup = { 0 };
+
+    lookup.glyphs = font.glyphs;
+    lookup.glyphCount = font.glyphCount;
+    for (int i = 0; i < GLYPH_LOOKUP_DIRECT; i++) lookup.direct[i] = -1;
+
+    // Hash slots: power of two, at least twice the glyphs above the direct range
+    int hashed = 0;
+    for (int i = 0; i < font.glyphCount; i++) if ((font.glyphs[i].value < 0) || (font.glyphs[i].value >= GLYPH_LOOKUP_DIRECT)) hashed++;
+
+    int slotsLog2 = 3;
+    while ((1 << slotsLog2) < 2*hashed) slotsLog2++;
+    lookup.hashMask = (1 << slotsLog2) - 1;
+    lookup.hashShift = 32 - slotsLog2;
+    lookup.keys = (int *)malloc((lookup.hashMask + 1)*sizeof(int));
+    lookup.values = (int *)malloc((lookup.hashMask + 1)*sizeof(int));
+    memset(lookup.keys, 0xff, (lookup.hashMask + 1)*sizeof(int));
+
+    // First glyph wins like the GetGlyphIndex() scan, fallback is the last '?'
+    for (int i = 0; i < font.glyphCount; i++)
+    {
+        int codepoint = font.glyphs[i].value;
+        if (codepoint == 63) lookup.fallbackIndex = i;
+
+        if ((codepoint >= 0) && (codepoint < GLYPH_LOOKUP_DIRECT))
+        {
+            if (lookup.direct[codepoint] < 0) lookup.direct[codepoint] = i;
+            continue;
+        }
+
+        unsigned int slot = ((unsigned int)codepoint*2654435761u) >> lookup.hashShift;
+        while ((lookup.keys[slot] != -1) && (lookup.keys[slot] != codepoint)) slot = (slot + 1) & lookup.hashMask;
+        if (lookup.keys[slot] == -1)
+        {
+            lookup.keys[slot] = codepoint;
+            lookup.values[slot] = i;
+        }
+    }
+
+    // Missing direct entries resolve to the fallback, one load and no branch for them
+    for (int i = 0; i < GLYPH_LOOKUP_DIRECT; i++) if (lookup.direct[i] < 0) lookup.direct[i] = lookup.fallbackIndex;
+
+    return lookup;
+}
+
+// Unload lookup data
+void UnloadGlyphLookup(GlyphLookup *lookup)
+{
+    free(lookup->keys);
+    free(lookup->values);
+
+    *lookup = (GlyphLookup){ 0 };
+}
+
+// Get glyph index, same result as GetGlyphIndex()
+int GetGlyphLookupIndex(const GlyphLookup *lookup, int codepoint)
+{
+    if ((unsigned int)codepoint < GLYPH_LOOKUP_DIRECT) return lookup->direct[codepoint];
+
+    // -1 marks empty slots, glyph values are never negative
+    unsigned int slot = ((unsigned int)codepoint*2654435761u) >> lookup->hashShift;
+    while (lookup->keys[slot] != -1)
+    {
+        if (lookup->keys[slot] == codepoint) return lookup->values[slot];
+        slot = (slot + 1) & lookup->hashMask;
+    }
+
+    return lookup->fallbackIndex;
+}
+
+// LoadFontEx() and register its lookup
+Font LoadFontIndexed(const char *fileName, int fontSize, int *codepoints, int codepointCount)
+{
+    Font font = LoadFontEx(fileName, fontSize, codepoints, codepointCount);
+    if (font.glyphs != NULL) RegisterFontLookup(font);
+
+    return font;
+}
+
+// Unregister lookup and UnloadFont()
+void UnloadFontIndexed(Font font)
+{
+    UnregisterFontLookup(font);
+    UnloadFont(font);
+}
+
+// Build and register lookup for a loaded font
+void RegisterFontLookup(Font font)
+{
+    if ((font.glyphs == NULL) || (FindFontLookup(font) != NULL)) return;
+
+    for (int i = 0; i < GLYPH_LOOKUP_MAX_FONTS; i++)
+    {
+        if (glyphLookups[i].glyphs == NULL)
+        {
+            glyphLookups[i] = LoadGlyphLookup(font);
+            glyphLookupLast = i;
+            return;
+        }
+    }
+
+    TraceLog(LOG_WARNING, "GLYPHS: Lookup registry full (%i fonts), font uses GetGlyphIndex()", GLYPH_LOOKUP_MAX_FONTS);
+}
+
+// Unload registered lookup of font
+void UnregisterFontLookup(Font font)
+{
+    for (int i = 0; i < GLYPH_LOOKUP_MAX_FONTS; i++)
+    {
+        if ((glyphLookups[i].glyphs != NULL) && (glyphLookups[i].glyphs == font.glyphs)) UnloadGlyphLookup(&glyphLookups[i]);
+    }
+}
+
+// GetGlyphIndex() through the registered lookup (registered on first use)
+int GetFontGlyphIndex(Font font, int codepoint)
+{
+    const GlyphLookup *lookup = FindFontLookup(font);
+    if (lookup == NULL)
+    {
+        RegisterFontLookup(font);
+        lookup = FindFontLookup(font);
+        if (lookup == NULL) return GetGlyphIndex(font, codepoint);
+    }
+
+    return GetGlyphLookupIndex(lookup, codepoint);
+}
+
+// Set line spacing, rtext (SetTextLineSpacing()) and this module
+void SetGlyphLineSpacing(int spacing)
+{
+    SetTextLineSpacing(spacing);
+    glyphLineSpacing = spacing;
+}
+
+// Get line spacing set with SetGlyphLineSpacing() (default 15)
+int GetGlyphLineSpacing(void)
+{
+    return glyphLineSpacing;
+}
+
+// MeasureTextEx() with the lookup
+Vector2 MeasureTextExIndexed(Font font, const char *text, float fontSize, float spacing)
+{
+    Vector2 textSize = { 0 };
+
+    if ((font.texture.id == 0) || (text == NULL)) return textSize;
+
+    const GlyphLookup *lookup = FindFontLookup(font);
+    int size = TextLength(text);    // Get size in bytes of text
+    int tempByteCounter = 0;        // Used to count longer text line num chars
+    int byteCounter = 0;
+
+    float textWidth = 0.0f;
+    float tempTextWidth = 0.0f;     // Used to count longer text line width
+
+    float textHeight = (float)font.baseSize;
+    float scaleFactor = fontSize/(float)font.baseSize;
+
+    for (int i = 0; i < size;)
+    {
+        byteCounter++;
+
+        int next = 0;
+        int letter = GetCodepointNext(&text[i], &next);
+        int index = (lookup != NULL)? GetGlyphLookupIndex(lookup, letter) : GetFontGlyphIndex(font, letter);
+
+        i += next;
+
+        if (letter != '\n')
+        {
+            if (font.glyphs[index].advanceX != 0) textWidth += font.glyphs[index].advanceX;
+            else textWidth += (font.recs[index].width + font.glyphs[index].offsetX);
+        }
+        else
+        {
+            if (tempTextWidth < textWidth) tempTextWidth = textWidth;
+            byteCounter = 0;
+            textWidth = 0;
+            textHeight += (float)glyphLineSpacing;
+        }
+
+        if (tempByteCounter < byteCounter) tempByteCounter = byteCounter;
+    }
+
+    if (tempTextWidth < textWidth) tempTextWidth = textWidth;
+
+    textSize.x = tempTextWidth*scaleFactor + (float)((tempByteCounter - 1)*spacing);
+    textSize.y = textHeight*scaleFactor;
+
+    return textSize;
+}
+
+// DrawTextEx() with the lookup
+void DrawTextExIndexed(Font font, const char *text, Vector2 position, float fontSize, float spacing, Color tint)
+{
+    if (font.texture.id == 0) font = GetFontDefault();  // Security check in case of not valid font
+
+    int size = TextLength(text);    // Total size in bytes of the text, scanned by codepoints in loop
+
+    int textOffsetY = 0;            // Offset between lines (on linebreak '\n')
+    float textOffsetX = 0.0f;       // Offset X to next character to draw
+
+    float scaleFactor = fontSize/font.baseSize;         // Character quad scaling factor
+
+    for (int i = 0; i < size;)
+    {
+        int codepointByteCount = 0;
+        int codepoint = GetCodepointNext(&text[i], &codepointByteCount);
+        int index = GetFontGlyphIndex(font, codepoint);
+
+        if (codepoint == '\n')
+        {
+            textOffsetY += glyphLineSpacing;
+            textOffsetX = 0.0f;
+        }
+        else
+        {
+            if ((codepoint != ' ') && (codepoint != '\t'))
+            {
+                DrawTextCodepointIndexed(font, codepoint, (Vector2){ position.x + textOffsetX, position.y + textOffsetY }, fontSize, tint);
+            }
+
+            if (font.glyphs[index].advanceX == 0) textOffsetX += ((float)font.recs[index].width*scaleFactor + spacing);
+            else textOffsetX += ((float)font.glyphs[index].advanceX*scaleFactor + spacing);
+        }
+
+        i += codepointByteCount;   // Move text bytes counter to next codepoint
+    }
+}
+
+// DrawTextCodepoint() with the lookup
+void DrawTextCodepointIndexed(Font font, int codepoint, Vector2 position, float fontSize, Color tint)
+{
+    int index = GetFontGlyphIndex(font, codepoint);
+    float scaleFactor = fontSize/font.baseSize;     // Character quad scaling factor
+
+    Rectangle dstRec = { position.x + font.glyphs[index].offsetX*scaleFactor - (float)font.glyphPadding*scaleFactor,
+                      position.y + font.glyphs[index].offsetY*scaleFactor - (float)font.glyphPadding*scaleFactor,
+                      (font.recs[index].width + 2.0f*font.glyphPadding)*scaleFactor,
+                      (font.recs[index].height + 2.0f*font.glyphPadding)*scaleFactor };
+
+    Rectangle srcRec = { font.recs[index].x - (float)font.glyphPadding, font.recs[index].y - (float)font.glyphPadding,
+                         font.recs[index].width + 2.0f*font.glyphPadding, font.recs[index].height + 2.0f*font.glyphPadding };
+
+    DrawTexturePro(font.texture, srcRec, dstRec, (Vector2){ 0, 0 }, 0.0f, tint);
+}
+
+// DrawTextCodepoints() with the lookup
+void DrawTextCodepointsIndexed(Font font, const int *codepoints, int codepointCount, Vector2 position, float fontSize, float spacing, Color tint)
+{
+    int textOffsetY = 0;            // Offset between lines (on linebreak '\n')
+    float textOffsetX = 0.0f;       // Offset X to next character to draw
+
+    float scaleFactor = fontSize/font.baseSize;         // Character quad scaling factor
+
+    for (int i = 0; i < codepointCount; i++)
+    {
+        int index = GetFontGlyphIndex(font, codepoints[i]);
+
+        if (codepoints[i] == '\n')
+        {
+            textOffsetY += glyphLineSpacing;
+            textOffsetX = 0.0f;
+        }
+        else
+        {
+            if ((codepoints[i] != ' ') && (codepoints[i] != '\t'))
+            {
+                DrawTextCodepointIndexed(font, codepoints[i], (Vector2){ position.x + textOffsetX, position.y + textOffsetY }, fontSize, tint);
+            }
+
+            if (font.glyphs[index].advanceX == 0) textOffsetX += ((float)font.recs[index].width*scaleFactor + spacing);
+            else textOffsetX += ((float)font.glyphs[index].advanceX*scaleFactor + spacing);
+        }
+    }
+}
+
+// Compare GetGlyphIndex() and the lookup on a glyphCount font
+// NOTE: Codepoints are ASCII first, then CJK from U+4E00, lookups hit random glyphs and 1/16 miss
+void BenchmarkGlyphLookup(int glyphCount, int lookups)
+{
+    Font font = { 0 };
+    font.glyphCount = glyphCount;
+    font.glyphs = (GlyphInfo *)calloc(glyphCount, sizeof(GlyphInfo));
+    for (int i = 0; i < glyphCount; i++) font.glyphs[i].value = (i < 95)? 32 + i : 0x4e00 + (i - 95);
+
+    int *codepoints = (int *)malloc(lookups*sizeof(int));
+    unsigned int seed = 12345;
+    for (int i = 0; i < lookups; i++)
+    {
+        seed = seed*1664525u + 1013904223u;
+        codepoints[i] = ((seed >> 28) == 0)? 0x3000 + (int)((seed >> 8) & 255) : font.glyphs[(seed >> 8)%glyphCount].value;
+    }
+
+    GlyphLookup lookup = LoadGlyphLookup(font);
+
+    // The scan is slow on big fonts, time it on fewer lookups
+    int scanLookups = (glyphCount > 1000)? lookups/100 : lookups;
+    int mismatches = 0;
+    long long checksum = 0;
+
+    double start = GetGlyphsTime();
+    for (int i = 0; i < scanLookups; i++) checksum += GetGlyphIndex(font, codepoints[i]);
+    double scanTime = GetGlyphsTime() - start;
+
+    start = GetGlyphsTime();
+    for (int i = 0; i < lookups; i++) checksum += GetGlyphLookupIndex(&lookup, codepoints[i]);
+    double lookupTime = GetGlyphsTime() - start;
+
+    start = GetGlyphsTime();
+    GlyphLookup build = LoadGlyphLookup(font);
+    double buildTime = GetGlyphsTime() - start;
+    UnloadGlyphLookup(&build);
+
+    for (int i = 0; i < scanLookups; i++) mismatches += (GetGlyphIndex(font, codepoints[i]) != GetGlyphLookupIndex(&lookup, codepoints[i]));
+
+    double scanNs = scanTime*1e9/scanLookups;
+    double lookupNs = lookupTime*1e9/lookups;
+    TraceLog(LOG_INFO, "BENCH: [%i glyphs] GetGlyphIndex() %9.1f ns, lookup %6.2f ns (%7.1fx), build %.3f ms, %i hash slots, mismatches: %i (checksum %lld)",
+             glyphCount, scanNs, lookupNs, scanNs/lookupNs, buildTime*1000.0, lookup.hashMask + 1, mismatches, checksum);
+
+    UnloadGlyphLookup(&lookup);
+    free(codepoints);
+    free(font.glyphs);
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Monotonic time in seconds
+static double GetGlyphsTime(void)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Find registered lookup of font, NULL if none
+static const GlyphLookup *FindFontLookup(Font font)
+{
+    const GlyphLookup *last = &glyphLookups[glyphLookupLast];
+    if ((last->glyphs == font.glyphs) && (last->glyphCount == font.glyphCount) && (font.glyphs != NULL)) return last;
+
+    for (int i = 0; i < GLYPH_LOOKUP_MAX_FONTS; i++)
+    {
+        if ((glyphLookups[i].glyphs == font.glyphs) && (glyphLookups[i].glyphCount == font.glyphCount) && (font.glyphs != NULL))
+        {
+            glyphLookupLast = i;
+            return &glyphLookups[i];
+        }
+    }
+
+    return NULL;
+}
+
+#endif // RGLYPHS_IMPLEMENTATION
@@ -9,6 +9,8 @@
 *       If not defined, the library is in header only mode and can be included in other headers 
 *       or source files without problems. But only ONE file should hold the implementation.
 *
+*   NOTE: Requires rtextfmt.h, its implementation must be in the same or another translation unit.
+*
 *   LICENSE: zlib/libpng
 *
 *   Copyright (c) 2017-2024 Victor Fisac (@victorfisac) and Ramon Santamaria (@raysan5)
@@ -104,6 +106,7 @@ void UpdateLightValues(Shader shader, Light light);         // Send light proper
 #if defined(RLIGHTS_IMPLEMENTATION)
 
 #include "raylib.h"
+#include "rtextfmt.h"           // Required for: TextFormatLocal()
 
 //----------------------------------------------------------------------------------
 // Defines and Macros
@@ -143,11 +146,11 @@ Light CreateLight(int type, Vector3 position, Vector3 target, Color color, Shade
         light.color = color;
 
         // NOTE: Lighting shader naming must be the provided ones
-        light.enabledLoc = GetShaderLocation(shader, TextFormat("lights[%i].enabled", lightsCount));
-        light.typeLoc = GetShaderLocation(shader, TextFormat("lights[%i].type", lightsCount));
-        light.positionLoc = GetShaderLocation(shader, TextFormat("lights[%i].position", lightsCount));
-        light.targetLoc = GetShaderLocation(shader, TextFormat("lights[%i].target", lightsCount));
-        light.colorLoc = GetShaderLocation(shader, TextFormat("lights[%i].color", lightsCount));
+        light.enabledLoc = GetShaderLocation(shader, TextFormatLocal("lights[%i].enabled", lightsCount));
+        light.typeLoc = GetShaderLocation(shader, TextFormatLocal("lights[%i].type", lightsCount));
+        light.positionLoc = GetShaderLocation(shader, TextFormatLocal("lights[%i].position", lightsCount));
+        light.targetLoc = GetShaderLocation(shader, TextFormatLocal("lights[%i].target", lightsCount));
+        light.colorLoc = GetShaderLocation(shader, TextFormatLocal("lights[%i].color", lightsCount));
 
         UpdateLightValues(shader, light);
         
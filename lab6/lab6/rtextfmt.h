@@ -0,0 +1,536 @@
+/**********************************************************************************************
+*
+*   raylib.textfmt - Allocation free, thread safe text formatting
+*
+*   DESCRIPTION:
+*       TextFormat() formats into one of 4 static 1 KiB buffers, clearing the whole buffer
+*       (memset) on every call: a fifth outstanding string overwrites the first and two threads
+*       formatting at once write the same buffers. Here text is formatted into an arena:
+*         - TextFormatTo(): caller arena, a fixed buffer (TextArenaFromBuffer()) or allocated
+*           once (LoadTextArena()), strings appended until ResetTextArena() or the arena wraps
+*         - TextFormatLocal(): TextFormat() replacement, per thread ring of TEXTFMT_LOCAL_SIZE
+*           bytes, strings stay valid until the ring wraps
+*       Nothing is cleared, only the formatted bytes and the terminator are written.
+*
+*       Typed fast path: %d %i %u %c %s %% %f and %.Nf (N up to 9) are converted directly,
+*       without the vsnprintf() machinery. Floats are rounded from the exact product with the
+*       power of ten, values within 1e-5 of a rounding tie (or too large) go to snprintf(), so
+*       output is the one printf gives. Any other conversion formats the string with vsnprintf().
+*
+*   CONFIGURATION:
+*
+*   #define RTEXTFMT_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+*   NOTE: Text longer than the arena is truncated ending in "..." like TextFormat()
+*
+**********************************************************************************************/
+
+#ifndef RTEXTFMT_H
+#define RTEXTFMT_H
+
+#include "raylib.h"
+#include <stdarg.h>             // Required for: va_list
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define TEXTFMT_LOCAL_SIZE      4096        // Per thread ring used by TextFormatLocal()
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Memory text is formatted into
+typedef struct {
+    char *buffer;
+    int capacity;               // Bytes, including terminators
+    int offset;                 // Next string position
+    bool owned;                 // Allocated by LoadTextArena()
+} TextArena;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+TextArena LoadTextArena(int capacity);                                  // Allocate arena of capacity bytes
+TextArena TextArenaFromBuffer(char *buffer, int capacity);              // Use caller buffer as arena (not owned)
+void UnloadTextArena(TextArena *arena);                                 // Free arena memory (if owned)
+void ResetTextArena(TextArena *arena);                                  // Start again from the beginning, earlier strings are invalid
+const char *TextFormatTo(TextArena *arena, const char *text, ...);      // Format text into arena
+const char *TextFormatToV(TextArena *arena, const char *text, va_list args);    // Format text into arena (va_list)
+const char *TextFormatLocal(const char *text, ...);                     // TextFormat() into a per thread ring, thread safe
+int TextFormatBuffer(char *buffer, int bufferSize, const char *text, ...);  // Format into buffer, returns length like snprintf()
+int TextFormatInt(char *buffer, int bufferSize, int value);             // Integer to text, returns length like snprintf()
+int TextFormatFloat(char *buffer, int bufferSize, double value, int decimals);  // Float to text as "%.*f", returns length like snprintf()
+void BenchmarkTextFormat(int iterations);                               // Compare TextFormat(), snprintf() and the arena formatters
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RTEXTFMT_H
+
+
+/***********************************************************************************
+*
+*   RTEXTFMT IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RTEXTFMT_IMPLEMENTATION) && !defined(RTEXTFMT_IMPLEMENTATION_DEFINED)
+#define RTEXTFMT_IMPLEMENTATION_DEFINED
+
+#include <chrono>               // Required for: std::chrono::steady_clock
+#include <math.h>               // Required for: floor(), fabs(), signbit()
+#include <stdio.h>              // Required for: snprintf(), vsnprintf()
+#include <stdlib.h>             // Required for: malloc(), free()
+#include <string.h>             // Required for: memcpy(), strlen(), strcmp()
+#include <thread>               // Required for: std::thread
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Output position, writes past the end are counted but not stored
+typedef struct {
+    char *buffer;
+    int size;                   // Bytes available, including terminator
+    int length;                 // Bytes the full text needs, without terminator
+} TextWriter;
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static const double textPowers10[10] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static double GetTextFmtTime(void);
+static void WriteText(TextWriter *writer, const char *text, int length);
+static int FormatUnsigned(char *digits, unsigned int value);
+static int FormatFloatExact(char *out, double value, int decimals);
+static bool IsFastFormat(const char *text);
+static int FormatTextV(char *buffer, int size, const char *text, va_list args);
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Allocate arena of capacity bytes
+TextArena LoadTextArena(int capacity)
+{
+    TextArena arena = TextArenaFromBuffer((char *)malloc(capacity), capacity);
+    arena.owned = true;
+
+    return arena;
+}
+
+// Use caller buffer as arena (not owned)
+TextArena TextArenaFromBuffer(char *buffer, int capacity)
+{
+    TextArena arena = { 0 };
+    arena.buffer = buffer;
+    arena.capacity = capacity;
+
+    return arena;
+}
+
+// Free arena memory (if owned)
+void UnloadTextArena(TextArena *arena)
+{
+    if (arena->owned) free(arena->buffer);
+
+    *arena = (TextArena){ 0 };
+}
+
+// Start again from the beginning, earlier strings are invalid
+void ResetTextArena(TextArena *arena)
+{
+    arena->offset = 0;
+}
+
+// Format text into arena
+const char *TextFormatTo(TextArena *arena, const char *text, ...)
+{
+    va_list args;
+    va_start(args, text);
+    const char *result = TextFormatToV(arena, text, args);
+    va_end(args);
+
+    return result;
+}
+
+// Format text into arena (va_list)
+// NOTE: Text that doesn't fit after the last string wraps to the arena start
+const char *TextFormatToV(TextArena *arena, const char *text, va_list args)
+{
+    if ((arena->buffer == NULL) || (arena->capacity < 4)) return "";
+
+    va_list retry;
+    va_copy(retry, args);
+
+    char *start = arena->buffer + arena->offset;
+    int length = FormatTextV(start, arena->capacity - arena->offset, text, args);
+    if (length < 0) length = 0;     // Encoding error, empty string
+
+    if ((length >= arena->capacity - arena->offset) && (arena->offset > 0))
+    {
+        start = arena->buffer;
+        length = FormatTextV(start, arena->capacity, text, retry);
+        if (length < 0) length = 0;
+    }
+    va_end(retry);
+
+    if (length >= arena->capacity - (int)(start - arena->buffer))
+    {
+        // Truncated, same mark as TextFormat()
+        length = arena->capacity - 1;
+        memcpy(arena->buffer + length - 3, "...", 3);
+    }
+
+    arena->offset = (int)(start - arena->buffer) + length + 1;
+    if (arena->offset >= arena->capacity) arena->offset = 0;
+
+    return start;
+}
+
+// TextFormat() into a per thread ring, thread safe
+const char *TextFormatLocal(const char *text, ...)
+{
+    static thread_local char buffer[TEXTFMT_LOCAL_SIZE];
+    static thread_local TextArena arena = { buffer, TEXTFMT_LOCAL_SIZE, 0, false };
+
+    va_list args;
+    va_start(args, text);
+    const char *result = TextFormatToV(&arena, text, args);
+    va_end(args);
+
+    return result;
+}
+
+// Format into buffer, returns length like snprintf()
+int TextFormatBuffer(char *buffer, int bufferSize, const char *text, ...)
+{
+    va_list args;
+    va_start(args, text);
+    int length = FormatTextV(buffer, bufferSize, text, args);
+    va_end(args);
+
+    return length;
+}
+
+// Integer to text, returns length like snprintf()
+int TextFormatInt(char *buffer, int bufferSize, int value)
+{
+    char digits[16] = { 0 };
+    int length = 0;
+
+    if (value < 0)
+    {
+        digits[0] = '-';
+        length = 1 + FormatUnsigned(digits + 1, 0u - (unsigned int)value);
+    }
+    else length = FormatUnsigned(digits, (unsigned int)value);
+
+    TextWriter writer = { buffer, bufferSize, 0 };
+    WriteText(&writer, digits, length);
+    if (bufferSize > 0) buffer[(length < bufferSize)? length : bufferSize - 1] = '\0';
+
+    return length;
+}
+
+// Float to text as "%.*f", returns length like snprintf()
+int TextFormatFloat(char *buffer, int bufferSize, double value, int decimals)
+{
+    char digits[48] = { 0 };
+    int length = FormatFloatExact(digits, value, decimals);
+    if (length < 0) return snprintf(buffer, bufferSize, "%.*f", decimals, value);
+
+    TextWriter writer = { buffer, bufferSize, 0 };
+    WriteText(&writer, digits, length);
+    if (bufferSize > 0) buffer[(length < bufferSize)? length : bufferSize - 1] = '\0';
+
+    return length;
+}
+
+// Compare TextFormat(), snprintf() and the arena formatters
+// NOTE: Outputs are checked against snprintf() over HUD formats, float ties and worker threads
+void BenchmarkTextFormat(int iterations)
+{
+    char expected[1024] = { 0 };
+    char local[1024] = { 0 };
+    int mismatches = 0;
+
+    // Exactness: float ties (0.125, 2.675), negative zero, large values and %s/%c/%u
+    char format[32] = "v=%.0f|%i|%u|%c|%s|%f %%";
+    for (int i = 0; i < 200000; i++)
+    {
+        double value = ((i%7) == 0)? (i - 100000)/1000.0 : ((i%7) == 1)? (i%1000)*0.125 : ((i%7) == 2)? -(i%100)/10000.0 : (double)((float)i*0.37f) - 20000.0f;
+        int decimals = i%10;
+        format[4] = (char)('0' + decimals);
+
+        snprintf(expected, sizeof(expected), format, value, i - 100000, (unsigned int)i*2654435761u, 'a' + i%26, (i%2)? "odd" : "even", value*1e3);
+        TextFormatBuffer(local, sizeof(local), format, value, i - 100000, (unsigned int)i*2654435761u, 'a' + i%26, (i%2)? "odd" : "even", value*1e3);
+        if (strcmp(expected, local) != 0) mismatches++;
+
+        snprintf(expected, sizeof(expected), "%.*f", decimals, value*1e5);
+        TextFormatFloat(local, sizeof(local), value*1e5, decimals);
+        if (strcmp(expected, local) != 0) mismatches++;
+    }
+
+    // Thread safety: workers format into their own ring while others do the same
+    const int threadCount = 4;
+    int threadMismatches[threadCount] = { 0 };
+    std::thread workers[threadCount];
+    for (int t = 0; t < threadCount; t++)
+    {
+        workers[t] = std::thread([t, &threadMismatches]() {
+            char check[256] = { 0 };
+            for (int i = 0; i < 50000; i++)
+            {
+                const char *a = TextFormatLocal("Thread %i: item %i, %.2f ms", t, i, i*0.01f);
+                const char *b = TextFormatLocal("Worker %i [%s]", i, (i%2)? "odd" : "even");
+                snprintf(check, sizeof(check), "Thread %i: item %i, %.2f ms", t, i, i*0.01f);
+                if (strcmp(a, check) != 0) threadMismatches[t]++;
+                snprintf(check, sizeof(check), "Worker %i [%s]", i, (i%2)? "odd" : "even");
+                if (strcmp(b, check) != 0) threadMismatches[t]++;
+            }
+        });
+    }
+    for (int t = 0; t < threadCount; t++)
+    {
+        workers[t].join();
+        mismatches += threadMismatches[t];
+    }
+
+    // Speed: HUD strings of the labs
+    const char *names[4] = { "TextFormat()", "snprintf()", "TextFormatLocal()", "TextFormatTo()" };
+    double times[4] = { 0 };
+    long long checksum = 0;
+    char arenaBuffer[4096] = { 0 };
+    TextArena arena = TextArenaFromBuffer(arenaBuffer, sizeof(arenaBuffer));
+
+    for (int mode = 0; mode < 4; mode++)
+    {
+        double start = GetTextFmtTime();
+        for (int i = 0; i < iterations; i++)
+        {
+            float frameTime = 16.0f + (i%100)*0.013f;
+            const char *hud = NULL;
+            const char *uniform = NULL;
+
+            switch (mode)
+            {
+                case 0:
+                {
+                    hud = TextFormat("Frame time: %.2f ms, draw calls: %i, objects: %i ([T] stress mode)", frameTime, i%500, i%10000);
+                    uniform = TextFormat("lights[%i].position", i%4);
+                } break;
+                case 1:
+                {
+                    snprintf(local, sizeof(local), "Frame time: %.2f ms, draw calls: %i, objects: %i ([T] stress mode)", frameTime, i%500, i%10000);
+                    snprintf(expected, sizeof(expected), "lights[%i].position", i%4);
+                    hud = local;
+                    uniform = expected;
+                } break;
+                case 2:
+                {
+                    hud = TextFormatLocal("Frame time: %.2f ms, draw calls: %i, objects: %i ([T] stress mode)", frameTime, i%500, i%10000);
+                    uniform = TextFormatLocal("lights[%i].position", i%4);
+                } break;
+                case 3:
+                {
+                    if ((i%16) == 0) ResetTextArena(&arena);   // Once per "frame"
+                    hud = TextFormatTo(&arena, "Frame time: %.2f ms, draw calls: %i, objects: %i ([T] stress mode)", frameTime, i%500, i%10000);
+                    uniform = TextFormatTo(&arena, "lights[%i].position", i%4);
+                } break;
+                default: break;
+            }
+
+            checksum += hud[12] + uniform[7];
+        }
+        times[mode] = GetTextFmtTime() - start;
+    }
+
+    for (int mode = 0; mode < 4; mode++)
+    {
+        TraceLog(LOG_INFO, "BENCH: [%i x 2 strings] %-18s %8.2f ns/string (%5.2fx)", iterations, names[mode], times[mode]*1e9/(2.0*iterations), times[0]/times[mode]);
+    }
+    TraceLog(LOG_INFO, "BENCH: Text format mismatches against snprintf(): %i (checksum %lld)", mismatches, checksum);
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Monotonic time in seconds
+static double GetTextFmtTime(void)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Append text, only the part that fits (keeping room for the terminator) is stored
+static void WriteText(TextWriter *writer, const char *text, int length)
+{
+    int room = writer->size - 1 - writer->length;
+    if (room > 0) memcpy(writer->buffer + writer->length, text, (length < room)? length : room);
+
+    writer->length += length;
+}
+
+// Unsigned integer digits, returns count
+static int FormatUnsigned(char *digits, unsigned int value)
+{
+    char reversed[12];
+    int count = 0;
+
+    do
+    {
+        reversed[count++] = (char)('0' + value%10);
+        value /= 10;
+    } while (value > 0);
+
+    for (int i = 0; i < count; i++) digits[i] = reversed[count - 1 - i];
+
+    return count;
+}
+
+// "%.*f" for values the double product rounds exactly, returns length or -1 to use snprintf()
+// NOTE: value*10^decimals below 2^32 - 0.5 is off by less than 2^-21 from the exact product, so the
+// rounding direction is the exact one unless the fraction is within 1e-5 of one half
+static int FormatFloatExact(char *out, double value, int decimals)
+{
+    if ((decimals < 0) || (decimals > 9) || (value != value)) return -1;
+
+    double scaled = fabs(value)*textPowers10[decimals];
+    if (scaled >= 4294967295.5) return -1;       // Rounded value must still fit the unsigned int integer part
+
+    double whole = floor(scaled);
+    double fraction = scaled - whole;
+    if (fabs(fraction - 0.5) < 1e-5) return -1;
+
+    unsigned long long rounded = (unsigned long long)whole + ((fraction > 0.5)? 1 : 0);
+    unsigned long long divisor = (unsigned long long)textPowers10[decimals];
+    unsigned int integer = (unsigned int)(rounded/divisor);
+    unsigned int decimal = (unsigned int)(rounded%divisor);
+
+    int length = 0;
+    if (signbit(value)) out[length++] = '-';     // printf keeps the sign of -0.0 and of values rounding to zero
+    length += FormatUnsigned(out + length, integer);
+
+    if (decimals > 0)
+    {
+        out[length++] = '.';
+        for (int i = decimals - 1; i >= 0; i--)
+        {
+            out[length + i] = (char)('0' + decimal%10);
+            decimal /= 10;
+        }
+        length += decimals;
+    }
+
+    return length;
+}
+
+// Check if every conversion in text has a fast path
+static bool IsFastFormat(const char *text)
+{
+    for (const char *c = text; *c != '\0'; c++)
+    {
+        if (*c != '%') continue;
+
+        c++;
+        if ((*c == '.') && (c[1] >= '0') && (c[1] <= '9') && (c[2] == 'f')) c += 2;
+        else if ((*c != 'd') && (*c != 'i') && (*c != 'u') && (*c != 'c') && (*c != 's') && (*c != 'f') && (*c != '%')) return false;
+    }
+
+    return true;
+}
+
+// vsnprintf() with typed fast paths, returns length the full text needs
+static int FormatTextV(char *buffer, int size, const char *text, va_list args)
+{
+    if (text == NULL) return 0;
+    if (!IsFastFormat(text)) return vsnprintf(buffer, size, text, args);
+
+    TextWriter writer = { buffer, size, 0 };
+    char digits[48];
+
+    const char *c = text;
+    while (*c != '\0')
+    {
+        const char *literal = c;
+        while ((*c != '\0') && (*c != '%')) c++;
+        if (c > literal) WriteText(&writer, literal, (int)(c - literal));
+        if (*c == '\0') break;
+
+        c++;    // Skip '%'
+        int decimals = 6;
+        if (*c == '.')
+        {
+            decimals = c[1] - '0';
+            c += 2;
+        }
+
+        switch (*c)
+        {
+            case 'd':
+            case 'i':
+            {
+                int value = va_arg(args, int);
+                int length = 0;
+                if (value < 0)
+                {
+                    digits[0] = '-';
+                    length = 1 + FormatUnsigned(digits + 1, 0u - (unsigned int)value);
+                }
+                else length = FormatUnsigned(digits, (unsigned int)value);
+                WriteText(&writer, digits, length);
+            } break;
+            case 'u': WriteText(&writer, digits, FormatUnsigned(digits, va_arg(args, unsigned int))); break;
+            case 'c':
+            {
+                digits[0] = (char)va_arg(args, int);
+                WriteText(&writer, digits, 1);
+            } break;
+            case 's':
+            {
+                const char *string = va_arg(args, const char *);
+                if (string == NULL) string = "(null)";
+                WriteText(&writer, string, (int)strlen(string));
+            } break;
+            case 'f':
+            {
+                double value = va_arg(args, double);
+                int length = FormatFloatExact(digits, value, decimals);
+                if (length < 0) length = snprintf(digits, sizeof(digits), "%.*f", decimals, value);
+                if (length < (int)sizeof(digits)) WriteText(&writer, digits, length);
+                else
+                {
+                    // Huge value, format again at full length
+                    char *large = (char *)malloc(length + 1);
+                    snprintf(large, length + 1, "%.*f", decimals, value);
+                    WriteText(&writer, large, length);
+                    free(large);
+                }
+            } break;
+            case '%': WriteText(&writer, "%", 1); break;
+            default: break;
+        }
+
+        c++;
+    }
+
+    if (size > 0) buffer[(writer.length < size)? writer.length : size - 1] = '\0';
+
+    return writer.length;
+}
+
+#endif // RTEXTFMT_IMPLEMENTATION
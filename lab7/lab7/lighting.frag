@@ -3,17 +3,22 @@
 // Input vertex attributes (from vertex shader)
 in vec3 fragPosition;
 in vec3 fragNormal;
+flat in vec4 fragAmbient;
+flat in vec4 fragDiffuse;
+flat in vec4 fragSpecular;
 
 // Output fragment color
 out vec4 finalColor;
 
+#define MAX_LIGHTS 256
+
+// NOTE: Member order matters, std140 layout is mirrored by LightData in rlights.h
 struct Light {
-    int enabled;
     vec3 position;
+    int type;
     vec3 target;
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
+    int enabled;
+    vec4 color;
 };
 
 struct Material {
@@ -25,31 +30,86 @@ struct Material {
 };
 
 // Input lighting values
-uniform Light light;
-uniform Material material;
+layout(std140, binding = 0) uniform LightBlock {
+    int lightsCount;
+    Light lights[MAX_LIGHTS];
+};
 uniform vec3 viewPos;
 
+// Clustered point lights, see rcluster.h
+#define CLUSTER_GRID_X 16
+#define CLUSTER_GRID_Y 9
+#define CLUSTER_GRID_Z 24
+
+struct PointLight {
+    vec3 position;
+    float radius;
+    vec3 color;
+    float intensity;
+};
+
+layout(std430, binding = 1) readonly buffer ClusterLights { PointLight pointLights[]; };
+layout(std430, binding = 2) readonly buffer ClusterCells { uvec2 clusterCells[]; };
+layout(std430, binding = 3) readonly buffer ClusterIndices { uint clusterIndices[]; };
+
+uniform int clustered;
+uniform vec2 clusterScreenSize;
+uniform vec2 clusterDepth;          // near, far
+uniform vec3 viewForward;
+
 void main()
 {
-    // ambient
-    vec3 ambient = light.ambient * material.ambient;
-    vec3 diffuse = vec3(0);
-    vec3 specular = vec3(0);
-    if (light.enabled == 1) {
-        // diffuse
-        vec3 norm = normalize(fragNormal);
-        vec3 lightDir = normalize(light.position - fragPosition);
-        float diff = max(dot(norm, lightDir), 0.0);
-        diffuse = light.diffuse * (diff * material.diffuse);
-
-        // specular
-        vec3 viewDir = normalize(viewPos - fragPosition);
-        vec3 reflectDir = reflect(-lightDir, norm);
-        float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-        specular = light.specular * (spec * material.specular);
+    // Material comes per instance
+    Material material = Material(fragAmbient.rgb, fragDiffuse.rgb, fragSpecular.rgb, fragAmbient.a, fragDiffuse.a);
+
+    vec3 result = vec3(0);
+    vec3 norm = normalize(fragNormal);
+    vec3 viewDir = normalize(viewPos - fragPosition);
+
+    for (int i = 0; i < lightsCount; i++) {
+        // ambient
+        vec3 ambient = lights[i].color.rgb * material.ambient;
+        vec3 diffuse = vec3(0);
+        vec3 specular = vec3(0);
+        if (lights[i].enabled == 1) {
+            // diffuse
+            vec3 lightDir = normalize(lights[i].position - fragPosition);
+            float diff = max(dot(norm, lightDir), 0.0);
+            diffuse = lights[i].color.rgb * (diff * material.diffuse);
+
+            // specular
+            vec3 reflectDir = reflect(-lightDir, norm);
+            float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+            specular = lights[i].color.rgb * (spec * material.specular);
+        }
+
+        result += ambient + diffuse + specular;
+    }
+
+    if (clustered == 1) {
+        // Find this fragment cluster, only its lights are shaded
+        float depth = dot(fragPosition - viewPos, viewForward);
+        int slice = (depth <= clusterDepth.x) ? 0 : int(log(depth/clusterDepth.x)/log(clusterDepth.y/clusterDepth.x)*CLUSTER_GRID_Z);
+        ivec2 tile = ivec2(gl_FragCoord.xy/clusterScreenSize*vec2(CLUSTER_GRID_X, CLUSTER_GRID_Y));
+        tile = clamp(tile, ivec2(0), ivec2(CLUSTER_GRID_X - 1, CLUSTER_GRID_Y - 1));
+        slice = min(slice, CLUSTER_GRID_Z - 1);
+
+        uvec2 cell = clusterCells[(slice*CLUSTER_GRID_Y + tile.y)*CLUSTER_GRID_X + tile.x];
+        for (uint i = 0u; i < cell.y; i++) {
+            PointLight pointLight = pointLights[clusterIndices[cell.x + i]];
+
+            vec3 toLight = pointLight.position - fragPosition;
+            float dist = length(toLight);
+            float falloff = clamp(1.0 - (dist*dist)/(pointLight.radius*pointLight.radius), 0.0, 1.0);
+            falloff *= falloff;
+
+            vec3 lightDir = toLight/dist;
+            float diff = max(dot(norm, lightDir), 0.0);
+            float spec = pow(max(dot(viewDir, reflect(-lightDir, norm)), 0.0), material.shininess);
+            result += pointLight.color*pointLight.intensity*falloff*(diff*material.diffuse + spec*material.specular);
+        }
     }
 
-    vec3 result = ambient + diffuse + specular;
     finalColor = vec4(result, material.transparency);
 
     float dist = length(viewPos - fragPosition);
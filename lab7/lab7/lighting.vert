@@ -5,25 +5,35 @@ in vec3 vertexPosition;
 in vec3 vertexNormal;
 in vec4 vertexColor;
 
+// Input per-instance attributes (see rscene.h)
+in mat4 instanceTransform;
+in vec4 instanceAmbient;
+in vec4 instanceDiffuse;
+in vec4 instanceSpecular;
+
 // Input uniform values
 uniform mat4 mvp;
-uniform mat4 matModel;
-uniform mat4 matNormal;
 
 // Output vertex attributes (to fragment shader)
 out vec3 fragPosition;
 out vec4 fragColor;
 out vec3 fragNormal;
+flat out vec4 fragAmbient;
+flat out vec4 fragDiffuse;
+flat out vec4 fragSpecular;
 
 // NOTE: Add here your custom variables
 
 void main()
 {
     // Send vertex attributes to fragment shader
-    fragPosition = vec3(matModel*vec4(vertexPosition, 1.0));
+    fragPosition = vec3(instanceTransform*vec4(vertexPosition, 1.0));
     fragColor = vertexColor;
-    fragNormal = normalize(vec3(matNormal*vec4(vertexNormal, 1.0)));
+    fragNormal = normalize(mat3(transpose(inverse(instanceTransform)))*vertexNormal);
+    fragAmbient = instanceAmbient;
+    fragDiffuse = instanceDiffuse;
+    fragSpecular = instanceSpecular;
 
-    // Calculate final vertex position
-    gl_Position = mvp*vec4(vertexPosition, 1.0);
-}
\ No newline at end of file
+    // Calculate final vertex position, mvp holds view and projection only when instancing
+    gl_Position = mvp*instanceTransform*vec4(vertexPosition, 1.0);
+}
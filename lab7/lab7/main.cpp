@@ -1,84 +1,75 @@
+#include "stddef.h"
 #include "stdlib.h"
+#include "string.h"
+#include "limits.h"
 #include "raylib.h"
 #include "raymath.h"
 #include "rlgl.h"
 #include "glfw3.h"
 
+#define RJOBS_IMPLEMENTATION
+#include "rjobs.h"
+#define RCOLLISION_IMPLEMENTATION
+#include "rcollision.h"
+#define RSCENE_IMPLEMENTATION
+#include "rscene.h"
+#define RSORT_IMPLEMENTATION
+#include "rsort.h"
+#define RUNIFORMS_IMPLEMENTATION
+#include "runiforms.h"
+#define RUBO_IMPLEMENTATION
+#include "rubo.h"
+#define RLIGHTS_IMPLEMENTATION
+#include "rlights.h"
+#define RCLUSTER_IMPLEMENTATION
+#include "rcluster.h"
+#define RSKINNING_IMPLEMENTATION
+#include "rskinning.h"
+#define RMATHSIMD_IMPLEMENTATION
+#include "rmathsimd.h"
+#define RCULL_IMPLEMENTATION
+#include "rcull.h"
+#define RSOFTGL_IMPLEMENTATION
+#include "rsoftgl.h"
+#define RHEADLESS_IMPLEMENTATION
+#include "rheadless.h"
+#define RTEXTFMT_IMPLEMENTATION
+#include "rtextfmt.h"
+#define RPROFILE_IMPLEMENTATION
+#include "rprofile.h"
+#define RGLYPHS_IMPLEMENTATION
+#include "rglyphs.h"
+#define RTEXTRUN_IMPLEMENTATION
+#include "rtextrun.h"
+#define RFONTLOAD_IMPLEMENTATION
+#include "rfontload.h"
+#define RFONTCACHE_IMPLEMENTATION
+#include "rfontcache.h"
+
 int screenWidth = 1280;
 int screenHeight = 720;
 
-typedef struct {
-    bool enabled;
-    Vector3 position;
-    Vector3 target;
-    Vector3 ambient;
-    Vector3 diffuse;
-    Vector3 specular;
-
-    // Shader locations
-    int enabledLoc;
-    int positionLoc;
-    int targetLoc;
-    int ambientLoc;
-    int diffuseLoc;
-    int specularLoc;
-    int attenuationLoc;
-} Light;
-
-typedef struct {
-    Vector3 ambient;
-    Vector3 diffuse;
-    Vector3 specular;
-    float shininess;
-    float transparency;
-
-    int ambientLoc;
-    int diffuseLoc;
-    int specularLoc;
-    int shininessLoc;
-    int transparencyLoc;
-} MyMaterial;
-
 typedef struct {
     Model model;
     Vector3 position;
     MyMaterial material;
-    float viewDistance;
+    int batch;
 } ModelPos;
 
-void updateLight(Light light, Shader shader) {
-    SetShaderValue(shader, light.enabledLoc, &light.enabled, SHADER_UNIFORM_INT);
-    // Send to shader light position values
-    float position[3] = { light.position.x, light.position.y, light.position.z };
-    SetShaderValue(shader, light.positionLoc, position, SHADER_UNIFORM_VEC3);
-    // Send to shader light target position values
-    float target[3] = { light.target.x, light.target.y, light.target.z };
-    SetShaderValue(shader, light.targetLoc, target, SHADER_UNIFORM_VEC3);
-
-    // Send to shader light color values
-    float ambient[3] = {light.ambient.x, light.ambient.y, light.ambient.z};
-    float diffuse[3] = {light.diffuse.x, light.diffuse.y, light.diffuse.z};
-    float specular[3] = {light.specular.x, light.specular.y, light.specular.z};
-
-    SetShaderValue(shader, light.ambientLoc, ambient, SHADER_UNIFORM_VEC3);
-    SetShaderValue(shader, light.diffuseLoc, diffuse, SHADER_UNIFORM_VEC3);
-    SetShaderValue(shader, light.specularLoc, specular, SHADER_UNIFORM_VEC3);
+// Materials travel with every instance, see rscene.h
+SceneMaterial toSceneMaterial(MyMaterial material, float transparency) {
+    return (SceneMaterial) {material.ambient, material.shininess*128, material.diffuse, transparency, material.specular, 0.0f};
 }
 
-void updateMaterial(MyMaterial material, Shader shader) {
-    float ambient[3] = {material.ambient.x, material.ambient.y, material.ambient.z};
-    float diffuse[3] = {material.diffuse.x, material.diffuse.y, material.diffuse.z};
-    float specular[3] = {material.specular.x, material.specular.y, material.specular.z};
+// Profiler counters for a drawn scene, one instanced draw per non-empty batch (see DrawScene())
+void profileScene(const Scene *scene) {
+    for (int i = 0; i < scene->batchCount; ++i) {
+        const SceneBatch *batch = &scene->batches[i];
+        if (batch->count == 0) continue;
 
-    SetShaderValue(shader, material.ambientLoc, ambient, SHADER_UNIFORM_VEC3);
-    SetShaderValue(shader, material.diffuseLoc, diffuse, SHADER_UNIFORM_VEC3);
-    SetShaderValue(shader, material.specularLoc, specular, SHADER_UNIFORM_VEC3);
-    SetShaderValue(shader, material.shininessLoc, &material.shininess, SHADER_UNIFORM_FLOAT);
-    SetShaderValue(shader, material.transparencyLoc, &material.transparency, SHADER_UNIFORM_FLOAT);
-}
-
-int cmp(const void *l, const void *r) {
-    return (int)(((ModelPos*)r)->viewDistance - ((ModelPos*)l)->viewDistance);
+        Mesh mesh = batch->mesh;
+        AddProfileDraw(batch->material, 1, ((mesh.indices != NULL) ? mesh.triangleCount*3 : mesh.vertexCount)*batch->count);
+    }
 }
 
 #ifndef LIGHTING_STENCIL_H
@@ -94,7 +85,7 @@ void EndStencil();
 // Stencil masks
 void BeginStencil()
 {
-    rlDrawRenderBatchActive();
+    ProfileDrawRenderBatch();
     glEnable(GL_STENCIL_TEST);
 }
 
@@ -109,7 +100,7 @@ void BeginStencilMask()
 
 void EndStencilMask()
 {
-    rlDrawRenderBatchActive();
+    ProfileDrawRenderBatch();
     glStencilFunc(GL_EQUAL, 1, 0xFF); // Pass test if stencil value is 1
     glStencilMask(0x00); // Don't write anything to stencil buffer
     glDepthMask(GL_TRUE); // Write to depth buffer
@@ -117,11 +108,182 @@ void EndStencilMask()
 
 void EndStencil()
 {
-    rlDrawRenderBatchActive();
+    ProfileDrawRenderBatch();
     glDisable(GL_STENCIL_TEST);
 }
 
-int main() {
+// Benchmarks run in a hidden window: lab7 --bench <name>
+int runBenchmark(const char *name, const char *modelPath) {
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(screenWidth, screenHeight, "lab7 benchmark");
+
+    if (strcmp(name, "raycast") == 0) {
+        Mesh knot = GenMeshKnot(1.0f, 2.0f, 128, 400);
+        BenchmarkRayCollisionBVH(knot, "GenMeshKnot", 1000);
+        UnloadMesh(knot);
+
+        Image noise = GenImagePerlinNoise(256, 256, 0, 0, 4.0f);
+        Mesh heightmap = GenMeshHeightmap(noise, (Vector3) {64, 8, 64});
+        BenchmarkRayCollisionBVH(heightmap, "GenMeshHeightmap", 1000);
+        UnloadMesh(heightmap);
+        UnloadImage(noise);
+    }
+    else if (strcmp(name, "raybatch") == 0) {
+        Mesh knot = GenMeshKnot(1.0f, 2.0f, 16, 128);
+        BenchmarkRayCollisionBatch(knot, "GenMeshKnot", 20000);
+        UnloadMesh(knot);
+    }
+    else if (strcmp(name, "depthsort") == 0) {
+        BenchmarkDepthSort(1000, 200);
+        BenchmarkDepthSort(10000, 100);
+        BenchmarkDepthSort(100000, 20);
+    }
+    else if (strcmp(name, "clusters") == 0) {
+        BenchmarkClusterGrid(1000, 100);
+        BenchmarkClusterGrid(10000, 100);
+    }
+    else if (strcmp(name, "skinning") == 0) {
+        // lab7 --bench skinning [model.glb|model.iqm]
+        // NOTE: Default rig is generated, 65536 vertices (64 chunks), the example models are a few chunks
+        if (modelPath == NULL) {
+            Model model = GenModelSkinnedStrip(64.0f, 255, 64);
+            ModelAnimation anim = GenModelAnimationBend(model, 120);
+            BenchmarkModelSkinning(model, anim, "GenModelSkinnedStrip", 200);
+            UnloadModelAnimation(anim);
+            UnloadModel(model);
+        }
+        else {
+            Model model = LoadModel(modelPath);
+            int animCount = 0;
+            ModelAnimation *anims = LoadModelAnimations(modelPath, &animCount);
+
+            if (animCount > 0) BenchmarkModelSkinning(model, anims[0], GetFileName(modelPath), 200);
+            else TraceLog(LOG_WARNING, "BENCH: No animations in model: %s", modelPath);
+
+            UnloadModelAnimations(anims, animCount);
+            UnloadModel(model);
+        }
+    }
+    else if (strcmp(name, "math") == 0) {
+        if (CheckMathSIMD(4097) > 0) TraceLog(LOG_WARNING, "BENCH: SIMD math kernels out of tolerance");
+        BenchmarkMathSIMD(4096, 2000);
+    }
+    else if (strcmp(name, "soft") == 0) {
+        BenchmarkSoftRaster(640, 360, 20);
+        BenchmarkSoftRaster(1920, 1080, 10);
+    }
+    else if (strcmp(name, "text") == 0) {
+        BenchmarkTextRuns(1000, 100);
+        BenchmarkTextRuns(10000, 50);
+    }
+    else if (strcmp(name, "glyphs") == 0) {
+        BenchmarkGlyphLookup(95, 10000000);
+        BenchmarkGlyphLookup(1000, 10000000);
+        BenchmarkGlyphLookup(20000, 10000000);
+    }
+    else if (strcmp(name, "fontcache") == 0) {
+        // lab7 --bench fontcache [font.ttf]
+        const char *fontPath = (modelPath != NULL)? modelPath : "_deps/raylib-src/examples/text/resources/DotGothic16-Regular.ttf";
+        BenchmarkDynamicFont(fontPath, 24, 1000);
+        BenchmarkDynamicFont(fontPath, 24, 5000);
+        BenchmarkDynamicFont(fontPath, 24, 20000);
+        BenchmarkDynamicFont(fontPath, 48, 5000);
+    }
+    else if (strcmp(name, "fontdata") == 0) {
+        // lab7 --bench fontdata [font.ttf]
+        const char *fontPath = (modelPath != NULL)? modelPath : "_deps/raylib-src/examples/text/resources/DotGothic16-Regular.ttf";
+        int counts[3] = { 256, 4096, 20000 };
+        int sizes[3] = { 16, 32, 64 };
+        for (int c = 0; c < 3; c++) for (int s = 0; s < 3; s++) BenchmarkFontData(fontPath, sizes[s], counts[c], FONT_DEFAULT);
+        for (int c = 0; c < 2; c++) for (int s = 0; s < 2; s++) BenchmarkFontData(fontPath, sizes[s], counts[c], FONT_SDF);
+    }
+    else if (strcmp(name, "textformat") == 0) {
+        BenchmarkTextFormat(1000000);
+    }
+    else TraceLog(LOG_WARNING, "BENCH: Unknown benchmark: %s", name);
+
+    CloseWindow();
+    return 0;
+}
+
+// Lab scene drawn with the software rasterizer, light (and the sphere showing it) at lightPosition
+void drawSoftScene(SoftContext *ctx, Vector3 lightPosition) {
+    Camera camera = { { 25.0f, 6.0f, 25.0f }, { 0.0f, 3.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, 45.0f, CAMERA_PERSPECTIVE };
+    SoftLight light = { true, lightPosition, { 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f } };
+    SoftMaterial obsidian = { {0.05375f, 0.05f, 0.06625f}, {0.18275f, 0.17f, 0.22525f}, {0.332741f, 0.328634f, 0.346435f}, 0.3f*128, 1.0f };
+    SoftMaterial ruby = { {0.1745f, 0.01175f, 0.01175f}, {0.61424f, 0.04136f, 0.04136f}, {0.727811f, 0.626959f, 0.626959f}, 0.6f*128, 0.3f };
+    SoftMaterial lamp = { {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f}, 1.0f*128, 0.3f };
+
+    SoftClear(ctx, RAYWHITE);
+    SoftBeginMode3D(ctx, camera);
+    SoftSetLighting(ctx, true, light, obsidian);
+    SoftDrawPlane(ctx, (Vector3){ 0.0f, 0.0f, 0.0f }, (Vector2){ 40.0f, 40.0f }, WHITE);
+    SoftSetLighting(ctx, true, light, lamp);
+    SoftDrawCube(ctx, (Vector3){ 7.0f, 2.5f, 0.0f }, 5.0f, 5.0f, 5.0f, WHITE);
+    SoftSetLighting(ctx, true, light, ruby);
+    SoftDrawSphere(ctx, light.position, 2.0f, 16, 16, WHITE);
+    SoftEndMode3D(ctx);
+}
+
+// Lab scene without window or GPU: lab7 --soft <out.png> [golden.png]
+int runSoftRender(const char *outPath, const char *goldenPath) {
+    SoftContext ctx = LoadSoftContext(screenWidth, screenHeight);
+    drawSoftScene(&ctx, (Vector3){ 10.0f, 10.0f, 10.0f });
+
+    Image image = LoadImageFromSoftContext(&ctx);
+    ExportImage(image, outPath);
+    int mismatches = (goldenPath != NULL)? CheckSoftGoldenImage(image, goldenPath, 2) : 0;
+
+    UnloadImage(image);
+    UnloadSoftContext(&ctx);
+    return (mismatches > 0)? 1 : 0;
+}
+
+// Uncapped headless replay on a 60 FPS fixed step clock: lab7 --headless <frames> [last.png]
+// The light orbits with clock time, so the last frame is the same on every run and machine speed
+int runHeadless(const char *framesArg, const char *outPath) {
+    // A frame limit of 0 means no limit, the replay would never end
+    char *end = NULL;
+    long frames = strtol(framesArg, &end, 10);
+    if ((end == framesArg) || (*end != '\0') || (frames <= 0) || (frames > INT_MAX)) {
+        TraceLog(LOG_ERROR, "HEADLESS: Invalid frame count: %s (usage: lab7 --headless <frames> [last.png], frames > 0)", framesArg);
+        return 1;
+    }
+
+    InitHeadlessWindow(screenWidth, screenHeight, 1.0/60.0);
+    SetHeadlessFrameLimit((int)frames);
+
+    while (!HeadlessShouldClose()) {
+        float angle = (float)GetHeadlessTime()*0.5f;
+        Vector3 lightPosition = Vector3RotateByAxisAngle((Vector3){ 10.0f, 10.0f, 10.0f }, (Vector3){ 0.0f, 1.0f, 0.0f }, angle);
+
+        drawSoftScene(BeginHeadlessDrawing(), lightPosition);
+        EndHeadlessDrawing();
+    }
+
+    if (outPath != NULL) TakeHeadlessScreenshot(outPath);
+    CloseHeadlessWindow();
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 2 && strcmp(argv[1], "--headless") == 0) return runHeadless(argv[2], (argc > 3)? argv[3] : NULL);
+    if (argc > 2 && strcmp(argv[1], "--soft") == 0) return runSoftRender(argv[2], (argc > 3)? argv[3] : NULL);
+    if (argc > 2 && strcmp(argv[1], "--bench") == 0) return runBenchmark(argv[2], (argc > 3)? argv[3] : NULL);
+
+    // lab7 --lights <N> starts with N clustered point lights
+    // lab7 --fixed-step <FPS> animates on a fixed step clock, uncapped (same animation frames on every run)
+    int pointLightCount = 1000;
+    bool clusteredLights = false;
+    double fixedStep = 0.0;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--lights") == 0) {
+            pointLightCount = atoi(argv[i + 1]);
+            clusteredLights = (pointLightCount > 0);
+        }
+        if (strcmp(argv[i], "--fixed-step") == 0 && atof(argv[i + 1]) > 0.0) fixedStep = 1.0/atof(argv[i + 1]);
+    }
+
     SetConfigFlags(FLAG_MSAA_4X_HINT);
     InitWindow(screenWidth, screenHeight, "lab7");
     SetWindowState(FLAG_WINDOW_RESIZABLE);
@@ -132,8 +294,9 @@ int main() {
     camera.fovy = 45.0f;                                    // Camera field-of-view Y
     camera.projection = CAMERA_PERSPECTIVE;
     DisableCursor();
-    SetTargetFPS(60);
+    SetTargetFPS((fixedStep > 0.0)? 0 : 60);
     bool firstPerson = false;
+    FrameClock clock = LoadFrameClock(fixedStep);
 
     Model cube = LoadModelFromMesh(GenMeshCube(5, 5, 5));
     Model plane = LoadModelFromMesh(GenMeshPlane(40, 40, 5, 5));
@@ -141,86 +304,123 @@ int main() {
     Shader shader = LoadShader("../lighting.vert", "../lighting.frag");
 
     shader.locs[SHADER_LOC_VECTOR_VIEW] = GetShaderLocation(shader, "viewPos");
+    shader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(shader, "instanceTransform");
     plane.materials[0].shader = shader;
     cube.materials[0].shader = shader;
     sphere.materials[0].shader = shader;
 
-    Light light = {false};
+    Light light = {0};
+    light.type = LIGHT_POINT;
     light.enabled = false;
     light.position = (Vector3){10,10,10};
     light.target = Vector3Zero();
-    light.ambient = (Vector3) {1.0f, 1.0f, 1.0f};
-    light.diffuse = (Vector3) {1.0f, 1.0f, 1.0f};
-    light.specular = (Vector3) {1.0f, 1.0f, 1.0f};
-
-    light.enabledLoc = GetShaderLocation(shader, "light.enabled");
-    light.positionLoc = GetShaderLocation(shader, "light.position");
-    light.targetLoc = GetShaderLocation(shader, "light.target");
-    light.ambientLoc = GetShaderLocation(shader, "light.ambient");
-    light.diffuseLoc = GetShaderLocation(shader, "light.diffuse");
-    light.specularLoc = GetShaderLocation(shader, "light.specular");
+    light.color = WHITE;
+    light.dirty = true;
 
     MyMaterial emerald = {0};
     emerald.ambient = (Vector3){0.24725f,	0.1995f, 0.0745f};
     emerald.diffuse = (Vector3){0.75164f, 0.60648f, 0.22648f};
     emerald.specular = (Vector3){0.628281f, 0.555802f, 0.366065f};
-    emerald.shininess = 0.4f*128;
+    emerald.shininess = 0.4f;
     emerald.transparency = 0.3f;
 
-    emerald.ambientLoc = GetShaderLocation(shader, "material.ambient");
-    emerald.diffuseLoc = GetShaderLocation(shader, "material.diffuse");
-    emerald.specularLoc = GetShaderLocation(shader, "material.specular");
-    emerald.shininessLoc = GetShaderLocation(shader, "material.shininess");
-    emerald.transparencyLoc = GetShaderLocation(shader, "material.transparency");
-
     MyMaterial ruby = {0};
     ruby.ambient = (Vector3){0.1745f,	0.01175f, 0.01175f};
     ruby.diffuse = (Vector3){0.61424f, 0.04136f, 0.04136f};
     ruby.specular = (Vector3){0.727811f, 0.626959f, 0.626959f};
-    ruby.shininess = 0.6f*128;
+    ruby.shininess = 0.6f;
     ruby.transparency = 0.3f;
 
-    ruby.ambientLoc = GetShaderLocation(shader, "material.ambient");
-    ruby.diffuseLoc = GetShaderLocation(shader, "material.diffuse");
-    ruby.specularLoc = GetShaderLocation(shader, "material.specular");
-    ruby.shininessLoc = GetShaderLocation(shader, "material.shininess");
-    ruby.transparencyLoc = GetShaderLocation(shader, "material.transparency");
-
     MyMaterial obsidian = {0};
     obsidian.ambient = (Vector3){0.05375f, 0.05f, 0.06625f};
     obsidian.diffuse = (Vector3){0.18275f, 0.17f, 0.22525f};
     obsidian.specular = (Vector3){0.332741f, 0.328634f, 0.346435f};
-    obsidian.shininess = 0.3f*128;
+    obsidian.shininess = 0.3f;
     obsidian.transparency = 1.0f;
 
-    obsidian.ambientLoc = GetShaderLocation(shader, "material.ambient");
-    obsidian.diffuseLoc = GetShaderLocation(shader, "material.diffuse");
-    obsidian.specularLoc = GetShaderLocation(shader, "material.specular");
-    obsidian.shininessLoc = GetShaderLocation(shader, "material.shininess");
-    obsidian.transparencyLoc = GetShaderLocation(shader, "material.transparency");
-
     MyMaterial lamp = {0};
     lamp.ambient = (Vector3){1.0f, 1.0f, 1.0f};
     lamp.diffuse = (Vector3){1.0f, 1.0f, 1.0f};
     lamp.specular = (Vector3){1.0f, 1.0f, 1.0f};
-    lamp.shininess = 1.0f*128;
+    lamp.shininess = 1.0f;
     lamp.transparency = 0.3f;
 
-    lamp.ambientLoc = GetShaderLocation(shader, "material.ambient");
-    lamp.diffuseLoc = GetShaderLocation(shader, "material.diffuse");
-    lamp.specularLoc = GetShaderLocation(shader, "material.specular");
-    lamp.shininessLoc = GetShaderLocation(shader, "material.shininess");
-    lamp.transparencyLoc = GetShaderLocation(shader, "material.transparency");
+    UniformCache uniforms = LoadUniformCache(shader);
+
+    // Lights are a std140 uniform block on binding point 0, sent again only when changed
+    LightBlock lightBlock = LoadLightBlock(shader, 0);
+    UpdateLightBlock(&lightBlock, &light, 1);
+    light.dirty = false;
 
-    updateLight(light, shader);
+    // Everything is drawn instanced: floor for the stencil mask, reflections, then real objects
+    // NOTE: Opaque objects go first, transparent ones back to front within each batch, farthest batch first
+    Scene floor = { 0 };
+    Scene reflections = { 0 };
+    Scene opaque = { 0 };
+    Scene objects = { 0 };
+    objects.ordered = true;
+    int planeBatch = AddSceneBatch(&floor, plane.meshes[0], plane.materials[0]);
 
     ModelPos modelPositions[2] = {
             (ModelPos) {sphere, light.position, ruby},
             (ModelPos) {cube, (Vector3) {7, 2.5f, 0}, lamp}
     };
+    for (int i = 0; i < 2; ++i) {
+        modelPositions[i].batch = AddSceneBatch(&objects, modelPositions[i].model.meshes[0], modelPositions[i].model.materials[0]);
+        AddSceneBatch(&opaque, modelPositions[i].model.meshes[0], modelPositions[i].model.materials[0]);
+        AddSceneBatch(&reflections, modelPositions[i].model.meshes[0], modelPositions[i].model.materials[0]);
+    }
     int modelIndex = 0;
 
+    // Stress mode: a grid of small objects sharing two meshes
+    const int stressCount = 100*100;
+    Model stressCube = LoadModelFromMesh(GenMeshCube(0.4f, 0.4f, 0.4f));
+    Model stressSphere = LoadModelFromMesh(GenMeshSphere(0.25f, 8, 8));
+    stressCube.materials[0].shader = shader;
+    stressSphere.materials[0].shader = shader;
+    MyMaterial stressMaterials[4] = {emerald, ruby, obsidian, lamp};
+
+    ModelPos *stressObjects = (ModelPos *)calloc(stressCount, sizeof(ModelPos));
+    for (int i = 0; i < stressCount; ++i) {
+        stressObjects[i].model = (i % 2 == 0) ? stressCube : stressSphere;
+        stressObjects[i].position = (Vector3) {-19.8f + 0.4f*(i % 100), 0.5f, -19.8f + 0.4f*(i / 100)};
+        stressObjects[i].material = stressMaterials[i % 4];
+        stressObjects[i].batch = AddSceneBatch(&objects, stressObjects[i].model.meshes[0], stressObjects[i].model.materials[0]);
+        AddSceneBatch(&opaque, stressObjects[i].model.meshes[0], stressObjects[i].model.materials[0]);
+        AddSceneBatch(&reflections, stressObjects[i].model.meshes[0], stressObjects[i].model.materials[0]);
+    }
+    bool stressMode = false;
+
+    // HUD lines keep their layout, each frame only reshapes from the first changed character
+    TextRun hudText[4];
+    for (int i = 0; i < 4; ++i) hudText[i] = LoadTextRunDefault("", 20);
+
+    // Point lights circle over the floor, binned in clusters every frame
+    ClusterLight *pointLights = (ClusterLight *)malloc(pointLightCount*sizeof(ClusterLight));
+    Vector3 *pointLightOrigins = (Vector3 *)malloc(pointLightCount*sizeof(Vector3));
+    for (int i = 0; i < pointLightCount; ++i) {
+        pointLightOrigins[i] = (Vector3) {GetRandomValue(-200, 200)/10.0f, GetRandomValue(3, 40)/10.0f, GetRandomValue(-200, 200)/10.0f};
+        Color color = ColorFromHSV((float)GetRandomValue(0, 360), 0.8f, 1.0f);
+        pointLights[i].radius = GetRandomValue(15, 40)/10.0f;
+        pointLights[i].color = (Vector3) {color.r/255.0f, color.g/255.0f, color.b/255.0f};
+        pointLights[i].intensity = 1.0f;
+    }
+    ClusterGrid clusters = LoadClusterGrid(1.0f, 200.0f);
+    int clusteredLoc = GetShaderLocation(shader, "clustered");
+    int clusterScreenSizeLoc = GetShaderLocation(shader, "clusterScreenSize");
+    int clusterDepthLoc = GetShaderLocation(shader, "clusterDepth");
+    int viewForwardLoc = GetShaderLocation(shader, "viewForward");
+    double binningTime = 0.0;
+
+    // Transparent objects are added farthest first (back to front per batch, see rscene.h)
+    Vector3 *objectPositions = (Vector3 *)malloc((2 + stressCount)*sizeof(Vector3));
+    DepthSort depthSort = { 0 };
+
+    // Objects outside the view frustum never reach the scene batches
+    bool frustumCulling = true;
+
     while (!WindowShouldClose()) {
+        BeginProfileScope("Update");
         Vector3 camMovement = (Vector3){0};
         Vector3 camRotation = (Vector3){0};
 
@@ -238,8 +438,19 @@ int main() {
         if(IsKeyDown(KEY_D)) camMovement.y = 1;
         if(IsKeyDown(KEY_LEFT_SHIFT)) camSpeed = 2.0f;
         if(IsKeyDown(KEY_LEFT_CONTROL)) camSpeed = 0.3f;
-        if(IsKeyPressed(KEY_L)) light.enabled = !light.enabled;
+        if(IsKeyPressed(KEY_L)) {
+            light.enabled = !light.enabled;
+            light.dirty = true;
+        }
         if(IsKeyPressed(KEY_P)) camera.projection = !camera.projection;
+        if(IsKeyPressed(KEY_T)) {
+            stressMode = !stressMode;
+            SetTargetFPS((stressMode || fixedStep > 0.0) ? 0 : 60); // Uncapped, so frame time shows the real cost
+        }
+        if(IsKeyPressed(KEY_O)) frustumCulling = !frustumCulling;
+        if(IsKeyPressed(KEY_K)) clusteredLights = !clusteredLights && (pointLightCount > 0);
+        if(IsKeyPressed(KEY_F3)) SetProfilerEnabled(!IsProfilerEnabled());
+        if(IsKeyPressed(KEY_F4)) StartProfileCapture(120);
         if(IsKeyPressed(KEY_F)) {
             firstPerson = !firstPerson;
             if(firstPerson) {
@@ -267,79 +478,166 @@ int main() {
         if (IsKeyDown(KEY_LEFT)) modelPositions[modelIndex].position.z += .5f; // Update the position of the object
         if (IsKeyDown(KEY_RIGHT)) modelPositions[modelIndex].position.z += -.5f; // Update the position of the object
 
+        UpdateCameraPro(&camera, Vector3Scale(camMovement, camSpeed), camRotation, -GetMouseWheelMove());
 
-        for (int i = 0; i < 2; ++i) {
-            modelPositions[i].viewDistance = Vector3Distance(camera.position, modelPositions[i].position);
+        ResetUniformCacheStats(&uniforms);
+        float cameraPos[3] = {camera.position.x, camera.position.y, camera.position.z};
+        SetCachedShaderValue(&uniforms, shader.locs[SHADER_LOC_VECTOR_VIEW], cameraPos, SHADER_UNIFORM_VEC3);
+        if (light.dirty) {
+            UpdateLightBlock(&lightBlock, &light, 1);
+            light.dirty = false;
         }
 
-        UpdateCameraPro(&camera, Vector3Scale(camMovement, camSpeed), camRotation, -GetMouseWheelMove());
+        int clustered = clusteredLights;
+        SetCachedShaderValue(&uniforms, clusteredLoc, &clustered, SHADER_UNIFORM_INT);
+        if (clusteredLights) {
+            float time = (float)GetClockTime(&clock);
+            for (int i = 0; i < pointLightCount; ++i) {
+                float angle = time*0.5f + i;
+                pointLights[i].position = Vector3Add(pointLightOrigins[i], (Vector3) {2.0f*cosf(angle), 0.0f, 2.0f*sinf(angle)});
+            }
 
-        float cameraPos[3] = {camera.position.x, camera.position.y, camera.position.z};
-        SetShaderValue(shader, shader.locs[SHADER_LOC_VECTOR_VIEW], cameraPos, SHADER_UNIFORM_VEC3);
-        updateLight(light, shader);
+            // Same matrices BeginMode3D() sets up
+            float aspect = (float)GetRenderWidth()/(float)GetRenderHeight();
+            Matrix projection = MatrixPerspective(camera.fovy*DEG2RAD, aspect, RL_CULL_DISTANCE_NEAR, RL_CULL_DISTANCE_FAR);
+            if (camera.projection == CAMERA_ORTHOGRAPHIC) {
+                float top = camera.fovy/2.0f;
+                projection = MatrixOrtho(-top*aspect, top*aspect, -top, top, RL_CULL_DISTANCE_NEAR, RL_CULL_DISTANCE_FAR);
+            }
+
+            BeginProfileScope("BuildClusterGrid");
+            double binningStart = GetTime();
+            BuildClusterGrid(&clusters, pointLights, pointLightCount, GetCameraMatrix(camera), projection);
+            binningTime = GetTime() - binningStart;
+            UploadClusterGrid(&clusters, pointLights, pointLightCount);
+            EndProfileScope();
+
+            float screenSize[2] = {(float)GetRenderWidth(), (float)GetRenderHeight()};
+            float depth[2] = {clusters.near, clusters.far};
+            Vector3 forward = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+            SetCachedShaderValue(&uniforms, clusterScreenSizeLoc, screenSize, SHADER_UNIFORM_VEC2);
+            SetCachedShaderValue(&uniforms, clusterDepthLoc, depth, SHADER_UNIFORM_VEC2);
+            SetCachedShaderValue(&uniforms, viewForwardLoc, &forward, SHADER_UNIFORM_VEC3);
+        }
+        EndProfileScope();
 
         BeginDrawing();
         ClearBackground(light.enabled ? LIGHTGRAY : (Color) {125, 41, 55, 100});
         BeginMode3D(camera);
         BeginBlendMode(BLEND_ALPHA);
 
-        BeginShaderMode(shader);
-        MyMaterial material = emerald;
-        material.transparency = 1.0f;
-        updateMaterial(material, shader);
-        rlDrawRenderBatchActive();
-        material = ruby;
-        material.transparency = 1.0f;
-        updateMaterial(material, shader);
-        EndShaderMode();
+        BeginProfileScope("Culling");
+        ClearScene(&floor);
+        ClearScene(&reflections);
+        ClearScene(&opaque);
+        ClearScene(&objects);
 
+        AddSceneInstance(&floor, planeBatch, MatrixIdentity(), toSceneMaterial(obsidian, obsidian.transparency));
+
+        int objectCount = 2 + (stressMode ? stressCount : 0);
+        for (int i = 0; i < objectCount; ++i) {
+            objectPositions[i] = (i < 2) ? modelPositions[i].position : stressObjects[i - 2].position;
+        }
+        const int *order = UpdateDepthSort(&depthSort, objectPositions, objectCount, camera.position);
+
+        BeginCulling(camera);
+        for (int i = 0; i < objectCount; ++i) {
+            ModelPos *object = (order[i] < 2) ? &modelPositions[order[i]] : &stressObjects[order[i] - 2];
+            Vector3 position = object->position;
+            Mesh mesh = object->model.meshes[0];
+
+            // Reflection is the object flipped upside down under the floor
+            Matrix reflection = MatrixMultiply(MatrixRotateX(PI), MatrixTranslate(position.x, -1-position.y, position.z));
+            Matrix transform = MatrixTranslate(position.x, position.y, position.z);
+            if (!frustumCulling || IsMeshVisible(mesh, reflection)) {
+                AddSceneInstance(&reflections, object->batch, reflection, toSceneMaterial(object->material, 0.1f));
+            }
+            if (!frustumCulling || IsMeshVisible(mesh, transform)) {
+                AddSceneInstance((object->material.transparency < 1.0f) ? &objects : &opaque, object->batch, transform, toSceneMaterial(object->material, object->material.transparency));
+            }
+        }
+        CullStats cullStats = GetCullStats();
+        EndProfileScope();
+
+        // GPU scopes per pass, to see whether the stencil reflection or the lit and fogged objects cost more
+        BeginProfileScope("Reflections");
         BeginStencil();
+        BeginProfileGpuScope("StencilMask");
         BeginStencilMask();
-        updateMaterial(obsidian, shader);
-        DrawModel(plane, (Vector3) {0, 0, 0}, 1.0f, WHITE);
+        DrawScene(&floor);
         EndStencilMask();
+        EndProfileGpuScope();
 
-
-        BeginShaderMode(shader);
-        material = emerald;
-        material.transparency = 0.3f;
-        updateMaterial(material, shader);
-        rlDrawRenderBatchActive();
-        material = ruby;
-        material.transparency = 0.3f;
-        updateMaterial(material, shader);
-        EndShaderMode();
-
-        for (int i = 0; i < 2; ++i) {
-            material = modelPositions[i].material;
-            material.transparency = 0.1f;
-            updateMaterial(material, shader);
-            DrawModelEx(modelPositions[i].model,
-                        (Vector3) {modelPositions[i].position.x, -1-modelPositions[i].position.y, modelPositions[i].position.z},
-                        (Vector3) {1.0f, 0.0f, 0.0f},
-                        180,
-                        (Vector3) {1.0f, 1.0f, 1.0f},
-                        WHITE);
-        }
+        BeginProfileGpuScope("ReflectedObjects");
+        DrawScene(&reflections);
+        EndProfileGpuScope();
 
         EndStencil();
+        EndProfileScope();
+
+        // Opaque first, then transparent batches farthest first over them
+        BeginProfileGpuScope("Objects");
+        DrawScene(&opaque);
+        DrawScene(&objects);
+        EndProfileGpuScope();
+        profileScene(&floor);
+        profileScene(&reflections);
+        profileScene(&opaque);
+        profileScene(&objects);
 
-        lamp.transparency = light.enabled ? 1.0f : 0.3f;
-        updateMaterial(lamp, shader);
-        for (int i = 0; i < 2; ++i) {
-            updateMaterial(modelPositions[i].material, shader);
-            DrawModel(modelPositions[i].model, modelPositions[i].position, 1.0f, WHITE);
-        }
+        EndBlendMode();
+        EndMode3D();
 
+        BeginProfileGpuScope("Overlay");
+        DrawFPS(10, 10);
+        SetTextRunText(&hudText[0], TextFormatLocal("Frame time: %.2f ms, draw calls: %i, objects: %i ([T] stress mode)", GetFrameTime()*1000.0f,
+                                               floor.drawCalls + reflections.drawCalls + opaque.drawCalls + objects.drawCalls,
+                                               opaque.instanceCount + objects.instanceCount));
+        SetTextRunText(&hudText[1], TextFormatLocal("Uniform uploads: %i issued, %i skipped", uniforms.uploadsIssued, uniforms.uploadsSkipped));
+        SetTextRunText(&hudText[2], TextFormatLocal("Culling: %s ([O] toggle), %i tested, %i culled, %i drawn", frustumCulling ? "on" : "off",
+                                               cullStats.tested, cullStats.culled, cullStats.drawn));
+        DrawTextRun(hudText[0], (Vector2) {10, 35}, DARKGRAY);
+        DrawTextRun(hudText[1], (Vector2) {10, 60}, DARKGRAY);
+        DrawTextRun(hudText[2], (Vector2) {10, 85}, DARKGRAY);
+        if (clusteredLights) {
+            SetTextRunText(&hudText[3], TextFormatLocal("Point lights: %i ([K] toggle), binning %.2f ms, %i visible, max %i per cluster", pointLightCount,
+                                                   binningTime*1000.0, clusters.visibleLights, clusters.maxClusterLights));
+            DrawTextRun(hudText[3], (Vector2) {10, 110}, DARKGRAY);
+        }
+        DrawProfileOverlay(GetScreenWidth() - 450, 10);
+        EndProfileGpuScope();
 
+        AddProfileCounter(PROFILE_UNIFORM_UPLOADS, uniforms.uploadsIssued);
+        ProfileEndDrawing();
+        TickFrameClock(&clock);
 
-        EndBlendMode();
-        EndMode3D();
-        EndDrawing();
+        // [F4] records 120 frames, then writes them for chrome://tracing
+        if (IsProfileCaptureDone()) {
+            ExportProfileTrace("lab7_trace.json");
+            StartProfileCapture(0);     // Clears the capture
+        }
     }
+    UnloadScene(&floor);
+    UnloadScene(&reflections);
+    UnloadScene(&opaque);
+    UnloadScene(&objects);
+    UnloadDepthSort(&depthSort);
+    UnloadMeshBoundsCache();
+    UnloadClusterGrid(&clusters);
+    free(pointLights);
+    free(pointLightOrigins);
+    free(objectPositions);
+    free(stressObjects);
+    for (int i = 0; i < 4; ++i) UnloadTextRun(&hudText[i]);
+    UnloadModel(stressCube);
+    UnloadModel(stressSphere);
     UnloadModel(cube);
     UnloadModel(plane);
+    UnloadModel(sphere);
+    UnloadLightBlock(&lightBlock);
+    UnloadUniformCache(&uniforms);
     UnloadShader(shader);
+    CloseProfiler();
     CloseWindow();
     return 0;
 }
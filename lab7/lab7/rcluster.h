@@ -0,0 +1,363 @@
+/**********************************************************************************************
+*
+*   raylib.cluster - Clustered forward lighting for many point lights
+*
+*   DESCRIPTION:
+*       The view frustum is split in a grid of clusters (froxels): CLUSTER_GRID_X x CLUSTER_GRID_Y
+*       screen tiles and CLUSTER_GRID_Z depth slices, exponentially spaced between near and far.
+*       Every frame the CPU bins the lights into the clusters their sphere of influence touches,
+*       and the fragment shader only shades the lights listed for its own cluster, so cost per
+*       fragment depends on the lights in range instead of the total count.
+*
+*       Binning is two passes over the lights: count per cluster, prefix sum, then fill a flat
+*       index list. Lights, cluster ranges and the index list go to the shader as std430 storage
+*       buffers (binding points 1, 2 and 3):
+*
+*           struct PointLight { vec3 position; float radius; vec3 color; float intensity; };
+*           layout(std430, binding = 1) readonly buffer ClusterLights { PointLight pointLights[]; };
+*           layout(std430, binding = 2) readonly buffer ClusterCells { uvec2 clusterCells[]; };     // offset, count
+*           layout(std430, binding = 3) readonly buffer ClusterIndices { uint clusterIndices[]; };
+*
+*       Cluster of a fragment: tile from gl_FragCoord.xy, slice from view depth d as
+*       floor(log(d/near)/log(far/near)*CLUSTER_GRID_Z), depths before near go to slice 0.
+*
+*   CONFIGURATION:
+*
+*   #define RCLUSTER_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+*   NOTE: Storage buffers need OpenGL 4.3, see rubo.h
+*
+**********************************************************************************************/
+
+#ifndef RCLUSTER_H
+#define RCLUSTER_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define CLUSTER_GRID_X          16      // Screen tiles horizontally
+#define CLUSTER_GRID_Y          9       // Screen tiles vertically
+#define CLUSTER_GRID_Z          24      // Depth slices
+#define CLUSTER_COUNT           (CLUSTER_GRID_X*CLUSTER_GRID_Y*CLUSTER_GRID_Z)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Point light, std430 layout (32 bytes)
+typedef struct {
+    Vector3 position;
+    float radius;               // No light beyond this distance
+    Vector3 color;
+    float intensity;
+} ClusterLight;
+
+// Cluster grid, rebuilt every frame
+typedef struct {
+    float near;                 // Depth range split in slices
+    float far;
+
+    unsigned int *cells;        // Offset and count in indices per cluster
+    unsigned int *indices;      // Light indices, grouped by cluster
+    int indexCount;
+    int indexCapacity;
+    int *lightRanges;           // Cluster range per light: x0, x1, y0, y1, z0, z1 (x0 = -1 when culled)
+    int lightCapacity;
+
+    unsigned int lightsSsbo;    // GPU buffers, grown as needed
+    unsigned int cellsSsbo;
+    unsigned int indicesSsbo;
+    int lightsSsboCapacity;
+    int indicesSsboCapacity;
+
+    int lightCount;             // Lights binned last build
+    int visibleLights;          // Lights touching at least one cluster
+    int maxClusterLights;       // Most lights in one cluster
+} ClusterGrid;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+ClusterGrid LoadClusterGrid(float near, float far);                                 // Load cluster grid for depth range
+void BuildClusterGrid(ClusterGrid *grid, const ClusterLight *lights, int count, Matrix view, Matrix projection);   // Bin lights into clusters (CPU)
+void UploadClusterGrid(ClusterGrid *grid, const ClusterLight *lights, int count);   // Send lights and clusters to storage buffers, bound to points 1-3
+void UnloadClusterGrid(ClusterGrid *grid);                                          // Unload cluster grid and buffers
+void BenchmarkClusterGrid(int lightCount, int iterations);                          // Time light binning and log results
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RCLUSTER_H
+
+
+/***********************************************************************************
+*
+*   RCLUSTER IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RCLUSTER_IMPLEMENTATION)
+
+#include "raymath.h"
+#include "rubo.h"
+
+#include <stdlib.h>             // Required for: calloc(), realloc(), free(), rand()
+#include <string.h>             // Required for: memset()
+#include <math.h>               // Required for: logf(), floorf()
+#include <float.h>              // Required for: FLT_MAX
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static int GetClusterSlice(const ClusterGrid *grid, float depth);
+static int GetClusterTile(float ndc, int tiles);
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Load cluster grid for depth range
+ClusterGrid LoadClusterGrid(float near, float far)
+{
+    ClusterGrid grid = { 0 };
+    grid.near = near;
+    grid.far = far;
+    grid.cells = (unsigned int *)calloc(CLUSTER_COUNT*2, sizeof(unsigned int));
+
+    return grid;
+}
+
+// Bin lights into clusters
+// NOTE: A light sphere is bounded by its view space box, the box corners projected give
+// the tile range, which is conservative for perspective and orthographic projections
+void BuildClusterGrid(ClusterGrid *grid, const ClusterLight *lights, int count, Matrix view, Matrix projection)
+{
+    if (count > grid->lightCapacity)
+    {
+        grid->lightCapacity = count;
+        grid->lightRanges = (int *)realloc(grid->lightRanges, count*6*sizeof(int));
+    }
+
+    memset(grid->cells, 0, CLUSTER_COUNT*2*sizeof(unsigned int));
+    unsigned int *clusterCounts = grid->cells;      // Offsets slot used for counts first
+    int total = 0;
+
+    grid->lightCount = count;
+    grid->visibleLights = 0;
+    grid->maxClusterLights = 0;
+
+    // Pass 1: cluster range of every light, count per cluster
+    for (int i = 0; i < count; i++)
+    {
+        int *range = &grid->lightRanges[i*6];
+        range[0] = -1;
+
+        Vector3 center = Vector3Transform(lights[i].position, view);
+        float radius = lights[i].radius;
+
+        // View space looks down -z
+        float nearDepth = -center.z - radius;
+        float farDepth = -center.z + radius;
+        if ((farDepth <= 0.0f) || (nearDepth >= grid->far)) continue;
+
+        // Keep corners in front of the camera for the projection
+        float zFront = -fmaxf(nearDepth, 0.001f);
+        float zBack = -fminf(farDepth, grid->far);
+
+        float minX = FLT_MAX, maxX = -FLT_MAX, minY = FLT_MAX, maxY = -FLT_MAX;
+        for (int c = 0; c < 8; c++)
+        {
+            Vector3 corner = { center.x + ((c & 1)? radius : -radius), center.y + ((c & 2)? radius : -radius), (c & 4)? zBack : zFront };
+
+            float clipX = projection.m0*corner.x + projection.m4*corner.y + projection.m8*corner.z + projection.m12;
+            float clipY = projection.m1*corner.x + projection.m5*corner.y + projection.m9*corner.z + projection.m13;
+            float clipW = projection.m3*corner.x + projection.m7*corner.y + projection.m11*corner.z + projection.m15;
+
+            float ndcX = clipX/clipW;
+            float ndcY = clipY/clipW;
+            minX = fminf(minX, ndcX);
+            maxX = fmaxf(maxX, ndcX);
+            minY = fminf(minY, ndcY);
+            maxY = fmaxf(maxY, ndcY);
+        }
+
+        if ((maxX < -1.0f) || (minX > 1.0f) || (maxY < -1.0f) || (minY > 1.0f)) continue;
+
+        minX = Clamp(minX, -1.0f, 1.0f);
+        maxX = Clamp(maxX, -1.0f, 1.0f);
+        minY = Clamp(minY, -1.0f, 1.0f);
+        maxY = Clamp(maxY, -1.0f, 1.0f);
+
+        range[0] = GetClusterTile(minX, CLUSTER_GRID_X);
+        range[1] = GetClusterTile(maxX, CLUSTER_GRID_X);
+        range[2] = GetClusterTile(minY, CLUSTER_GRID_Y);
+        range[3] = GetClusterTile(maxY, CLUSTER_GRID_Y);
+        range[4] = GetClusterSlice(grid, nearDepth);
+        range[5] = GetClusterSlice(grid, farDepth);
+
+        for (int z = range[4]; z <= range[5]; z++)
+        {
+            for (int y = range[2]; y <= range[3]; y++)
+            {
+                for (int x = range[0]; x <= range[1]; x++) clusterCounts[((z*CLUSTER_GRID_Y + y)*CLUSTER_GRID_X + x)*2 + 1]++;
+            }
+        }
+
+        total += (range[1] - range[0] + 1)*(range[3] - range[2] + 1)*(range[5] - range[4] + 1);
+        grid->visibleLights++;
+    }
+
+    // Prefix sum, counts are rebuilt while filling
+    unsigned int offset = 0;
+    for (int c = 0; c < CLUSTER_COUNT; c++)
+    {
+        unsigned int clusterCount = grid->cells[c*2 + 1];
+        if ((int)clusterCount > grid->maxClusterLights) grid->maxClusterLights = (int)clusterCount;
+
+        grid->cells[c*2] = offset;
+        grid->cells[c*2 + 1] = 0;
+        offset += clusterCount;
+    }
+
+    if (total > grid->indexCapacity)
+    {
+        grid->indexCapacity = total + total/2;
+        grid->indices = (unsigned int *)realloc(grid->indices, grid->indexCapacity*sizeof(unsigned int));
+    }
+    grid->indexCount = total;
+
+    // Pass 2: fill light indices, clusters list lights in ascending order
+    for (int i = 0; i < count; i++)
+    {
+        const int *range = &grid->lightRanges[i*6];
+        if (range[0] < 0) continue;
+
+        for (int z = range[4]; z <= range[5]; z++)
+        {
+            for (int y = range[2]; y <= range[3]; y++)
+            {
+                for (int x = range[0]; x <= range[1]; x++)
+                {
+                    unsigned int *cell = &grid->cells[((z*CLUSTER_GRID_Y + y)*CLUSTER_GRID_X + x)*2];
+                    grid->indices[cell[0] + cell[1]] = (unsigned int)i;
+                    cell[1]++;
+                }
+            }
+        }
+    }
+}
+
+// Send lights and clusters to storage buffers, bound to points 1-3
+// NOTE: Buffers only grow, reloaded when the data does not fit
+void UploadClusterGrid(ClusterGrid *grid, const ClusterLight *lights, int count)
+{
+    if (grid->cellsSsbo == 0) grid->cellsSsbo = LoadStorageBuffer(NULL, CLUSTER_COUNT*2*sizeof(unsigned int));
+
+    if ((count > grid->lightsSsboCapacity) || (grid->lightsSsbo == 0))
+    {
+        UnloadStorageBuffer(grid->lightsSsbo);
+        grid->lightsSsboCapacity = (count > 64)? count : 64;
+        grid->lightsSsbo = LoadStorageBuffer(NULL, grid->lightsSsboCapacity*sizeof(ClusterLight));
+    }
+
+    if ((grid->indexCount > grid->indicesSsboCapacity) || (grid->indicesSsbo == 0))
+    {
+        UnloadStorageBuffer(grid->indicesSsbo);
+        grid->indicesSsboCapacity = (grid->indexCapacity > 256)? grid->indexCapacity : 256;
+        grid->indicesSsbo = LoadStorageBuffer(NULL, grid->indicesSsboCapacity*sizeof(unsigned int));
+    }
+
+    if (count > 0) UpdateStorageBuffer(grid->lightsSsbo, lights, count*sizeof(ClusterLight), 0);
+    UpdateStorageBuffer(grid->cellsSsbo, grid->cells, CLUSTER_COUNT*2*sizeof(unsigned int), 0);
+    if (grid->indexCount > 0) UpdateStorageBuffer(grid->indicesSsbo, grid->indices, grid->indexCount*sizeof(unsigned int), 0);
+
+    BindStorageBuffer(grid->lightsSsbo, 1);
+    BindStorageBuffer(grid->cellsSsbo, 2);
+    BindStorageBuffer(grid->indicesSsbo, 3);
+}
+
+// Unload cluster grid and buffers
+void UnloadClusterGrid(ClusterGrid *grid)
+{
+    UnloadStorageBuffer(grid->lightsSsbo);
+    UnloadStorageBuffer(grid->cellsSsbo);
+    UnloadStorageBuffer(grid->indicesSsbo);
+
+    free(grid->cells);
+    free(grid->indices);
+    free(grid->lightRanges);
+
+    memset(grid, 0, sizeof(ClusterGrid));
+}
+
+// Time light binning and log results
+// NOTE: Lights are spread over a 80x80 floor, camera looks over it like lab7 does
+void BenchmarkClusterGrid(int lightCount, int iterations)
+{
+    ClusterLight *lights = (ClusterLight *)malloc(lightCount*sizeof(ClusterLight));
+
+    srand(1);
+    for (int i = 0; i < lightCount; i++)
+    {
+        lights[i].position = (Vector3){ (rand()%8000)/100.0f - 40.0f, (rand()%500)/100.0f, (rand()%8000)/100.0f - 40.0f };
+        lights[i].radius = 1.0f + (rand()%300)/100.0f;
+        lights[i].color = (Vector3){ 1.0f, 1.0f, 1.0f };
+        lights[i].intensity = 1.0f;
+    }
+
+    Matrix view = MatrixLookAt((Vector3){ 25.0f, 6.0f, 25.0f }, (Vector3){ 0.0f, 3.0f, 0.0f }, (Vector3){ 0.0f, 1.0f, 0.0f });
+    Matrix projection = MatrixPerspective(45.0f*DEG2RAD, 16.0f/9.0f, 0.01, 1000.0);
+
+    ClusterGrid grid = LoadClusterGrid(1.0f, 200.0f);
+    BuildClusterGrid(&grid, lights, lightCount, view, projection);      // Warm up, grows buffers
+
+    double start = GetTime();
+    for (int i = 0; i < iterations; i++) BuildClusterGrid(&grid, lights, lightCount, view, projection);
+    double time = (GetTime() - start)/iterations;
+
+    int usedClusters = 0;
+    for (int c = 0; c < CLUSTER_COUNT; c++) if (grid.cells[c*2 + 1] > 0) usedClusters++;
+
+    TraceLog(LOG_INFO, "BENCH: [clusters] %i lights, %ix%ix%i clusters, binning %.3f ms", lightCount, CLUSTER_GRID_X, CLUSTER_GRID_Y, CLUSTER_GRID_Z, time*1000.0);
+    TraceLog(LOG_INFO, "BENCH: [clusters] %i lights visible, %i light indices, %i clusters used", grid.visibleLights, grid.indexCount, usedClusters);
+    TraceLog(LOG_INFO, "BENCH: [clusters] lights per used cluster: %.1f average, %i max (vs %i without clustering)",
+             (usedClusters > 0)? (float)grid.indexCount/usedClusters : 0.0f, grid.maxClusterLights, lightCount);
+
+    UnloadClusterGrid(&grid);
+    free(lights);
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Get depth slice, exponential between near and far
+static int GetClusterSlice(const ClusterGrid *grid, float depth)
+{
+    if (depth <= grid->near) return 0;
+
+    int slice = (int)floorf(logf(depth/grid->near)/logf(grid->far/grid->near)*CLUSTER_GRID_Z);
+
+    return (slice < CLUSTER_GRID_Z)? slice : CLUSTER_GRID_Z - 1;
+}
+
+// Get screen tile from normalized device coordinate
+static int GetClusterTile(float ndc, int tiles)
+{
+    int tile = (int)floorf((ndc*0.5f + 0.5f)*tiles);
+
+    if (tile < 0) return 0;
+    return (tile < tiles)? tile : tiles - 1;
+}
+
+#endif // RCLUSTER_IMPLEMENTATION
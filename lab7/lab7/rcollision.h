@@ -0,0 +1,872 @@
+/**********************************************************************************************
+*
+*   raylib.collision - Accelerated ray queries against meshes
+*
+*   DESCRIPTION:
+*       GetRayCollisionMesh() transforms every vertex and tests every triangle for each ray.
+*       This module builds a bounding volume hierarchy once per mesh (binned SAH) and answers
+*       ray queries by moving the ray into model space instead of moving the triangles.
+*
+*       Batch queries take an array of rays and pay the per-call setup once: triangles are
+*       transformed a single time and tested against packets of 4 (SSE/NEON) or 8 (AVX) rays
+*       in SoA form, with packets split across the rjobs.h worker pool.
+*
+*   CONFIGURATION:
+*
+*   #define RCOLLISION_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+**********************************************************************************************/
+
+#ifndef RCOLLISION_H
+#define RCOLLISION_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define BVH_SAH_BINS            16      // Number of bins used to evaluate SAH splits
+#define BVH_MAX_LEAF_TRIANGLES  4       // Leaves never hold more triangles than this (unless at BVH_MAX_DEPTH)
+#define BVH_MAX_DEPTH           64      // Tree depth limit, also the traversal stack size
+#define RAY_BATCH_GRAIN         8       // Packets (or BVH rays x8) handed to a worker at a time
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// BVH node, 32 bytes
+// NOTE: Inner nodes store their two children at nodes[first] and nodes[first + 1]
+typedef struct {
+    Vector3 min;
+    int first;              // First child (inner node) or first triangle (leaf)
+    Vector3 max;
+    int count;              // Triangles in leaf, 0 for inner nodes
+} MeshBVHNode;
+
+// Mesh bounding volume hierarchy
+// NOTE: Triangles are copied in BVH order, the source mesh can be unloaded
+typedef struct {
+    int nodeCount;
+    int triangleCount;
+    MeshBVHNode *nodes;
+    Vector3 *triangles;     // Triangle vertices in model space (3 per triangle)
+} MeshBVH;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+MeshBVH LoadMeshBVH(Mesh mesh);                                             // Build mesh BVH (requires CPU vertex data)
+void UnloadMeshBVH(MeshBVH bvh);                                            // Unload mesh BVH
+bool IsMeshBVHReady(MeshBVH bvh);                                           // Check if mesh BVH was built
+RayCollision GetRayCollisionBVH(Ray ray, MeshBVH bvh, Matrix transform);    // Get collision info between ray and BVH mesh
+void BenchmarkRayCollisionBVH(Mesh mesh, const char *name, int rayCount);   // Compare BVH against GetRayCollisionMesh() and log results
+
+void GetRayCollisionMeshBatch(const Ray *rays, int rayCount, Mesh mesh, Matrix transform, RayCollision *collisions);   // Get collision info for many rays against one mesh
+void GetRayCollisionModelBatch(const Ray *rays, int rayCount, Model model, RayCollision *collisions);                 // Get collision info for many rays against all model meshes
+void GetRayCollisionBVHBatch(const Ray *rays, int rayCount, MeshBVH bvh, Matrix transform, RayCollision *collisions); // Get collision info for many rays against one BVH mesh
+void BenchmarkRayCollisionBatch(Mesh mesh, const char *name, int rayCount); // Compare batch queries against a per-ray loop and log results
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RCOLLISION_H
+
+
+/***********************************************************************************
+*
+*   RCOLLISION IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RCOLLISION_IMPLEMENTATION)
+
+#include "raymath.h"
+#include "rjobs.h"
+
+#include <stdlib.h>             // Required for: malloc(), free()
+#include <float.h>              // Required for: FLT_MAX
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #include <arm_neon.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define BVH_EPSILON     0.000001f       // Same tolerance as GetRayCollisionTriangle()
+
+// Ray packet operations, RAY_PACKET_SIZE lanes of float
+#if defined(__AVX__)
+    #define RAY_PACKET_SIZE         8
+    typedef __m256 rpfloat;
+    #define RP_SET1(x)              _mm256_set1_ps(x)
+    #define RP_LOAD(p)              _mm256_loadu_ps(p)
+    #define RP_STORE(p, a)          _mm256_storeu_ps(p, a)
+    #define RP_ADD(a, b)            _mm256_add_ps(a, b)
+    #define RP_SUB(a, b)            _mm256_sub_ps(a, b)
+    #define RP_MUL(a, b)            _mm256_mul_ps(a, b)
+    #define RP_DIV(a, b)            _mm256_div_ps(a, b)
+    #define RP_GT(a, b)             _mm256_cmp_ps(a, b, _CMP_GT_OQ)
+    #define RP_GE(a, b)             _mm256_cmp_ps(a, b, _CMP_GE_OQ)
+    #define RP_AND(a, b)            _mm256_and_ps(a, b)
+    #define RP_OR(a, b)             _mm256_or_ps(a, b)
+    #define RP_SELECT(a, b, mask)   _mm256_blendv_ps(a, b, mask)
+    #define RP_ANY(mask)            (_mm256_movemask_ps(mask) != 0)
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define RAY_PACKET_SIZE         4
+    typedef __m128 rpfloat;
+    #define RP_SET1(x)              _mm_set1_ps(x)
+    #define RP_LOAD(p)              _mm_loadu_ps(p)
+    #define RP_STORE(p, a)          _mm_storeu_ps(p, a)
+    #define RP_ADD(a, b)            _mm_add_ps(a, b)
+    #define RP_SUB(a, b)            _mm_sub_ps(a, b)
+    #define RP_MUL(a, b)            _mm_mul_ps(a, b)
+    #define RP_DIV(a, b)            _mm_div_ps(a, b)
+    #define RP_GT(a, b)             _mm_cmpgt_ps(a, b)
+    #define RP_GE(a, b)             _mm_cmpge_ps(a, b)
+    #define RP_AND(a, b)            _mm_and_ps(a, b)
+    #define RP_OR(a, b)             _mm_or_ps(a, b)
+    #define RP_SELECT(a, b, mask)   _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a))
+    #define RP_ANY(mask)            (_mm_movemask_ps(mask) != 0)
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #define RAY_PACKET_SIZE         4
+    typedef float32x4_t rpfloat;
+    #define RP_SET1(x)              vdupq_n_f32(x)
+    #define RP_LOAD(p)              vld1q_f32(p)
+    #define RP_STORE(p, a)          vst1q_f32(p, a)
+    #define RP_ADD(a, b)            vaddq_f32(a, b)
+    #define RP_SUB(a, b)            vsubq_f32(a, b)
+    #define RP_MUL(a, b)            vmulq_f32(a, b)
+    #define RP_DIV(a, b)            vdivq_f32(a, b)
+    #define RP_GT(a, b)             vreinterpretq_f32_u32(vcgtq_f32(a, b))
+    #define RP_GE(a, b)             vreinterpretq_f32_u32(vcgeq_f32(a, b))
+    #define RP_AND(a, b)            vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)))
+    #define RP_OR(a, b)             vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)))
+    #define RP_SELECT(a, b, mask)   vbslq_f32(vreinterpretq_u32_f32(mask), b, a)
+    #define RP_ANY(mask)            (vmaxvq_u32(vreinterpretq_u32_f32(mask)) != 0)
+#else
+    #define RAY_PACKET_SIZE         1       // No SIMD available, packets degrade to single rays
+#endif
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Ray prepared for BVH traversal, in model space
+typedef struct {
+    Vector3 position;
+    Vector3 direction;
+    Vector3 invDirection;
+} BVHRay;
+
+// SAH bin
+typedef struct {
+    BoundingBox bounds;
+    int count;
+} BVHBin;
+
+// Triangle prepared for batch tests, world space
+typedef struct {
+    Vector3 v0;
+    Vector3 edge1;
+    Vector3 edge2;
+} BatchTriangle;
+
+// Shared state of a batch query, read by all workers
+typedef struct {
+    const Ray *rays;
+    int rayCount;
+    RayCollision *collisions;
+    const BatchTriangle *triangles;
+    int triangleCount;
+    MeshBVH bvh;
+    Matrix transform;
+} RayBatch;
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static BoundingBox BVHEmptyBox(void);
+static BoundingBox BVHGrowBox(BoundingBox box, Vector3 point);
+static BoundingBox BVHMergeBox(BoundingBox a, BoundingBox b);
+static float BVHBoxArea(BoundingBox box);
+static void BVHSubdivide(MeshBVH *bvh, int nodeIndex, int depth, int *triIndices, const Vector3 *centroids, const Vector3 *vertices);
+static float BVHIntersectBox(const BVHRay *ray, Vector3 min, Vector3 max, float tmax);
+static RayCollision BVHTraverse(MeshBVH bvh, Ray ray, Matrix transform, int *trianglesTested);
+static Ray *GenBenchmarkRays(Mesh mesh, Matrix transform, int rayCount);
+static void RayBatchPacketJob(int begin, int end, void *userData);
+static void RayBatchBVHJob(int begin, int end, void *userData);
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Build mesh BVH
+MeshBVH LoadMeshBVH(Mesh mesh)
+{
+    MeshBVH bvh = { 0 };
+
+    if ((mesh.vertices == NULL) || (mesh.triangleCount <= 0))
+    {
+        TraceLog(LOG_WARNING, "BVH: Mesh vertex data not available on CPU, BVH not built");
+        return bvh;
+    }
+
+    int triangleCount = mesh.triangleCount;
+    const Vector3 *vertdata = (const Vector3 *)mesh.vertices;
+
+    Vector3 *vertices = (Vector3 *)malloc(triangleCount*3*sizeof(Vector3));
+    Vector3 *centroids = (Vector3 *)malloc(triangleCount*sizeof(Vector3));
+    int *triIndices = (int *)malloc(triangleCount*sizeof(int));
+
+    for (int i = 0; i < triangleCount; i++)
+    {
+        for (int k = 0; k < 3; k++)
+        {
+            int index = (mesh.indices != NULL)? mesh.indices[i*3 + k] : i*3 + k;
+            vertices[i*3 + k] = vertdata[index];
+        }
+
+        centroids[i] = Vector3Scale(Vector3Add(Vector3Add(vertices[i*3], vertices[i*3 + 1]), vertices[i*3 + 2]), 1.0f/3.0f);
+        triIndices[i] = i;
+    }
+
+    bvh.triangleCount = triangleCount;
+    bvh.nodes = (MeshBVHNode *)malloc((2*triangleCount - 1)*sizeof(MeshBVHNode));
+    bvh.nodeCount = 1;
+    bvh.nodes[0].first = 0;
+    bvh.nodes[0].count = triangleCount;
+
+    BVHSubdivide(&bvh, 0, 0, triIndices, centroids, vertices);
+
+    // Store triangles in leaf order so every leaf reads one contiguous range
+    bvh.triangles = (Vector3 *)malloc(triangleCount*3*sizeof(Vector3));
+    for (int i = 0; i < triangleCount; i++)
+    {
+        bvh.triangles[i*3 + 0] = vertices[triIndices[i]*3 + 0];
+        bvh.triangles[i*3 + 1] = vertices[triIndices[i]*3 + 1];
+        bvh.triangles[i*3 + 2] = vertices[triIndices[i]*3 + 2];
+    }
+
+    free(vertices);
+    free(centroids);
+    free(triIndices);
+
+    TraceLog(LOG_INFO, "BVH: Mesh BVH built successfully (%i triangles, %i nodes)", bvh.triangleCount, bvh.nodeCount);
+
+    return bvh;
+}
+
+// Unload mesh BVH
+void UnloadMeshBVH(MeshBVH bvh)
+{
+    free(bvh.nodes);
+    free(bvh.triangles);
+}
+
+// Check if mesh BVH was built
+bool IsMeshBVHReady(MeshBVH bvh)
+{
+    return (bvh.nodes != NULL) && (bvh.triangles != NULL);
+}
+
+// Get collision info between ray and BVH mesh
+// NOTE: Results match GetRayCollisionMesh(ray, mesh, transform) for the source mesh
+RayCollision GetRayCollisionBVH(Ray ray, MeshBVH bvh, Matrix transform)
+{
+    return BVHTraverse(bvh, ray, transform, NULL);
+}
+
+// Compare BVH against GetRayCollisionMesh() and log results
+void BenchmarkRayCollisionBVH(Mesh mesh, const char *name, int rayCount)
+{
+    BoundingBox box = GetMeshBoundingBox(mesh);
+    float radius = Vector3Length(Vector3Subtract(box.max, box.min));
+    Matrix transform = MatrixMultiply(MatrixRotateY(0.5f), MatrixTranslate(1.0f, 2.0f, 3.0f));
+    Ray *rays = GenBenchmarkRays(mesh, transform, rayCount);
+
+    RayCollision *linear = (RayCollision *)malloc(rayCount*sizeof(RayCollision));
+
+    double linearStart = GetTime();
+    for (int i = 0; i < rayCount; i++) linear[i] = GetRayCollisionMesh(rays[i], mesh, transform);
+    double linearTime = GetTime() - linearStart;
+
+    double buildStart = GetTime();
+    MeshBVH bvh = LoadMeshBVH(mesh);
+    double buildTime = GetTime() - buildStart;
+
+    long long trianglesTested = 0;
+    int mismatches = 0;
+
+    double bvhStart = GetTime();
+    for (int i = 0; i < rayCount; i++)
+    {
+        int tested = 0;
+        RayCollision hit = BVHTraverse(bvh, rays[i], transform, &tested);
+        trianglesTested += tested;
+
+        if ((hit.hit != linear[i].hit) || (hit.hit && (fabsf(hit.distance - linear[i].distance) > 0.001f*radius))) mismatches++;
+    }
+    double bvhTime = GetTime() - bvhStart;
+
+    TraceLog(LOG_INFO, "BENCH: [%s] %i triangles, %i rays, BVH build %.2f ms", name, mesh.triangleCount, rayCount, buildTime*1000.0);
+    TraceLog(LOG_INFO, "BENCH: [%s] linear: %10.0f rays/s, %8i triangles/ray", name, rayCount/linearTime, mesh.triangleCount);
+    TraceLog(LOG_INFO, "BENCH: [%s] bvh:    %10.0f rays/s, %8.1f triangles/ray (%.1fx, %i mismatches)", name,
+        rayCount/bvhTime, (double)trianglesTested/rayCount, linearTime/bvhTime, mismatches);
+
+    UnloadMeshBVH(bvh);
+    free(linear);
+    free(rays);
+}
+
+// Get collision info for many rays against one mesh
+// NOTE: Equivalent to GetRayCollisionMesh() per ray, triangles are transformed once per call
+void GetRayCollisionMeshBatch(const Ray *rays, int rayCount, Mesh mesh, Matrix transform, RayCollision *collisions)
+{
+    for (int i = 0; i < rayCount; i++) collisions[i] = (RayCollision){ 0 };
+    if ((mesh.vertices == NULL) || (rayCount <= 0)) return;
+
+    const Vector3 *vertdata = (const Vector3 *)mesh.vertices;
+    BatchTriangle *triangles = (BatchTriangle *)malloc(mesh.triangleCount*sizeof(BatchTriangle));
+
+    for (int i = 0; i < mesh.triangleCount; i++)
+    {
+        Vector3 v[3];
+        for (int k = 0; k < 3; k++)
+        {
+            int index = (mesh.indices != NULL)? mesh.indices[i*3 + k] : i*3 + k;
+            v[k] = Vector3Transform(vertdata[index], transform);
+        }
+
+        triangles[i].v0 = v[0];
+        triangles[i].edge1 = Vector3Subtract(v[1], v[0]);
+        triangles[i].edge2 = Vector3Subtract(v[2], v[0]);
+    }
+
+    RayBatch batch = { 0 };
+    batch.rays = rays;
+    batch.rayCount = rayCount;
+    batch.collisions = collisions;
+    batch.triangles = triangles;
+    batch.triangleCount = mesh.triangleCount;
+
+    int packetCount = (rayCount + RAY_PACKET_SIZE - 1)/RAY_PACKET_SIZE;
+    RunJobsParallel(packetCount, RAY_BATCH_GRAIN, RayBatchPacketJob, &batch);
+
+    free(triangles);
+}
+
+// Get collision info for many rays against all model meshes
+void GetRayCollisionModelBatch(const Ray *rays, int rayCount, Model model, RayCollision *collisions)
+{
+    for (int i = 0; i < rayCount; i++) collisions[i] = (RayCollision){ 0 };
+    if (rayCount <= 0) return;
+
+    RayCollision *meshCollisions = (RayCollision *)malloc(rayCount*sizeof(RayCollision));
+
+    for (int m = 0; m < model.meshCount; m++)
+    {
+        GetRayCollisionMeshBatch(rays, rayCount, model.meshes[m], model.transform, meshCollisions);
+
+        for (int i = 0; i < rayCount; i++)
+        {
+            if (meshCollisions[i].hit && (!collisions[i].hit || (meshCollisions[i].distance < collisions[i].distance))) collisions[i] = meshCollisions[i];
+        }
+    }
+
+    free(meshCollisions);
+}
+
+// Get collision info for many rays against one BVH mesh
+void GetRayCollisionBVHBatch(const Ray *rays, int rayCount, MeshBVH bvh, Matrix transform, RayCollision *collisions)
+{
+    RayBatch batch = { 0 };
+    batch.rays = rays;
+    batch.rayCount = rayCount;
+    batch.collisions = collisions;
+    batch.bvh = bvh;
+    batch.transform = transform;
+
+    RunJobsParallel(rayCount, RAY_BATCH_GRAIN*8, RayBatchBVHJob, &batch);
+}
+
+// Compare batch queries against a per-ray loop and log results
+void BenchmarkRayCollisionBatch(Mesh mesh, const char *name, int rayCount)
+{
+    Matrix transform = MatrixMultiply(MatrixRotateY(0.5f), MatrixTranslate(1.0f, 2.0f, 3.0f));
+    Ray *rays = GenBenchmarkRays(mesh, transform, rayCount);
+    RayCollision *scalar = (RayCollision *)malloc(rayCount*sizeof(RayCollision));
+    RayCollision *batch = (RayCollision *)malloc(rayCount*sizeof(RayCollision));
+    int threadCount = GetJobsThreadCount();
+
+    double scalarStart = GetTime();
+    for (int i = 0; i < rayCount; i++) scalar[i] = GetRayCollisionMesh(rays[i], mesh, transform);
+    double scalarTime = GetTime() - scalarStart;
+
+    InitJobs(1);
+    double packetStart = GetTime();
+    GetRayCollisionMeshBatch(rays, rayCount, mesh, transform, batch);
+    double packetTime = GetTime() - packetStart;
+
+    InitJobs(threadCount);
+    double batchStart = GetTime();
+    GetRayCollisionMeshBatch(rays, rayCount, mesh, transform, batch);
+    double batchTime = GetTime() - batchStart;
+
+    int mismatches = 0;
+    for (int i = 0; i < rayCount; i++)
+    {
+        if ((batch[i].hit != scalar[i].hit) || (batch[i].hit && (fabsf(batch[i].distance - scalar[i].distance) > 0.0001f*(1.0f + scalar[i].distance)))) mismatches++;
+    }
+
+    MeshBVH bvh = LoadMeshBVH(mesh);
+    double bvhStart = GetTime();
+    GetRayCollisionBVHBatch(rays, rayCount, bvh, transform, batch);
+    double bvhTime = GetTime() - bvhStart;
+    UnloadMeshBVH(bvh);
+
+    TraceLog(LOG_INFO, "BENCH: [%s] %i triangles, %i rays, packet size %i, %i threads", name, mesh.triangleCount, rayCount, RAY_PACKET_SIZE, threadCount);
+    TraceLog(LOG_INFO, "BENCH: [%s] per-ray loop:     %10.0f rays/s", name, rayCount/scalarTime);
+    TraceLog(LOG_INFO, "BENCH: [%s] batch, 1 thread:  %10.0f rays/s (%.1fx)", name, rayCount/packetTime, scalarTime/packetTime);
+    TraceLog(LOG_INFO, "BENCH: [%s] batch, %2i threads: %10.0f rays/s (%.1fx, %i mismatches)", name, threadCount, rayCount/batchTime, scalarTime/batchTime, mismatches);
+    TraceLog(LOG_INFO, "BENCH: [%s] BVH batch:        %10.0f rays/s (%.1fx)", name, rayCount/bvhTime, scalarTime/bvhTime);
+
+    free(batch);
+    free(scalar);
+    free(rays);
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+static BoundingBox BVHEmptyBox(void)
+{
+    return (BoundingBox){ { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+}
+
+static BoundingBox BVHGrowBox(BoundingBox box, Vector3 point)
+{
+    return (BoundingBox){ Vector3Min(box.min, point), Vector3Max(box.max, point) };
+}
+
+static BoundingBox BVHMergeBox(BoundingBox a, BoundingBox b)
+{
+    return (BoundingBox){ Vector3Min(a.min, b.min), Vector3Max(a.max, b.max) };
+}
+
+static float BVHBoxArea(BoundingBox box)
+{
+    Vector3 e = Vector3Subtract(box.max, box.min);
+    return e.x*e.y + e.y*e.z + e.z*e.x;
+}
+
+// Compute node bounds and split it using binned SAH, recursively
+// NOTE: Nodes at BVH_MAX_DEPTH stay leaves, so traversal never needs more than BVH_MAX_DEPTH stack entries
+static void BVHSubdivide(MeshBVH *bvh, int nodeIndex, int depth, int *triIndices, const Vector3 *centroids, const Vector3 *vertices)
+{
+    MeshBVHNode *node = &bvh->nodes[nodeIndex];
+    int first = node->first;
+    int count = node->count;
+
+    BoundingBox bounds = BVHEmptyBox();
+    BoundingBox centroidBounds = BVHEmptyBox();
+    for (int i = first; i < first + count; i++)
+    {
+        int tri = triIndices[i];
+        bounds = BVHGrowBox(bounds, vertices[tri*3 + 0]);
+        bounds = BVHGrowBox(bounds, vertices[tri*3 + 1]);
+        bounds = BVHGrowBox(bounds, vertices[tri*3 + 2]);
+        centroidBounds = BVHGrowBox(centroidBounds, centroids[tri]);
+    }
+
+    node->min = bounds.min;
+    node->max = bounds.max;
+
+    if ((count <= 2) || (depth >= BVH_MAX_DEPTH)) return;
+
+    // Find the cheapest split over all axes
+    int bestAxis = -1;
+    int bestSplit = 0;
+    float bestCost = FLT_MAX;
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        float cmin = (&centroidBounds.min.x)[axis];
+        float cmax = (&centroidBounds.max.x)[axis];
+        if (cmax - cmin < 1e-12f) continue;
+
+        BVHBin bins[BVH_SAH_BINS];
+        for (int b = 0; b < BVH_SAH_BINS; b++) { bins[b].bounds = BVHEmptyBox(); bins[b].count = 0; }
+
+        float scale = BVH_SAH_BINS/(cmax - cmin);
+        for (int i = first; i < first + count; i++)
+        {
+            int tri = triIndices[i];
+            int b = (int)(((&centroids[tri].x)[axis] - cmin)*scale);
+            if (b > BVH_SAH_BINS - 1) b = BVH_SAH_BINS - 1;
+
+            bins[b].count++;
+            bins[b].bounds = BVHGrowBox(bins[b].bounds, vertices[tri*3 + 0]);
+            bins[b].bounds = BVHGrowBox(bins[b].bounds, vertices[tri*3 + 1]);
+            bins[b].bounds = BVHGrowBox(bins[b].bounds, vertices[tri*3 + 2]);
+        }
+
+        // Sweep from both sides to get areas and counts for every split plane
+        float leftArea[BVH_SAH_BINS - 1], rightArea[BVH_SAH_BINS - 1];
+        int leftCount[BVH_SAH_BINS - 1], rightCount[BVH_SAH_BINS - 1];
+        BoundingBox leftBox = BVHEmptyBox(), rightBox = BVHEmptyBox();
+        int leftSum = 0, rightSum = 0;
+
+        for (int b = 0; b < BVH_SAH_BINS - 1; b++)
+        {
+            leftSum += bins[b].count;
+            leftCount[b] = leftSum;
+            if (bins[b].count > 0) leftBox = BVHMergeBox(leftBox, bins[b].bounds);
+            leftArea[b] = (leftSum > 0)? BVHBoxArea(leftBox) : 0.0f;
+
+            int r = BVH_SAH_BINS - 1 - b;
+            rightSum += bins[r].count;
+            rightCount[r - 1] = rightSum;
+            if (bins[r].count > 0) rightBox = BVHMergeBox(rightBox, bins[r].bounds);
+            rightArea[r - 1] = (rightSum > 0)? BVHBoxArea(rightBox) : 0.0f;
+        }
+
+        for (int b = 0; b < BVH_SAH_BINS - 1; b++)
+        {
+            if ((leftCount[b] == 0) || (rightCount[b] == 0)) continue;
+
+            float cost = leftCount[b]*leftArea[b] + rightCount[b]*rightArea[b];
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = b;
+            }
+        }
+    }
+
+    // Keep a leaf when splitting does not pay off (traversal cost ~ one triangle test)
+    float leafCost = count*BVHBoxArea(bounds);
+    if ((count <= BVH_MAX_LEAF_TRIANGLES) && ((bestAxis == -1) || (bestCost + BVHBoxArea(bounds) >= leafCost))) return;
+
+    // Median split when there is no SAH split (all centroids at one point) or the partition ends up one sided
+    int split = first + count/2;
+
+    if (bestAxis != -1)
+    {
+        // Partition triangles in place
+        float cmin = (&centroidBounds.min.x)[bestAxis];
+        float scale = BVH_SAH_BINS/((&centroidBounds.max.x)[bestAxis] - cmin);
+        int i = first;
+        int j = first + count - 1;
+
+        while (i <= j)
+        {
+            int b = (int)(((&centroids[triIndices[i]].x)[bestAxis] - cmin)*scale);
+            if (b > BVH_SAH_BINS - 1) b = BVH_SAH_BINS - 1;
+
+            if (b <= bestSplit) i++;
+            else
+            {
+                int tmp = triIndices[i];
+                triIndices[i] = triIndices[j];
+                triIndices[j] = tmp;
+                j--;
+            }
+        }
+
+        if ((i > first) && (i < first + count)) split = i;
+    }
+
+    int leftCount = split - first;
+
+    int leftIndex = bvh->nodeCount;
+    bvh->nodeCount += 2;
+
+    bvh->nodes[leftIndex].first = first;
+    bvh->nodes[leftIndex].count = leftCount;
+    bvh->nodes[leftIndex + 1].first = split;
+    bvh->nodes[leftIndex + 1].count = count - leftCount;
+
+    node = &bvh->nodes[nodeIndex];
+    node->first = leftIndex;
+    node->count = 0;
+
+    BVHSubdivide(bvh, leftIndex, depth + 1, triIndices, centroids, vertices);
+    BVHSubdivide(bvh, leftIndex + 1, depth + 1, triIndices, centroids, vertices);
+}
+
+// Get ray entry distance into box, FLT_MAX if missed or farther than tmax
+static float BVHIntersectBox(const BVHRay *ray, Vector3 min, Vector3 max, float tmax)
+{
+    float tx1 = (min.x - ray->position.x)*ray->invDirection.x, tx2 = (max.x - ray->position.x)*ray->invDirection.x;
+    float tnear = fminf(tx1, tx2), tfar = fmaxf(tx1, tx2);
+    float ty1 = (min.y - ray->position.y)*ray->invDirection.y, ty2 = (max.y - ray->position.y)*ray->invDirection.y;
+    tnear = fmaxf(tnear, fminf(ty1, ty2)); tfar = fminf(tfar, fmaxf(ty1, ty2));
+    float tz1 = (min.z - ray->position.z)*ray->invDirection.z, tz2 = (max.z - ray->position.z)*ray->invDirection.z;
+    tnear = fmaxf(tnear, fminf(tz1, tz2)); tfar = fminf(tfar, fmaxf(tz1, tz2));
+
+    if ((tfar >= tnear) && (tnear < tmax) && (tfar > 0.0f)) return tnear;
+    return FLT_MAX;
+}
+
+// Traverse BVH with the ray moved into model space
+static RayCollision BVHTraverse(MeshBVH bvh, Ray ray, Matrix transform, int *trianglesTested)
+{
+    RayCollision collision = { 0 };
+    if (!IsMeshBVHReady(bvh)) return collision;
+
+    Matrix invTransform = MatrixInvert(transform);
+
+    // NOTE: Direction is not normalized, so the ray parameter t is the same in both spaces
+    BVHRay local = { 0 };
+    local.position = Vector3Transform(ray.position, invTransform);
+    local.direction = (Vector3){ invTransform.m0*ray.direction.x + invTransform.m4*ray.direction.y + invTransform.m8*ray.direction.z,
+                                 invTransform.m1*ray.direction.x + invTransform.m5*ray.direction.y + invTransform.m9*ray.direction.z,
+                                 invTransform.m2*ray.direction.x + invTransform.m6*ray.direction.y + invTransform.m10*ray.direction.z };
+    local.invDirection = (Vector3){ 1.0f/local.direction.x, 1.0f/local.direction.y, 1.0f/local.direction.z };
+
+    float closest = FLT_MAX;
+    int closestTri = -1;
+    int tested = 0;
+
+    int stack[BVH_MAX_DEPTH];
+    int stackSize = 0;
+    int nodeIndex = 0;
+
+    if (BVHIntersectBox(&local, bvh.nodes[0].min, bvh.nodes[0].max, closest) == FLT_MAX) nodeIndex = -1;
+
+    while (nodeIndex != -1)
+    {
+        const MeshBVHNode *node = &bvh.nodes[nodeIndex];
+
+        if (node->count > 0)
+        {
+            for (int i = node->first; i < node->first + node->count; i++)
+            {
+                const Vector3 *v = &bvh.triangles[i*3];
+                tested++;
+
+                // Moller-Trumbore, same tests as GetRayCollisionTriangle()
+                Vector3 edge1 = Vector3Subtract(v[1], v[0]);
+                Vector3 edge2 = Vector3Subtract(v[2], v[0]);
+                Vector3 p = Vector3CrossProduct(local.direction, edge2);
+                float det = Vector3DotProduct(edge1, p);
+                if ((det > -BVH_EPSILON) && (det < BVH_EPSILON)) continue;
+
+                float invDet = 1.0f/det;
+                Vector3 tv = Vector3Subtract(local.position, v[0]);
+                float u = Vector3DotProduct(tv, p)*invDet;
+                if ((u < 0.0f) || (u > 1.0f)) continue;
+
+                Vector3 q = Vector3CrossProduct(tv, edge1);
+                float w = Vector3DotProduct(local.direction, q)*invDet;
+                if ((w < 0.0f) || ((u + w) > 1.0f)) continue;
+
+                float t = Vector3DotProduct(edge2, q)*invDet;
+                if ((t > BVH_EPSILON) && (t < closest))
+                {
+                    closest = t;
+                    closestTri = i;
+                }
+            }
+
+            nodeIndex = (stackSize > 0)? stack[--stackSize] : -1;
+            continue;
+        }
+
+        // Visit the nearer child first, push the other one if it can still hold a closer hit
+        int near = node->first;
+        int far = node->first + 1;
+        float nearDist = BVHIntersectBox(&local, bvh.nodes[near].min, bvh.nodes[near].max, closest);
+        float farDist = BVHIntersectBox(&local, bvh.nodes[far].min, bvh.nodes[far].max, closest);
+
+        if (farDist < nearDist)
+        {
+            int tmpIndex = near; near = far; far = tmpIndex;
+            float tmpDist = nearDist; nearDist = farDist; farDist = tmpDist;
+        }
+
+        if (nearDist == FLT_MAX) nodeIndex = (stackSize > 0)? stack[--stackSize] : -1;
+        else
+        {
+            nodeIndex = near;
+            if (farDist != FLT_MAX) stack[stackSize++] = far;     // At most one entry per level, fits BVH_MAX_DEPTH
+        }
+    }
+
+    if (trianglesTested != NULL) *trianglesTested = tested;
+
+    if (closestTri != -1)
+    {
+        const Vector3 *v = &bvh.triangles[closestTri*3];
+        Vector3 n = Vector3CrossProduct(Vector3Subtract(v[1], v[0]), Vector3Subtract(v[2], v[0]));
+
+        // Bring normal back to world space with the inverse transpose, a mirroring transform flips it
+        Vector3 worldNormal = { invTransform.m0*n.x + invTransform.m1*n.y + invTransform.m2*n.z,
+                                invTransform.m4*n.x + invTransform.m5*n.y + invTransform.m6*n.z,
+                                invTransform.m8*n.x + invTransform.m9*n.y + invTransform.m10*n.z };
+        if (MatrixDeterminant(transform) < 0.0f) worldNormal = Vector3Negate(worldNormal);
+
+        collision.hit = true;
+        collision.distance = closest;
+        collision.normal = Vector3Normalize(worldNormal);
+        collision.point = Vector3Add(ray.position, Vector3Scale(ray.direction, closest));
+    }
+
+    return collision;
+}
+
+// Generate benchmark rays: they start on a sphere around the mesh and aim at random points inside its bounds
+static Ray *GenBenchmarkRays(Mesh mesh, Matrix transform, int rayCount)
+{
+    BoundingBox box = GetMeshBoundingBox(mesh);
+    Vector3 center = Vector3Scale(Vector3Add(box.min, box.max), 0.5f);
+    float radius = Vector3Length(Vector3Subtract(box.max, box.min));
+
+    Ray *rays = (Ray *)malloc(rayCount*sizeof(Ray));
+    for (int i = 0; i < rayCount; i++)
+    {
+        Vector3 dir = Vector3Normalize((Vector3){ (float)GetRandomValue(-1000, 1000), (float)GetRandomValue(-1000, 1000), (float)GetRandomValue(-1000, 1000) });
+        Vector3 origin = Vector3Add(center, Vector3Scale(dir, radius));
+        Vector3 target = { Lerp(box.min.x, box.max.x, GetRandomValue(0, 1000)/1000.0f),
+                           Lerp(box.min.y, box.max.y, GetRandomValue(0, 1000)/1000.0f),
+                           Lerp(box.min.z, box.max.z, GetRandomValue(0, 1000)/1000.0f) };
+
+        rays[i].position = Vector3Transform(origin, transform);
+        rays[i].direction = Vector3Normalize(Vector3Subtract(Vector3Transform(target, transform), rays[i].position));
+    }
+
+    return rays;
+}
+
+// Test ray packets [begin, end) against all batch triangles
+static void RayBatchPacketJob(int begin, int end, void *userData)
+{
+    const RayBatch *batch = (const RayBatch *)userData;
+
+    for (int packet = begin; packet < end; packet++)
+    {
+        int first = packet*RAY_PACKET_SIZE;
+        int lanes = (batch->rayCount - first < RAY_PACKET_SIZE)? batch->rayCount - first : RAY_PACKET_SIZE;
+        float closest[RAY_PACKET_SIZE];
+        float closestTri[RAY_PACKET_SIZE];
+
+#if (RAY_PACKET_SIZE > 1)
+        // Gather rays in SoA form, unused lanes repeat the last ray
+        float ox[RAY_PACKET_SIZE], oy[RAY_PACKET_SIZE], oz[RAY_PACKET_SIZE];
+        float dx[RAY_PACKET_SIZE], dy[RAY_PACKET_SIZE], dz[RAY_PACKET_SIZE];
+        for (int l = 0; l < RAY_PACKET_SIZE; l++)
+        {
+            const Ray *ray = &batch->rays[first + ((l < lanes)? l : lanes - 1)];
+            ox[l] = ray->position.x; oy[l] = ray->position.y; oz[l] = ray->position.z;
+            dx[l] = ray->direction.x; dy[l] = ray->direction.y; dz[l] = ray->direction.z;
+        }
+
+        rpfloat rox = RP_LOAD(ox), roy = RP_LOAD(oy), roz = RP_LOAD(oz);
+        rpfloat rdx = RP_LOAD(dx), rdy = RP_LOAD(dy), rdz = RP_LOAD(dz);
+        rpfloat best = RP_SET1(FLT_MAX);
+        rpfloat bestTri = RP_SET1(-1.0f);
+        const rpfloat zero = RP_SET1(0.0f);
+        const rpfloat one = RP_SET1(1.0f);
+        const rpfloat eps = RP_SET1(BVH_EPSILON);
+        const rpfloat negEps = RP_SET1(-BVH_EPSILON);
+
+        for (int i = 0; i < batch->triangleCount; i++)
+        {
+            const BatchTriangle *tri = &batch->triangles[i];
+            rpfloat e1x = RP_SET1(tri->edge1.x), e1y = RP_SET1(tri->edge1.y), e1z = RP_SET1(tri->edge1.z);
+            rpfloat e2x = RP_SET1(tri->edge2.x), e2y = RP_SET1(tri->edge2.y), e2z = RP_SET1(tri->edge2.z);
+
+            // p = cross(direction, edge2), det = dot(edge1, p)
+            rpfloat px = RP_SUB(RP_MUL(rdy, e2z), RP_MUL(rdz, e2y));
+            rpfloat py = RP_SUB(RP_MUL(rdz, e2x), RP_MUL(rdx, e2z));
+            rpfloat pz = RP_SUB(RP_MUL(rdx, e2y), RP_MUL(rdy, e2x));
+            rpfloat det = RP_ADD(RP_ADD(RP_MUL(e1x, px), RP_MUL(e1y, py)), RP_MUL(e1z, pz));
+            rpfloat mask = RP_OR(RP_GT(det, eps), RP_GT(negEps, det));
+            if (!RP_ANY(mask)) continue;
+
+            rpfloat invDet = RP_DIV(one, det);
+            rpfloat tx = RP_SUB(rox, RP_SET1(tri->v0.x));
+            rpfloat ty = RP_SUB(roy, RP_SET1(tri->v0.y));
+            rpfloat tz = RP_SUB(roz, RP_SET1(tri->v0.z));
+
+            rpfloat u = RP_MUL(RP_ADD(RP_ADD(RP_MUL(tx, px), RP_MUL(ty, py)), RP_MUL(tz, pz)), invDet);
+            mask = RP_AND(mask, RP_AND(RP_GE(u, zero), RP_GE(one, u)));
+            if (!RP_ANY(mask)) continue;
+
+            // q = cross(tv, edge1)
+            rpfloat qx = RP_SUB(RP_MUL(ty, e1z), RP_MUL(tz, e1y));
+            rpfloat qy = RP_SUB(RP_MUL(tz, e1x), RP_MUL(tx, e1z));
+            rpfloat qz = RP_SUB(RP_MUL(tx, e1y), RP_MUL(ty, e1x));
+
+            rpfloat v = RP_MUL(RP_ADD(RP_ADD(RP_MUL(rdx, qx), RP_MUL(rdy, qy)), RP_MUL(rdz, qz)), invDet);
+            mask = RP_AND(mask, RP_AND(RP_GE(v, zero), RP_GE(one, RP_ADD(u, v))));
+            if (!RP_ANY(mask)) continue;
+
+            rpfloat t = RP_MUL(RP_ADD(RP_ADD(RP_MUL(e2x, qx), RP_MUL(e2y, qy)), RP_MUL(e2z, qz)), invDet);
+            mask = RP_AND(mask, RP_AND(RP_GT(t, eps), RP_GT(best, t)));
+
+            best = RP_SELECT(best, t, mask);
+            bestTri = RP_SELECT(bestTri, RP_SET1((float)i), mask);
+        }
+
+        RP_STORE(closest, best);
+        RP_STORE(closestTri, bestTri);
+#else
+        for (int l = 0; l < lanes; l++)
+        {
+            closest[l] = FLT_MAX;
+            closestTri[l] = -1.0f;
+
+            for (int i = 0; i < batch->triangleCount; i++)
+            {
+                const BatchTriangle *tri = &batch->triangles[i];
+                RayCollision hit = GetRayCollisionTriangle(batch->rays[first + l], tri->v0, Vector3Add(tri->v0, tri->edge1), Vector3Add(tri->v0, tri->edge2));
+                if (hit.hit && (hit.distance < closest[l])) { closest[l] = hit.distance; closestTri[l] = (float)i; }
+            }
+        }
+#endif
+
+        for (int l = 0; l < lanes; l++)
+        {
+            RayCollision collision = { 0 };
+
+            if (closestTri[l] >= 0.0f)
+            {
+                const Ray *ray = &batch->rays[first + l];
+                const BatchTriangle *tri = &batch->triangles[(int)closestTri[l]];
+
+                collision.hit = true;
+                collision.distance = closest[l];
+                collision.normal = Vector3Normalize(Vector3CrossProduct(tri->edge1, tri->edge2));
+                collision.point = Vector3Add(ray->position, Vector3Scale(ray->direction, closest[l]));
+            }
+
+            batch->collisions[first + l] = collision;
+        }
+    }
+}
+
+// Trace rays [begin, end) through the batch BVH
+static void RayBatchBVHJob(int begin, int end, void *userData)
+{
+    const RayBatch *batch = (const RayBatch *)userData;
+
+    for (int i = begin; i < end; i++) batch->collisions[i] = BVHTraverse(batch->bvh, batch->rays[i], batch->transform, NULL);
+}
+
+#endif // RCOLLISION_IMPLEMENTATION
@@ -0,0 +1,407 @@
+/**********************************************************************************************
+*
+*   raylib.cull - View frustum culling with cached mesh bounding volumes
+*
+*   DESCRIPTION:
+*       BeginCulling() extracts the six frustum planes from the same view and projection
+*       matrices BeginMode3D() sets up, then every mesh is tested before it reaches rlgl:
+*         - Bounds are computed once per mesh with GetMeshBoundingBox() and cached, keyed by
+*           the mesh vertex data, as a box plus its bounding sphere
+*         - The transformed sphere is tested first, the transformed box only when the sphere
+*           crosses a plane
+*
+*       DrawMeshCulled(), DrawModelCulled() and DrawMeshInstancedCulled() are the culled
+*       versions of the raylib calls, IsMeshVisible() is for callers batching their own draws.
+*       GetCullStats() tells how many meshes were tested, culled and drawn since BeginCulling().
+*
+*   CONFIGURATION:
+*
+*   #define RCULL_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+**********************************************************************************************/
+
+#ifndef RCULL_H
+#define RCULL_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Frustum planes, normal pointing inside: dot(normal, p) + w >= 0 for points inside
+typedef struct {
+    Vector4 planes[6];          // Left, right, bottom, top, near, far
+} Frustum;
+
+// Mesh bounding volumes in model space
+typedef struct {
+    BoundingBox box;
+    Vector3 center;             // Bounding sphere around the box
+    float radius;
+} MeshBounds;
+
+// Culling statistics since BeginCulling()
+typedef struct {
+    int tested;
+    int culled;
+    int drawn;
+} CullStats;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+Frustum GetCameraFrustum(Camera camera, float aspect);                                 // Get world space frustum, same matrices as BeginMode3D()
+Frustum GetFrustumFromMatrix(Matrix viewProjection);                                   // Get frustum from MatrixMultiply(view, projection)
+bool CheckFrustumSphere(const Frustum *frustum, Vector3 center, float radius);         // Check sphere touches frustum
+bool CheckFrustumBox(const Frustum *frustum, BoundingBox box);                          // Check box touches frustum
+bool CheckFrustumBounds(const Frustum *frustum, MeshBounds bounds, Matrix transform);   // Check transformed bounds touch frustum
+
+MeshBounds GetMeshBounds(Mesh mesh);                                                    // Get mesh bounds, computed on first call and cached
+void UnloadMeshBoundsCache(void);                                                       // Unload cached bounds (call before unloading meshes whose memory may be reused)
+
+void BeginCulling(Camera camera);                                                       // Set frustum from camera and render size, reset statistics
+bool IsMeshVisible(Mesh mesh, Matrix transform);                                        // Test mesh against current frustum, counted in statistics
+void DrawMeshCulled(Mesh mesh, Material material, Matrix transform);                    // DrawMesh() if visible
+void DrawModelCulled(Model model, Vector3 position, float scale, Color tint);            // DrawModel() meshes that are visible
+int DrawMeshInstancedCulled(Mesh mesh, Material material, const Matrix *transforms, int instances); // DrawMeshInstanced() visible instances, returns drawn count
+CullStats GetCullStats(void);                                                           // Get statistics since BeginCulling()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RCULL_H
+
+
+/***********************************************************************************
+*
+*   RCULL IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RCULL_IMPLEMENTATION)
+
+#include "raymath.h"
+#include "rlgl.h"
+
+#include <stdlib.h>             // Required for: calloc(), realloc(), free()
+#include <stdint.h>             // Required for: uintptr_t
+#include <math.h>               // Required for: sqrtf(), fabsf()
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Cached bounds of one mesh, open addressing table keyed by vertex data
+typedef struct {
+    const float *vertices;      // NULL for empty slots
+    int vertexCount;
+    MeshBounds bounds;
+} MeshBoundsEntry;
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static MeshBoundsEntry *boundsCache = NULL;
+static int boundsCacheCapacity = 0;             // Power of two
+static int boundsCacheCount = 0;
+
+static Frustum cullFrustum = { 0 };
+static CullStats cullStats = { 0 };
+static Matrix *cullTransforms = NULL;           // Visible instances for DrawMeshInstancedCulled()
+static int cullTransformsCapacity = 0;
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static Vector4 NormalizePlane(Vector4 plane);
+static unsigned int HashMeshVertices(const float *vertices);
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Get world space frustum, same matrices as BeginMode3D()
+Frustum GetCameraFrustum(Camera camera, float aspect)
+{
+    Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
+    Matrix projection = { 0 };
+
+    if (camera.projection == CAMERA_ORTHOGRAPHIC)
+    {
+        double top = camera.fovy/2.0;
+        double right = top*aspect;
+        projection = MatrixOrtho(-right, right, -top, top, RL_CULL_DISTANCE_NEAR, RL_CULL_DISTANCE_FAR);
+    }
+    else projection = MatrixPerspective(camera.fovy*DEG2RAD, aspect, RL_CULL_DISTANCE_NEAR, RL_CULL_DISTANCE_FAR);
+
+    return GetFrustumFromMatrix(MatrixMultiply(view, projection));
+}
+
+// Get frustum from MatrixMultiply(view, projection)
+// NOTE: Planes are clip matrix row 3 plus or minus rows 0, 1 and 2 (Gribb and Hartmann)
+Frustum GetFrustumFromMatrix(Matrix m)
+{
+    Vector4 row0 = { m.m0, m.m4, m.m8, m.m12 };
+    Vector4 row1 = { m.m1, m.m5, m.m9, m.m13 };
+    Vector4 row2 = { m.m2, m.m6, m.m10, m.m14 };
+    Vector4 row3 = { m.m3, m.m7, m.m11, m.m15 };
+
+    Frustum frustum = { 0 };
+    frustum.planes[0] = NormalizePlane((Vector4){ row3.x + row0.x, row3.y + row0.y, row3.z + row0.z, row3.w + row0.w });   // Left
+    frustum.planes[1] = NormalizePlane((Vector4){ row3.x - row0.x, row3.y - row0.y, row3.z - row0.z, row3.w - row0.w });   // Right
+    frustum.planes[2] = NormalizePlane((Vector4){ row3.x + row1.x, row3.y + row1.y, row3.z + row1.z, row3.w + row1.w });   // Bottom
+    frustum.planes[3] = NormalizePlane((Vector4){ row3.x - row1.x, row3.y - row1.y, row3.z - row1.z, row3.w - row1.w });   // Top
+    frustum.planes[4] = NormalizePlane((Vector4){ row3.x + row2.x, row3.y + row2.y, row3.z + row2.z, row3.w + row2.w });   // Near
+    frustum.planes[5] = NormalizePlane((Vector4){ row3.x - row2.x, row3.y - row2.y, row3.z - row2.z, row3.w - row2.w });   // Far
+
+    return frustum;
+}
+
+// Check sphere touches frustum
+bool CheckFrustumSphere(const Frustum *frustum, Vector3 center, float radius)
+{
+    for (int i = 0; i < 6; i++)
+    {
+        Vector4 p = frustum->planes[i];
+        if (p.x*center.x + p.y*center.y + p.z*center.z + p.w < -radius) return false;
+    }
+
+    return true;
+}
+
+// Check box touches frustum
+// NOTE: Conservative, boxes near frustum corners can pass while outside
+bool CheckFrustumBox(const Frustum *frustum, BoundingBox box)
+{
+    for (int i = 0; i < 6; i++)
+    {
+        // Box corner furthest along the plane normal
+        Vector4 p = frustum->planes[i];
+        float x = (p.x >= 0.0f)? box.max.x : box.min.x;
+        float y = (p.y >= 0.0f)? box.max.y : box.min.y;
+        float z = (p.z >= 0.0f)? box.max.z : box.min.z;
+
+        if (p.x*x + p.y*y + p.z*z + p.w < 0.0f) return false;
+    }
+
+    return true;
+}
+
+// Check transformed bounds touch frustum
+// NOTE: Sphere first, the box (as world axis aligned box around the transformed one) only
+// when the sphere crosses a plane
+bool CheckFrustumBounds(const Frustum *frustum, MeshBounds bounds, Matrix transform)
+{
+    if (bounds.radius == INFINITY) return true;
+
+    Vector3 center = Vector3Transform(bounds.center, transform);
+
+    // Largest axis scale
+    float sx = transform.m0*transform.m0 + transform.m1*transform.m1 + transform.m2*transform.m2;
+    float sy = transform.m4*transform.m4 + transform.m5*transform.m5 + transform.m6*transform.m6;
+    float sz = transform.m8*transform.m8 + transform.m9*transform.m9 + transform.m10*transform.m10;
+    float radius = bounds.radius*sqrtf(fmaxf(sx, fmaxf(sy, sz)));
+
+    bool crossing = false;
+    for (int i = 0; i < 6; i++)
+    {
+        Vector4 p = frustum->planes[i];
+        float distance = p.x*center.x + p.y*center.y + p.z*center.z + p.w;
+
+        if (distance < -radius) return false;
+        if (distance < radius) crossing = true;
+    }
+
+    if (!crossing) return true;
+
+    // Box center and half extents through the transform (Arvo)
+    Vector3 boxCenter = Vector3Transform(Vector3Scale(Vector3Add(bounds.box.min, bounds.box.max), 0.5f), transform);
+    Vector3 half = Vector3Scale(Vector3Subtract(bounds.box.max, bounds.box.min), 0.5f);
+    Vector3 extents = {
+        fabsf(transform.m0)*half.x + fabsf(transform.m4)*half.y + fabsf(transform.m8)*half.z,
+        fabsf(transform.m1)*half.x + fabsf(transform.m5)*half.y + fabsf(transform.m9)*half.z,
+        fabsf(transform.m2)*half.x + fabsf(transform.m6)*half.y + fabsf(transform.m10)*half.z
+    };
+
+    return CheckFrustumBox(frustum, (BoundingBox){ Vector3Subtract(boxCenter, extents), Vector3Add(boxCenter, extents) });
+}
+
+// Get mesh bounds, computed on first call and cached
+MeshBounds GetMeshBounds(Mesh mesh)
+{
+    if (mesh.vertices == NULL)
+    {
+        // No CPU vertex data, bounds can not be computed: infinite sphere, never culled
+        MeshBounds bounds = { 0 };
+        bounds.radius = INFINITY;
+        return bounds;
+    }
+
+    // Grow at 50% load, rehash existing entries
+    if ((boundsCacheCount + 1)*2 > boundsCacheCapacity)
+    {
+        int capacity = (boundsCacheCapacity == 0)? 64 : boundsCacheCapacity*2;
+        MeshBoundsEntry *entries = (MeshBoundsEntry *)calloc(capacity, sizeof(MeshBoundsEntry));
+
+        for (int i = 0; i < boundsCacheCapacity; i++)
+        {
+            if (boundsCache[i].vertices == NULL) continue;
+
+            unsigned int slot = HashMeshVertices(boundsCache[i].vertices) & (capacity - 1);
+            while (entries[slot].vertices != NULL) slot = (slot + 1) & (capacity - 1);
+            entries[slot] = boundsCache[i];
+        }
+
+        free(boundsCache);
+        boundsCache = entries;
+        boundsCacheCapacity = capacity;
+    }
+
+    unsigned int slot = HashMeshVertices(mesh.vertices) & (boundsCacheCapacity - 1);
+    while (boundsCache[slot].vertices != NULL)
+    {
+        MeshBoundsEntry *entry = &boundsCache[slot];
+        if ((entry->vertices == mesh.vertices) && (entry->vertexCount == mesh.vertexCount)) return entry->bounds;
+        slot = (slot + 1) & (boundsCacheCapacity - 1);
+    }
+
+    MeshBounds bounds = { 0 };
+    bounds.box = GetMeshBoundingBox(mesh);
+    bounds.center = Vector3Scale(Vector3Add(bounds.box.min, bounds.box.max), 0.5f);
+    bounds.radius = Vector3Distance(bounds.center, bounds.box.max);
+
+    boundsCache[slot].vertices = mesh.vertices;
+    boundsCache[slot].vertexCount = mesh.vertexCount;
+    boundsCache[slot].bounds = bounds;
+    boundsCacheCount++;
+
+    return bounds;
+}
+
+// Unload cached bounds
+void UnloadMeshBoundsCache(void)
+{
+    free(boundsCache);
+    free(cullTransforms);
+
+    boundsCache = NULL;
+    boundsCacheCapacity = 0;
+    boundsCacheCount = 0;
+    cullTransforms = NULL;
+    cullTransformsCapacity = 0;
+}
+
+// Set frustum from camera and render size, reset statistics
+void BeginCulling(Camera camera)
+{
+    float aspect = (float)GetRenderWidth()/(float)GetRenderHeight();
+
+    cullFrustum = GetCameraFrustum(camera, aspect);
+    cullStats = (CullStats){ 0 };
+}
+
+// Test mesh against current frustum, counted in statistics
+bool IsMeshVisible(Mesh mesh, Matrix transform)
+{
+    bool visible = CheckFrustumBounds(&cullFrustum, GetMeshBounds(mesh), transform);
+
+    cullStats.tested++;
+    if (visible) cullStats.drawn++;
+    else cullStats.culled++;
+
+    return visible;
+}
+
+// DrawMesh() if visible
+void DrawMeshCulled(Mesh mesh, Material material, Matrix transform)
+{
+    if (IsMeshVisible(mesh, transform)) DrawMesh(mesh, material, transform);
+}
+
+// DrawModel() meshes that are visible
+// NOTE: Same transform and tint handling as DrawModelEx()
+void DrawModelCulled(Model model, Vector3 position, float scale, Color tint)
+{
+    Matrix transform = MatrixMultiply(model.transform, MatrixMultiply(MatrixScale(scale, scale, scale), MatrixTranslate(position.x, position.y, position.z)));
+
+    for (int i = 0; i < model.meshCount; i++)
+    {
+        if (!IsMeshVisible(model.meshes[i], transform)) continue;
+
+        Material *material = &model.materials[model.meshMaterial[i]];
+        Color color = material->maps[MATERIAL_MAP_DIFFUSE].color;
+
+        Color colorTint = WHITE;
+        colorTint.r = (unsigned char)(((int)color.r*(int)tint.r)/255);
+        colorTint.g = (unsigned char)(((int)color.g*(int)tint.g)/255);
+        colorTint.b = (unsigned char)(((int)color.b*(int)tint.b)/255);
+        colorTint.a = (unsigned char)(((int)color.a*(int)tint.a)/255);
+
+        material->maps[MATERIAL_MAP_DIFFUSE].color = colorTint;
+        DrawMesh(model.meshes[i], *material, transform);
+        material->maps[MATERIAL_MAP_DIFFUSE].color = color;
+    }
+}
+
+// DrawMeshInstanced() visible instances, returns drawn count
+int DrawMeshInstancedCulled(Mesh mesh, Material material, const Matrix *transforms, int instances)
+{
+    if (instances > cullTransformsCapacity)
+    {
+        cullTransformsCapacity = instances;
+        cullTransforms = (Matrix *)realloc(cullTransforms, cullTransformsCapacity*sizeof(Matrix));
+    }
+
+    MeshBounds bounds = GetMeshBounds(mesh);
+    int visible = 0;
+
+    for (int i = 0; i < instances; i++)
+    {
+        if (CheckFrustumBounds(&cullFrustum, bounds, transforms[i])) cullTransforms[visible++] = transforms[i];
+    }
+
+    cullStats.tested += instances;
+    cullStats.drawn += visible;
+    cullStats.culled += instances - visible;
+
+    if (visible > 0) DrawMeshInstanced(mesh, material, cullTransforms, visible);
+
+    return visible;
+}
+
+// Get statistics since BeginCulling()
+CullStats GetCullStats(void)
+{
+    return cullStats;
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Normalize plane so w is the distance to the origin
+static Vector4 NormalizePlane(Vector4 plane)
+{
+    float length = sqrtf(plane.x*plane.x + plane.y*plane.y + plane.z*plane.z);
+    if (length > 0.0f) plane = (Vector4){ plane.x/length, plane.y/length, plane.z/length, plane.w/length };
+
+    return plane;
+}
+
+// Hash vertex data pointer (Fibonacci hashing)
+static unsigned int HashMeshVertices(const float *vertices)
+{
+    uintptr_t key = (uintptr_t)vertices >> 4;
+    return (unsigned int)((key*11400714819323198485ull) >> 32);
+}
+
+#endif // RCULL_IMPLEMENTATION
@@ -0,0 +1,781 @@
+/**********************************************************************************************
+*
+*   raylib.fontcache - Dynamic glyph cache, glyphs rasterized on first use
+*
+*   DESCRIPTION:
+*       LoadFontEx() rasterizes every requested codepoint with stb_truetype (LoadFontData()) and
+*       GenImageFontAtlas() packs them all into one atlas: a CJK range costs seconds of startup
+*       and megabytes of texture for glyphs a screen never shows. A DynamicFont keeps the TTF
+*       data and rasterizes glyphs when text first needs them:
+*         - Missing glyphs of a text are rasterized together, LoadFontDataParallel() (rfontload.h)
+*         - Shelf packing: rows of font height, glyphs appended left to right
+*         - Atlas grows (size doubled) up to maxAtlasSize, then the least recently used shelf
+*           is evicted, never one holding glyphs of the text being drawn
+*         - Only the dirty span of every shelf goes to the GPU (UpdateTextureRec()), from a
+*           one byte per pixel CPU copy of the atlas
+*
+*       Glyph bitmaps and metrics are the ones LoadFontEx() gives (same LoadFontData() output),
+*       layout follows DrawTextEx()/MeasureTextEx(). font.font holds the cached glyphs in raylib
+*       Font form: DrawTextEx() works on it for cached glyphs.
+*
+*   CONFIGURATION:
+*
+*   #define RFONTCACHE_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+*   NOTE: Requires rglyphs.h (line spacing) and rfontload.h, evicting or growing flushes the render batch
+*
+**********************************************************************************************/
+
+#ifndef RFONTCACHE_H
+#define RFONTCACHE_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Atlas row, glyphs packed left to right
+typedef struct {
+    int y;                      // Top of the shelf in atlas
+    int height;
+    int x;                      // Next free position
+    unsigned int lastUse;       // Newest use stamp of its glyphs
+    int dirtyMin;               // Span to upload, dirtyMin >= dirtyMax when clean
+    int dirtyMax;
+} FontCacheShelf;
+
+// Font rasterizing glyphs on first use
+typedef struct {
+    Font font;                  // Cached glyphs (value -1 for free slots), recs and atlas texture
+    unsigned char *fileData;    // TTF data
+    int dataSize;
+
+    int glyphCapacity;
+    int *glyphShelf;            // Shelf of every glyph slot, -1 while not packed
+    unsigned int *glyphUse;     // Use stamp of every glyph slot
+    int *freeGlyphs;            // Free glyph slots
+    int freeCount;
+    int *keys;                  // Hash codepoints, -1 for empty slots
+    int *values;                // Hash glyph slots
+    int hashMask;
+    int hashShift;
+
+    unsigned char *atlas;       // CPU copy of atlas alpha
+    int atlasSize;
+    int maxAtlasSize;
+    FontCacheShelf *shelves;
+    int shelfCount;
+    int shelfCapacity;
+
+    unsigned int stamp;         // Incremented on every draw/measure
+    int *pending;               // Glyph slots waiting to be rasterized
+    int pendingCount;
+    int pendingCapacity;
+    unsigned char *upload;      // GRAY_ALPHA staging for dirty spans
+    int uploadCapacity;
+
+    int rasterized;             // Stats: glyphs rasterized, evicted, atlas grows, uploads
+    int evicted;
+    int grown;
+    int uploads;
+    long long uploadedBytes;
+} DynamicFont;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+DynamicFont LoadDynamicFont(const char *fileName, int fontSize, int maxAtlasSize);  // Load TTF data, no glyph rasterized yet
+void UnloadDynamicFont(DynamicFont *font);                              // Unload font data and atlas
+bool IsDynamicFontReady(DynamicFont font);                              // Check if font data was loaded
+int LoadDynamicFontGlyphs(DynamicFont *font, const int *codepoints, int codepointCount);   // Rasterize glyphs ahead, returns glyphs cached
+Vector2 MeasureTextDynamic(DynamicFont *font, const char *text, float fontSize, float spacing);  // MeasureTextEx() for a dynamic font
+void DrawTextDynamic(DynamicFont *font, const char *text, Vector2 position, float fontSize, float spacing, Color tint);  // DrawTextEx() for a dynamic font
+void BenchmarkDynamicFont(const char *fileName, int fontSize, int codepointCount);  // Compare LoadFontEx() and the dynamic font, startup and memory
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFONTCACHE_H
+
+
+/***********************************************************************************
+*
+*   RFONTCACHE IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RFONTCACHE_IMPLEMENTATION) && !defined(RFONTCACHE_IMPLEMENTATION_DEFINED)
+#define RFONTCACHE_IMPLEMENTATION_DEFINED
+
+#include "rlgl.h"
+#include "rglyphs.h"            // Required for: GetGlyphLineSpacing()
+#include "rfontload.h"          // Required for: LoadFontDataParallel()
+
+#include <chrono>               // Required for: std::chrono::steady_clock
+#include <stdlib.h>             // Required for: malloc(), calloc(), realloc(), free()
+#include <string.h>             // Required for: memset(), memcpy()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define FONTCACHE_GLYPH_PADDING     4       // Same as LoadFontEx() (FONT_TTF_DEFAULT_CHARS_PADDING)
+#define FONTCACHE_ATLAS_SIZE        256     // Starting atlas size
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static double GetFontCacheTime(void);
+static int FindCachedGlyph(const DynamicFont *font, int codepoint);
+static void InsertCachedGlyph(DynamicFont *font, int codepoint, int slot);
+static void RebuildGlyphHash(DynamicFont *font, int capacity);
+static int RequestGlyph(DynamicFont *font, int codepoint);
+static void FreeGlyph(DynamicFont *font, int slot);
+static void RasterizePendingGlyphs(DynamicFont *font);
+static bool PackGlyph(DynamicFont *font, int slot, Image image);
+static bool GrowAtlas(DynamicFont *font);
+static bool EvictShelf(DynamicFont *font, int height);
+static void UploadDirtyShelves(DynamicFont *font);
+static void RequestText(DynamicFont *font, const char *text);
+static void DrawCachedGlyph(const DynamicFont *font, int slot, Vector2 position, float fontSize, Color tint);
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Load TTF data, no glyph rasterized yet
+DynamicFont LoadDynamicFont(const char *fileName, int fontSize, int maxAtlasSize)
+{
+    DynamicFont font = { 0 };
+
+    font.fileData = LoadFileData(fileName, &font.dataSize);
+    if (font.fileData == NULL) return font;
+
+    font.font.baseSize = fontSize;
+    font.font.glyphPadding = FONTCACHE_GLYPH_PADDING;
+    font.maxAtlasSize = maxAtlasSize;
+    font.atlasSize = (maxAtlasSize < FONTCACHE_ATLAS_SIZE)? maxAtlasSize : FONTCACHE_ATLAS_SIZE;
+    font.atlas = (unsigned char *)calloc(font.atlasSize*font.atlasSize, 1);
+
+    // Texels are only sampled inside uploaded glyph boxes, no initial data needed
+    font.font.texture.id = rlLoadTexture(NULL, font.atlasSize, font.atlasSize, PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA, 1);
+    font.font.texture.width = font.atlasSize;
+    font.font.texture.height = font.atlasSize;
+    font.font.texture.mipmaps = 1;
+    font.font.texture.format = PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA;
+
+    RebuildGlyphHash(&font, 0);
+
+    TraceLog(LOG_INFO, "FONTCACHE: [%s] Dynamic font loaded (size: %i, atlas: %i, max atlas: %i)", fileName, fontSize, font.atlasSize, maxAtlasSize);
+
+    return font;
+}
+
+// Unload font data and atlas
+void UnloadDynamicFont(DynamicFont *font)
+{
+    if (font->font.texture.id > 0) rlUnloadTexture(font->font.texture.id);
+
+    UnloadFileData(font->fileData);
+    free(font->font.glyphs);
+    free(font->font.recs);
+    free(font->glyphShelf);
+    free(font->glyphUse);
+    free(font->freeGlyphs);
+    free(font->keys);
+    free(font->values);
+    free(font->atlas);
+    free(font->shelves);
+    free(font->pending);
+    free(font->upload);
+
+    *font = (DynamicFont){ 0 };
+}
+
+// Check if font data was loaded
+bool IsDynamicFontReady(DynamicFont font)
+{
+    return (font.fileData != NULL) && (font.font.texture.id > 0);
+}
+
+// Rasterize glyphs ahead, returns glyphs cached
+int LoadDynamicFontGlyphs(DynamicFont *font, const int *codepoints, int codepointCount)
+{
+    if (!IsDynamicFontReady(*font)) return 0;
+
+    font->stamp++;
+    for (int i = 0; i < codepointCount; i++) RequestGlyph(font, codepoints[i]);
+    RasterizePendingGlyphs(font);
+    UploadDirtyShelves(font);
+
+    int cached = 0;
+    for (int i = 0; i < codepointCount; i++) cached += (FindCachedGlyph(font, codepoints[i]) >= 0);
+
+    return cached;
+}
+
+// MeasureTextEx() for a dynamic font
+Vector2 MeasureTextDynamic(DynamicFont *font, const char *text, float fontSize, float spacing)
+{
+    Vector2 textSize = { 0 };
+
+    if (!IsDynamicFontReady(*font) || (text == NULL)) return textSize;
+
+    RequestText(font, text);
+
+    int size = TextLength(text);    // Get size in bytes of text
+    int tempByteCounter = 0;        // Used to count longer text line num chars
+    int byteCounter = 0;
+
+    float textWidth = 0.0f;
+    float tempTextWidth = 0.0f;     // Used to count longer text line width
+
+    float textHeight = (float)font->font.baseSize;
+    float scaleFactor = fontSize/(float)font->font.baseSize;
+
+    for (int i = 0; i < size;)
+    {
+        byteCounter++;
+
+        int next = 0;
+        int letter = GetCodepointNext(&text[i], &next);
+        int index = FindCachedGlyph(font, letter);
+
+        i += next;
+
+        if (letter != '\n')
+        {
+            if (index < 0) {}           // Could not be cached, not drawn either
+            else if (font->font.glyphs[index].advanceX != 0) textWidth += font->font.glyphs[index].advanceX;
+            else textWidth += (font->font.recs[index].width + font->font.glyphs[index].offsetX);
+        }
+        else
+        {
+            if (tempTextWidth < textWidth) tempTextWidth = textWidth;
+            byteCounter = 0;
+            textWidth = 0;
+            textHeight += (float)GetGlyphLineSpacing();
+        }
+
+        if (tempByteCounter < byteCounter) tempByteCounter = byteCounter;
+    }
+
+    if (tempTextWidth < textWidth) tempTextWidth = textWidth;
+
+    textSize.x = tempTextWidth*scaleFactor + (float)((tempByteCounter - 1)*spacing);
+    textSize.y = textHeight*scaleFactor;
+
+    return textSize;
+}
+
+// DrawTextEx() for a dynamic font
+// NOTE: Glyphs are cached and uploaded before the first quad, a batch flush can't draw stale texels
+void DrawTextDynamic(DynamicFont *font, const char *text, Vector2 position, float fontSize, float spacing, Color tint)
+{
+    if (!IsDynamicFontReady(*font) || (text == NULL)) return;
+
+    RequestText(font, text);
+
+    int size = TextLength(text);    // Total size in bytes of the text, scanned by codepoints in loop
+
+    int textOffsetY = 0;            // Offset between lines (on linebreak '\n')
+    float textOffsetX = 0.0f;       // Offset X to next character to draw
+
+    float scaleFactor = fontSize/font->font.baseSize;   // Character quad scaling factor
+
+    for (int i = 0; i < size;)
+    {
+        int codepointByteCount = 0;
+        int codepoint = GetCodepointNext(&text[i], &codepointByteCount);
+        int index = FindCachedGlyph(font, codepoint);
+
+        i += codepointByteCount;   // Move text bytes counter to next codepoint
+
+        if (codepoint == '\n')
+        {
+            textOffsetY += GetGlyphLineSpacing();
+            textOffsetX = 0.0f;
+        }
+        else if (index >= 0)
+        {
+            if ((codepoint != ' ') && (codepoint != '\t'))
+            {
+                DrawCachedGlyph(font, index, (Vector2){ position.x + textOffsetX, position.y + textOffsetY }, fontSize, tint);
+            }
+
+            if (font->font.glyphs[index].advanceX == 0) textOffsetX += ((float)font->font.recs[index].width*scaleFactor + spacing);
+            else textOffsetX += ((float)font->font.glyphs[index].advanceX*scaleFactor + spacing);
+        }
+    }
+}
+
+// Compare LoadFontEx() and the dynamic font, startup and memory
+// NOTE: Codepoints are ASCII then CJK from U+4E00, a screen shows ASCII and 200 CJK glyphs,
+// needs a window (glyphs are drawn in hidden frames)
+void BenchmarkDynamicFont(const char *fileName, int fontSize, int codepointCount)
+{
+    int *codepoints = (int *)malloc(codepointCount*sizeof(int));
+    for (int i = 0; i < codepointCount; i++) codepoints[i] = (i < 95)? 32 + i : 0x4e00 + (i - 95);
+
+    // Screen text: ASCII line and 200 CJK glyphs on lines of 40
+    int screenCount = 0;
+    int *screen = (int *)malloc((95 + 210)*sizeof(int));
+    for (int i = 0; i < 95; i++) screen[screenCount++] = 32 + i;
+    for (int i = 0; (i < 200) && (95 + i < codepointCount); i++)
+    {
+        if ((i%40) == 0) screen[screenCount++] = '\n';
+        screen[screenCount++] = codepoints[95 + i];
+    }
+    char *screenText = LoadUTF8(screen, screenCount);
+
+    const int frames = 100;
+
+    // Eager: every codepoint rasterized and packed at load
+    double start = GetFontCacheTime();
+    Font eager = LoadFontEx(fileName, fontSize, codepoints, codepointCount);
+    double eagerLoad = GetFontCacheTime() - start;
+
+    start = GetFontCacheTime();
+    BeginDrawing();
+    DrawTextEx(eager, screenText, (Vector2){ 10, 10 }, (float)fontSize, 0, BLACK);
+    rlDrawRenderBatchActive();
+    double eagerFirst = GetFontCacheTime() - start;
+    EndDrawing();
+
+    double eagerFrame = 0.0;
+    for (int frame = 0; frame < frames; frame++)
+    {
+        BeginDrawing();
+        start = GetFontCacheTime();
+        DrawTextEx(eager, screenText, (Vector2){ 10, 10 }, (float)fontSize, 0, BLACK);
+        rlDrawRenderBatchActive();
+        eagerFrame += GetFontCacheTime() - start;
+        EndDrawing();
+    }
+
+    int eagerWidth = eager.texture.width;
+    int eagerHeight = eager.texture.height;
+    long long eagerVram = (long long)eagerWidth*eagerHeight*2;
+    long long eagerRam = (long long)eager.glyphCount*(sizeof(GlyphInfo) + sizeof(Rectangle));
+    for (int i = 0; i < eager.glyphCount; i++) eagerRam += GetPixelDataSize(eager.glyphs[i].image.width, eager.glyphs[i].image.height, eager.glyphs[i].image.format);
+    UnloadFont(eager);
+
+    // Dynamic: screen glyphs rasterized on the first frame
+    start = GetFontCacheTime();
+    DynamicFont dynamic = LoadDynamicFont(fileName, fontSize, 4096);
+    double dynamicLoad = GetFontCacheTime() - start;
+
+    start = GetFontCacheTime();
+    BeginDrawing();
+    DrawTextDynamic(&dynamic, screenText, (Vector2){ 10, 10 }, (float)fontSize, 0, BLACK);
+    rlDrawRenderBatchActive();
+    double dynamicFirst = GetFontCacheTime() - start;
+    EndDrawing();
+
+    double dynamicFrame = 0.0;
+    for (int frame = 0; frame < frames; frame++)
+    {
+        BeginDrawing();
+        start = GetFontCacheTime();
+        DrawTextDynamic(&dynamic, screenText, (Vector2){ 10, 10 }, (float)fontSize, 0, BLACK);
+        rlDrawRenderBatchActive();
+        dynamicFrame += GetFontCacheTime() - start;
+        EndDrawing();
+    }
+
+    long long dynamicVram = (long long)dynamic.atlasSize*dynamic.atlasSize*2;
+    long long dynamicRam = (long long)dynamic.atlasSize*dynamic.atlasSize + dynamic.dataSize +
+        (long long)dynamic.glyphCapacity*(sizeof(GlyphInfo) + sizeof(Rectangle) + 2*sizeof(int) + sizeof(unsigned int)) + 2LL*(dynamic.hashMask + 1)*sizeof(int);
+
+    TraceLog(LOG_INFO, "BENCH: [%i codepoints, size %i] %-16s startup %9.2f ms (load %9.2f + first frame %7.2f), frame %6.3f ms, atlas %4ix%-4i VRAM %7.2f MB, RAM %6.2f MB",
+             codepointCount, fontSize, "LoadFontEx()", (eagerLoad + eagerFirst)*1000.0, eagerLoad*1000.0, eagerFirst*1000.0, eagerFrame*1000.0/frames,
+             eagerWidth, eagerHeight, eagerVram/1048576.0, eagerRam/1048576.0);
+    TraceLog(LOG_INFO, "BENCH: [%i codepoints, size %i] %-16s startup %9.2f ms (load %9.2f + first frame %7.2f), frame %6.3f ms, atlas %4ix%-4i VRAM %7.2f MB, RAM %6.2f MB (TTF %.2f MB, %i glyphs)",
+             codepointCount, fontSize, "DynamicFont", (dynamicLoad + dynamicFirst)*1000.0, dynamicLoad*1000.0, dynamicFirst*1000.0, dynamicFrame*1000.0/frames,
+             dynamic.atlasSize, dynamic.atlasSize, dynamicVram/1048576.0, dynamicRam/1048576.0, dynamic.dataSize/1048576.0, dynamic.rasterized);
+    UnloadDynamicFont(&dynamic);
+
+    // Eviction: 512x512 atlas, every frame shows the next 100 codepoints of the range
+    DynamicFont small = LoadDynamicFont(fileName, fontSize, 512);
+    int pageCount = (codepointCount + 99)/100;
+    double smallFrame = 0.0;
+    for (int frame = 0; frame < frames; frame++)
+    {
+        int first = (frame%pageCount)*100;
+        int count = (first + 100 <= codepointCount)? 100 : codepointCount - first;
+        char *page = LoadUTF8(&codepoints[first], count);
+
+        BeginDrawing();
+        start = GetFontCacheTime();
+        DrawTextDynamic(&small, page, (Vector2){ 10, 10 }, (float)fontSize, 0, BLACK);
+        rlDrawRenderBatchActive();
+        smallFrame += GetFontCacheTime() - start;
+        EndDrawing();
+
+        UnloadUTF8(page);
+    }
+
+    TraceLog(LOG_INFO, "BENCH: [%i codepoints, size %i] %-16s 100 new glyphs per frame %6.3f ms, rasterized %i, evicted %i, uploads %i (%.2f MB)",
+             codepointCount, fontSize, "DynamicFont 512", smallFrame*1000.0/frames, small.rasterized, small.evicted, small.uploads, small.uploadedBytes/1048576.0);
+    UnloadDynamicFont(&small);
+
+    UnloadUTF8(screenText);
+    free(screen);
+    free(codepoints);
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Monotonic time in seconds
+static double GetFontCacheTime(void)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Find glyph slot of codepoint, -1 if not cached
+static int FindCachedGlyph(const DynamicFont *font, int codepoint)
+{
+    unsigned int slot = ((unsigned int)codepoint*2654435761u) >> font->hashShift;
+    while (font->keys[slot] != -1)
+    {
+        if (font->keys[slot] == codepoint) return font->values[slot];
+        slot = (slot + 1) & font->hashMask;
+    }
+
+    return -1;
+}
+
+// Insert codepoint, hash has room (load <= 0.5)
+static void InsertCachedGlyph(DynamicFont *font, int codepoint, int slot)
+{
+    unsigned int hash = ((unsigned int)codepoint*2654435761u) >> font->hashShift;
+    while (font->keys[hash] != -1) hash = (hash + 1) & font->hashMask;
+
+    font->keys[hash] = codepoint;
+    font->values[hash] = slot;
+}
+
+// Rebuild hash from glyph slots, sized for capacity glyphs
+static void RebuildGlyphHash(DynamicFont *font, int capacity)
+{
+    int slotsLog2 = 4;
+    while ((1 << slotsLog2) < 2*capacity) slotsLog2++;
+
+    if (font->hashMask != (1 << slotsLog2) - 1)
+    {
+        font->hashMask = (1 << slotsLog2) - 1;
+        font->hashShift = 32 - slotsLog2;
+        font->keys = (int *)realloc(font->keys, (font->hashMask + 1)*sizeof(int));
+        font->values = (int *)realloc(font->values, (font->hashMask + 1)*sizeof(int));
+    }
+    memset(font->keys, 0xff, (font->hashMask + 1)*sizeof(int));
+
+    for (int i = 0; i < font->font.glyphCount; i++)
+    {
+        if (font->font.glyphs[i].value != -1) InsertCachedGlyph(font, font->font.glyphs[i].value, i);
+    }
+}
+
+// Get glyph slot of codepoint for the current stamp, new slots wait for RasterizePendingGlyphs()
+static int RequestGlyph(DynamicFont *font, int codepoint)
+{
+    int slot = FindCachedGlyph(font, codepoint);
+
+    if (slot < 0)
+    {
+        if (font->freeCount > 0) slot = font->freeGlyphs[--font->freeCount];
+        else
+        {
+            if (font->font.glyphCount == font->glyphCapacity)
+            {
+                font->glyphCapacity = (font->glyphCapacity == 0)? 128 : 2*font->glyphCapacity;
+                font->font.glyphs = (GlyphInfo *)realloc(font->font.glyphs, font->glyphCapacity*sizeof(GlyphInfo));
+                font->font.recs = (Rectangle *)realloc(font->font.recs, font->glyphCapacity*sizeof(Rectangle));
+                font->glyphShelf = (int *)realloc(font->glyphShelf, font->glyphCapacity*sizeof(int));
+                font->glyphUse = (unsigned int *)realloc(font->glyphUse, font->glyphCapacity*sizeof(unsigned int));
+                font->freeGlyphs = (int *)realloc(font->freeGlyphs, font->glyphCapacity*sizeof(int));
+                RebuildGlyphHash(font, font->glyphCapacity);
+            }
+            slot = font->font.glyphCount++;
+        }
+
+        font->font.glyphs[slot] = (GlyphInfo){ 0 };
+        font->font.glyphs[slot].value = codepoint;
+        font->font.recs[slot] = (Rectangle){ 0 };
+        font->glyphShelf[slot] = -1;
+        InsertCachedGlyph(font, codepoint, slot);
+
+        if (font->pendingCount == font->pendingCapacity)
+        {
+            font->pendingCapacity = (font->pendingCapacity == 0)? 64 : 2*font->pendingCapacity;
+            font->pending = (int *)realloc(font->pending, font->pendingCapacity*sizeof(int));
+        }
+        font->pending[font->pendingCount++] = slot;
+    }
+    else if (font->glyphShelf[slot] >= 0) font->shelves[font->glyphShelf[slot]].lastUse = font->stamp;
+
+    font->glyphUse[slot] = font->stamp;
+
+    return slot;
+}
+
+// Free glyph slot, hash is rebuilt by the caller
+static void FreeGlyph(DynamicFont *font, int slot)
+{
+    font->font.glyphs[slot].value = -1;
+    font->glyphShelf[slot] = -1;
+    font->freeGlyphs[font->freeCount++] = slot;
+}
+
+// Rasterize pending glyphs in parallel and pack them
+static void RasterizePendingGlyphs(DynamicFont *font)
+{
+    if (font->pendingCount == 0) return;
+
+    int *codepoints = (int *)malloc(font->pendingCount*sizeof(int));
+    for (int i = 0; i < font->pendingCount; i++) codepoints[i] = font->font.glyphs[font->pending[i]].value;
+
+    GlyphInfo *glyphs = LoadFontDataParallel(font->fileData, font->dataSize, font->font.baseSize, codepoints, font->pendingCount, FONT_DEFAULT);
+
+    int failed = 0;
+    for (int i = 0; i < font->pendingCount; i++)
+    {
+        int slot = font->pending[i];
+
+        if ((glyphs != NULL) && PackGlyph(font, slot, glyphs[i].image))
+        {
+            font->font.glyphs[slot].offsetX = glyphs[i].offsetX;
+            font->font.glyphs[slot].offsetY = glyphs[i].offsetY;
+            font->font.glyphs[slot].advanceX = glyphs[i].advanceX;
+            font->rasterized++;
+        }
+        else
+        {
+            FreeGlyph(font, slot);
+            failed++;
+        }
+    }
+
+    if (failed > 0)
+    {
+        TraceLog(LOG_WARNING, "FONTCACHE: %i glyphs could not be cached (atlas full of glyphs in use or no shelf tall enough)", failed);
+        RebuildGlyphHash(font, font->glyphCapacity);
+    }
+
+    if (glyphs != NULL) UnloadFontData(glyphs, font->pendingCount);
+    free(codepoints);
+    font->pendingCount = 0;
+}
+
+// Pack glyph image into a shelf, growing the atlas or evicting shelves when full
+static bool PackGlyph(DynamicFont *font, int slot, Image image)
+{
+    int padding = font->font.glyphPadding;
+    int width = image.width + 2*padding;
+    int height = image.height + 2*padding;
+
+    if ((width > font->maxAtlasSize) || (height > font->maxAtlasSize)) return false;
+
+    int shelf = -1;
+    while (shelf < 0)
+    {
+        // Lowest shelf that fits, shelves are uniform unless a glyph is taller than the font
+        for (int i = 0; i < font->shelfCount; i++)
+        {
+            if ((font->shelves[i].height >= height) && (font->shelves[i].x + width <= font->atlasSize) &&
+                ((shelf < 0) || (font->shelves[i].height < font->shelves[shelf].height))) shelf = i;
+        }
+        if (shelf >= 0) break;
+
+        int bottom = (font->shelfCount > 0)? font->shelves[font->shelfCount - 1].y + font->shelves[font->shelfCount - 1].height : 0;
+        int shelfHeight = (height > font->font.baseSize + 2*padding)? height : font->font.baseSize + 2*padding;
+
+        if ((bottom + shelfHeight <= font->atlasSize) && (width <= font->atlasSize))
+        {
+            if (font->shelfCount == font->shelfCapacity)
+            {
+                font->shelfCapacity = (font->shelfCapacity == 0)? 16 : 2*font->shelfCapacity;
+                font->shelves = (FontCacheShelf *)realloc(font->shelves, font->shelfCapacity*sizeof(FontCacheShelf));
+            }
+
+            shelf = font->shelfCount++;
+            font->shelves[shelf] = (FontCacheShelf){ bottom, shelfHeight, 0, 0, 0, 0 };
+        }
+        else if (!GrowAtlas(font) && !EvictShelf(font, height)) return false;
+    }
+
+    FontCacheShelf *target = &font->shelves[shelf];
+    int x = target->x + padding;
+    int y = target->y + padding;
+
+    for (int row = 0; row < image.height; row++)
+    {
+        memcpy(font->atlas + (size_t)(y + row)*font->atlasSize + x, (unsigned char *)image.data + (size_t)row*image.width, image.width);
+    }
+
+    if (target->dirtyMin >= target->dirtyMax) target->dirtyMin = target->x;
+    target->dirtyMax = target->x + width;
+    target->x += width;
+    target->lastUse = font->stamp;
+
+    font->font.recs[slot] = (Rectangle){ (float)x, (float)y, (float)image.width, (float)image.height };
+    font->glyphShelf[slot] = shelf;
+
+    return true;
+}
+
+// Double atlas size (up to maxAtlasSize), shelves keep their place
+static bool GrowAtlas(DynamicFont *font)
+{
+    if (font->atlasSize >= font->maxAtlasSize) return false;
+    int size = (2*font->atlasSize < font->maxAtlasSize)? 2*font->atlasSize : font->maxAtlasSize;
+
+    unsigned char *atlas = (unsigned char *)calloc((size_t)size*size, 1);
+    for (int y = 0; y < font->atlasSize; y++) memcpy(atlas + (size_t)y*size, font->atlas + (size_t)y*font->atlasSize, font->atlasSize);
+
+    // Quads already batched use the old texture
+    rlDrawRenderBatchActive();
+    rlUnloadTexture(font->font.texture.id);
+
+    free(font->atlas);
+    font->atlas = atlas;
+    font->atlasSize = size;
+    font->font.texture.id = rlLoadTexture(NULL, size, size, PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA, 1);
+    font->font.texture.width = size;
+    font->font.texture.height = size;
+    font->grown++;
+
+    // Whole shelves go up again
+    for (int i = 0; i < font->shelfCount; i++)
+    {
+        font->shelves[i].dirtyMin = 0;
+        font->shelves[i].dirtyMax = font->shelves[i].x;
+    }
+
+    return true;
+}
+
+// Evict least recently used shelf not used by the current text that can hold a glyph of height
+// NOTE: The last shelf can also be made taller when the atlas has room below it, false when no shelf
+// can take the glyph (then every eviction would free a shelf the glyph still doesn't fit)
+static bool EvictShelf(DynamicFont *font, int height)
+{
+    int shelf = -1;
+    for (int i = 0; i < font->shelfCount; i++)
+    {
+        const FontCacheShelf *candidate = &font->shelves[i];
+        bool fits = (candidate->height >= height) || ((i == font->shelfCount - 1) && (candidate->y + height <= font->atlasSize));
+
+        if (fits && (candidate->lastUse != font->stamp) && ((shelf < 0) || (candidate->lastUse < font->shelves[shelf].lastUse))) shelf = i;
+    }
+    if (shelf < 0) return false;
+
+    // Quads already batched may sample the shelf
+    rlDrawRenderBatchActive();
+
+    for (int i = 0; i < font->font.glyphCount; i++)
+    {
+        if ((font->font.glyphs[i].value != -1) && (font->glyphShelf[i] == shelf))
+        {
+            FreeGlyph(font, i);
+            font->evicted++;
+        }
+    }
+    RebuildGlyphHash(font, font->glyphCapacity);
+
+    // Cleared so padding of new glyphs is empty, only their boxes are uploaded
+    FontCacheShelf *target = &font->shelves[shelf];
+    if (target->height < height) target->height = height;
+    for (int y = target->y; y < target->y + target->height; y++) memset(font->atlas + (size_t)y*font->atlasSize, 0, font->atlasSize);
+    target->x = 0;
+    target->dirtyMin = 0;
+    target->dirtyMax = 0;
+
+    return true;
+}
+
+// Upload dirty span of every shelf
+static void UploadDirtyShelves(DynamicFont *font)
+{
+    for (int i = 0; i < font->shelfCount; i++)
+    {
+        FontCacheShelf *shelf = &font->shelves[i];
+        if (shelf->dirtyMin >= shelf->dirtyMax) continue;
+
+        int width = shelf->dirtyMax - shelf->dirtyMin;
+        int bytes = width*shelf->height*2;
+        if (bytes > font->uploadCapacity)
+        {
+            font->uploadCapacity = bytes;
+            font->upload = (unsigned char *)realloc(font->upload, bytes);
+        }
+
+        // GRAY_ALPHA as GenImageFontAtlas(): white, glyph in alpha
+        unsigned char *dst = font->upload;
+        for (int y = shelf->y; y < shelf->y + shelf->height; y++)
+        {
+            const unsigned char *src = font->atlas + (size_t)y*font->atlasSize + shelf->dirtyMin;
+            for (int x = 0; x < width; x++, dst += 2)
+            {
+                dst[0] = 255;
+                dst[1] = src[x];
+            }
+        }
+
+        UpdateTextureRec(font->font.texture, (Rectangle){ (float)shelf->dirtyMin, (float)shelf->y, (float)width, (float)shelf->height }, font->upload);
+
+        font->uploads++;
+        font->uploadedBytes += bytes;
+        shelf->dirtyMin = 0;
+        shelf->dirtyMax = 0;
+    }
+}
+
+// Cache glyphs of text for a new stamp and upload them
+static void RequestText(DynamicFont *font, const char *text)
+{
+    font->stamp++;
+
+    int size = TextLength(text);
+    for (int i = 0; i < size;)
+    {
+        int codepointByteCount = 0;
+        int codepoint = GetCodepointNext(&text[i], &codepointByteCount);
+        if (codepoint != '\n') RequestGlyph(font, codepoint);
+
+        i += codepointByteCount;
+    }
+
+    RasterizePendingGlyphs(font);
+    UploadDirtyShelves(font);
+}
+
+// DrawTextCodepoint() for a cached glyph
+static void DrawCachedGlyph(const DynamicFont *font, int slot, Vector2 position, float fontSize, Color tint)
+{
+    const GlyphInfo *glyph = &font->font.glyphs[slot];
+    Rectangle rec = font->font.recs[slot];
+    float padding = (float)font->font.glyphPadding;
+    float scaleFactor = fontSize/font->font.baseSize;     // Character quad scaling factor
+
+    Rectangle dstRec = { position.x + glyph->offsetX*scaleFactor - padding*scaleFactor,
+                         position.y + glyph->offsetY*scaleFactor - padding*scaleFactor,
+                         (rec.width + 2.0f*padding)*scaleFactor,
+                         (rec.height + 2.0f*padding)*scaleFactor };
+
+    Rectangle srcRec = { rec.x - padding, rec.y - padding, rec.width + 2.0f*padding, rec.height + 2.0f*padding };
+
+    DrawTexturePro(font->font.texture, srcRec, dstRec, (Vector2){ 0, 0 }, 0.0f, tint);
+}
+
+#endif // RFONTCACHE_IMPLEMENTATION
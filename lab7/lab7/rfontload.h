@@ -0,0 +1,247 @@
+/**********************************************************************************************
+*
+*   raylib.fontload - Parallel font rasterization
+*
+*   DESCRIPTION:
+*       LoadFontData() renders codepoints one after another with stb_truetype on the loading
+*       thread. Glyphs don't depend on each other: LoadFontDataParallel() splits the codepoints
+*       in chunks and runs LoadFontData() on every chunk from the rjobs.h pool, each call with
+*       its own stbtt_fontinfo over the shared (read only) TTF data. Results are bit-identical to
+*       LoadFontData(), the glyph array is laid out the same and freed with UnloadFontData().
+*
+*       FONT_SDF benefits the most, stbtt_GetCodepointSDF() costs far more per glyph than the
+*       antialiased bitmap. LoadFontExParallel() is LoadFontEx() on top of it (TTF/OTF).
+*
+*   CONFIGURATION:
+*
+*   #define RFONTLOAD_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+*   NOTE: Requires rjobs.h, raylib allocator (RL_MALLOC) must be thread safe (malloc is)
+*
+**********************************************************************************************/
+
+#ifndef RFONTLOAD_H
+#define RFONTLOAD_H
+
+#include "raylib.h"
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+GlyphInfo *LoadFontDataParallel(const unsigned char *fileData, int dataSize, int fontSize, int *codepoints, int codepointCount, int type);  // LoadFontData() split across the job pool
+Font LoadFontExParallel(const char *fileName, int fontSize, int *codepoints, int codepointCount);    // LoadFontEx() with glyphs rasterized in parallel
+void BenchmarkFontData(const char *fileName, int fontSize, int codepointCount, int type);           // Compare LoadFontData() and LoadFontDataParallel()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFONTLOAD_H
+
+
+/***********************************************************************************
+*
+*   RFONTLOAD IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RFONTLOAD_IMPLEMENTATION) && !defined(RFONTLOAD_IMPLEMENTATION_DEFINED)
+#define RFONTLOAD_IMPLEMENTATION_DEFINED
+
+#include "rjobs.h"
+
+#include <atomic>               // Required for: std::atomic
+#include <chrono>               // Required for: std::chrono::steady_clock
+#include <stdlib.h>             // Required for: malloc(), free()
+#include <string.h>             // Required for: memcpy(), memcmp(), memset()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define FONTLOAD_JOB_GLYPHS         32      // Glyphs per job chunk, one stbtt_InitFont() each
+#define FONTLOAD_JOB_GLYPHS_SDF     4       // Glyphs per job chunk for SDF, costly and uneven
+#define FONTLOAD_GLYPH_PADDING      4       // Same as LoadFontEx() (FONT_TTF_DEFAULT_CHARS_PADDING)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// LoadFontData() arguments shared by the jobs
+typedef struct {
+    const unsigned char *fileData;
+    int dataSize;
+    int fontSize;
+    int *codepoints;
+    int type;
+    GlyphInfo *glyphs;          // Output, codepoint order
+    std::atomic<int> *failed;   // Set when a chunk could not be loaded
+} FontDataJob;
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static double GetFontLoadTime(void);
+static void LoadFontDataJob(int begin, int end, void *userData);
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// LoadFontData() split across the job pool
+// NOTE: Same defaults as LoadFontData(): 95 glyphs from 32 (Space) when codepoints is NULL
+GlyphInfo *LoadFontDataParallel(const unsigned char *fileData, int dataSize, int fontSize, int *codepoints, int codepointCount, int type)
+{
+    if (fileData == NULL) return NULL;
+
+    codepointCount = (codepointCount > 0)? codepointCount : 95;
+
+    int *defaultCodepoints = NULL;
+    if (codepoints == NULL)
+    {
+        defaultCodepoints = (int *)malloc(codepointCount*sizeof(int));
+        for (int i = 0; i < codepointCount; i++) defaultCodepoints[i] = i + 32;
+        codepoints = defaultCodepoints;
+    }
+
+    std::atomic<int> failed(0);
+    FontDataJob job = { 0 };
+    job.fileData = fileData;
+    job.dataSize = dataSize;
+    job.fontSize = fontSize;
+    job.codepoints = codepoints;
+    job.type = type;
+    job.failed = &failed;
+    job.glyphs = (GlyphInfo *)RL_MALLOC(codepointCount*sizeof(GlyphInfo));
+
+    RunJobsParallel(codepointCount, (type == FONT_SDF)? FONTLOAD_JOB_GLYPHS_SDF : FONTLOAD_JOB_GLYPHS, LoadFontDataJob, &job);
+
+    // A chunk only fails when the font can't be parsed, then every chunk does
+    if (failed.load() != 0)
+    {
+        UnloadFontData(job.glyphs, codepointCount);
+        job.glyphs = NULL;
+    }
+
+    free(defaultCodepoints);
+
+    return job.glyphs;
+}
+
+// LoadFontEx() with glyphs rasterized in parallel
+Font LoadFontExParallel(const char *fileName, int fontSize, int *codepoints, int codepointCount)
+{
+    if (!IsFileExtension(fileName, ".ttf;.otf")) return LoadFontEx(fileName, fontSize, codepoints, codepointCount);
+
+    Font font = { 0 };
+
+    int dataSize = 0;
+    unsigned char *fileData = LoadFileData(fileName, &dataSize);
+    if (fileData == NULL) return GetFontDefault();
+
+    font.baseSize = fontSize;
+    font.glyphCount = (codepointCount > 0)? codepointCount : 95;
+    font.glyphs = LoadFontDataParallel(fileData, dataSize, font.baseSize, codepoints, font.glyphCount, FONT_DEFAULT);
+    UnloadFileData(fileData);
+
+    if (font.glyphs == NULL) return GetFontDefault();
+
+    font.glyphPadding = FONTLOAD_GLYPH_PADDING;
+
+    Image atlas = GenImageFontAtlas(font.glyphs, &font.recs, font.glyphCount, font.baseSize, font.glyphPadding, 0);
+    font.texture = LoadTextureFromImage(atlas);
+
+    // Update glyphs[i].image to use alpha, required to be used on ImageDrawText()
+    for (int i = 0; i < font.glyphCount; i++)
+    {
+        UnloadImage(font.glyphs[i].image);
+        font.glyphs[i].image = ImageFromImage(atlas, font.recs[i]);
+    }
+
+    UnloadImage(atlas);
+
+    TraceLog(LOG_INFO, "FONT: [%s] Data loaded in parallel (%i pixel size | %i glyphs | %i threads)", fileName, font.baseSize, font.glyphCount, GetJobsThreadCount());
+
+    return font;
+}
+
+// Compare LoadFontData() and LoadFontDataParallel()
+// NOTE: Codepoints are ASCII then CJK from U+4E00, glyphs are compared field by field and pixel by pixel,
+// except SDF space offsets: LoadFontData() never writes them (malloc garbage, space is not drawn)
+void BenchmarkFontData(const char *fileName, int fontSize, int codepointCount, int type)
+{
+    int dataSize = 0;
+    unsigned char *fileData = LoadFileData(fileName, &dataSize);
+    if (fileData == NULL) return;
+
+    int *codepoints = (int *)malloc(codepointCount*sizeof(int));
+    for (int i = 0; i < codepointCount; i++) codepoints[i] = (i < 95)? 32 + i : 0x4e00 + (i - 95);
+
+    double start = GetFontLoadTime();
+    GlyphInfo *serial = LoadFontData(fileData, dataSize, fontSize, codepoints, codepointCount, type);
+    double serialTime = GetFontLoadTime() - start;
+
+    start = GetFontLoadTime();
+    GlyphInfo *parallel = LoadFontDataParallel(fileData, dataSize, fontSize, codepoints, codepointCount, type);
+    double parallelTime = GetFontLoadTime() - start;
+
+    int mismatches = 0;
+    for (int i = 0; (i < codepointCount) && (serial != NULL) && (parallel != NULL); i++)
+    {
+        const GlyphInfo *a = &serial[i];
+        const GlyphInfo *b = &parallel[i];
+        int bytes = GetPixelDataSize(a->image.width, a->image.height, a->image.format);
+        bool offsets = (type != FONT_SDF) || (a->value != 32);
+
+        if ((a->value != b->value) || (offsets && ((a->offsetX != b->offsetX) || (a->offsetY != b->offsetY))) || (a->advanceX != b->advanceX) ||
+            (a->image.width != b->image.width) || (a->image.height != b->image.height) || (a->image.format != b->image.format) ||
+            ((a->image.data == NULL) != (b->image.data == NULL)) ||
+            ((a->image.data != NULL) && (b->image.data != NULL) && (memcmp(a->image.data, b->image.data, bytes) != 0))) mismatches++;
+    }
+
+    TraceLog(LOG_INFO, "BENCH: [%5i codepoints, size %2i, %-7s] LoadFontData() %9.2f ms, parallel %9.2f ms (%i threads, %4.2fx), mismatches: %i",
+             codepointCount, fontSize, (type == FONT_SDF)? "SDF" : (type == FONT_BITMAP)? "BITMAP" : "DEFAULT", serialTime*1000.0, parallelTime*1000.0,
+             GetJobsThreadCount(), serialTime/parallelTime, mismatches);
+
+    UnloadFontData(serial, codepointCount);
+    UnloadFontData(parallel, codepointCount);
+    free(codepoints);
+    UnloadFileData(fileData);
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Monotonic time in seconds
+static double GetFontLoadTime(void)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Rasterize codepoints [begin, end) into the shared glyph array
+static void LoadFontDataJob(int begin, int end, void *userData)
+{
+    FontDataJob *job = (FontDataJob *)userData;
+
+    GlyphInfo *glyphs = LoadFontData(job->fileData, job->dataSize, job->fontSize, &job->codepoints[begin], end - begin, job->type);
+
+    if (glyphs != NULL)
+    {
+        memcpy(&job->glyphs[begin], glyphs, (end - begin)*sizeof(GlyphInfo));
+        RL_FREE(glyphs);        // Images now owned by job->glyphs
+    }
+    else
+    {
+        memset(&job->glyphs[begin], 0, (end - begin)*sizeof(GlyphInfo));
+        job->failed->store(1);
+    }
+}
+
+#endif // RFONTLOAD_IMPLEMENTATION
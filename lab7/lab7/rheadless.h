@@ -0,0 +1,298 @@
+/**********************************************************************************************
+*
+*   raylib.headless - Headless platform and fixed step frame clock
+*
+*   DESCRIPTION:
+*       FrameClock replaces GetTime()/GetFrameTime() in frame loops:
+*         - Wall clock mode (fixedStep 0) measures real frame times, like rcore does
+*         - Fixed step mode advances exactly fixedStep seconds per TickFrameClock(), whatever
+*           the real frame took, so animations and simulations replay identically and loops can
+*           run uncapped for throughput measurements
+*       Wall time is tracked in both modes, GetClockWallTime() gives the real elapsed seconds.
+*
+*       The headless platform is the window side of a raylib platform (init, should close,
+*       begin/end drawing, frame time, screenshot) without GLFW or GL: drawing goes to a
+*       rsoftgl.h context and the platform clock is a FrameClock. A frame limit ends the loop,
+*       so the same code runs windowed or headless:
+*
+*           InitHeadlessWindow(1280, 720, 1.0/60.0);
+*           SetHeadlessFrameLimit(600);
+*           while (!HeadlessShouldClose())
+*           {
+*               SoftContext *ctx = BeginHeadlessDrawing();
+*               ... update with GetHeadlessTime()/GetHeadlessFrameTime(), draw with Soft*() ...
+*               EndHeadlessDrawing();
+*           }
+*           TakeHeadlessScreenshot("frame600.png");
+*           CloseHeadlessWindow();
+*
+*   CONFIGURATION:
+*
+*   #define RHEADLESS_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+*   NOTE: Requires rsoftgl.h, its implementation must be in the same or another translation unit
+*
+**********************************************************************************************/
+
+#ifndef RHEADLESS_H
+#define RHEADLESS_H
+
+#include "raylib.h"
+#include "rsoftgl.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Frame clock, virtual time advances by fixedStep per tick (wall clock when fixedStep is 0)
+typedef struct {
+    double fixedStep;           // Seconds per frame, 0 for wall clock
+    double time;                // Clock time since LoadFrameClock()
+    double frameTime;           // Last frame duration
+    unsigned int frameCounter;  // Ticks since LoadFrameClock()
+    double wallStart;           // Real time at LoadFrameClock()
+    double wallPrevious;        // Real time at last tick
+} FrameClock;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+FrameClock LoadFrameClock(double fixedStep);                        // Load frame clock, fixedStep 0 for wall clock
+void TickFrameClock(FrameClock *clock);                             // Advance clock by one frame (call once per frame, after drawing)
+double GetClockTime(const FrameClock *clock);                       // Get clock time in seconds
+float GetClockFrameTime(const FrameClock *clock);                   // Get last frame duration in seconds
+unsigned int GetClockFrameCount(const FrameClock *clock);           // Get frames since clock load
+double GetClockWallTime(const FrameClock *clock);                   // Get real seconds since clock load
+
+void InitHeadlessWindow(int width, int height, double fixedStep);   // Init headless platform (software context and clock)
+void CloseHeadlessWindow(void);                                     // Close headless platform
+bool IsHeadlessWindowReady(void);                                   // Check headless platform initialized
+void SetHeadlessFrameLimit(unsigned int frames);                    // Set frames before HeadlessShouldClose() (0 = no limit)
+bool HeadlessShouldClose(void);                                     // Check frame limit reached
+SoftContext *BeginHeadlessDrawing(void);                            // Setup frame, returns the context to draw into
+void EndHeadlessDrawing(void);                                      // Flush drawing and tick the platform clock
+double GetHeadlessTime(void);                                       // Get platform clock time in seconds
+float GetHeadlessFrameTime(void);                                   // Get platform frame time in seconds
+unsigned int GetHeadlessFrameCount(void);                           // Get frames drawn
+double GetHeadlessWallTime(void);                                   // Get real seconds since init
+Image LoadHeadlessScreenImage(void);                                // Get last frame as image (RGBA8)
+void TakeHeadlessScreenshot(const char *fileName);                  // Export last frame to file
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RHEADLESS_H
+
+
+/***********************************************************************************
+*
+*   RHEADLESS IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RHEADLESS_IMPLEMENTATION) && !defined(RHEADLESS_IMPLEMENTATION_DEFINED)
+#define RHEADLESS_IMPLEMENTATION_DEFINED
+
+#include <chrono>               // Required for: std::chrono::steady_clock
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Headless platform state, the counterpart of rcore CORE.Window/CORE.Time
+typedef struct {
+    bool ready;
+    SoftContext context;
+    FrameClock clock;
+    unsigned int frameLimit;
+} HeadlessPlatform;
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static HeadlessPlatform headless = { 0 };
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static double GetWallTime(void);
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Load frame clock, fixedStep 0 for wall clock
+FrameClock LoadFrameClock(double fixedStep)
+{
+    FrameClock clock = { 0 };
+
+    clock.fixedStep = (fixedStep > 0.0)? fixedStep : 0.0;
+    clock.wallStart = GetWallTime();
+    clock.wallPrevious = clock.wallStart;
+
+    return clock;
+}
+
+// Advance clock by one frame (call once per frame, after drawing)
+void TickFrameClock(FrameClock *clock)
+{
+    double now = GetWallTime();
+    clock->frameCounter++;
+
+    if (clock->fixedStep > 0.0)
+    {
+        // Multiply instead of accumulating, time stays exact for any frame count
+        clock->frameTime = clock->fixedStep;
+        clock->time = clock->fixedStep*clock->frameCounter;
+    }
+    else
+    {
+        clock->frameTime = now - clock->wallPrevious;
+        clock->time = now - clock->wallStart;
+    }
+
+    clock->wallPrevious = now;
+}
+
+// Get clock time in seconds
+double GetClockTime(const FrameClock *clock)
+{
+    return clock->time;
+}
+
+// Get last frame duration in seconds
+float GetClockFrameTime(const FrameClock *clock)
+{
+    return (float)clock->frameTime;
+}
+
+// Get frames since clock load
+unsigned int GetClockFrameCount(const FrameClock *clock)
+{
+    return clock->frameCounter;
+}
+
+// Get real seconds since clock load
+double GetClockWallTime(const FrameClock *clock)
+{
+    return GetWallTime() - clock->wallStart;
+}
+
+// Init headless platform (software context and clock)
+void InitHeadlessWindow(int width, int height, double fixedStep)
+{
+    if (headless.ready) CloseHeadlessWindow();
+
+    headless.context = LoadSoftContext(width, height);
+    headless.clock = LoadFrameClock(fixedStep);
+    headless.frameLimit = 0;
+    headless.ready = true;
+
+    TraceLog(LOG_INFO, "HEADLESS: Initialized %ix%i, %s clock", width, height, (fixedStep > 0.0)? "fixed step" : "wall");
+    if (fixedStep > 0.0) TraceLog(LOG_INFO, "HEADLESS: Fixed step: %.6f s (%.2f FPS)", fixedStep, 1.0/fixedStep);
+}
+
+// Close headless platform
+void CloseHeadlessWindow(void)
+{
+    if (!headless.ready) return;
+
+    TraceLog(LOG_INFO, "HEADLESS: %u frames in %.3f s wall time (%.1f FPS uncapped)", headless.clock.frameCounter,
+             GetClockWallTime(&headless.clock), headless.clock.frameCounter/GetClockWallTime(&headless.clock));
+
+    UnloadSoftContext(&headless.context);
+    headless = (HeadlessPlatform){ 0 };
+}
+
+// Check headless platform initialized
+bool IsHeadlessWindowReady(void)
+{
+    return headless.ready;
+}
+
+// Set frames before HeadlessShouldClose() (0 = no limit)
+void SetHeadlessFrameLimit(unsigned int frames)
+{
+    headless.frameLimit = frames;
+}
+
+// Check frame limit reached
+bool HeadlessShouldClose(void)
+{
+    if (!headless.ready) return true;
+
+    return (headless.frameLimit > 0) && (headless.clock.frameCounter >= headless.frameLimit);
+}
+
+// Setup frame, returns the context to draw into
+SoftContext *BeginHeadlessDrawing(void)
+{
+    return &headless.context;
+}
+
+// Flush drawing and tick the platform clock
+void EndHeadlessDrawing(void)
+{
+    SoftFlush(&headless.context);
+    TickFrameClock(&headless.clock);
+}
+
+// Get platform clock time in seconds
+double GetHeadlessTime(void)
+{
+    return GetClockTime(&headless.clock);
+}
+
+// Get platform frame time in seconds
+float GetHeadlessFrameTime(void)
+{
+    return GetClockFrameTime(&headless.clock);
+}
+
+// Get frames drawn
+unsigned int GetHeadlessFrameCount(void)
+{
+    return GetClockFrameCount(&headless.clock);
+}
+
+// Get real seconds since init
+double GetHeadlessWallTime(void)
+{
+    return GetClockWallTime(&headless.clock);
+}
+
+// Get last frame as image (RGBA8)
+Image LoadHeadlessScreenImage(void)
+{
+    return LoadImageFromSoftContext(&headless.context);
+}
+
+// Export last frame to file
+void TakeHeadlessScreenshot(const char *fileName)
+{
+    Image image = LoadHeadlessScreenImage();
+    ExportImage(image, fileName);
+    UnloadImage(image);
+
+    TraceLog(LOG_INFO, "HEADLESS: [%s] Screenshot taken at frame %u (t = %.3f s)", fileName, headless.clock.frameCounter, headless.clock.time);
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Monotonic real time in seconds, works without a window
+static double GetWallTime(void)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif // RHEADLESS_IMPLEMENTATION
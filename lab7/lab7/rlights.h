@@ -0,0 +1,409 @@
+/**********************************************************************************************
+*
+*   raylib.lights - Some useful functions to deal with lights data
+*
+*   DESCRIPTION:
+*       Lights and materials can be sent one uniform at a time (UpdateLightValues()) or as
+*       whole arrays in std140 uniform blocks (UpdateLightBlock()), declared in the shader as:
+*
+*           struct Light { vec3 position; int type; vec3 target; int enabled; vec4 color; };
+*           layout(std140) uniform LightBlock { int lightsCount; Light lights[MAX_LIGHTS]; };
+*
+*           struct Material { vec3 ambient; float shininess; vec3 diffuse; float transparency; vec3 specular; };
+*           layout(std140) uniform MaterialBlock { int materialsCount; Material materials[MAX_MATERIALS]; };
+*
+*   CONFIGURATION:
+*
+*   #define RLIGHTS_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers 
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+*   NOTE: Requires rtextfmt.h, its implementation must be in the same or another translation unit.
+*
+*   LICENSE: zlib/libpng
+*
+*   Copyright (c) 2017-2024 Victor Fisac (@victorfisac) and Ramon Santamaria (@raysan5)
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+#ifndef RLIGHTS_H
+#define RLIGHTS_H
+
+#include "runiforms.h"          // Required for: UniformCache
+#include "rubo.h"               // Required for: LoadUniformBuffer(), UpdateUniformBuffer()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define MAX_LIGHTS  256       // Max dynamic lights, must match the shader LightBlock (stays under the 16KB UBO minimum)
+#define MAX_MATERIALS   64    // Max materials, must match the shader MaterialBlock
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Light data
+typedef struct {   
+    int type;
+    bool enabled;
+    Vector3 position;
+    Vector3 target;
+    Color color;
+    float attenuation;
+    bool dirty;             // Values changed since last upload
+    
+    // Shader locations
+    int enabledLoc;
+    int typeLoc;
+    int positionLoc;
+    int targetLoc;
+    int colorLoc;
+    int attenuationLoc;
+} Light;
+
+typedef struct {
+    Vector3 ambient;
+    Vector3 diffuse;
+    Vector3 specular;
+    float shininess;
+    float transparency;     // Alpha, 1.0 is opaque
+
+    int ambientLoc;
+    int diffuseLoc;
+    int specularLoc;
+    int shininessLoc;
+
+    bool dirty;             // Values changed since last upload
+} MyMaterial;
+
+// Light in a LightBlock, std140 layout (48 bytes)
+typedef struct {
+    Vector3 position;
+    int type;
+    Vector3 target;
+    int enabled;
+    Vector4 color;
+} LightData;
+
+// Material in a MaterialBlock, std140 layout (48 bytes)
+typedef struct {
+    Vector3 ambient;
+    float shininess;
+    Vector3 diffuse;
+    float transparency;
+    Vector3 specular;
+    float unused;
+} MaterialData;
+
+// LightBlock contents, count padded to the 16-byte array alignment
+typedef struct {
+    int count;
+    int unused[3];
+    LightData lights[MAX_LIGHTS];
+} LightBlockData;
+
+// MaterialBlock contents
+typedef struct {
+    int count;
+    int unused[3];
+    MaterialData materials[MAX_MATERIALS];
+} MaterialBlockData;
+
+// Lights uploaded together as one uniform block
+typedef struct {
+    unsigned int uboId;
+    int bindingPoint;
+    LightBlockData *data;       // CPU copy of the block
+} LightBlock;
+
+// Materials uploaded together as one uniform block
+typedef struct {
+    unsigned int uboId;
+    int bindingPoint;
+    MaterialBlockData *data;    // CPU copy of the block
+} MaterialBlock;
+
+// Light type
+typedef enum {
+    LIGHT_DIRECTIONAL = 0,
+    LIGHT_POINT
+} LightType;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+Light CreateLight(int type, Vector3 position, Vector3 target, Color color, Shader shader);   // Create a light and get shader locations
+void UpdateLightValues(Shader shader, Light light);         // Send light properties to shader
+void UpdateMaterialValues(MyMaterial material, Shader shader);  // Send material properties to shader
+void UpdateLightValuesCached(UniformCache *cache, Light *light);            // Send light properties if dirty, unchanged values skipped
+void UpdateMaterialValuesCached(UniformCache *cache, MyMaterial *material); // Send material properties if dirty, unchanged values skipped
+
+LightBlock LoadLightBlock(Shader shader, int bindingPoint);                 // Load light uniform block and attach shader "LightBlock" to binding point
+void UpdateLightBlock(LightBlock *block, const Light *lights, int count);   // Send all lights with one buffer update
+void UnloadLightBlock(LightBlock *block);                                   // Unload light uniform block
+MaterialBlock LoadMaterialBlock(Shader shader, int bindingPoint);           // Load material uniform block and attach shader "MaterialBlock" to binding point
+void UpdateMaterialBlock(MaterialBlock *block, const MyMaterial *materials, int count); // Send all materials with one buffer update
+void UnloadMaterialBlock(MaterialBlock *block);                             // Unload material uniform block
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RLIGHTS_H
+
+
+/***********************************************************************************
+*
+*   RLIGHTS IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RLIGHTS_IMPLEMENTATION)
+
+#include "raylib.h"
+
+#include "rtextfmt.h"           // Required for: TextFormatLocal()
+
+#include <stddef.h>             // Required for: offsetof()
+#include <stdlib.h>             // Required for: calloc(), free()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+// ...
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// ...
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static int lightsCount = 0;    // Current amount of created lights
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+// ...
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Create a light and get shader locations
+// NOTE: Shaders reading a LightBlock have no lights[%i] uniforms (locations are -1), send lights with UpdateLightBlock()
+Light CreateLight(int type, Vector3 position, Vector3 target, Color color, Shader shader)
+{
+    Light light = { 0 };
+
+    if (lightsCount < MAX_LIGHTS)
+    {
+        light.enabled = true;
+        light.type = type;
+        light.position = position;
+        light.target = target;
+        light.color = color;
+        light.dirty = true;
+
+        // NOTE: Lighting shader naming must be the provided ones
+        light.enabledLoc = GetShaderLocation(shader, TextFormatLocal("lights[%i].enabled", lightsCount));
+        light.typeLoc = GetShaderLocation(shader, TextFormatLocal("lights[%i].type", lightsCount));
+        light.positionLoc = GetShaderLocation(shader, TextFormatLocal("lights[%i].position", lightsCount));
+        light.targetLoc = GetShaderLocation(shader, TextFormatLocal("lights[%i].target", lightsCount));
+        light.colorLoc = GetShaderLocation(shader, TextFormatLocal("lights[%i].color", lightsCount));
+
+        UpdateLightValues(shader, light);
+        
+        lightsCount++;
+    }
+
+    return light;
+}
+
+// Send light properties to shader
+// NOTE: Light shader locations should be available 
+void UpdateLightValues(Shader shader, Light light)
+{
+    // Send to shader light enabled state and type
+    SetShaderValue(shader, light.enabledLoc, &light.enabled, SHADER_UNIFORM_INT);
+    SetShaderValue(shader, light.typeLoc, &light.type, SHADER_UNIFORM_INT);
+
+    // Send to shader light position values
+    float position[3] = { light.position.x, light.position.y, light.position.z };
+    SetShaderValue(shader, light.positionLoc, position, SHADER_UNIFORM_VEC3);
+
+    // Send to shader light target position values
+    float target[3] = { light.target.x, light.target.y, light.target.z };
+    SetShaderValue(shader, light.targetLoc, target, SHADER_UNIFORM_VEC3);
+
+    // Send to shader light color values
+    float color[4] = { (float)light.color.r/(float)255, (float)light.color.g/(float)255, 
+                       (float)light.color.b/(float)255, (float)light.color.a/(float)255 };
+    SetShaderValue(shader, light.colorLoc, color, SHADER_UNIFORM_VEC4);
+}
+
+void UpdateMaterialValues(MyMaterial material, Shader shader) {
+    float ambient[] = { material.ambient.x, material.ambient.y, material.ambient.z };
+    float diffuse[] = { material.diffuse.x, material.diffuse.y, material.diffuse.z };
+    float specular[] = { material.specular.x, material.specular.y, material.specular.z };
+    float materialShininess = material.shininess*128;
+
+    SetShaderValue(shader, material.ambientLoc, ambient, SHADER_UNIFORM_VEC3);
+    SetShaderValue(shader, material.diffuseLoc, diffuse, SHADER_UNIFORM_VEC3);
+    SetShaderValue(shader, material.specularLoc, specular, SHADER_UNIFORM_VEC3);
+    SetShaderValue(shader, material.shininessLoc, &materialShininess, SHADER_UNIFORM_FLOAT);
+}
+
+// Send light properties if dirty, unchanged values skipped
+// NOTE: A static light costs no uniform uploads
+void UpdateLightValuesCached(UniformCache *cache, Light *light)
+{
+    if (!light->dirty) return;
+
+    int enabled = light->enabled;
+    SetCachedShaderValue(cache, light->enabledLoc, &enabled, SHADER_UNIFORM_INT);
+    SetCachedShaderValue(cache, light->typeLoc, &light->type, SHADER_UNIFORM_INT);
+
+    float position[3] = { light->position.x, light->position.y, light->position.z };
+    SetCachedShaderValue(cache, light->positionLoc, position, SHADER_UNIFORM_VEC3);
+
+    float target[3] = { light->target.x, light->target.y, light->target.z };
+    SetCachedShaderValue(cache, light->targetLoc, target, SHADER_UNIFORM_VEC3);
+
+    float color[4] = { (float)light->color.r/(float)255, (float)light->color.g/(float)255,
+                       (float)light->color.b/(float)255, (float)light->color.a/(float)255 };
+    SetCachedShaderValue(cache, light->colorLoc, color, SHADER_UNIFORM_VEC4);
+
+    light->dirty = false;
+}
+
+// Send material properties if dirty, unchanged values skipped
+// NOTE: Switching between materials needs the new one marked dirty
+void UpdateMaterialValuesCached(UniformCache *cache, MyMaterial *material)
+{
+    if (!material->dirty) return;
+
+    float ambient[] = { material->ambient.x, material->ambient.y, material->ambient.z };
+    float diffuse[] = { material->diffuse.x, material->diffuse.y, material->diffuse.z };
+    float specular[] = { material->specular.x, material->specular.y, material->specular.z };
+    float materialShininess = material->shininess*128;
+
+    SetCachedShaderValue(cache, material->ambientLoc, ambient, SHADER_UNIFORM_VEC3);
+    SetCachedShaderValue(cache, material->diffuseLoc, diffuse, SHADER_UNIFORM_VEC3);
+    SetCachedShaderValue(cache, material->specularLoc, specular, SHADER_UNIFORM_VEC3);
+    SetCachedShaderValue(cache, material->shininessLoc, &materialShininess, SHADER_UNIFORM_FLOAT);
+
+    material->dirty = false;
+}
+
+// Load light uniform block and attach shader "LightBlock" to binding point
+LightBlock LoadLightBlock(Shader shader, int bindingPoint)
+{
+    LightBlock block = { 0 };
+    block.bindingPoint = bindingPoint;
+    block.data = (LightBlockData *)calloc(1, sizeof(LightBlockData));
+    block.uboId = LoadUniformBuffer(block.data, sizeof(LightBlockData));
+
+    BindUniformBuffer(block.uboId, bindingPoint);
+    SetShaderUniformBlock(shader, "LightBlock", bindingPoint);
+
+    return block;
+}
+
+// Send all lights with one buffer update
+// NOTE: Only the used part of the array is sent
+void UpdateLightBlock(LightBlock *block, const Light *lights, int count)
+{
+    if (count > MAX_LIGHTS) count = MAX_LIGHTS;
+
+    for (int i = 0; i < count; i++)
+    {
+        LightData *light = &block->data->lights[i];
+        light->position = lights[i].position;
+        light->type = lights[i].type;
+        light->target = lights[i].target;
+        light->enabled = lights[i].enabled;
+        light->color = ColorNormalize(lights[i].color);
+    }
+
+    block->data->count = count;
+
+    UpdateUniformBuffer(block->uboId, block->data, offsetof(LightBlockData, lights) + count*sizeof(LightData), 0);
+}
+
+// Unload light uniform block
+void UnloadLightBlock(LightBlock *block)
+{
+    UnloadUniformBuffer(block->uboId);
+    free(block->data);
+
+    block->uboId = 0;
+    block->data = NULL;
+}
+
+// Load material uniform block and attach shader "MaterialBlock" to binding point
+MaterialBlock LoadMaterialBlock(Shader shader, int bindingPoint)
+{
+    MaterialBlock block = { 0 };
+    block.bindingPoint = bindingPoint;
+    block.data = (MaterialBlockData *)calloc(1, sizeof(MaterialBlockData));
+    block.uboId = LoadUniformBuffer(block.data, sizeof(MaterialBlockData));
+
+    BindUniformBuffer(block.uboId, bindingPoint);
+    SetShaderUniformBlock(shader, "MaterialBlock", bindingPoint);
+
+    return block;
+}
+
+// Send all materials with one buffer update
+void UpdateMaterialBlock(MaterialBlock *block, const MyMaterial *materials, int count)
+{
+    if (count > MAX_MATERIALS) count = MAX_MATERIALS;
+
+    for (int i = 0; i < count; i++)
+    {
+        MaterialData *material = &block->data->materials[i];
+        material->ambient = materials[i].ambient;
+        material->shininess = materials[i].shininess*128;
+        material->diffuse = materials[i].diffuse;
+        material->transparency = materials[i].transparency;
+        material->specular = materials[i].specular;
+    }
+
+    block->data->count = count;
+
+    UpdateUniformBuffer(block->uboId, block->data, offsetof(MaterialBlockData, materials) + count*sizeof(MaterialData), 0);
+}
+
+// Unload material uniform block
+void UnloadMaterialBlock(MaterialBlock *block)
+{
+    UnloadUniformBuffer(block->uboId);
+    free(block->data);
+
+    block->uboId = 0;
+    block->data = NULL;
+}
+
+#endif // RLIGHTS_IMPLEMENTATION
\ No newline at end of file
@@ -0,0 +1,928 @@
+/**********************************************************************************************
+*
+*   raylib.mathsimd - SIMD backend for raymath.h matrix and vector kernels
+*
+*   DESCRIPTION:
+*       Same functions as raymath.h with a SIMD suffix, same arguments and results:
+*           MatrixMultiplySIMD(), MatrixInvertSIMD(), MatrixTransposeSIMD(),
+*           QuaternionToMatrixSIMD(), Vector3TransformSIMD()
+*       plus array variants, one matrix applied to many values:
+*           Vector3TransformArray(), MatrixMultiplyArray()
+*
+*       Single value functions use SSE2 or NEON, chosen at compile time. Array functions are
+*       dispatched at runtime: AVX when the CPU and OS support it (GCC/Clang/MSVC on x86),
+*       SSE2 or NEON otherwise. SetMathSimdBackend() forces a backend, MATH_SIMD_SCALAR routes
+*       everything back to raymath.h.
+*
+*       Multiply, transform, transpose and quaternion kernels do the same float operations in the
+*       same order as raymath.h, results match bit for bit unless the compiler contracts the
+*       scalar code into FMA. MatrixInvertSIMD() uses 2x2 block inversion, results differ in
+*       the last bits. CheckMathSIMD() compares every kernel against raymath.h.
+*
+*       NEON has no MatrixInvertSIMD() and QuaternionToMatrixSIMD() kernels, they call raymath.h.
+*
+*       raymath.h functions are inlined, these are not: for one value only MatrixInvertSIMD() is
+*       faster, other single value kernels lose to the call and struct copies (BenchmarkMathSIMD()).
+*       Loops over many values should use the array functions.
+*
+*   CONFIGURATION:
+*
+*   #define RMATHSIMD_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+*   #define RAYMATH_SIMD
+*       Redirects MatrixInvert() to MatrixInvertSIMD() in code after this header.
+*
+**********************************************************************************************/
+
+#ifndef RMATHSIMD_H
+#define RMATHSIMD_H
+
+#include "raylib.h"
+#include "raymath.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// SIMD backends
+typedef enum {
+    MATH_SIMD_SCALAR = 0,       // raymath.h
+    MATH_SIMD_SSE2,             // x86, 4-wide
+    MATH_SIMD_NEON,             // ARM64, 4-wide
+    MATH_SIMD_AVX               // x86, 8-wide, array functions only
+} MathSimdBackend;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+Matrix MatrixMultiplySIMD(Matrix left, Matrix right);                                  // Same as MatrixMultiply()
+Matrix MatrixInvertSIMD(Matrix mat);                                                   // Same as MatrixInvert(), last bits may differ
+Matrix MatrixTransposeSIMD(Matrix mat);                                                // Same as MatrixTranspose()
+Matrix QuaternionToMatrixSIMD(Quaternion q);                                           // Same as QuaternionToMatrix()
+Vector3 Vector3TransformSIMD(Vector3 v, Matrix mat);                                   // Same as Vector3Transform()
+
+void Vector3TransformArray(Vector3 *result, const Vector3 *points, int count, Matrix mat);   // Transform points by one matrix, result can be points
+void MatrixMultiplyArray(Matrix *result, const Matrix *left, int count, Matrix right);      // Multiply matrices by one matrix, result can be left
+
+int GetMathSimdBackend(void);                                                           // Get current backend (MathSimdBackend)
+bool SetMathSimdBackend(int backend);                                                   // Force backend, false if not supported
+bool IsMathSimdBackendSupported(int backend);                                           // Check backend is compiled in and supported by the CPU
+const char *GetMathSimdBackendName(int backend);                                        // Get backend name for logs
+
+int CheckMathSIMD(int count);                                                           // Compare all kernels and backends against raymath.h, returns failures
+void BenchmarkMathSIMD(int count, int iterations);                                      // Time raymath.h against SIMD kernels and log results
+
+#ifdef __cplusplus
+}
+#endif
+
+#if defined(RAYMATH_SIMD)
+    #define MatrixInvert(mat)               MatrixInvertSIMD(mat)
+#endif
+
+#endif // RMATHSIMD_H
+
+
+/***********************************************************************************
+*
+*   RMATHSIMD IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RMATHSIMD_IMPLEMENTATION) && !defined(RMATHSIMD_IMPLEMENTATION_DEFINED)
+#define RMATHSIMD_IMPLEMENTATION_DEFINED    // Other modules include this header too
+
+#include <stdlib.h>             // Required for: malloc(), free(), rand(), srand()
+#include <string.h>             // Required for: memcpy()
+#include <math.h>               // Required for: fabsf()
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define RMS_SSE2
+    #include <emmintrin.h>
+    #if defined(__GNUC__) || defined(__clang__)
+        #define RMS_AVX
+        #define RMS_TARGET_AVX __attribute__((target("avx")))
+        #include <immintrin.h>
+    #elif defined(_MSC_VER)
+        #define RMS_AVX
+        #define RMS_TARGET_AVX
+        #include <immintrin.h>
+        #include <intrin.h>     // Required for: __cpuid(), _xgetbv()
+    #endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #define RMS_NEON
+    #include <arm_neon.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+
+// Scalar reference, parenthesis skip RAYMATH_SIMD redirections
+#define RMS_MatrixMultiply          (MatrixMultiply)
+#define RMS_MatrixInvert            (MatrixInvert)
+#define RMS_MatrixTranspose         (MatrixTranspose)
+#define RMS_QuaternionToMatrix      (QuaternionToMatrix)
+#define RMS_Vector3Transform        (Vector3Transform)
+
+#if defined(RMS_SSE2)
+    #define RMS_DEFAULT_BACKEND     MATH_SIMD_SSE2
+
+    // Lanes of the result in x, y, z, w order: first two from a, last two from b
+    #define RMS_SHUFFLE(a, b, x, y, z, w)   _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x))
+    #define RMS_SWIZZLE(a, x, y, z, w)      _mm_castsi128_ps(_mm_shuffle_epi32(_mm_castps_si128(a), _MM_SHUFFLE(w, z, y, x)))
+#elif defined(RMS_NEON)
+    #define RMS_DEFAULT_BACKEND     MATH_SIMD_NEON
+#else
+    #define RMS_DEFAULT_BACKEND     MATH_SIMD_SCALAR
+#endif
+
+#define RMS_TOLERANCE_ULPS          2           // Bit exact kernels, room for FMA contraction of the scalar code
+#define RMS_TOLERANCE_INVERT        1e-5f       // MatrixInvertSIMD(), relative to the largest element
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static int mathSimdBackend = RMS_DEFAULT_BACKEND;
+static bool mathSimdDetected = false;          // AVX checked, only array functions use it
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static void DetectMathSimdBackend(void);
+#if defined(RMS_AVX)
+static bool IsAvxSupported(void);
+static void Vector3TransformArrayAVX(Vector3 *result, const Vector3 *points, int count, Matrix mat);
+static void MatrixMultiplyArrayAVX(Matrix *result, const Matrix *left, int count, Matrix right);
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Same as MatrixMultiply()
+// NOTE: Matrix memory is row major, result row r is the sum of left rows scaled by right row r
+Matrix MatrixMultiplySIMD(Matrix left, Matrix right)
+{
+    if (mathSimdBackend == MATH_SIMD_SCALAR) return RMS_MatrixMultiply(left, right);
+
+    Matrix result;
+    const float *l = &left.m0;
+    const float *r = &right.m0;
+    float *out = &result.m0;
+
+#if defined(RMS_SSE2)
+    __m128 l0 = _mm_loadu_ps(l + 0);
+    __m128 l1 = _mm_loadu_ps(l + 4);
+    __m128 l2 = _mm_loadu_ps(l + 8);
+    __m128 l3 = _mm_loadu_ps(l + 12);
+
+    for (int i = 0; i < 16; i += 4)
+    {
+        __m128 row = _mm_mul_ps(l0, _mm_set1_ps(r[i]));
+        row = _mm_add_ps(row, _mm_mul_ps(l1, _mm_set1_ps(r[i + 1])));
+        row = _mm_add_ps(row, _mm_mul_ps(l2, _mm_set1_ps(r[i + 2])));
+        row = _mm_add_ps(row, _mm_mul_ps(l3, _mm_set1_ps(r[i + 3])));
+        _mm_storeu_ps(out + i, row);
+    }
+#elif defined(RMS_NEON)
+    float32x4_t l0 = vld1q_f32(l + 0);
+    float32x4_t l1 = vld1q_f32(l + 4);
+    float32x4_t l2 = vld1q_f32(l + 8);
+    float32x4_t l3 = vld1q_f32(l + 12);
+
+    for (int i = 0; i < 16; i += 4)
+    {
+        float32x4_t row = vmulq_n_f32(l0, r[i]);
+        row = vaddq_f32(row, vmulq_n_f32(l1, r[i + 1]));
+        row = vaddq_f32(row, vmulq_n_f32(l2, r[i + 2]));
+        row = vaddq_f32(row, vmulq_n_f32(l3, r[i + 3]));
+        vst1q_f32(out + i, row);
+    }
+#else
+    result = RMS_MatrixMultiply(left, right);
+    (void)l; (void)r; (void)out;
+#endif
+
+    return result;
+}
+
+// Same as MatrixInvert(), last bits may differ
+// NOTE: 2x2 block inversion with adjugates, 1/det is the only division
+Matrix MatrixInvertSIMD(Matrix mat)
+{
+#if defined(RMS_SSE2)
+    if (mathSimdBackend == MATH_SIMD_SCALAR) return RMS_MatrixInvert(mat);
+
+    const float *m = &mat.m0;
+    __m128 row0 = _mm_loadu_ps(m + 0);
+    __m128 row1 = _mm_loadu_ps(m + 4);
+    __m128 row2 = _mm_loadu_ps(m + 8);
+    __m128 row3 = _mm_loadu_ps(m + 12);
+
+    // 2x2 sub matrices, row major in one register
+    __m128 a = _mm_movelh_ps(row0, row1);
+    __m128 b = _mm_movehl_ps(row1, row0);
+    __m128 c = _mm_movelh_ps(row2, row3);
+    __m128 d = _mm_movehl_ps(row3, row2);
+
+    // Determinants of a, b, c and d
+    __m128 detSub = _mm_sub_ps(_mm_mul_ps(RMS_SHUFFLE(row0, row2, 0, 2, 0, 2), RMS_SHUFFLE(row1, row3, 1, 3, 1, 3)),
+                               _mm_mul_ps(RMS_SHUFFLE(row0, row2, 1, 3, 1, 3), RMS_SHUFFLE(row1, row3, 0, 2, 0, 2)));
+    __m128 detA = RMS_SWIZZLE(detSub, 0, 0, 0, 0);
+    __m128 detB = RMS_SWIZZLE(detSub, 1, 1, 1, 1);
+    __m128 detC = RMS_SWIZZLE(detSub, 2, 2, 2, 2);
+    __m128 detD = RMS_SWIZZLE(detSub, 3, 3, 3, 3);
+
+    // adj(d)*c and adj(a)*b
+    __m128 dc = _mm_sub_ps(_mm_mul_ps(RMS_SWIZZLE(d, 3, 3, 0, 0), c), _mm_mul_ps(RMS_SWIZZLE(d, 1, 1, 2, 2), RMS_SWIZZLE(c, 2, 3, 0, 1)));
+    __m128 ab = _mm_sub_ps(_mm_mul_ps(RMS_SWIZZLE(a, 3, 3, 0, 0), b), _mm_mul_ps(RMS_SWIZZLE(a, 1, 1, 2, 2), RMS_SWIZZLE(b, 2, 3, 0, 1)));
+
+    // Adjugates of the inverse blocks: x = |d|a - b(dc), w = |a|d - c(ab), y = |b|c - d*adj(ab), z = |c|b - a*adj(dc)
+    __m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), _mm_add_ps(_mm_mul_ps(b, RMS_SWIZZLE(dc, 0, 3, 0, 3)), _mm_mul_ps(RMS_SWIZZLE(b, 1, 0, 3, 2), RMS_SWIZZLE(dc, 2, 1, 2, 1))));
+    __m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), _mm_add_ps(_mm_mul_ps(c, RMS_SWIZZLE(ab, 0, 3, 0, 3)), _mm_mul_ps(RMS_SWIZZLE(c, 1, 0, 3, 2), RMS_SWIZZLE(ab, 2, 1, 2, 1))));
+    __m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), _mm_sub_ps(_mm_mul_ps(d, RMS_SWIZZLE(ab, 3, 0, 3, 0)), _mm_mul_ps(RMS_SWIZZLE(d, 1, 0, 3, 2), RMS_SWIZZLE(ab, 2, 1, 2, 1))));
+    __m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), _mm_sub_ps(_mm_mul_ps(a, RMS_SWIZZLE(dc, 3, 0, 3, 0)), _mm_mul_ps(RMS_SWIZZLE(a, 1, 0, 3, 2), RMS_SWIZZLE(dc, 2, 1, 2, 1))));
+
+    // |m| = |a||d| + |b||c| - trace((ab)(dc))
+    __m128 trace = _mm_mul_ps(ab, RMS_SWIZZLE(dc, 0, 2, 1, 3));
+    trace = _mm_add_ps(trace, RMS_SWIZZLE(trace, 2, 3, 0, 1));
+    trace = _mm_add_ps(trace, RMS_SWIZZLE(trace, 1, 0, 3, 2));
+    __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+
+    __m128 invDet = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+    x = _mm_mul_ps(x, invDet);
+    y = _mm_mul_ps(y, invDet);
+    z = _mm_mul_ps(z, invDet);
+    w = _mm_mul_ps(w, invDet);
+
+    // Adjugate shuffle back into rows
+    Matrix result;
+    float *out = &result.m0;
+    _mm_storeu_ps(out + 0, RMS_SHUFFLE(x, y, 3, 1, 3, 1));
+    _mm_storeu_ps(out + 4, RMS_SHUFFLE(x, y, 2, 0, 2, 0));
+    _mm_storeu_ps(out + 8, RMS_SHUFFLE(z, w, 3, 1, 3, 1));
+    _mm_storeu_ps(out + 12, RMS_SHUFFLE(z, w, 2, 0, 2, 0));
+
+    return result;
+#else
+    return RMS_MatrixInvert(mat);
+#endif
+}
+
+// Same as MatrixTranspose()
+Matrix MatrixTransposeSIMD(Matrix mat)
+{
+    if (mathSimdBackend == MATH_SIMD_SCALAR) return RMS_MatrixTranspose(mat);
+
+    Matrix result;
+    const float *m = &mat.m0;
+    float *out = &result.m0;
+
+#if defined(RMS_SSE2)
+    __m128 row0 = _mm_loadu_ps(m + 0);
+    __m128 row1 = _mm_loadu_ps(m + 4);
+    __m128 row2 = _mm_loadu_ps(m + 8);
+    __m128 row3 = _mm_loadu_ps(m + 12);
+    _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+    _mm_storeu_ps(out + 0, row0);
+    _mm_storeu_ps(out + 4, row1);
+    _mm_storeu_ps(out + 8, row2);
+    _mm_storeu_ps(out + 12, row3);
+#elif defined(RMS_NEON)
+    float32x4x4_t columns = vld4q_f32(m);
+    vst1q_f32(out + 0, columns.val[0]);
+    vst1q_f32(out + 4, columns.val[1]);
+    vst1q_f32(out + 8, columns.val[2]);
+    vst1q_f32(out + 12, columns.val[3]);
+#else
+    result = RMS_MatrixTranspose(mat);
+    (void)m; (void)out;
+#endif
+
+    return result;
+}
+
+// Same as QuaternionToMatrix()
+// NOTE: Every row is e + k*2*(u*v + s*(w*t)) with lanes of q picked to match raymath.h terms
+Matrix QuaternionToMatrixSIMD(Quaternion q)
+{
+#if defined(RMS_SSE2)
+    if (mathSimdBackend == MATH_SIMD_SCALAR) return RMS_QuaternionToMatrix(q);
+
+    __m128 v = _mm_loadu_ps(&q.x);
+    __m128 two = _mm_set1_ps(2.0f);
+
+    // Row 0: 1 - 2(y*y + z*z), 2(x*y - w*z), 2(x*z + w*y)
+    __m128 t0 = _mm_add_ps(_mm_mul_ps(RMS_SWIZZLE(v, 1, 0, 0, 0), RMS_SWIZZLE(v, 1, 1, 2, 0)),
+                           _mm_mul_ps(_mm_setr_ps(1.0f, -1.0f, 1.0f, 0.0f), _mm_mul_ps(RMS_SWIZZLE(v, 2, 3, 3, 0), RMS_SWIZZLE(v, 2, 2, 1, 0))));
+    __m128 row0 = _mm_add_ps(_mm_setr_ps(1.0f, 0.0f, 0.0f, 0.0f), _mm_mul_ps(_mm_setr_ps(-1.0f, 1.0f, 1.0f, 0.0f), _mm_mul_ps(two, t0)));
+
+    // Row 1: 2(x*y + w*z), 1 - 2(x*x + z*z), 2(y*z - w*x)
+    __m128 t1 = _mm_add_ps(_mm_mul_ps(RMS_SWIZZLE(v, 0, 0, 1, 0), RMS_SWIZZLE(v, 1, 0, 2, 0)),
+                           _mm_mul_ps(_mm_setr_ps(1.0f, 1.0f, -1.0f, 0.0f), _mm_mul_ps(RMS_SWIZZLE(v, 3, 2, 3, 0), RMS_SWIZZLE(v, 2, 2, 0, 0))));
+    __m128 row1 = _mm_add_ps(_mm_setr_ps(0.0f, 1.0f, 0.0f, 0.0f), _mm_mul_ps(_mm_setr_ps(1.0f, -1.0f, 1.0f, 0.0f), _mm_mul_ps(two, t1)));
+
+    // Row 2: 2(x*z - w*y), 2(y*z + w*x), 1 - 2(x*x + y*y)
+    __m128 t2 = _mm_add_ps(_mm_mul_ps(RMS_SWIZZLE(v, 0, 1, 0, 0), RMS_SWIZZLE(v, 2, 2, 0, 0)),
+                           _mm_mul_ps(_mm_setr_ps(-1.0f, 1.0f, 1.0f, 0.0f), _mm_mul_ps(RMS_SWIZZLE(v, 3, 3, 1, 0), RMS_SWIZZLE(v, 1, 0, 1, 0))));
+    __m128 row2 = _mm_add_ps(_mm_setr_ps(0.0f, 0.0f, 1.0f, 0.0f), _mm_mul_ps(_mm_setr_ps(1.0f, 1.0f, -1.0f, 0.0f), _mm_mul_ps(two, t2)));
+
+    Matrix result;
+    float *out = &result.m0;
+    _mm_storeu_ps(out + 0, row0);
+    _mm_storeu_ps(out + 4, row1);
+    _mm_storeu_ps(out + 8, row2);
+    _mm_storeu_ps(out + 12, _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+
+    return result;
+#else
+    return RMS_QuaternionToMatrix(q);
+#endif
+}
+
+// Same as Vector3Transform()
+// NOTE: Single points need a transpose, Vector3TransformArray() is the fast path
+Vector3 Vector3TransformSIMD(Vector3 v, Matrix mat)
+{
+    if (mathSimdBackend == MATH_SIMD_SCALAR) return RMS_Vector3Transform(v, mat);
+
+    Vector3 result;
+    float out[4];
+
+#if defined(RMS_SSE2)
+    const float *m = &mat.m0;
+    __m128 col0 = _mm_loadu_ps(m + 0);
+    __m128 col1 = _mm_loadu_ps(m + 4);
+    __m128 col2 = _mm_loadu_ps(m + 8);
+    __m128 col3 = _mm_loadu_ps(m + 12);
+    _MM_TRANSPOSE4_PS(col0, col1, col2, col3);
+
+    __m128 r = _mm_mul_ps(col0, _mm_set1_ps(v.x));
+    r = _mm_add_ps(r, _mm_mul_ps(col1, _mm_set1_ps(v.y)));
+    r = _mm_add_ps(r, _mm_mul_ps(col2, _mm_set1_ps(v.z)));
+    r = _mm_add_ps(r, col3);
+    _mm_storeu_ps(out, r);
+#elif defined(RMS_NEON)
+    float32x4x4_t cols = vld4q_f32(&mat.m0);
+
+    float32x4_t r = vmulq_n_f32(cols.val[0], v.x);
+    r = vaddq_f32(r, vmulq_n_f32(cols.val[1], v.y));
+    r = vaddq_f32(r, vmulq_n_f32(cols.val[2], v.z));
+    r = vaddq_f32(r, cols.val[3]);
+    vst1q_f32(out, r);
+#else
+    return RMS_Vector3Transform(v, mat);
+#endif
+
+    result.x = out[0];
+    result.y = out[1];
+    result.z = out[2];
+
+    return result;
+}
+
+// Transform points by one matrix, result can be points
+// NOTE: 4 points per step as x, y and z registers, one multiply-add per matrix element
+void Vector3TransformArray(Vector3 *result, const Vector3 *points, int count, Matrix mat)
+{
+    if (!mathSimdDetected) DetectMathSimdBackend();
+
+    int i = 0;
+
+#if defined(RMS_AVX)
+    if (mathSimdBackend == MATH_SIMD_AVX)
+    {
+        Vector3TransformArrayAVX(result, points, count, mat);
+        return;
+    }
+#endif
+
+#if defined(RMS_SSE2)
+    if (mathSimdBackend != MATH_SIMD_SCALAR)
+    {
+        __m128 m0 = _mm_set1_ps(mat.m0), m4 = _mm_set1_ps(mat.m4), m8 = _mm_set1_ps(mat.m8), m12 = _mm_set1_ps(mat.m12);
+        __m128 m1 = _mm_set1_ps(mat.m1), m5 = _mm_set1_ps(mat.m5), m9 = _mm_set1_ps(mat.m9), m13 = _mm_set1_ps(mat.m13);
+        __m128 m2 = _mm_set1_ps(mat.m2), m6 = _mm_set1_ps(mat.m6), m10 = _mm_set1_ps(mat.m10), m14 = _mm_set1_ps(mat.m14);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            // x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3 to x, y and z registers
+            const float *p = &points[i].x;
+            __m128 a = _mm_loadu_ps(p + 0);
+            __m128 b = _mm_loadu_ps(p + 4);
+            __m128 c = _mm_loadu_ps(p + 8);
+
+            __m128 x = RMS_SHUFFLE(a, RMS_SHUFFLE(b, c, 2, 2, 1, 1), 0, 3, 0, 2);
+            __m128 y = RMS_SHUFFLE(RMS_SHUFFLE(a, b, 1, 1, 0, 0), RMS_SHUFFLE(b, c, 3, 3, 2, 2), 0, 2, 0, 2);
+            __m128 z = RMS_SHUFFLE(RMS_SHUFFLE(a, b, 2, 2, 1, 1), c, 0, 2, 0, 3);
+
+            __m128 rx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, x), _mm_mul_ps(m4, y)), _mm_mul_ps(m8, z)), m12);
+            __m128 ry = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m1, x), _mm_mul_ps(m5, y)), _mm_mul_ps(m9, z)), m13);
+            __m128 rz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m2, x), _mm_mul_ps(m6, y)), _mm_mul_ps(m10, z)), m14);
+
+            // Back to x y z triplets
+            float *out = &result[i].x;
+            _mm_storeu_ps(out + 0, RMS_SHUFFLE(RMS_SHUFFLE(rx, ry, 0, 0, 0, 0), RMS_SHUFFLE(rz, rx, 0, 0, 1, 1), 0, 2, 0, 2));
+            _mm_storeu_ps(out + 4, RMS_SHUFFLE(RMS_SHUFFLE(ry, rz, 1, 1, 1, 1), RMS_SHUFFLE(rx, ry, 2, 2, 2, 2), 0, 2, 0, 2));
+            _mm_storeu_ps(out + 8, RMS_SHUFFLE(RMS_SHUFFLE(rz, rx, 2, 2, 3, 3), RMS_SHUFFLE(ry, rz, 3, 3, 3, 3), 0, 2, 0, 2));
+        }
+    }
+#elif defined(RMS_NEON)
+    if (mathSimdBackend != MATH_SIMD_SCALAR)
+    {
+        for (; i + 4 <= count; i += 4)
+        {
+            float32x4x3_t p = vld3q_f32(&points[i].x);     // Loads x, y and z registers
+            float32x4x3_t r;
+
+            r.val[0] = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_n_f32(p.val[0], mat.m0), vmulq_n_f32(p.val[1], mat.m4)), vmulq_n_f32(p.val[2], mat.m8)), vdupq_n_f32(mat.m12));
+            r.val[1] = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_n_f32(p.val[0], mat.m1), vmulq_n_f32(p.val[1], mat.m5)), vmulq_n_f32(p.val[2], mat.m9)), vdupq_n_f32(mat.m13));
+            r.val[2] = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_n_f32(p.val[0], mat.m2), vmulq_n_f32(p.val[1], mat.m6)), vmulq_n_f32(p.val[2], mat.m10)), vdupq_n_f32(mat.m14));
+
+            vst3q_f32(&result[i].x, r);
+        }
+    }
+#endif
+
+    for (; i < count; i++) result[i] = RMS_Vector3Transform(points[i], mat);
+}
+
+// Multiply matrices by one matrix, result can be left
+void MatrixMultiplyArray(Matrix *result, const Matrix *left, int count, Matrix right)
+{
+    if (!mathSimdDetected) DetectMathSimdBackend();
+
+#if defined(RMS_AVX)
+    if (mathSimdBackend == MATH_SIMD_AVX)
+    {
+        MatrixMultiplyArrayAVX(result, left, count, right);
+        return;
+    }
+#endif
+
+#if defined(RMS_SSE2)
+    if (mathSimdBackend != MATH_SIMD_SCALAR)
+    {
+        // Right matrix elements splatted once for all matrices
+        const float *r = &right.m0;
+        __m128 splat[16];
+        for (int k = 0; k < 16; k++) splat[k] = _mm_set1_ps(r[k]);
+
+        for (int i = 0; i < count; i++)
+        {
+            const float *l = &left[i].m0;
+            __m128 l0 = _mm_loadu_ps(l + 0);
+            __m128 l1 = _mm_loadu_ps(l + 4);
+            __m128 l2 = _mm_loadu_ps(l + 8);
+            __m128 l3 = _mm_loadu_ps(l + 12);
+
+            float *out = &result[i].m0;
+            for (int k = 0; k < 16; k += 4)
+            {
+                __m128 row = _mm_mul_ps(l0, splat[k]);
+                row = _mm_add_ps(row, _mm_mul_ps(l1, splat[k + 1]));
+                row = _mm_add_ps(row, _mm_mul_ps(l2, splat[k + 2]));
+                row = _mm_add_ps(row, _mm_mul_ps(l3, splat[k + 3]));
+                _mm_storeu_ps(out + k, row);
+            }
+        }
+
+        return;
+    }
+#endif
+
+    for (int i = 0; i < count; i++) result[i] = MatrixMultiplySIMD(left[i], right);
+}
+
+// Get current backend
+int GetMathSimdBackend(void)
+{
+    if (!mathSimdDetected) DetectMathSimdBackend();
+
+    return mathSimdBackend;
+}
+
+// Force backend, false if not supported
+bool SetMathSimdBackend(int backend)
+{
+    if (!IsMathSimdBackendSupported(backend)) return false;
+
+    mathSimdBackend = backend;
+    mathSimdDetected = true;
+
+    return true;
+}
+
+// Check backend is compiled in and supported by the CPU
+bool IsMathSimdBackendSupported(int backend)
+{
+    switch (backend)
+    {
+        case MATH_SIMD_SCALAR: return true;
+    #if defined(RMS_SSE2)
+        case MATH_SIMD_SSE2: return true;
+    #endif
+    #if defined(RMS_NEON)
+        case MATH_SIMD_NEON: return true;
+    #endif
+    #if defined(RMS_AVX)
+        case MATH_SIMD_AVX: return IsAvxSupported();
+    #endif
+        default: return false;
+    }
+}
+
+// Get backend name for logs
+const char *GetMathSimdBackendName(int backend)
+{
+    switch (backend)
+    {
+        case MATH_SIMD_SCALAR: return "scalar";
+        case MATH_SIMD_SSE2: return "SSE2";
+        case MATH_SIMD_NEON: return "NEON";
+        case MATH_SIMD_AVX: return "AVX";
+        default: return "unknown";
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Upgrade default backend to AVX when supported
+static void DetectMathSimdBackend(void)
+{
+#if defined(RMS_AVX)
+    if (IsAvxSupported()) mathSimdBackend = MATH_SIMD_AVX;
+#endif
+
+    mathSimdDetected = true;
+}
+
+#if defined(RMS_AVX)
+// Check CPU has AVX and OS saves the registers
+static bool IsAvxSupported(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    return osxsave && avx && ((_xgetbv(0) & 6) == 6);
+#else
+    return __builtin_cpu_supports("avx");
+#endif
+}
+
+// Vector3TransformArray() 8 points per step, 128-bit lanes hold points 0-3 and 4-7
+RMS_TARGET_AVX static void Vector3TransformArrayAVX(Vector3 *result, const Vector3 *points, int count, Matrix mat)
+{
+    __m256 m0 = _mm256_set1_ps(mat.m0), m4 = _mm256_set1_ps(mat.m4), m8 = _mm256_set1_ps(mat.m8), m12 = _mm256_set1_ps(mat.m12);
+    __m256 m1 = _mm256_set1_ps(mat.m1), m5 = _mm256_set1_ps(mat.m5), m9 = _mm256_set1_ps(mat.m9), m13 = _mm256_set1_ps(mat.m13);
+    __m256 m2 = _mm256_set1_ps(mat.m2), m6 = _mm256_set1_ps(mat.m6), m10 = _mm256_set1_ps(mat.m10), m14 = _mm256_set1_ps(mat.m14);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const float *p = &points[i].x;
+        __m256 a = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 0)), _mm_loadu_ps(p + 12), 1);
+        __m256 b = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 4)), _mm_loadu_ps(p + 16), 1);
+        __m256 c = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 8)), _mm_loadu_ps(p + 20), 1);
+
+        __m256 x = _mm256_shuffle_ps(a, _mm256_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+        __m256 y = _mm256_shuffle_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm256_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 z = _mm256_shuffle_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), c, _MM_SHUFFLE(3, 0, 2, 0));
+
+        __m256 rx = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m0, x), _mm256_mul_ps(m4, y)), _mm256_mul_ps(m8, z)), m12);
+        __m256 ry = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m1, x), _mm256_mul_ps(m5, y)), _mm256_mul_ps(m9, z)), m13);
+        __m256 rz = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m2, x), _mm256_mul_ps(m6, y)), _mm256_mul_ps(m10, z)), m14);
+
+        __m256 oa = _mm256_shuffle_ps(_mm256_shuffle_ps(rx, ry, _MM_SHUFFLE(0, 0, 0, 0)), _mm256_shuffle_ps(rz, rx, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 ob = _mm256_shuffle_ps(_mm256_shuffle_ps(ry, rz, _MM_SHUFFLE(1, 1, 1, 1)), _mm256_shuffle_ps(rx, ry, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 oc = _mm256_shuffle_ps(_mm256_shuffle_ps(rz, rx, _MM_SHUFFLE(3, 3, 2, 2)), _mm256_shuffle_ps(ry, rz, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+
+        float *out = &result[i].x;
+        _mm_storeu_ps(out + 0, _mm256_castps256_ps128(oa));
+        _mm_storeu_ps(out + 4, _mm256_castps256_ps128(ob));
+        _mm_storeu_ps(out + 8, _mm256_castps256_ps128(oc));
+        _mm_storeu_ps(out + 12, _mm256_extractf128_ps(oa, 1));
+        _mm_storeu_ps(out + 16, _mm256_extractf128_ps(ob, 1));
+        _mm_storeu_ps(out + 20, _mm256_extractf128_ps(oc, 1));
+    }
+
+    for (; i < count; i++) result[i] = RMS_Vector3Transform(points[i], mat);
+}
+
+// MatrixMultiplyArray() two result rows per register
+RMS_TARGET_AVX static void MatrixMultiplyArrayAVX(Matrix *result, const Matrix *left, int count, Matrix right)
+{
+    // Right row r element k in the low lane, row r + 1 element k in the high lane
+    const float *r = &right.m0;
+    __m256 splat01[4], splat23[4];
+    for (int k = 0; k < 4; k++)
+    {
+        splat01[k] = _mm256_setr_ps(r[k], r[k], r[k], r[k], r[4 + k], r[4 + k], r[4 + k], r[4 + k]);
+        splat23[k] = _mm256_setr_ps(r[8 + k], r[8 + k], r[8 + k], r[8 + k], r[12 + k], r[12 + k], r[12 + k], r[12 + k]);
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        const float *l = &left[i].m0;
+        __m256 l0 = _mm256_broadcast_ps((const __m128 *)(l + 0));
+        __m256 l1 = _mm256_broadcast_ps((const __m128 *)(l + 4));
+        __m256 l2 = _mm256_broadcast_ps((const __m128 *)(l + 8));
+        __m256 l3 = _mm256_broadcast_ps((const __m128 *)(l + 12));
+
+        __m256 rows01 = _mm256_mul_ps(l0, splat01[0]);
+        rows01 = _mm256_add_ps(rows01, _mm256_mul_ps(l1, splat01[1]));
+        rows01 = _mm256_add_ps(rows01, _mm256_mul_ps(l2, splat01[2]));
+        rows01 = _mm256_add_ps(rows01, _mm256_mul_ps(l3, splat01[3]));
+
+        __m256 rows23 = _mm256_mul_ps(l0, splat23[0]);
+        rows23 = _mm256_add_ps(rows23, _mm256_mul_ps(l1, splat23[1]));
+        rows23 = _mm256_add_ps(rows23, _mm256_mul_ps(l2, splat23[2]));
+        rows23 = _mm256_add_ps(rows23, _mm256_mul_ps(l3, splat23[3]));
+
+        _mm256_storeu_ps(&result[i].m0, rows01);
+        _mm256_storeu_ps(&result[i].m0 + 8, rows23);
+    }
+}
+#endif
+
+//----------------------------------------------------------------------------------
+// Tests and benchmark
+//----------------------------------------------------------------------------------
+
+// Random float in [min, max]
+static float GetMathSimdRandom(float min, float max)
+{
+    return min + (max - min)*(float)rand()/(float)RAND_MAX;
+}
+
+// Random translation, rotation and scale matrix, well conditioned for inversion
+static Matrix GetMathSimdRandomMatrix(void)
+{
+    Vector3 axis = Vector3Normalize((Vector3){ GetMathSimdRandom(-1, 1), GetMathSimdRandom(-1, 1), GetMathSimdRandom(0.1f, 1) });
+    Matrix scale = MatrixScale(GetMathSimdRandom(0.25f, 4), GetMathSimdRandom(0.25f, 4), GetMathSimdRandom(0.25f, 4));
+    Matrix rotation = MatrixRotate(axis, GetMathSimdRandom(-PI, PI));
+    Matrix translation = MatrixTranslate(GetMathSimdRandom(-100, 100), GetMathSimdRandom(-100, 100), GetMathSimdRandom(-100, 100));
+
+    return RMS_MatrixMultiply(RMS_MatrixMultiply(scale, rotation), translation);
+}
+
+// Distance in units in the last place, 0 when equal (+0 and -0 too)
+static int GetFloatUlps(float a, float b)
+{
+    if (a == b) return 0;
+
+    int ia, ib;
+    memcpy(&ia, &a, sizeof(int));
+    memcpy(&ib, &b, sizeof(int));
+    long long oa = (ia < 0)? (long long)(int)0x80000000 - ia : ia;     // Ordered as integers
+    long long ob = (ib < 0)? (long long)(int)0x80000000 - ib : ib;
+    long long d = (oa > ob)? oa - ob : ob - oa;
+
+    return (d > 0x7fffffff)? 0x7fffffff : (int)d;
+}
+
+static int GetMatrixUlps(Matrix a, Matrix b)
+{
+    int ulps = 0;
+    for (int k = 0; k < 16; k++)
+    {
+        int d = GetFloatUlps((&a.m0)[k], (&b.m0)[k]);
+        if (d > ulps) ulps = d;
+    }
+    return ulps;
+}
+
+// Log one kernel check, returns 1 on failure
+static int LogMathSimdCheck(const char *kernel, const char *backend, int ulps, int tolerance)
+{
+    bool failed = (ulps > tolerance);
+    TraceLog(failed? LOG_WARNING : LOG_INFO, "CHECK: [raymath] %-22s %-6s max %i ulps (tolerance %i)%s", kernel, backend, ulps, tolerance, failed? " FAILED" : "");
+    return failed? 1 : 0;
+}
+
+// Compare all kernels and backends against raymath.h, returns failures
+int CheckMathSIMD(int count)
+{
+    int previous = GetMathSimdBackend();
+    int failures = 0;
+
+    Matrix *matrices = (Matrix *)malloc(count*sizeof(Matrix));
+    Matrix *products = (Matrix *)malloc(count*sizeof(Matrix));
+    Quaternion *rotations = (Quaternion *)malloc(count*sizeof(Quaternion));
+    Vector3 *points = (Vector3 *)malloc(count*sizeof(Vector3));
+    Vector3 *transformed = (Vector3 *)malloc(count*sizeof(Vector3));
+
+    srand(1);
+    for (int i = 0; i < count; i++)
+    {
+        matrices[i] = GetMathSimdRandomMatrix();
+        rotations[i] = QuaternionNormalize((Quaternion){ GetMathSimdRandom(-1, 1), GetMathSimdRandom(-1, 1), GetMathSimdRandom(-1, 1), GetMathSimdRandom(-1, 1) });
+        points[i] = (Vector3){ GetMathSimdRandom(-100, 100), GetMathSimdRandom(-100, 100), GetMathSimdRandom(-100, 100) };
+    }
+    Matrix transform = GetMathSimdRandomMatrix();
+
+    const int backends[] = { MATH_SIMD_SSE2, MATH_SIMD_NEON, MATH_SIMD_AVX };
+    for (int b = 0; b < 3; b++)
+    {
+        if (!SetMathSimdBackend(backends[b])) continue;
+        const char *name = GetMathSimdBackendName(backends[b]);
+
+        // Single value kernels only have a 4-wide version
+        if (backends[b] != MATH_SIMD_AVX)
+        {
+            int multiplyUlps = 0, transposeUlps = 0, quaternionUlps = 0, transformUlps = 0;
+            float invertError = 0.0f;
+
+            for (int i = 0; i < count; i++)
+            {
+                Matrix next = matrices[(i + 1)%count];
+                int d = GetMatrixUlps(MatrixMultiplySIMD(matrices[i], next), RMS_MatrixMultiply(matrices[i], next));
+                if (d > multiplyUlps) multiplyUlps = d;
+
+                d = GetMatrixUlps(MatrixTransposeSIMD(matrices[i]), RMS_MatrixTranspose(matrices[i]));
+                if (d > transposeUlps) transposeUlps = d;
+
+                d = GetMatrixUlps(QuaternionToMatrixSIMD(rotations[i]), RMS_QuaternionToMatrix(rotations[i]));
+                if (d > quaternionUlps) quaternionUlps = d;
+
+                Vector3 simd = Vector3TransformSIMD(points[i], matrices[i]);
+                Vector3 scalar = RMS_Vector3Transform(points[i], matrices[i]);
+                d = GetFloatUlps(simd.x, scalar.x);
+                if (d > transformUlps) transformUlps = d;
+                d = GetFloatUlps(simd.y, scalar.y);
+                if (d > transformUlps) transformUlps = d;
+                d = GetFloatUlps(simd.z, scalar.z);
+                if (d > transformUlps) transformUlps = d;
+
+                // Inverse error relative to the largest element, ulps blow up on elements near 0
+                Matrix inverse = MatrixInvertSIMD(matrices[i]);
+                Matrix reference = RMS_MatrixInvert(matrices[i]);
+                float largest = 0.0f, error = 0.0f;
+                for (int k = 0; k < 16; k++)
+                {
+                    if (fabsf((&reference.m0)[k]) > largest) largest = fabsf((&reference.m0)[k]);
+                    if (fabsf((&inverse.m0)[k] - (&reference.m0)[k]) > error) error = fabsf((&inverse.m0)[k] - (&reference.m0)[k]);
+                }
+                if (error/largest > invertError) invertError = error/largest;
+            }
+
+            failures += LogMathSimdCheck("MatrixMultiplySIMD", name, multiplyUlps, RMS_TOLERANCE_ULPS);
+            failures += LogMathSimdCheck("MatrixTransposeSIMD", name, transposeUlps, 0);
+            failures += LogMathSimdCheck("QuaternionToMatrixSIMD", name, quaternionUlps, RMS_TOLERANCE_ULPS);
+            failures += LogMathSimdCheck("Vector3TransformSIMD", name, transformUlps, RMS_TOLERANCE_ULPS);
+
+            bool failed = !(invertError <= RMS_TOLERANCE_INVERT);
+            TraceLog(failed? LOG_WARNING : LOG_INFO, "CHECK: [raymath] %-22s %-6s max %g relative error (tolerance %g)%s",
+                     "MatrixInvertSIMD", name, invertError, RMS_TOLERANCE_INVERT, failed? " FAILED" : "");
+            if (failed) failures++;
+        }
+
+        // Array kernels, odd count to run the tail loops, in place like callers do
+        int arrayCount = count - 1;
+        int transformUlps = 0, multiplyUlps = 0;
+
+        memcpy(transformed, points, arrayCount*sizeof(Vector3));
+        Vector3TransformArray(transformed, transformed, arrayCount, transform);
+        for (int i = 0; i < arrayCount; i++)
+        {
+            Vector3 scalar = RMS_Vector3Transform(points[i], transform);
+            int d = GetFloatUlps(transformed[i].x, scalar.x);
+            if (d > transformUlps) transformUlps = d;
+            d = GetFloatUlps(transformed[i].y, scalar.y);
+            if (d > transformUlps) transformUlps = d;
+            d = GetFloatUlps(transformed[i].z, scalar.z);
+            if (d > transformUlps) transformUlps = d;
+        }
+
+        memcpy(products, matrices, arrayCount*sizeof(Matrix));
+        MatrixMultiplyArray(products, products, arrayCount, transform);
+        for (int i = 0; i < arrayCount; i++)
+        {
+            int d = GetMatrixUlps(products[i], RMS_MatrixMultiply(matrices[i], transform));
+            if (d > multiplyUlps) multiplyUlps = d;
+        }
+
+        failures += LogMathSimdCheck("Vector3TransformArray", name, transformUlps, RMS_TOLERANCE_ULPS);
+        failures += LogMathSimdCheck("MatrixMultiplyArray", name, multiplyUlps, RMS_TOLERANCE_ULPS);
+    }
+
+    SetMathSimdBackend(previous);
+
+    free(matrices);
+    free(products);
+    free(rotations);
+    free(points);
+    free(transformed);
+
+    return failures;
+}
+
+// Time raymath.h against SIMD kernels and log results
+// NOTE: Results are summed into a sink so loops are not optimized out
+void BenchmarkMathSIMD(int count, int iterations)
+{
+    int previous = GetMathSimdBackend();
+    int best = previous;
+    SetMathSimdBackend(RMS_DEFAULT_BACKEND);
+
+    Matrix *matrices = (Matrix *)malloc(count*sizeof(Matrix));
+    Matrix *products = (Matrix *)malloc(count*sizeof(Matrix));
+    Quaternion *rotations = (Quaternion *)malloc(count*sizeof(Quaternion));
+    Vector3 *points = (Vector3 *)malloc(count*sizeof(Vector3));
+    Vector3 *transformed = (Vector3 *)malloc(count*sizeof(Vector3));
+
+    srand(1);
+    for (int i = 0; i < count; i++)
+    {
+        matrices[i] = GetMathSimdRandomMatrix();
+        rotations[i] = QuaternionNormalize((Quaternion){ GetMathSimdRandom(-1, 1), GetMathSimdRandom(-1, 1), GetMathSimdRandom(-1, 1), GetMathSimdRandom(-1, 1) });
+        points[i] = (Vector3){ GetMathSimdRandom(-100, 100), GetMathSimdRandom(-100, 100), GetMathSimdRandom(-100, 100) };
+    }
+    Matrix transform = GetMathSimdRandomMatrix();
+
+    double calls = (double)count*iterations;
+    float sink = 0.0f;
+
+    TraceLog(LOG_INFO, "BENCH: [raymath] %i values, %i iterations, 4-wide backend %s, best backend %s", count, iterations,
+             GetMathSimdBackendName(RMS_DEFAULT_BACKEND), GetMathSimdBackendName(best));
+
+    // Single value kernels: raymath.h against SIMD, same loop around both
+    #define RMS_BENCH_KERNEL(label, scalarCall, simdCall, sinkValue) \
+    { \
+        double start = GetTime(); \
+        for (int n = 0; n < iterations; n++) for (int i = 0; i < count; i++) { scalarCall; sink += sinkValue; } \
+        double scalarTime = GetTime() - start; \
+        start = GetTime(); \
+        for (int n = 0; n < iterations; n++) for (int i = 0; i < count; i++) { simdCall; sink += sinkValue; } \
+        double simdTime = GetTime() - start; \
+        TraceLog(LOG_INFO, "BENCH: [raymath] %-22s scalar %6.2f ns, SIMD %6.2f ns (%.2fx)", label, \
+                 scalarTime*1e9/calls, simdTime*1e9/calls, scalarTime/simdTime); \
+    }
+
+    RMS_BENCH_KERNEL("MatrixMultiply", products[i] = RMS_MatrixMultiply(matrices[i], transform), products[i] = MatrixMultiplySIMD(matrices[i], transform), products[i].m15)
+    RMS_BENCH_KERNEL("MatrixInvert", products[i] = RMS_MatrixInvert(matrices[i]), products[i] = MatrixInvertSIMD(matrices[i]), products[i].m15)
+    RMS_BENCH_KERNEL("MatrixTranspose", products[i] = RMS_MatrixTranspose(matrices[i]), products[i] = MatrixTransposeSIMD(matrices[i]), products[i].m3)
+    RMS_BENCH_KERNEL("QuaternionToMatrix", products[i] = RMS_QuaternionToMatrix(rotations[i]), products[i] = QuaternionToMatrixSIMD(rotations[i]), products[i].m10)
+    RMS_BENCH_KERNEL("Vector3Transform", transformed[i] = RMS_Vector3Transform(points[i], transform), transformed[i] = Vector3TransformSIMD(points[i], transform), transformed[i].z)
+
+    #undef RMS_BENCH_KERNEL
+
+    // Array kernels per backend against a raymath.h loop
+    const int backends[] = { MATH_SIMD_SCALAR, MATH_SIMD_SSE2, MATH_SIMD_NEON, MATH_SIMD_AVX };
+    double transformBase = 0.0, multiplyBase = 0.0;
+
+    for (int b = 0; b < 4; b++)
+    {
+        if (!SetMathSimdBackend(backends[b])) continue;
+
+        double start = GetTime();
+        for (int n = 0; n < iterations; n++)
+        {
+            Vector3TransformArray(transformed, points, count, transform);
+            sink += transformed[n%count].x;
+        }
+        double transformTime = GetTime() - start;
+
+        start = GetTime();
+        for (int n = 0; n < iterations; n++)
+        {
+            MatrixMultiplyArray(products, matrices, count, transform);
+            sink += products[n%count].m0;
+        }
+        double multiplyTime = GetTime() - start;
+
+        if (backends[b] == MATH_SIMD_SCALAR)
+        {
+            transformBase = transformTime;
+            multiplyBase = multiplyTime;
+        }
+
+        TraceLog(LOG_INFO, "BENCH: [raymath] %-22s %-6s %6.2f ns/point  (%.2fx)", "Vector3TransformArray", GetMathSimdBackendName(backends[b]),
+                 transformTime*1e9/calls, transformBase/transformTime);
+        TraceLog(LOG_INFO, "BENCH: [raymath] %-22s %-6s %6.2f ns/matrix (%.2fx)", "MatrixMultiplyArray", GetMathSimdBackendName(backends[b]),
+                 multiplyTime*1e9/calls, multiplyBase/multiplyTime);
+    }
+
+    SetMathSimdBackend(previous);
+    TraceLog(LOG_DEBUG, "BENCH: [raymath] sink %f", sink);
+
+    free(matrices);
+    free(products);
+    free(rotations);
+    free(points);
+    free(transformed);
+}
+
+#endif // RMATHSIMD_IMPLEMENTATION
@@ -0,0 +1,764 @@
+/**********************************************************************************************
+*
+*   raylib.profile - Frame profiler with CPU scopes, draw counters and Chrome trace export
+*
+*   DESCRIPTION:
+*       Named scopes are recorded per frame with BeginProfileScope()/EndProfileScope() and
+*       aggregated at EndProfileFrame() into per-scope averages and maximums. While disabled,
+*       every call returns after testing a single flag, so instrumentation can stay in hot paths.
+*
+*       Counters (draw calls, vertices, texture binds, uniform uploads) are added by the callers
+*       that know them and reset each frame. ProfileDrawMesh(), ProfileDrawMeshInstanced(),
+*       ProfileDrawRenderBatch() and ProfileEndDrawing() wrap the raylib calls with a scope and
+*       their counters.
+*
+*       GPU scopes (BeginProfileGpuScope()/EndProfileGpuScope()) are CPU scopes that also time the
+*       GPU work in between with GL_TIME_ELAPSED queries. Queries go in a ring of frames and are
+*       read PROFILE_GPU_FRAMES later, only when their result is available, so reading never
+*       stalls the pipeline. GPU scopes can't nest (one elapsed query at a time), an inner one is
+*       timed on the CPU only. Without timer queries (OpenGL 1.1, ES 2.0/3.0) they are CPU scopes.
+*
+*       DrawProfileOverlay() shows the last frames on screen, StartProfileCapture() records the
+*       next frames and ExportProfileTrace() writes them in Chrome trace event format (JSON),
+*       to open in chrome://tracing or https://ui.perfetto.dev
+*
+*   CONFIGURATION:
+*
+*   #define RPROFILE_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+*   NOTE: rlgl is not part of this tree, so batches flushed internally by rlgl (texture or mode
+*   changes, full buffers) are not counted, only the ProfileDrawRenderBatch() calls are
+*
+**********************************************************************************************/
+
+#ifndef RPROFILE_H
+#define RPROFILE_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define PROFILE_MAX_SCOPES          64      // Distinct scope names
+#define PROFILE_MAX_DEPTH           32      // Nested scopes
+#define PROFILE_MAX_EVENTS        4096      // Scope events per frame
+#define PROFILE_GPU_FRAMES           4      // Frames in flight before GPU queries are read
+#define PROFILE_GPU_MAX_QUERIES     32      // GPU scopes per frame
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Frame counters
+typedef enum {
+    PROFILE_DRAW_CALLS = 0,
+    PROFILE_VERTICES,
+    PROFILE_TEXTURE_BINDS,
+    PROFILE_UNIFORM_UPLOADS,
+    PROFILE_COUNTER_COUNT
+} ProfileCounter;
+
+// Scope statistics, times in seconds
+typedef struct {
+    const char *name;
+    int depth;                  // Nesting level where the scope was first seen
+    int calls;                  // Calls last frame
+    double time;                // Total time last frame
+    double average;             // Smoothed time per frame
+    double max;                 // Max time per frame since capture or enable
+    bool gpu;                   // Scope has GPU timings
+    double gpuTime;             // GPU time of the last resolved frame
+    double gpuAverage;          // Smoothed GPU time per frame
+} ProfileScopeStats;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+void SetProfilerEnabled(bool enabled);                                  // Enable profiler, scopes and counters are ignored while disabled
+bool IsProfilerEnabled(void);                                           // Check profiler enabled
+void CloseProfiler(void);                                               // Free capture memory and GPU queries (before CloseWindow())
+void BeginProfileScope(const char *name);                               // Begin named scope (name must outlive the frame, a literal)
+void EndProfileScope(void);                                             // End last scope
+void BeginProfileGpuScope(const char *name);                            // Begin named scope timed on CPU and GPU (flushes rlgl batch)
+void EndProfileGpuScope(void);                                          // End GPU scope (flushes rlgl batch)
+bool IsProfileGpuTimingSupported(void);                                 // Check GPU timer queries available (needs GL context)
+void AddProfileCounter(int counter, int amount);                        // Add to frame counter (ProfileCounter)
+void AddProfileDraw(Material material, int drawCalls, int vertices);    // Add counters for draws with material (for callers issuing their own draws)
+void EndProfileFrame(void);                                             // Aggregate frame scopes and counters, start next frame
+double GetProfileFrameTime(void);                                       // Get last frame time in seconds, frame to frame
+int GetProfileCounter(int counter);                                     // Get counter value for last frame
+const ProfileScopeStats *GetProfileScopes(int *count);                  // Get scope statistics, in first seen order
+void DrawProfileOverlay(int posX, int posY);                            // Draw scope timings and counters
+
+void StartProfileCapture(int frames);                                   // Record next frames for ExportProfileTrace()
+bool IsProfileCaptureDone(void);                                        // Check capture recorded all its frames
+bool ExportProfileTrace(const char *fileName);                          // Export capture as Chrome trace JSON
+
+void ProfileDrawRenderBatch(void);                                      // rlDrawRenderBatchActive() in a scope
+void ProfileDrawMesh(Mesh mesh, Material material, Matrix transform);   // DrawMesh() in a scope, with counters
+void ProfileDrawMeshInstanced(Mesh mesh, Material material, const Matrix *transforms, int instances);   // DrawMeshInstanced() in a scope, with counters
+void ProfileEndDrawing(void);                                           // EndDrawing() in a scope, then EndProfileFrame()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RPROFILE_H
+
+
+/***********************************************************************************
+*
+*   RPROFILE IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RPROFILE_IMPLEMENTATION) && !defined(RPROFILE_IMPLEMENTATION_DEFINED)
+#define RPROFILE_IMPLEMENTATION_DEFINED
+
+#include "rlgl.h"               // Required for: rlDrawRenderBatchActive()
+#include "rtextfmt.h"           // Required for: TextFormatLocal()
+
+#include <chrono>               // Required for: std::chrono::steady_clock
+#include <stdio.h>              // Required for: FILE, fopen(), fprintf(), fclose()
+#include <stdlib.h>             // Required for: realloc(), free()
+#include <string.h>             // Required for: strcmp()
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define PROFILE_SMOOTHING       0.05        // Weight of the last frame in averages
+
+#if defined(_WIN32) && !defined(_WIN64)
+    #define RPROFILE_APIENTRY __stdcall
+#else
+    #define RPROFILE_APIENTRY
+#endif
+
+#define RPROFILE_GL_TIME_ELAPSED            0x88BF
+#define RPROFILE_GL_QUERY_RESULT            0x8866
+#define RPROFILE_GL_QUERY_RESULT_AVAILABLE  0x8867
+
+#ifndef MAX_MATERIAL_MAPS
+    #define MAX_MATERIAL_MAPS      12       // Maximum number of maps supported, same as raylib config.h
+#endif
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Scope instance, times in seconds since profiler epoch
+typedef struct {
+    const char *name;
+    double start;
+    double duration;
+    int depth;
+    bool gpu;                   // GPU time, start is the CPU submission time
+} ProfileEvent;
+
+// Timer query slot in the GPU ring
+typedef struct {
+    const char *name;
+    double cpuStart;            // Submission time, places the result in traces
+    bool pending;
+} ProfileGpuQuery;
+
+// Captured frame
+typedef struct {
+    double start;
+    double duration;
+    int firstEvent;             // Range in capture events
+    int eventCount;
+    int counters[PROFILE_COUNTER_COUNT];
+} ProfileFrame;
+
+// Profiler state
+typedef struct {
+    bool enabled;
+    double epoch;
+    double frameStart;
+    double frameTime;
+
+    ProfileEvent events[PROFILE_MAX_EVENTS];
+    int eventCount;
+    int stack[PROFILE_MAX_DEPTH];   // Open event indices, -1 when the frame was full
+    int depth;
+
+    ProfileScopeStats scopes[PROFILE_MAX_SCOPES];
+    int scopeCount;
+    int counters[PROFILE_COUNTER_COUNT];
+    int lastCounters[PROFILE_COUNTER_COUNT];
+
+    int captureFrames;          // Frames left to record
+    ProfileFrame *frames;
+    int frameCount;
+    int frameCapacity;
+    ProfileEvent *captureEvents;
+    int captureEventCount;
+    int captureEventCapacity;
+
+    unsigned int gpuQueryIds[PROFILE_GPU_FRAMES][PROFILE_GPU_MAX_QUERIES];
+    ProfileGpuQuery gpuQueries[PROFILE_GPU_FRAMES][PROFILE_GPU_MAX_QUERIES];
+    int gpuQueryCounts[PROFILE_GPU_FRAMES];
+    int gpuFrame;               // Ring frame taking new queries
+    int gpuScopeDepth;          // Scope depth of the open query, -1 when none
+    int gpuDropped;             // Results not ready when their slot came back
+} Profiler;
+
+typedef void (*ProfileGLProc)(void);
+
+typedef void (RPROFILE_APIENTRY *ProfileGenQueriesProc)(int n, unsigned int *ids);
+typedef void (RPROFILE_APIENTRY *ProfileDeleteQueriesProc)(int n, const unsigned int *ids);
+typedef void (RPROFILE_APIENTRY *ProfileBeginQueryProc)(unsigned int target, unsigned int id);
+typedef void (RPROFILE_APIENTRY *ProfileEndQueryProc)(unsigned int target);
+typedef void (RPROFILE_APIENTRY *ProfileGetQueryObjectivProc)(unsigned int id, unsigned int pname, int *params);
+typedef void (RPROFILE_APIENTRY *ProfileGetQueryObjectui64vProc)(unsigned int id, unsigned int pname, unsigned long long *params);
+
+#ifdef __cplusplus
+extern "C" ProfileGLProc glfwGetProcAddress(const char *procname);     // Provided by GLFW inside raylib
+#else
+ProfileGLProc glfwGetProcAddress(const char *procname);
+#endif
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static Profiler profiler = { 0 };
+
+static ProfileGenQueriesProc profileGenQueries = NULL;
+static ProfileDeleteQueriesProc profileDeleteQueries = NULL;
+static ProfileBeginQueryProc profileBeginQuery = NULL;
+static ProfileEndQueryProc profileEndQuery = NULL;
+static ProfileGetQueryObjectivProc profileGetQueryObjectiv = NULL;
+static ProfileGetQueryObjectui64vProc profileGetQueryObjectui64v = NULL;
+static int profileGpuState = 0;         // 0: not loaded, 1: ready, -1: not supported
+
+static const char *profileCounterNames[PROFILE_COUNTER_COUNT] = { "drawCalls", "vertices", "textureBinds", "uniformUploads" };
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static double GetProfileTime(void);
+static ProfileScopeStats *GetProfileScopeStats(const char *name, int depth);
+static void CaptureProfileFrame(double frameEnd);
+static bool LoadProfileGpuFunctions(void);
+static void ResolveProfileGpuFrame(int frame);
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Enable profiler, scopes and counters are ignored while disabled
+void SetProfilerEnabled(bool enabled)
+{
+    if (enabled && !profiler.enabled)
+    {
+        if (profiler.epoch == 0.0) profiler.epoch = GetProfileTime();
+        profiler.frameStart = GetProfileTime() - profiler.epoch;
+        profiler.eventCount = 0;
+        profiler.depth = 0;
+        profiler.gpuScopeDepth = -1;
+        for (int i = 0; i < profiler.scopeCount; i++) profiler.scopes[i].max = 0.0;
+        for (int i = 0; i < PROFILE_COUNTER_COUNT; i++) profiler.counters[i] = 0;
+    }
+
+    profiler.enabled = enabled;
+}
+
+// Check profiler enabled
+bool IsProfilerEnabled(void)
+{
+    return profiler.enabled;
+}
+
+// Free capture memory and GPU queries
+void CloseProfiler(void)
+{
+    if ((profileGpuState == 1) && (profiler.gpuQueryIds[0][0] != 0)) profileDeleteQueries(PROFILE_GPU_FRAMES*PROFILE_GPU_MAX_QUERIES, &profiler.gpuQueryIds[0][0]);
+
+    free(profiler.frames);
+    free(profiler.captureEvents);
+    profiler = (Profiler){ 0 };
+    profileGpuState = 0;
+}
+
+// Begin named scope (name must outlive the frame, a literal)
+void BeginProfileScope(const char *name)
+{
+    if (!profiler.enabled) return;
+
+    if (profiler.depth >= PROFILE_MAX_DEPTH)
+    {
+        profiler.depth++;       // Still balanced by EndProfileScope(), nothing recorded
+        return;
+    }
+
+    int index = -1;
+    if (profiler.eventCount < PROFILE_MAX_EVENTS)
+    {
+        index = profiler.eventCount++;
+        profiler.events[index].name = name;
+        profiler.events[index].depth = profiler.depth;
+        profiler.events[index].duration = 0.0;
+        profiler.events[index].gpu = false;
+        profiler.events[index].start = GetProfileTime() - profiler.epoch;
+    }
+
+    profiler.stack[profiler.depth++] = index;
+}
+
+// End last scope
+void EndProfileScope(void)
+{
+    if (!profiler.enabled || (profiler.depth == 0)) return;
+
+    double now = GetProfileTime() - profiler.epoch;
+
+    profiler.depth--;
+    if (profiler.depth >= PROFILE_MAX_DEPTH) return;
+
+    int index = profiler.stack[profiler.depth];
+    if (index >= 0) profiler.events[index].duration = now - profiler.events[index].start;
+}
+
+// Begin named scope timed on CPU and GPU (flushes rlgl batch)
+void BeginProfileGpuScope(const char *name)
+{
+    if (!profiler.enabled) return;
+
+    int frame = profiler.gpuFrame;
+    bool timed = (profiler.gpuScopeDepth < 0) && (profiler.gpuQueryCounts[frame] < PROFILE_GPU_MAX_QUERIES) && LoadProfileGpuFunctions();
+
+    // Vertices batched before the scope are not part of it
+    if (timed) rlDrawRenderBatchActive();
+
+    BeginProfileScope(name);
+
+    if (timed)
+    {
+        int index = profiler.gpuQueryCounts[frame]++;
+        ProfileGpuQuery *query = &profiler.gpuQueries[frame][index];
+
+        query->name = name;
+        query->cpuStart = GetProfileTime() - profiler.epoch;
+        query->pending = true;
+        profiler.gpuScopeDepth = profiler.depth - 1;
+        profileBeginQuery(RPROFILE_GL_TIME_ELAPSED, profiler.gpuQueryIds[frame][index]);
+    }
+}
+
+// End GPU scope (flushes rlgl batch)
+void EndProfileGpuScope(void)
+{
+    if (!profiler.enabled) return;
+
+    if ((profiler.gpuScopeDepth >= 0) && (profiler.depth - 1 == profiler.gpuScopeDepth))
+    {
+        rlDrawRenderBatchActive();
+        profileEndQuery(RPROFILE_GL_TIME_ELAPSED);
+        profiler.gpuScopeDepth = -1;
+    }
+
+    EndProfileScope();
+}
+
+// Check GPU timer queries available (needs GL context)
+bool IsProfileGpuTimingSupported(void)
+{
+    return LoadProfileGpuFunctions();
+}
+
+// Add to frame counter (ProfileCounter)
+void AddProfileCounter(int counter, int amount)
+{
+    if (!profiler.enabled || (counter < 0) || (counter >= PROFILE_COUNTER_COUNT)) return;
+
+    profiler.counters[counter] += amount;
+}
+
+// Add counters for draws with material: one bind per used map, matrices and colors per draw call
+// NOTE: Same uniforms DrawMesh() sets, locations not found in the shader are not uploaded
+void AddProfileDraw(Material material, int drawCalls, int vertices)
+{
+    if (!profiler.enabled) return;
+
+    int binds = 0;
+    for (int i = 0; i < MAX_MATERIAL_MAPS; i++)
+    {
+        if ((material.maps != NULL) && (material.maps[i].texture.id > 0)) binds++;
+    }
+
+    int uniforms = 0;
+    if (material.shader.locs != NULL)
+    {
+        static const int locs[] = { SHADER_LOC_MATRIX_MVP, SHADER_LOC_MATRIX_MODEL, SHADER_LOC_MATRIX_VIEW, SHADER_LOC_MATRIX_PROJECTION,
+                                    SHADER_LOC_MATRIX_NORMAL, SHADER_LOC_COLOR_DIFFUSE, SHADER_LOC_COLOR_SPECULAR };
+        for (int i = 0; i < (int)(sizeof(locs)/sizeof(locs[0])); i++) uniforms += (material.shader.locs[locs[i]] != -1);
+    }
+
+    profiler.counters[PROFILE_DRAW_CALLS] += drawCalls;
+    profiler.counters[PROFILE_VERTICES] += vertices;
+    profiler.counters[PROFILE_TEXTURE_BINDS] += binds*drawCalls;
+    profiler.counters[PROFILE_UNIFORM_UPLOADS] += uniforms*drawCalls;
+}
+
+// Aggregate frame scopes and counters, start next frame
+void EndProfileFrame(void)
+{
+    if (!profiler.enabled) return;
+
+    double now = GetProfileTime() - profiler.epoch;
+
+    // Scopes still open are dropped: they count with no time and the stack restarts empty
+    // NOTE: Their late EndProfileScope() calls close scopes of the next frame
+    if (profiler.depth > 0)
+    {
+        TraceLog(LOG_WARNING, "PROFILE: %i scopes still open at frame end", profiler.depth);
+        if (profiler.gpuScopeDepth >= 0) profileEndQuery(RPROFILE_GL_TIME_ELAPSED);
+        profiler.gpuScopeDepth = -1;
+        profiler.depth = 0;
+    }
+
+    for (int i = 0; i < profiler.scopeCount; i++)
+    {
+        profiler.scopes[i].time = 0.0;
+        profiler.scopes[i].calls = 0;
+    }
+
+    for (int i = 0; i < profiler.eventCount; i++)
+    {
+        if (profiler.events[i].gpu) continue;
+
+        ProfileScopeStats *scope = GetProfileScopeStats(profiler.events[i].name, profiler.events[i].depth);
+        if (scope == NULL) continue;
+
+        scope->time += profiler.events[i].duration;
+        scope->calls++;
+    }
+
+    for (int i = 0; i < profiler.scopeCount; i++)
+    {
+        ProfileScopeStats *scope = &profiler.scopes[i];
+        scope->average += (scope->time - scope->average)*PROFILE_SMOOTHING;
+        if (scope->time > scope->max) scope->max = scope->time;
+    }
+
+    // Oldest ring frame is read before its queries are reused next frame
+    if (profileGpuState == 1)
+    {
+        profiler.gpuFrame = (profiler.gpuFrame + 1)%PROFILE_GPU_FRAMES;
+        ResolveProfileGpuFrame(profiler.gpuFrame);
+    }
+
+    if (profiler.captureFrames > 0) CaptureProfileFrame(now);
+
+    profiler.frameTime = now - profiler.frameStart;
+    profiler.frameStart = now;
+    profiler.eventCount = 0;
+    for (int i = 0; i < PROFILE_COUNTER_COUNT; i++)
+    {
+        profiler.lastCounters[i] = profiler.counters[i];
+        profiler.counters[i] = 0;
+    }
+}
+
+// Get last frame time in seconds, frame to frame
+double GetProfileFrameTime(void)
+{
+    return profiler.frameTime;
+}
+
+// Get counter value for last frame
+int GetProfileCounter(int counter)
+{
+    if ((counter < 0) || (counter >= PROFILE_COUNTER_COUNT)) return 0;
+
+    return profiler.lastCounters[counter];
+}
+
+// Get scope statistics, in first seen order
+const ProfileScopeStats *GetProfileScopes(int *count)
+{
+    if (count != NULL) *count = profiler.scopeCount;
+
+    return profiler.scopes;
+}
+
+// Draw scope timings and counters
+void DrawProfileOverlay(int posX, int posY)
+{
+    if (!profiler.enabled) return;
+
+    const int width = 440;
+    const int lineHeight = 14;
+    int height = (profiler.scopeCount + 4)*lineHeight + 8;
+    double frameTime = (profiler.frameTime > 0.0)? profiler.frameTime : 1.0/60.0;
+
+    DrawRectangle(posX, posY, width, height, Fade(BLACK, 0.7f));
+
+    int y = posY + 4;
+    DrawText(TextFormatLocal("CPU frame %.2f ms", profiler.frameTime*1000.0), posX + 4, y, 10, RAYWHITE);
+    DrawText("avg ms   max ms   gpu ms  calls", posX + width - 190, y, 10, GRAY);
+    y += lineHeight;
+
+    for (int i = 0; i < profiler.scopeCount; i++)
+    {
+        const ProfileScopeStats *scope = &profiler.scopes[i];
+        int barWidth = (int)(scope->average/frameTime*(width - 8));
+        if (barWidth > width - 8) barWidth = width - 8;
+
+        DrawRectangle(posX + 4, y, barWidth, lineHeight - 2, Fade(SKYBLUE, 0.35f));
+        DrawText(scope->name, posX + 4 + 10*scope->depth, y + 1, 10, RAYWHITE);
+        DrawText(TextFormatLocal("%6.2f   %6.2f   %6s  %5i", scope->average*1000.0, scope->max*1000.0,
+                            scope->gpu? TextFormatLocal("%.2f", scope->gpuAverage*1000.0) : "-", scope->calls), posX + width - 190, y + 1, 10, RAYWHITE);
+        y += lineHeight;
+    }
+
+    y += lineHeight/2;
+    DrawText(TextFormatLocal("Draw calls: %i, vertices: %i", profiler.lastCounters[PROFILE_DRAW_CALLS], profiler.lastCounters[PROFILE_VERTICES]), posX + 4, y, 10, YELLOW);
+    y += lineHeight;
+    DrawText(TextFormatLocal("Texture binds: %i, uniform uploads: %i", profiler.lastCounters[PROFILE_TEXTURE_BINDS], profiler.lastCounters[PROFILE_UNIFORM_UPLOADS]), posX + 4, y, 10, YELLOW);
+    y += lineHeight;
+    if (profiler.captureFrames > 0) DrawText(TextFormatLocal("Capturing: %i frames left", profiler.captureFrames), posX + 4, y, 10, RED);
+}
+
+// Record next frames for ExportProfileTrace()
+void StartProfileCapture(int frames)
+{
+    profiler.frameCount = 0;
+    profiler.captureEventCount = 0;
+    profiler.captureFrames = frames;
+    for (int i = 0; i < profiler.scopeCount; i++) profiler.scopes[i].max = 0.0;
+
+    if (!profiler.enabled) SetProfilerEnabled(true);
+}
+
+// Check capture recorded all its frames
+bool IsProfileCaptureDone(void)
+{
+    return (profiler.captureFrames == 0) && (profiler.frameCount > 0);
+}
+
+// Export capture as Chrome trace JSON
+// NOTE: Complete events ("X") per scope, one counter event ("C") per frame, times in microseconds,
+// GPU scopes go on their own "gpu" track at their CPU submission time, in the frame they were read
+bool ExportProfileTrace(const char *fileName)
+{
+    FILE *file = fopen(fileName, "wt");
+    if (file == NULL)
+    {
+        TraceLog(LOG_WARNING, "PROFILE: [%s] Failed to open file for writing", fileName);
+        return false;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"raylib\"}}");
+    fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"main\"}}");
+    fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"gpu\"}}");
+
+    for (int f = 0; f < profiler.frameCount; f++)
+    {
+        const ProfileFrame *frame = &profiler.frames[f];
+
+        fprintf(file, ",\n{\"name\":\"Frame %i\",\"cat\":\"frame\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}",
+                f, frame->start*1e6, frame->duration*1e6);
+
+        for (int i = frame->firstEvent; i < frame->firstEvent + frame->eventCount; i++)
+        {
+            const ProfileEvent *event = &profiler.captureEvents[i];
+            fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%i}",
+                    event->name, event->gpu? "gpu" : "cpu", event->start*1e6, event->duration*1e6, event->gpu? 2 : 1);
+        }
+
+        fprintf(file, ",\n{\"name\":\"counters\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"args\":{", frame->start*1e6);
+        for (int c = 0; c < PROFILE_COUNTER_COUNT; c++) fprintf(file, "%s\"%s\":%i", (c > 0)? "," : "", profileCounterNames[c], frame->counters[c]);
+        fprintf(file, "}}");
+    }
+
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    TraceLog(LOG_INFO, "PROFILE: [%s] Trace exported: %i frames, %i scopes", fileName, profiler.frameCount, profiler.captureEventCount);
+    return true;
+}
+
+// rlDrawRenderBatchActive() in a scope
+void ProfileDrawRenderBatch(void)
+{
+    BeginProfileScope("rlDrawRenderBatch");
+    rlDrawRenderBatchActive();
+    AddProfileCounter(PROFILE_DRAW_CALLS, 1);
+    EndProfileScope();
+}
+
+// DrawMesh() in a scope, with counters
+void ProfileDrawMesh(Mesh mesh, Material material, Matrix transform)
+{
+    BeginProfileScope("DrawMesh");
+    DrawMesh(mesh, material, transform);
+    AddProfileDraw(material, 1, (mesh.indices != NULL)? mesh.triangleCount*3 : mesh.vertexCount);
+    EndProfileScope();
+}
+
+// DrawMeshInstanced() in a scope, with counters
+void ProfileDrawMeshInstanced(Mesh mesh, Material material, const Matrix *transforms, int instances)
+{
+    BeginProfileScope("DrawMeshInstanced");
+    DrawMeshInstanced(mesh, material, transforms, instances);
+    AddProfileDraw(material, 1, ((mesh.indices != NULL)? mesh.triangleCount*3 : mesh.vertexCount)*instances);
+    EndProfileScope();
+}
+
+// EndDrawing() in a scope, then EndProfileFrame()
+// NOTE: Includes buffer swap and SetTargetFPS() wait
+void ProfileEndDrawing(void)
+{
+    BeginProfileScope("EndDrawing");
+    EndDrawing();
+    EndProfileScope();
+
+    EndProfileFrame();
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Monotonic time in seconds, works without a window
+static double GetProfileTime(void)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Find or add scope statistics by name, NULL when PROFILE_MAX_SCOPES is reached
+static ProfileScopeStats *GetProfileScopeStats(const char *name, int depth)
+{
+    for (int i = 0; i < profiler.scopeCount; i++)
+    {
+        // Literals usually share the pointer, compare text only when it differs
+        if ((profiler.scopes[i].name == name) || (strcmp(profiler.scopes[i].name, name) == 0)) return &profiler.scopes[i];
+    }
+
+    if (profiler.scopeCount >= PROFILE_MAX_SCOPES) return NULL;
+
+    ProfileScopeStats *scope = &profiler.scopes[profiler.scopeCount++];
+    *scope = (ProfileScopeStats){ 0 };
+    scope->name = name;
+    scope->depth = depth;
+
+    return scope;
+}
+
+// Copy frame events and counters to the capture
+static void CaptureProfileFrame(double frameEnd)
+{
+    if (profiler.frameCount >= profiler.frameCapacity)
+    {
+        profiler.frameCapacity = (profiler.frameCapacity == 0)? 256 : 2*profiler.frameCapacity;
+        profiler.frames = (ProfileFrame *)realloc(profiler.frames, profiler.frameCapacity*sizeof(ProfileFrame));
+    }
+    if (profiler.captureEventCount + profiler.eventCount > profiler.captureEventCapacity)
+    {
+        while (profiler.captureEventCount + profiler.eventCount > profiler.captureEventCapacity)
+        {
+            profiler.captureEventCapacity = (profiler.captureEventCapacity == 0)? 4096 : 2*profiler.captureEventCapacity;
+        }
+        profiler.captureEvents = (ProfileEvent *)realloc(profiler.captureEvents, profiler.captureEventCapacity*sizeof(ProfileEvent));
+    }
+
+    ProfileFrame *frame = &profiler.frames[profiler.frameCount++];
+    frame->start = profiler.frameStart;
+    frame->duration = frameEnd - profiler.frameStart;
+    frame->firstEvent = profiler.captureEventCount;
+    frame->eventCount = profiler.eventCount;
+    memcpy(frame->counters, profiler.counters, sizeof(frame->counters));
+
+    memcpy(&profiler.captureEvents[profiler.captureEventCount], profiler.events, profiler.eventCount*sizeof(ProfileEvent));
+    profiler.captureEventCount += profiler.eventCount;
+    profiler.captureFrames--;
+}
+
+// Load GL timer query entry points, needs a current context (after InitWindow())
+// NOTE: GL_TIME_ELAPSED is core in OpenGL 3.3, OpenGL 1.1 and ES 2.0/3.0 don't have it
+static bool LoadProfileGpuFunctions(void)
+{
+    if (profileGpuState != 0) return (profileGpuState == 1);
+
+    int version = rlGetVersion();
+    if ((version == RL_OPENGL_33) || (version == RL_OPENGL_43))
+    {
+        profileGenQueries = (ProfileGenQueriesProc)glfwGetProcAddress("glGenQueries");
+        profileDeleteQueries = (ProfileDeleteQueriesProc)glfwGetProcAddress("glDeleteQueries");
+        profileBeginQuery = (ProfileBeginQueryProc)glfwGetProcAddress("glBeginQuery");
+        profileEndQuery = (ProfileEndQueryProc)glfwGetProcAddress("glEndQuery");
+        profileGetQueryObjectiv = (ProfileGetQueryObjectivProc)glfwGetProcAddress("glGetQueryObjectiv");
+        profileGetQueryObjectui64v = (ProfileGetQueryObjectui64vProc)glfwGetProcAddress("glGetQueryObjectui64v");
+    }
+
+    bool ready = (profileGenQueries != NULL) && (profileDeleteQueries != NULL) && (profileBeginQuery != NULL) &&
+                 (profileEndQuery != NULL) && (profileGetQueryObjectiv != NULL) && (profileGetQueryObjectui64v != NULL);
+
+    if (ready) profileGenQueries(PROFILE_GPU_FRAMES*PROFILE_GPU_MAX_QUERIES, &profiler.gpuQueryIds[0][0]);
+    else TraceLog(LOG_WARNING, "PROFILE: GPU timer queries not supported (OpenGL 3.3 required), GPU scopes timed on CPU only");
+
+    profileGpuState = ready? 1 : -1;
+    return ready;
+}
+
+// Read ring frame queries that are ready, without waiting, and free the frame for reuse
+static void ResolveProfileGpuFrame(int frame)
+{
+    for (int i = 0; i < profiler.scopeCount; i++) profiler.scopes[i].gpuTime = 0.0;
+
+    bool resolved = false;
+    for (int i = 0; i < profiler.gpuQueryCounts[frame]; i++)
+    {
+        ProfileGpuQuery *query = &profiler.gpuQueries[frame][i];
+        if (!query->pending) continue;
+        query->pending = false;
+
+        int available = 0;
+        profileGetQueryObjectiv(profiler.gpuQueryIds[frame][i], RPROFILE_GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+        {
+            profiler.gpuDropped++;      // Reading it now would stall, the slot is needed next frame
+            continue;
+        }
+
+        unsigned long long nanoseconds = 0;
+        profileGetQueryObjectui64v(profiler.gpuQueryIds[frame][i], RPROFILE_GL_QUERY_RESULT, &nanoseconds);
+        double time = nanoseconds*1e-9;
+
+        ProfileScopeStats *scope = GetProfileScopeStats(query->name, 0);
+        if (scope != NULL)
+        {
+            scope->gpu = true;
+            scope->gpuTime += time;
+        }
+        resolved = true;
+
+        if (profiler.eventCount < PROFILE_MAX_EVENTS)
+        {
+            profiler.events[profiler.eventCount++] = (ProfileEvent){ query->name, query->cpuStart, time, 0, true };
+        }
+    }
+
+    if (resolved)
+    {
+        for (int i = 0; i < profiler.scopeCount; i++)
+        {
+            ProfileScopeStats *scope = &profiler.scopes[i];
+            if (scope->gpu) scope->gpuAverage += (scope->gpuTime - scope->gpuAverage)*PROFILE_SMOOTHING;
+        }
+    }
+
+    profiler.gpuQueryCounts[frame] = 0;
+}
+
+#endif // RPROFILE_IMPLEMENTATION
@@ -0,0 +1,237 @@
+/**********************************************************************************************
+*
+*   raylib.scene - Instanced drawing of many objects sharing few meshes
+*
+*   DESCRIPTION:
+*       Objects are grouped in batches by mesh and material (shader). Every frame the
+*       instances are re-added with their transform and material parameters, and DrawScene()
+*       submits each batch with a single DrawMeshInstanced() call, so draw calls grow with
+*       the number of distinct meshes instead of the number of objects.
+*
+*       An ordered scene (scene.ordered) draws its batches in the order they got their first
+*       instance, for blending: with instances added farthest first, every batch is back to
+*       front and batches go farthest batch first. Order across batches is approximate
+*       (instances of two batches are not interleaved), draw calls stay one per batch.
+*
+*       Material parameters go to the shader as per-instance vertex attributes:
+*           in mat4 instanceTransform;
+*           in vec4 instanceAmbient;        // ambient.rgb, shininess
+*           in vec4 instanceDiffuse;        // diffuse.rgb, transparency
+*           in vec4 instanceSpecular;       // specular.rgb, unused
+*
+*   CONFIGURATION:
+*
+*   #define RSCENE_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+**********************************************************************************************/
+
+#ifndef RSCENE_H
+#define RSCENE_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define SCENE_MAX_BATCHES       32      // Max distinct mesh/material pairs per scene
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Per-instance material parameters, laid out as three vec4 attributes
+typedef struct {
+    Vector3 ambient;
+    float shininess;
+    Vector3 diffuse;
+    float transparency;
+    Vector3 specular;
+    float unused;
+} SceneMaterial;
+
+// Instances sharing one mesh and material
+typedef struct {
+    Mesh mesh;
+    Material material;
+    int count;
+    int capacity;
+    Matrix *transforms;
+    SceneMaterial *materials;
+
+    unsigned int materialsVboId;    // Per-instance material buffer
+    int materialsVboCapacity;
+    int materialLocs[3];            // instanceAmbient, instanceDiffuse, instanceSpecular
+} SceneBatch;
+
+// Scene, batches keep their instance storage between frames
+typedef struct {
+    SceneBatch batches[SCENE_MAX_BATCHES];
+    int batchCount;
+
+    bool ordered;                   // Draw batches in order of their first instance
+    int batchOrder[SCENE_MAX_BATCHES];
+    int batchOrderCount;
+
+    int drawCalls;                  // Draw calls issued since last ClearScene()
+    int instanceCount;              // Instances drawn since last ClearScene()
+} Scene;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+int AddSceneBatch(Scene *scene, Mesh mesh, Material material);                          // Get batch for mesh/material, created if needed (-1 if full)
+void AddSceneInstance(Scene *scene, int batch, Matrix transform, SceneMaterial material); // Add instance to batch for next DrawScene()
+void ClearScene(Scene *scene);                                                          // Remove all instances and reset statistics
+void DrawScene(Scene *scene);                                                           // Draw all batches, one draw call per batch (first filled first if ordered)
+void UnloadScene(Scene *scene);                                                         // Unload scene buffers (meshes and materials are not owned)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RSCENE_H
+
+
+/***********************************************************************************
+*
+*   RSCENE IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RSCENE_IMPLEMENTATION)
+
+#include "rlgl.h"
+
+#include <stdlib.h>             // Required for: realloc(), free()
+#include <string.h>             // Required for: memset()
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Get batch for mesh/material, created if needed
+int AddSceneBatch(Scene *scene, Mesh mesh, Material material)
+{
+    for (int i = 0; i < scene->batchCount; i++)
+    {
+        SceneBatch *batch = &scene->batches[i];
+        if ((batch->mesh.vaoId == mesh.vaoId) && (batch->material.shader.id == material.shader.id)) return i;
+    }
+
+    if (scene->batchCount >= SCENE_MAX_BATCHES)
+    {
+        TraceLog(LOG_WARNING, "SCENE: Max batches reached (%i)", SCENE_MAX_BATCHES);
+        return -1;
+    }
+
+    SceneBatch *batch = &scene->batches[scene->batchCount];
+    memset(batch, 0, sizeof(SceneBatch));
+    batch->mesh = mesh;
+    batch->material = material;
+    batch->materialLocs[0] = rlGetLocationAttrib(material.shader.id, "instanceAmbient");
+    batch->materialLocs[1] = rlGetLocationAttrib(material.shader.id, "instanceDiffuse");
+    batch->materialLocs[2] = rlGetLocationAttrib(material.shader.id, "instanceSpecular");
+
+    if (material.shader.locs[SHADER_LOC_MATRIX_MODEL] == -1) TraceLog(LOG_WARNING, "SCENE: Shader [ID %i] has no instanceTransform attribute", material.shader.id);
+
+    return scene->batchCount++;
+}
+
+// Add instance to batch for next DrawScene()
+void AddSceneInstance(Scene *scene, int batch, Matrix transform, SceneMaterial material)
+{
+    if ((batch < 0) || (batch >= scene->batchCount)) return;
+
+    SceneBatch *b = &scene->batches[batch];
+
+    if (b->count == b->capacity)
+    {
+        b->capacity = (b->capacity == 0)? 64 : b->capacity*2;
+        b->transforms = (Matrix *)realloc(b->transforms, b->capacity*sizeof(Matrix));
+        b->materials = (SceneMaterial *)realloc(b->materials, b->capacity*sizeof(SceneMaterial));
+    }
+
+    b->transforms[b->count] = transform;
+    b->materials[b->count] = material;
+    b->count++;
+
+    if (scene->ordered && (b->count == 1)) scene->batchOrder[scene->batchOrderCount++] = batch;
+}
+
+// Remove all instances and reset statistics
+void ClearScene(Scene *scene)
+{
+    for (int i = 0; i < scene->batchCount; i++) scene->batches[i].count = 0;
+
+    scene->batchOrderCount = 0;
+    scene->drawCalls = 0;
+    scene->instanceCount = 0;
+}
+
+// Draw all batches, one draw call per batch (first filled first if ordered)
+// NOTE: Instances stay in the scene, call ClearScene() before adding the next frame
+void DrawScene(Scene *scene)
+{
+    int drawCount = scene->ordered? scene->batchOrderCount : scene->batchCount;
+
+    for (int i = 0; i < drawCount; i++)
+    {
+        SceneBatch *batch = &scene->batches[scene->ordered? scene->batchOrder[i] : i];
+        if (batch->count == 0) continue;
+
+        if (batch->materialLocs[0] != -1)
+        {
+            int dataSize = batch->count*sizeof(SceneMaterial);
+
+            if (batch->count > batch->materialsVboCapacity)
+            {
+                rlUnloadVertexBuffer(batch->materialsVboId);
+                batch->materialsVboId = rlLoadVertexBuffer(batch->materials, dataSize, true);
+                batch->materialsVboCapacity = batch->count;
+            }
+            else rlUpdateVertexBuffer(batch->materialsVboId, batch->materials, dataSize, 0);
+
+            // Mesh VAO keeps the attribute setup for the following DrawMeshInstanced()
+            // NOTE: Set every draw, another scene may have bound its own buffer to this mesh
+            rlEnableVertexArray(batch->mesh.vaoId);
+            rlEnableVertexBuffer(batch->materialsVboId);
+            for (int k = 0; k < 3; k++)
+            {
+                if (batch->materialLocs[k] == -1) continue;
+
+                rlEnableVertexAttribute(batch->materialLocs[k]);
+                rlSetVertexAttribute(batch->materialLocs[k], 4, RL_FLOAT, false, sizeof(SceneMaterial), (void *)(k*sizeof(Vector4)));
+                rlSetVertexAttributeDivisor(batch->materialLocs[k], 1);
+            }
+            rlDisableVertexBuffer();
+            rlDisableVertexArray();
+        }
+
+        DrawMeshInstanced(batch->mesh, batch->material, batch->transforms, batch->count);
+
+        scene->drawCalls++;
+        scene->instanceCount += batch->count;
+    }
+}
+
+// Unload scene buffers
+void UnloadScene(Scene *scene)
+{
+    for (int i = 0; i < scene->batchCount; i++)
+    {
+        rlUnloadVertexBuffer(scene->batches[i].materialsVboId);
+        free(scene->batches[i].transforms);
+        free(scene->batches[i].materials);
+    }
+
+    memset(scene, 0, sizeof(Scene));
+}
+
+#endif // RSCENE_IMPLEMENTATION
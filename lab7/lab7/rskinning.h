@@ -0,0 +1,537 @@
+/**********************************************************************************************
+*
+*   raylib.skinning - Multithreaded CPU skinning for animated models
+*
+*   DESCRIPTION:
+*       Same result as UpdateModelAnimation(), computed differently:
+*         - One matrix per bone per frame: bind pose inverse, scale, rotation and translation
+*           folded together, instead of quaternion math per vertex and weight
+*         - Vertices split in chunks run on the rjobs.h thread pool, every vertex blends its
+*           bone matrices with 4-wide SIMD (SSE2/NEON, scalar fallback)
+*         - Chunks only referencing bones that did not move since the last update are skipped,
+*           and only ranges of changed chunks are uploaded to the GPU
+*
+*   CONFIGURATION:
+*
+*   #define RSKINNING_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+**********************************************************************************************/
+
+#ifndef RSKINNING_H
+#define RSKINNING_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define SKINNING_CHUNK_VERTICES     1024        // Vertices per job and per dirty range
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Vertex range of one mesh
+typedef struct {
+    int mesh;
+    int first;
+    int count;
+    int boneCount;
+    unsigned char *bones;       // Bones used by the chunk vertices
+    bool dirty;                 // Skinned on last update, needs upload
+} SkinningChunk;
+
+// Skinning state of one model, keeps last bone matrices to find what changed
+typedef struct {
+    int boneCount;
+    float *boneMatrices;        // Per bone 8 vec4: position matrix columns 0-2 and translation, normal matrix columns 0-2, unused
+    bool *boneChanged;
+    bool initialized;           // First update skins everything
+
+    SkinningChunk *chunks;
+    int chunkCount;
+
+    int uploadedVertices;       // Last update statistics
+    int skippedVertices;        // Vertices of chunks whose bones did not move
+} ModelSkinning;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+ModelSkinning LoadModelSkinning(Model model);                                                   // Load skinning state, splits meshes in chunks
+void UnloadModelSkinning(ModelSkinning *skinning);                                              // Unload skinning state
+void UpdateModelAnimationParallel(ModelSkinning *skinning, Model model, ModelAnimation anim, int frame);   // Update model animated vertex data on the thread pool
+void BenchmarkModelSkinning(Model model, ModelAnimation anim, const char *name, int frames);    // Compare against UpdateModelAnimation() for 1/2/4/8 threads and log results
+Model GenModelSkinnedStrip(float length, int resolution, int boneCount);                        // Generate plane strip along X skinned to a bone chain (benchmark rig)
+ModelAnimation GenModelAnimationBend(Model model, int frameCount);                              // Generate wave bending every bone of a GenModelSkinnedStrip() chain
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RSKINNING_H
+
+
+/***********************************************************************************
+*
+*   RSKINNING IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RSKINNING_IMPLEMENTATION)
+
+#include "raymath.h"
+#include "rlgl.h"
+#include "rjobs.h"
+
+#include <stdlib.h>             // Required for: calloc(), malloc(), free()
+#include <string.h>             // Required for: memcpy(), memcmp()
+#include <stdio.h>              // Required for: snprintf()
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #include <arm_neon.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+
+// 4-wide vectors, one matrix column or one vertex per register
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    typedef __m128 SkVec;
+    #define SK_SET1(x)              _mm_set1_ps(x)
+    #define SK_ZERO()               _mm_setzero_ps()
+    #define SK_LOAD(p)              _mm_loadu_ps(p)
+    #define SK_STORE(p, a)          _mm_storeu_ps(p, a)
+    #define SK_ADD(a, b)            _mm_add_ps(a, b)
+    #define SK_MUL(a, b)            _mm_mul_ps(a, b)
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    typedef float32x4_t SkVec;
+    #define SK_SET1(x)              vdupq_n_f32(x)
+    #define SK_ZERO()               vdupq_n_f32(0.0f)
+    #define SK_LOAD(p)              vld1q_f32(p)
+    #define SK_STORE(p, a)          vst1q_f32(p, a)
+    #define SK_ADD(a, b)            vaddq_f32(a, b)
+    #define SK_MUL(a, b)            vmulq_f32(a, b)
+#else
+    typedef struct { float v[4]; } SkVec;
+    static inline SkVec SkSet1(float x) { SkVec r = { { x, x, x, x } }; return r; }
+    static inline SkVec SkLoad(const float *p) { SkVec r = { { p[0], p[1], p[2], p[3] } }; return r; }
+    static inline SkVec SkAdd(SkVec a, SkVec b) { SkVec r = { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; return r; }
+    static inline SkVec SkMul(SkVec a, SkVec b) { SkVec r = { { a.v[0]*b.v[0], a.v[1]*b.v[1], a.v[2]*b.v[2], a.v[3]*b.v[3] } }; return r; }
+    #define SK_SET1(x)              SkSet1(x)
+    #define SK_ZERO()               SkSet1(0.0f)
+    #define SK_LOAD(p)              SkLoad(p)
+    #define SK_STORE(p, a)          memcpy(p, (a).v, 4*sizeof(float))
+    #define SK_ADD(a, b)            SkAdd(a, b)
+    #define SK_MUL(a, b)            SkMul(a, b)
+#endif
+
+#define SKINNING_BONE_FLOATS        32          // 8 vec4 per bone
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct {
+    ModelSkinning *skinning;
+    Model model;
+} SkinningJob;
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static void ComputeBoneMatrices(ModelSkinning *skinning, Model model, ModelAnimation anim, int frame);
+static void SkinChunksJob(int begin, int end, void *userData);
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Load skinning state, splits meshes in chunks
+ModelSkinning LoadModelSkinning(Model model)
+{
+    ModelSkinning skinning = { 0 };
+    skinning.boneCount = model.boneCount;
+    skinning.boneMatrices = (float *)calloc(model.boneCount*SKINNING_BONE_FLOATS, sizeof(float));
+    skinning.boneChanged = (bool *)calloc(model.boneCount, sizeof(bool));
+
+    for (int m = 0; m < model.meshCount; m++)
+    {
+        if ((model.meshes[m].boneIds == NULL) || (model.meshes[m].boneWeights == NULL)) continue;
+        skinning.chunkCount += (model.meshes[m].vertexCount + SKINNING_CHUNK_VERTICES - 1)/SKINNING_CHUNK_VERTICES;
+    }
+
+    skinning.chunks = (SkinningChunk *)calloc(skinning.chunkCount, sizeof(SkinningChunk));
+    bool *used = (bool *)calloc(256, sizeof(bool));
+    int c = 0;
+
+    for (int m = 0; m < model.meshCount; m++)
+    {
+        Mesh mesh = model.meshes[m];
+        if ((mesh.boneIds == NULL) || (mesh.boneWeights == NULL))
+        {
+            TraceLog(LOG_WARNING, "SKINNING: Mesh %i has no connection to bones", m);
+            continue;
+        }
+
+        for (int first = 0; first < mesh.vertexCount; first += SKINNING_CHUNK_VERTICES, c++)
+        {
+            SkinningChunk *chunk = &skinning.chunks[c];
+            chunk->mesh = m;
+            chunk->first = first;
+            chunk->count = (first + SKINNING_CHUNK_VERTICES < mesh.vertexCount)? SKINNING_CHUNK_VERTICES : mesh.vertexCount - first;
+
+            memset(used, 0, 256*sizeof(bool));
+            for (int i = first*4; i < (first + chunk->count)*4; i++)
+            {
+                if (mesh.boneWeights[i] != 0.0f) used[mesh.boneIds[i]] = true;
+            }
+
+            chunk->bones = (unsigned char *)malloc(256);
+            for (int b = 0; b < 256; b++) if (used[b] && (b < model.boneCount)) chunk->bones[chunk->boneCount++] = (unsigned char)b;
+        }
+    }
+
+    free(used);
+
+    return skinning;
+}
+
+// Unload skinning state
+void UnloadModelSkinning(ModelSkinning *skinning)
+{
+    for (int c = 0; c < skinning->chunkCount; c++) free(skinning->chunks[c].bones);
+    free(skinning->chunks);
+    free(skinning->boneMatrices);
+    free(skinning->boneChanged);
+
+    memset(skinning, 0, sizeof(ModelSkinning));
+}
+
+// Update model animated vertex data on the thread pool
+// NOTE: Uploads happen on the calling thread, it must own the GL context
+void UpdateModelAnimationParallel(ModelSkinning *skinning, Model model, ModelAnimation anim, int frame)
+{
+    if ((anim.frameCount <= 0) || (anim.bones == NULL) || (anim.framePoses == NULL)) return;
+    if (frame >= anim.frameCount) frame = frame%anim.frameCount;
+
+    ComputeBoneMatrices(skinning, model, anim, frame);
+
+    SkinningJob job = { skinning, model };
+    RunJobsParallel(skinning->chunkCount, 1, SkinChunksJob, &job);
+    skinning->initialized = true;
+
+    // Upload runs of dirty chunks, chunks of a mesh are consecutive
+    skinning->uploadedVertices = 0;
+    skinning->skippedVertices = 0;
+
+    for (int c = 0; c < skinning->chunkCount;)
+    {
+        if (!skinning->chunks[c].dirty)
+        {
+            skinning->skippedVertices += skinning->chunks[c].count;
+            c++;
+            continue;
+        }
+
+        int last = c;
+        while ((last + 1 < skinning->chunkCount) && skinning->chunks[last + 1].dirty && (skinning->chunks[last + 1].mesh == skinning->chunks[c].mesh)) last++;
+
+        Mesh mesh = model.meshes[skinning->chunks[c].mesh];
+        int first = skinning->chunks[c].first;
+        int count = skinning->chunks[last].first + skinning->chunks[last].count - first;
+
+        rlUpdateVertexBuffer(mesh.vboId[0], mesh.animVertices + first*3, count*3*sizeof(float), first*3*sizeof(float));
+        if (mesh.animNormals != NULL) rlUpdateVertexBuffer(mesh.vboId[2], mesh.animNormals + first*3, count*3*sizeof(float), first*3*sizeof(float));
+
+        skinning->uploadedVertices += count;
+        c = last + 1;
+    }
+}
+
+// Compare against UpdateModelAnimation() for 1/2/4/8 threads and log results
+// NOTE: Every frame is a new pose, so nothing is skipped
+void BenchmarkModelSkinning(Model model, ModelAnimation anim, const char *name, int frames)
+{
+    int vertexCount = 0;
+    for (int m = 0; m < model.meshCount; m++) vertexCount += model.meshes[m].vertexCount;
+
+    double start = GetTime();
+    for (int f = 0; f < frames; f++) UpdateModelAnimation(model, anim, f);
+    double referenceTime = (GetTime() - start)/frames;
+
+    // Reference result of the last frame
+    float **reference = (float **)calloc(model.meshCount, sizeof(float *));
+    for (int m = 0; m < model.meshCount; m++)
+    {
+        if (model.meshes[m].animVertices == NULL) continue;
+        reference[m] = (float *)malloc(model.meshes[m].vertexCount*3*sizeof(float));
+        memcpy(reference[m], model.meshes[m].animVertices, model.meshes[m].vertexCount*3*sizeof(float));
+    }
+
+    TraceLog(LOG_INFO, "BENCH: [%s] %i vertices, %i bones, %i frames", name, vertexCount, model.boneCount, frames);
+    if (vertexCount < 4*8*SKINNING_CHUNK_VERTICES) TraceLog(LOG_WARNING, "BENCH: [%s] Less than 4 chunks per thread at 8 threads, parallel times won't scale", name);
+    TraceLog(LOG_INFO, "BENCH: [%s] UpdateModelAnimation():  %8.3f ms/frame", name, referenceTime*1000.0);
+
+    const int threadCounts[4] = { 1, 2, 4, 8 };
+    for (int t = 0; t < 4; t++)
+    {
+        InitJobs(threadCounts[t]);
+        ModelSkinning skinning = LoadModelSkinning(model);
+
+        start = GetTime();
+        for (int f = 0; f < frames; f++) UpdateModelAnimationParallel(&skinning, model, anim, f);
+        double time = (GetTime() - start)/frames;
+
+        float maxError = 0.0f;
+        for (int m = 0; m < model.meshCount; m++)
+        {
+            if (reference[m] == NULL) continue;
+            for (int i = 0; i < model.meshes[m].vertexCount*3; i++) maxError = fmaxf(maxError, fabsf(reference[m][i] - model.meshes[m].animVertices[i]));
+        }
+
+        TraceLog(LOG_INFO, "BENCH: [%s] parallel, %i threads:    %8.3f ms/frame (%.1fx, max error %g)", name, threadCounts[t],
+                 time*1000.0, referenceTime/time, maxError);
+
+        UnloadModelSkinning(&skinning);
+    }
+
+    InitJobs(0);
+
+    for (int m = 0; m < model.meshCount; m++) free(reference[m]);
+    free(reference);
+}
+
+// Generate plane strip along X skinned to a bone chain (benchmark rig)
+// NOTE: resolution quads along X and Z (4:1 quads), every vertex blends its two nearest bones
+Model GenModelSkinnedStrip(float length, int resolution, int boneCount)
+{
+    if (boneCount < 2) boneCount = 2;
+    if (boneCount > 255) boneCount = 255;
+
+    int resX = resolution + 1;
+    int resZ = resolution + 1;
+    float width = length/4.0f;
+    float segment = length/(boneCount - 1);
+
+    Mesh mesh = { 0 };
+    mesh.vertexCount = resX*resZ;
+    mesh.triangleCount = 2*(resX - 1)*(resZ - 1);
+    mesh.vertices = (float *)malloc(mesh.vertexCount*3*sizeof(float));
+    mesh.normals = (float *)malloc(mesh.vertexCount*3*sizeof(float));
+    mesh.texcoords = (float *)malloc(mesh.vertexCount*2*sizeof(float));
+    mesh.animVertices = (float *)malloc(mesh.vertexCount*3*sizeof(float));
+    mesh.animNormals = (float *)malloc(mesh.vertexCount*3*sizeof(float));
+    mesh.boneIds = (unsigned char *)calloc(mesh.vertexCount*4, sizeof(unsigned char));
+    mesh.boneWeights = (float *)calloc(mesh.vertexCount*4, sizeof(float));
+    mesh.indices = (unsigned short *)malloc(mesh.triangleCount*3*sizeof(unsigned short));
+
+    for (int z = 0; z < resZ; z++)
+    {
+        for (int x = 0; x < resX; x++)
+        {
+            int i = z*resX + x;
+            float u = (float)x/(resX - 1);
+
+            mesh.vertices[i*3 + 0] = u*length;
+            mesh.vertices[i*3 + 1] = 0.0f;
+            mesh.vertices[i*3 + 2] = ((float)z/(resZ - 1) - 0.5f)*width;
+            mesh.normals[i*3 + 0] = 0.0f;
+            mesh.normals[i*3 + 1] = 1.0f;
+            mesh.normals[i*3 + 2] = 0.0f;
+            mesh.texcoords[i*2 + 0] = u;
+            mesh.texcoords[i*2 + 1] = (float)z/(resZ - 1);
+
+            // Linear blend between the two bones around the vertex
+            float t = u*(boneCount - 1);
+            int bone = (int)t;
+            if (bone > boneCount - 2) bone = boneCount - 2;
+            mesh.boneIds[i*4 + 0] = (unsigned char)bone;
+            mesh.boneIds[i*4 + 1] = (unsigned char)(bone + 1);
+            mesh.boneWeights[i*4 + 0] = 1.0f - (t - bone);
+            mesh.boneWeights[i*4 + 1] = t - bone;
+        }
+    }
+
+    memcpy(mesh.animVertices, mesh.vertices, mesh.vertexCount*3*sizeof(float));
+    memcpy(mesh.animNormals, mesh.normals, mesh.vertexCount*3*sizeof(float));
+
+    // NOTE: 16 bit indices, resolution is limited to 255 (65536 vertices)
+    int k = 0;
+    for (int z = 0; z < resZ - 1; z++)
+    {
+        for (int x = 0; x < resX - 1; x++)
+        {
+            unsigned short i = (unsigned short)(z*resX + x);
+            mesh.indices[k++] = i;
+            mesh.indices[k++] = (unsigned short)(i + resX);
+            mesh.indices[k++] = (unsigned short)(i + 1);
+            mesh.indices[k++] = (unsigned short)(i + 1);
+            mesh.indices[k++] = (unsigned short)(i + resX);
+            mesh.indices[k++] = (unsigned short)(i + resX + 1);
+        }
+    }
+
+    UploadMesh(&mesh, true);
+
+    Model model = LoadModelFromMesh(mesh);
+    model.boneCount = boneCount;
+    model.bones = (BoneInfo *)calloc(boneCount, sizeof(BoneInfo));
+    model.bindPose = (Transform *)malloc(boneCount*sizeof(Transform));
+
+    for (int b = 0; b < boneCount; b++)
+    {
+        snprintf(model.bones[b].name, sizeof(model.bones[b].name), "bone%i", b);
+        model.bones[b].parent = b - 1;
+        model.bindPose[b] = (Transform){ (Vector3){ b*segment, 0.0f, 0.0f }, QuaternionIdentity(), (Vector3){ 1.0f, 1.0f, 1.0f } };
+    }
+
+    return model;
+}
+
+// Generate wave bending every bone of a GenModelSkinnedStrip() chain
+// NOTE: Poses are in model space, like the ones LoadModelAnimations() returns
+ModelAnimation GenModelAnimationBend(Model model, int frameCount)
+{
+    ModelAnimation anim = { 0 };
+    snprintf(anim.name, sizeof(anim.name), "bend");
+    anim.boneCount = model.boneCount;
+    anim.frameCount = frameCount;
+    anim.bones = (BoneInfo *)malloc(model.boneCount*sizeof(BoneInfo));
+    memcpy(anim.bones, model.bones, model.boneCount*sizeof(BoneInfo));
+    anim.framePoses = (Transform **)malloc(frameCount*sizeof(Transform *));
+
+    float segment = (model.boneCount > 1)? model.bindPose[1].translation.x - model.bindPose[0].translation.x : 1.0f;
+
+    for (int f = 0; f < frameCount; f++)
+    {
+        Transform *poses = (Transform *)malloc(model.boneCount*sizeof(Transform));
+        Quaternion parentRotation = QuaternionIdentity();
+        Vector3 position = model.bindPose[0].translation;
+
+        for (int b = 0; b < model.boneCount; b++)
+        {
+            if (b > 0) position = Vector3Add(position, Vector3RotateByQuaternion((Vector3){ segment, 0.0f, 0.0f }, parentRotation));
+
+            float angle = 0.2f*sinf(2.0f*PI*f/frameCount + 0.4f*b);
+            Quaternion rotation = QuaternionMultiply(parentRotation, QuaternionFromAxisAngle((Vector3){ 0.0f, 0.0f, 1.0f }, angle));
+
+            poses[b] = (Transform){ position, rotation, (Vector3){ 1.0f, 1.0f, 1.0f } };
+            parentRotation = rotation;
+        }
+
+        anim.framePoses[f] = poses;
+    }
+
+    return anim;
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// One matrix per bone: v' = R*(S*(v - bindT)) + T, with R = rotation*inverse(bindRotation)
+// NOTE: Normals only take R, like UpdateModelAnimation() does
+static void ComputeBoneMatrices(ModelSkinning *skinning, Model model, ModelAnimation anim, int frame)
+{
+    for (int b = 0; b < skinning->boneCount; b++)
+    {
+        Transform bind = model.bindPose[b];
+        Transform pose = anim.framePoses[frame][b];
+
+        Matrix rotation = QuaternionToMatrix(QuaternionMultiply(pose.rotation, QuaternionInvert(bind.rotation)));
+
+        float bone[SKINNING_BONE_FLOATS] = {
+            rotation.m0*pose.scale.x, rotation.m1*pose.scale.x, rotation.m2*pose.scale.x, 0.0f,
+            rotation.m4*pose.scale.y, rotation.m5*pose.scale.y, rotation.m6*pose.scale.y, 0.0f,
+            rotation.m8*pose.scale.z, rotation.m9*pose.scale.z, rotation.m10*pose.scale.z, 0.0f,
+            0.0f, 0.0f, 0.0f, 0.0f,
+            rotation.m0, rotation.m1, rotation.m2, 0.0f,
+            rotation.m4, rotation.m5, rotation.m6, 0.0f,
+            rotation.m8, rotation.m9, rotation.m10, 0.0f,
+            0.0f, 0.0f, 0.0f, 0.0f
+        };
+
+        // Translation: T - L*bindT
+        for (int k = 0; k < 3; k++)
+        {
+            bone[12 + k] = (&pose.translation.x)[k] - (bone[k]*bind.translation.x + bone[4 + k]*bind.translation.y + bone[8 + k]*bind.translation.z);
+        }
+
+        float *stored = &skinning->boneMatrices[b*SKINNING_BONE_FLOATS];
+        skinning->boneChanged[b] = !skinning->initialized || (memcmp(stored, bone, sizeof(bone)) != 0);
+        if (skinning->boneChanged[b]) memcpy(stored, bone, sizeof(bone));
+    }
+}
+
+// Skin chunks [begin, end) whose bones changed
+static void SkinChunksJob(int begin, int end, void *userData)
+{
+    SkinningJob *job = (SkinningJob *)userData;
+    ModelSkinning *skinning = job->skinning;
+
+    for (int c = begin; c < end; c++)
+    {
+        SkinningChunk *chunk = &skinning->chunks[c];
+
+        chunk->dirty = false;
+        for (int i = 0; i < chunk->boneCount; i++) chunk->dirty |= skinning->boneChanged[chunk->bones[i]];
+        if (!chunk->dirty) continue;
+
+        Mesh mesh = job->model.meshes[chunk->mesh];
+        bool normals = (mesh.normals != NULL) && (mesh.animNormals != NULL);
+
+        for (int v = chunk->first; v < chunk->first + chunk->count; v++)
+        {
+            SkVec c0 = SK_ZERO(), c1 = SK_ZERO(), c2 = SK_ZERO(), t = SK_ZERO();
+            SkVec n0 = SK_ZERO(), n1 = SK_ZERO(), n2 = SK_ZERO();
+
+            // Blend the bone matrices by weight
+            for (int j = v*4; j < v*4 + 4; j++)
+            {
+                float weight = mesh.boneWeights[j];
+                if (weight == 0.0f) continue;
+
+                const float *bone = &skinning->boneMatrices[mesh.boneIds[j]*SKINNING_BONE_FLOATS];
+                SkVec w = SK_SET1(weight);
+                c0 = SK_ADD(c0, SK_MUL(w, SK_LOAD(bone)));
+                c1 = SK_ADD(c1, SK_MUL(w, SK_LOAD(bone + 4)));
+                c2 = SK_ADD(c2, SK_MUL(w, SK_LOAD(bone + 8)));
+                t = SK_ADD(t, SK_MUL(w, SK_LOAD(bone + 12)));
+
+                if (normals)
+                {
+                    n0 = SK_ADD(n0, SK_MUL(w, SK_LOAD(bone + 16)));
+                    n1 = SK_ADD(n1, SK_MUL(w, SK_LOAD(bone + 20)));
+                    n2 = SK_ADD(n2, SK_MUL(w, SK_LOAD(bone + 24)));
+                }
+            }
+
+            // Stored through a temporary, a 4-wide store would overwrite the next vertex
+            float result[4];
+            const float *position = &mesh.vertices[v*3];
+            SkVec p = SK_ADD(SK_ADD(SK_MUL(c0, SK_SET1(position[0])), SK_MUL(c1, SK_SET1(position[1]))), SK_ADD(SK_MUL(c2, SK_SET1(position[2])), t));
+            SK_STORE(result, p);
+            memcpy(&mesh.animVertices[v*3], result, 3*sizeof(float));
+
+            if (normals)
+            {
+                const float *normal = &mesh.normals[v*3];
+                SkVec n = SK_ADD(SK_ADD(SK_MUL(n0, SK_SET1(normal[0])), SK_MUL(n1, SK_SET1(normal[1]))), SK_MUL(n2, SK_SET1(normal[2])));
+                SK_STORE(result, n);
+                memcpy(&mesh.animNormals[v*3], result, 3*sizeof(float));
+            }
+        }
+    }
+}
+
+#endif // RSKINNING_IMPLEMENTATION
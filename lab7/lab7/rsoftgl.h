@@ -0,0 +1,1125 @@
+/**********************************************************************************************
+*
+*   raylib.softgl - Headless tiled software rasterizer
+*
+*   DESCRIPTION:
+*       Renders into an Image without window or OpenGL context, for machines with no GPU and
+*       for reproducible benchmarks and golden image checks. The API follows rlgl immediate
+*       mode (SoftBegin()/SoftVertex3f()/SoftEnd(), matrix stack, texture, blend mode) plus
+*       helpers for the shapes and meshes the labs draw.
+*
+*       Pipeline:
+*         - Vertices go through the matrix stack at SoftVertex3f(), lighting runs per vertex
+*           (same Phong model as lighting.frag: ambient + diffuse + specular per material)
+*         - Triangles are clipped against the near plane, back faces culled (CCW front, like
+*           rlgl defaults), then binned in 64x64 tiles in submission order
+*         - SoftFlush() rasterizes tiles in parallel (rjobs.h), each tile owns its pixels so
+*           blending order is kept without locks; edge functions are evaluated 4 pixels at
+*           a time with SSE2 (scalar fallback elsewhere)
+*         - Depth test (less or equal), perspective correct texcoords and colors, repeat wrap
+*           nearest texture sampling, BLEND_ALPHA/BLEND_ADDITIVE/BLEND_MULTIPLIED
+*
+*       Every pixel is computed from absolute edge values, never stepped incrementally, so
+*       the result doesn't depend on tile size, thread count or SIMD path.
+*
+*   CONFIGURATION:
+*
+*   #define RSOFTGL_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+*   NOTE: Implementation uses rjobs.h (C++11 threads) and std::chrono for timings, GetTime()
+*   needs the window platform to be initialized
+*
+**********************************************************************************************/
+
+#ifndef RSOFTGL_H
+#define RSOFTGL_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define SOFT_TILE_SIZE              64          // Tile side in pixels, multiple of 4
+#define SOFT_MAX_MATRIX_STACK       32
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Point light, same fields as the lab7 Light
+typedef struct {
+    bool enabled;
+    Vector3 position;
+    Vector3 ambient;
+    Vector3 diffuse;
+    Vector3 specular;
+} SoftLight;
+
+// Phong material, alpha comes from transparency
+typedef struct {
+    Vector3 ambient;
+    Vector3 diffuse;
+    Vector3 specular;
+    float shininess;
+    float transparency;
+} SoftMaterial;
+
+// Screen space triangle ready to rasterize
+typedef struct {
+    float x[3], y[3];           // Pixel coordinates, top-left origin
+    float z[3];                 // Depth [0..1]
+    float w[3];                 // 1/w
+    float u[3], v[3];           // Texcoords divided by w
+    float c[3][4];              // Colors [0..1] divided by w
+    int minX, minY, maxX, maxY; // Pixel bounds, inclusive
+    const Image *texture;       // NULL for white
+    int blendMode;              // -1 for no blending
+    bool depthWrite;
+} SoftTriangle;
+
+// Frame statistics
+typedef struct {
+    int triangles;              // Submitted
+    int culled;                 // Back facing, degenerate or behind the camera
+    int clipped;                // Cut by the near plane
+    int binned;                 // Triangle references in tile bins
+    long long pixels;           // Pixels passing coverage
+    double setupTime;           // Seconds between SoftBegin() and SoftEnd(): vertex processing and binning
+    double rasterTime;          // Seconds in SoftFlush()
+} SoftStats;
+
+// Software rendering context
+typedef struct {
+    int width;
+    int height;
+    Color *color;
+    float *depth;
+
+    int tilesX, tilesY;
+    int **bins;                 // Triangle indices per tile
+    int *binCounts;
+    int *binCapacities;
+    long long *tilePixels;      // Covered pixels per tile, summed by SoftFlush()
+    SoftTriangle *triangles;
+    int triangleCount;
+    int triangleCapacity;
+    bool parallel;              // Rasterize tiles on the job pool
+
+    Matrix view, projection, viewProjection;
+    Vector3 viewPosition;
+    Matrix stack[SOFT_MAX_MATRIX_STACK];
+    int stackCounter;
+    Matrix transform;           // Model transform, top of the stack
+
+    int mode;                   // Primitive being recorded
+    int vertexCounter;
+    double beginTime;           // SoftBegin() time, setup is timed per SoftBegin()/SoftEnd() batch
+    Vector3 positions[4];       // Primitive vertices, world space
+    Vector3 normals[4];
+    Vector2 texcoords[4];
+    Color colors[4];
+    Vector2 texcoord;           // Current attributes
+    Vector3 normal;
+    Color vertexColor;
+
+    const Image *texture;
+    int blendMode;
+    bool depthTest;
+    bool depthWrite;
+    bool backfaceCulling;
+    bool lighting;
+    SoftLight light;
+    SoftMaterial material;
+
+    SoftStats stats;
+} SoftContext;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+SoftContext LoadSoftContext(int width, int height);                                     // Load software context (color and depth buffers)
+void UnloadSoftContext(SoftContext *ctx);                                               // Unload software context
+void SoftClear(SoftContext *ctx, Color color);                                          // Clear color and depth, drops pending triangles
+void SoftBeginMode3D(SoftContext *ctx, Camera3D camera);                                // Set view and projection like BeginMode3D()
+void SoftEndMode3D(SoftContext *ctx);                                                   // Rasterize pending triangles
+void SoftFlush(SoftContext *ctx);                                                       // Rasterize pending triangles (tiles in parallel)
+Image LoadImageFromSoftContext(const SoftContext *ctx);                                 // Copy color buffer to a new image (RGBA8)
+SoftStats GetSoftStats(const SoftContext *ctx);                                         // Get statistics since SoftClear()
+
+void SoftPushMatrix(SoftContext *ctx);                                                  // Push model transform
+void SoftPopMatrix(SoftContext *ctx);                                                   // Pop model transform
+void SoftMultMatrix(SoftContext *ctx, Matrix matrix);                                   // Multiply model transform (applied before the current one)
+void SoftTranslatef(SoftContext *ctx, float x, float y, float z);                       // Translate model transform
+void SoftRotatef(SoftContext *ctx, float angle, float x, float y, float z);             // Rotate model transform, angle in degrees
+void SoftScalef(SoftContext *ctx, float x, float y, float z);                           // Scale model transform
+
+void SoftBegin(SoftContext *ctx, int mode);                                             // Begin primitives (RL_TRIANGLES, RL_QUADS)
+void SoftEnd(SoftContext *ctx);                                                         // End primitives
+void SoftVertex3f(SoftContext *ctx, float x, float y, float z);                         // Add vertex with current attributes
+void SoftTexCoord2f(SoftContext *ctx, float u, float v);                                // Set texcoord for next vertices
+void SoftNormal3f(SoftContext *ctx, float x, float y, float z);                         // Set normal for next vertices
+void SoftColor4ub(SoftContext *ctx, unsigned char r, unsigned char g, unsigned char b, unsigned char a);   // Set color for next vertices
+void SoftSetTexture(SoftContext *ctx, const Image *image);                              // Set texture (RGBA8 image), NULL for white
+void SoftSetBlendMode(SoftContext *ctx, int mode);                                      // Set blend mode, -1 disables blending
+void SoftSetDepthTest(SoftContext *ctx, bool test, bool write);                         // Set depth test and depth writes
+void SoftSetBackfaceCulling(SoftContext *ctx, bool enabled);                            // Set back face culling (CCW front faces)
+void SoftSetLighting(SoftContext *ctx, bool enabled, SoftLight light, SoftMaterial material);   // Set per vertex lighting, vertex colors are used when disabled
+
+void SoftDrawMesh(SoftContext *ctx, Mesh mesh, Matrix transform, Color tint);           // Draw mesh from its CPU arrays
+void SoftDrawCube(SoftContext *ctx, Vector3 position, float width, float height, float length, Color color);   // Draw cube like DrawCube()
+void SoftDrawSphere(SoftContext *ctx, Vector3 center, float radius, int rings, int slices, Color color);       // Draw sphere like DrawSphereEx()
+void SoftDrawPlane(SoftContext *ctx, Vector3 center, Vector2 size, Color color);        // Draw XZ plane like DrawPlane()
+
+int CheckSoftGoldenImage(Image image, const char *goldenPath, int tolerance);           // Compare with golden image (written if missing), returns pixels off by more than tolerance
+void BenchmarkSoftRaster(int width, int height, int frames);                            // Benchmark rasterizer on a lit scene, 1 thread vs all
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RSOFTGL_H
+
+
+/***********************************************************************************
+*
+*   RSOFTGL IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RSOFTGL_IMPLEMENTATION) && !defined(RSOFTGL_IMPLEMENTATION_DEFINED)
+#define RSOFTGL_IMPLEMENTATION_DEFINED
+
+#include "raymath.h"
+#include "rlgl.h"               // Required for: RL_TRIANGLES, RL_QUADS, RL_CULL_DISTANCE_NEAR/FAR
+#include "rjobs.h"
+
+#include <chrono>               // Required for: std::chrono::steady_clock
+#include <math.h>               // Required for: sinf(), cosf(), powf(), floorf(), ceilf()
+#include <stdlib.h>             // Required for: malloc(), calloc(), realloc(), free()
+#include <string.h>             // Required for: memcpy()
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define RSOFTGL_SSE2
+    #include <emmintrin.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define SOFT_NEAR_EPSILON       1e-5f       // Clip space w below this is behind the camera
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Vertex after lighting, before clipping
+typedef struct {
+    Vector4 clip;
+    float u, v;
+    float c[4];
+} SoftClipVertex;
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static double SoftGetTime(void);
+static void SoftEmitTriangle(SoftContext *ctx, int i0, int i1, int i2);
+static SoftClipVertex SoftShadeVertex(const SoftContext *ctx, Vector3 position, Vector3 normal, Vector2 texcoord, Color color);
+static SoftClipVertex SoftLerpVertex(SoftClipVertex a, SoftClipVertex b, float t);
+static void SoftSetupTriangle(SoftContext *ctx, const SoftClipVertex *a, const SoftClipVertex *b, const SoftClipVertex *c);
+static void SoftRasterTiles(int begin, int end, void *userData);
+static void SoftRasterTriangle(SoftContext *ctx, const SoftTriangle *tri, int tileX, int tileY, long long *pixels);
+static void SoftShadePixel(SoftContext *ctx, const SoftTriangle *tri, int px, int py, float b0, float b1, float b2);
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Load software context (color and depth buffers)
+SoftContext LoadSoftContext(int width, int height)
+{
+    SoftContext ctx = { 0 };
+
+    ctx.width = width;
+    ctx.height = height;
+    ctx.color = (Color *)malloc(width*height*sizeof(Color));
+    ctx.depth = (float *)malloc(width*height*sizeof(float));
+
+    ctx.tilesX = (width + SOFT_TILE_SIZE - 1)/SOFT_TILE_SIZE;
+    ctx.tilesY = (height + SOFT_TILE_SIZE - 1)/SOFT_TILE_SIZE;
+    int tileCount = ctx.tilesX*ctx.tilesY;
+    ctx.bins = (int **)calloc(tileCount, sizeof(int *));
+    ctx.binCounts = (int *)calloc(tileCount, sizeof(int));
+    ctx.binCapacities = (int *)calloc(tileCount, sizeof(int));
+    ctx.tilePixels = (long long *)calloc(tileCount, sizeof(long long));
+    ctx.parallel = true;
+
+    ctx.view = MatrixIdentity();
+    ctx.projection = MatrixIdentity();
+    ctx.viewProjection = MatrixIdentity();
+    ctx.transform = MatrixIdentity();
+    ctx.vertexColor = WHITE;
+    ctx.normal = (Vector3){ 0.0f, 1.0f, 0.0f };
+    ctx.blendMode = BLEND_ALPHA;
+    ctx.depthTest = true;
+    ctx.depthWrite = true;
+    ctx.backfaceCulling = true;
+    ctx.mode = RL_TRIANGLES;
+
+    SoftClear(&ctx, BLACK);
+
+    return ctx;
+}
+
+// Unload software context
+void UnloadSoftContext(SoftContext *ctx)
+{
+    for (int i = 0; i < ctx->tilesX*ctx->tilesY; i++) free(ctx->bins[i]);
+    free(ctx->bins);
+    free(ctx->binCounts);
+    free(ctx->binCapacities);
+    free(ctx->tilePixels);
+    free(ctx->triangles);
+    free(ctx->color);
+    free(ctx->depth);
+
+    *ctx = (SoftContext){ 0 };
+}
+
+// Clear color and depth, drops pending triangles
+void SoftClear(SoftContext *ctx, Color color)
+{
+    int count = ctx->width*ctx->height;
+    for (int i = 0; i < count; i++)
+    {
+        ctx->color[i] = color;
+        ctx->depth[i] = 1.0f;
+    }
+
+    ctx->triangleCount = 0;
+    for (int i = 0; i < ctx->tilesX*ctx->tilesY; i++) ctx->binCounts[i] = 0;
+    ctx->stats = (SoftStats){ 0 };
+}
+
+// Set view and projection like BeginMode3D()
+void SoftBeginMode3D(SoftContext *ctx, Camera3D camera)
+{
+    float aspect = (float)ctx->width/(float)ctx->height;
+
+    if (camera.projection == CAMERA_ORTHOGRAPHIC)
+    {
+        float top = camera.fovy/2.0f;
+        ctx->projection = MatrixOrtho(-top*aspect, top*aspect, -top, top, RL_CULL_DISTANCE_NEAR, RL_CULL_DISTANCE_FAR);
+    }
+    else ctx->projection = MatrixPerspective(camera.fovy*DEG2RAD, aspect, RL_CULL_DISTANCE_NEAR, RL_CULL_DISTANCE_FAR);
+
+    ctx->view = MatrixLookAt(camera.position, camera.target, camera.up);
+    ctx->viewProjection = MatrixMultiply(ctx->view, ctx->projection);
+    ctx->viewPosition = camera.position;
+    ctx->stackCounter = 0;
+    ctx->transform = MatrixIdentity();
+}
+
+// Rasterize pending triangles
+void SoftEndMode3D(SoftContext *ctx)
+{
+    SoftFlush(ctx);
+}
+
+// Rasterize pending triangles (tiles in parallel)
+void SoftFlush(SoftContext *ctx)
+{
+    if (ctx->triangleCount == 0) return;
+
+    double start = SoftGetTime();
+    int tileCount = ctx->tilesX*ctx->tilesY;
+
+    if (ctx->parallel) RunJobsParallel(tileCount, 1, SoftRasterTiles, ctx);
+    else SoftRasterTiles(0, tileCount, ctx);
+
+    for (int i = 0; i < tileCount; i++)
+    {
+        ctx->stats.pixels += ctx->tilePixels[i];
+        ctx->binCounts[i] = 0;
+    }
+    ctx->triangleCount = 0;
+
+    ctx->stats.rasterTime += SoftGetTime() - start;
+}
+
+// Copy color buffer to a new image (RGBA8)
+Image LoadImageFromSoftContext(const SoftContext *ctx)
+{
+    Image image = { 0 };
+
+    image.data = malloc(ctx->width*ctx->height*sizeof(Color));
+    memcpy(image.data, ctx->color, ctx->width*ctx->height*sizeof(Color));
+    image.width = ctx->width;
+    image.height = ctx->height;
+    image.mipmaps = 1;
+    image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+
+    return image;
+}
+
+// Get statistics since SoftClear()
+SoftStats GetSoftStats(const SoftContext *ctx)
+{
+    return ctx->stats;
+}
+
+// Push model transform
+void SoftPushMatrix(SoftContext *ctx)
+{
+    if (ctx->stackCounter >= SOFT_MAX_MATRIX_STACK)
+    {
+        TraceLog(LOG_ERROR, "SOFTGL: Matrix stack overflow (SOFT_MAX_MATRIX_STACK)");
+        return;
+    }
+
+    ctx->stack[ctx->stackCounter++] = ctx->transform;
+}
+
+// Pop model transform
+void SoftPopMatrix(SoftContext *ctx)
+{
+    if (ctx->stackCounter > 0) ctx->transform = ctx->stack[--ctx->stackCounter];
+}
+
+// Multiply model transform, same order as rlMultMatrixf()
+void SoftMultMatrix(SoftContext *ctx, Matrix matrix)
+{
+    ctx->transform = MatrixMultiply(matrix, ctx->transform);
+}
+
+// Translate model transform
+void SoftTranslatef(SoftContext *ctx, float x, float y, float z)
+{
+    SoftMultMatrix(ctx, MatrixTranslate(x, y, z));
+}
+
+// Rotate model transform, angle in degrees
+void SoftRotatef(SoftContext *ctx, float angle, float x, float y, float z)
+{
+    SoftMultMatrix(ctx, MatrixRotate((Vector3){ x, y, z }, angle*DEG2RAD));
+}
+
+// Scale model transform
+void SoftScalef(SoftContext *ctx, float x, float y, float z)
+{
+    SoftMultMatrix(ctx, MatrixScale(x, y, z));
+}
+
+// Begin primitives
+void SoftBegin(SoftContext *ctx, int mode)
+{
+    ctx->mode = mode;
+    ctx->vertexCounter = 0;
+    ctx->beginTime = SoftGetTime();
+}
+
+// End primitives, an incomplete primitive is dropped
+void SoftEnd(SoftContext *ctx)
+{
+    ctx->vertexCounter = 0;
+    ctx->stats.setupTime += SoftGetTime() - ctx->beginTime;
+}
+
+// Add vertex with current attributes
+void SoftVertex3f(SoftContext *ctx, float x, float y, float z)
+{
+    int i = ctx->vertexCounter;
+    Matrix m = ctx->transform;
+
+    ctx->positions[i] = Vector3Transform((Vector3){ x, y, z }, m);
+    ctx->normals[i] = ctx->normal;
+    ctx->texcoords[i] = ctx->texcoord;
+    ctx->colors[i] = ctx->vertexColor;
+    ctx->vertexCounter++;
+
+    if ((ctx->mode == RL_QUADS) && (ctx->vertexCounter == 4))
+    {
+        SoftEmitTriangle(ctx, 0, 1, 2);
+        SoftEmitTriangle(ctx, 0, 2, 3);
+        ctx->vertexCounter = 0;
+    }
+    else if ((ctx->mode != RL_QUADS) && (ctx->vertexCounter == 3))
+    {
+        SoftEmitTriangle(ctx, 0, 1, 2);
+        ctx->vertexCounter = 0;
+    }
+}
+
+// Set texcoord for next vertices
+void SoftTexCoord2f(SoftContext *ctx, float u, float v)
+{
+    ctx->texcoord = (Vector2){ u, v };
+}
+
+// Set normal for next vertices, model space
+void SoftNormal3f(SoftContext *ctx, float x, float y, float z)
+{
+    ctx->normal = (Vector3){ x, y, z };
+}
+
+// Set color for next vertices
+void SoftColor4ub(SoftContext *ctx, unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+{
+    ctx->vertexColor = (Color){ r, g, b, a };
+}
+
+// Set texture (RGBA8 image), NULL for white
+void SoftSetTexture(SoftContext *ctx, const Image *image)
+{
+    if ((image != NULL) && (image->format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8))
+    {
+        TraceLog(LOG_WARNING, "SOFTGL: Texture format must be PIXELFORMAT_UNCOMPRESSED_R8G8B8A8");
+        image = NULL;
+    }
+
+    ctx->texture = image;
+}
+
+// Set blend mode, -1 disables blending
+void SoftSetBlendMode(SoftContext *ctx, int mode)
+{
+    ctx->blendMode = mode;
+}
+
+// Set depth test and depth writes
+void SoftSetDepthTest(SoftContext *ctx, bool test, bool write)
+{
+    ctx->depthTest = test;
+    ctx->depthWrite = write;
+}
+
+// Set back face culling (CCW front faces)
+void SoftSetBackfaceCulling(SoftContext *ctx, bool enabled)
+{
+    ctx->backfaceCulling = enabled;
+}
+
+// Set per vertex lighting, vertex colors are used when disabled
+void SoftSetLighting(SoftContext *ctx, bool enabled, SoftLight light, SoftMaterial material)
+{
+    ctx->lighting = enabled;
+    ctx->light = light;
+    ctx->material = material;
+}
+
+// Draw mesh from its CPU arrays
+void SoftDrawMesh(SoftContext *ctx, Mesh mesh, Matrix transform, Color tint)
+{
+    if (mesh.vertices == NULL) return;
+
+    SoftPushMatrix(ctx);
+    SoftMultMatrix(ctx, transform);
+    SoftBegin(ctx, RL_TRIANGLES);
+
+    int count = (mesh.indices != NULL)? mesh.triangleCount*3 : mesh.vertexCount;
+    for (int k = 0; k < count; k++)
+    {
+        int i = (mesh.indices != NULL)? mesh.indices[k] : k;
+
+        if (mesh.normals != NULL) SoftNormal3f(ctx, mesh.normals[3*i], mesh.normals[3*i + 1], mesh.normals[3*i + 2]);
+        if (mesh.texcoords != NULL) SoftTexCoord2f(ctx, mesh.texcoords[2*i], mesh.texcoords[2*i + 1]);
+        if (mesh.colors != NULL)
+        {
+            SoftColor4ub(ctx, mesh.colors[4*i]*tint.r/255, mesh.colors[4*i + 1]*tint.g/255,
+                         mesh.colors[4*i + 2]*tint.b/255, mesh.colors[4*i + 3]*tint.a/255);
+        }
+        else SoftColor4ub(ctx, tint.r, tint.g, tint.b, tint.a);
+
+        SoftVertex3f(ctx, mesh.vertices[3*i], mesh.vertices[3*i + 1], mesh.vertices[3*i + 2]);
+    }
+
+    SoftEnd(ctx);
+    SoftPopMatrix(ctx);
+}
+
+// Draw cube like DrawCube()
+void SoftDrawCube(SoftContext *ctx, Vector3 position, float width, float height, float length, Color color)
+{
+    static const float faces[6][4][3] = {
+        { { -1, -1,  1 }, {  1, -1,  1 }, {  1,  1,  1 }, { -1,  1,  1 } },     // Front
+        { {  1, -1, -1 }, { -1, -1, -1 }, { -1,  1, -1 }, {  1,  1, -1 } },     // Back
+        { { -1,  1,  1 }, {  1,  1,  1 }, {  1,  1, -1 }, { -1,  1, -1 } },     // Top
+        { { -1, -1, -1 }, {  1, -1, -1 }, {  1, -1,  1 }, { -1, -1,  1 } },     // Bottom
+        { {  1, -1,  1 }, {  1, -1, -1 }, {  1,  1, -1 }, {  1,  1,  1 } },     // Right
+        { { -1, -1, -1 }, { -1, -1,  1 }, { -1,  1,  1 }, { -1,  1, -1 } },     // Left
+    };
+    static const float normals[6][3] = { { 0, 0, 1 }, { 0, 0, -1 }, { 0, 1, 0 }, { 0, -1, 0 }, { 1, 0, 0 }, { -1, 0, 0 } };
+
+    SoftPushMatrix(ctx);
+    SoftTranslatef(ctx, position.x, position.y, position.z);
+    SoftBegin(ctx, RL_QUADS);
+    SoftColor4ub(ctx, color.r, color.g, color.b, color.a);
+
+    for (int f = 0; f < 6; f++)
+    {
+        SoftNormal3f(ctx, normals[f][0], normals[f][1], normals[f][2]);
+        for (int k = 0; k < 4; k++)
+        {
+            SoftTexCoord2f(ctx, (k == 1 || k == 2)? 1.0f : 0.0f, (k >= 2)? 0.0f : 1.0f);
+            SoftVertex3f(ctx, faces[f][k][0]*width/2, faces[f][k][1]*height/2, faces[f][k][2]*length/2);
+        }
+    }
+
+    SoftEnd(ctx);
+    SoftPopMatrix(ctx);
+}
+
+// Draw sphere like DrawSphereEx()
+void SoftDrawSphere(SoftContext *ctx, Vector3 center, float radius, int rings, int slices, Color color)
+{
+    SoftPushMatrix(ctx);
+    SoftTranslatef(ctx, center.x, center.y, center.z);
+    SoftBegin(ctx, RL_QUADS);
+    SoftColor4ub(ctx, color.r, color.g, color.b, color.a);
+
+    for (int i = 0; i < rings; i++)
+    {
+        float lat0 = PI*(-0.5f + (float)i/rings);
+        float lat1 = PI*(-0.5f + (float)(i + 1)/rings);
+
+        for (int j = 0; j < slices; j++)
+        {
+            float lon0 = 2*PI*j/slices;
+            float lon1 = 2*PI*(j + 1)/slices;
+
+            // CCW seen from outside
+            float corners[4][2] = { { lat0, lon0 }, { lat0, lon1 }, { lat1, lon1 }, { lat1, lon0 } };
+            for (int k = 0; k < 4; k++)
+            {
+                Vector3 n = { cosf(corners[k][0])*sinf(corners[k][1]), sinf(corners[k][0]), cosf(corners[k][0])*cosf(corners[k][1]) };
+                SoftNormal3f(ctx, n.x, n.y, n.z);
+                SoftTexCoord2f(ctx, corners[k][1]/(2*PI), 0.5f - corners[k][0]/PI);
+                SoftVertex3f(ctx, n.x*radius, n.y*radius, n.z*radius);
+            }
+        }
+    }
+
+    SoftEnd(ctx);
+    SoftPopMatrix(ctx);
+}
+
+// Draw XZ plane like DrawPlane()
+void SoftDrawPlane(SoftContext *ctx, Vector3 center, Vector2 size, Color color)
+{
+    SoftPushMatrix(ctx);
+    SoftTranslatef(ctx, center.x, center.y, center.z);
+    SoftScalef(ctx, size.x, 1.0f, size.y);
+
+    SoftBegin(ctx, RL_QUADS);
+    SoftColor4ub(ctx, color.r, color.g, color.b, color.a);
+    SoftNormal3f(ctx, 0.0f, 1.0f, 0.0f);
+
+    SoftTexCoord2f(ctx, 0.0f, 0.0f); SoftVertex3f(ctx, -0.5f, 0.0f, -0.5f);
+    SoftTexCoord2f(ctx, 0.0f, 1.0f); SoftVertex3f(ctx, -0.5f, 0.0f, 0.5f);
+    SoftTexCoord2f(ctx, 1.0f, 1.0f); SoftVertex3f(ctx, 0.5f, 0.0f, 0.5f);
+    SoftTexCoord2f(ctx, 1.0f, 0.0f); SoftVertex3f(ctx, 0.5f, 0.0f, -0.5f);
+
+    SoftEnd(ctx);
+    SoftPopMatrix(ctx);
+}
+
+// Compare with golden image (written if missing), returns pixels off by more than tolerance
+int CheckSoftGoldenImage(Image image, const char *goldenPath, int tolerance)
+{
+    if (!FileExists(goldenPath))
+    {
+        ExportImage(image, goldenPath);
+        TraceLog(LOG_INFO, "CHECK: [%s] Golden image written", goldenPath);
+        return 0;
+    }
+
+    Image golden = LoadImage(goldenPath);
+    if ((golden.width != image.width) || (golden.height != image.height))
+    {
+        TraceLog(LOG_WARNING, "CHECK: [%s] Size mismatch: %ix%i, golden %ix%i", goldenPath, image.width, image.height, golden.width, golden.height);
+        UnloadImage(golden);
+        return image.width*image.height;
+    }
+
+    Image current = ImageCopy(image);
+    ImageFormat(&golden, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    ImageFormat(&current, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+    const unsigned char *a = (const unsigned char *)current.data;
+    const unsigned char *b = (const unsigned char *)golden.data;
+    int mismatches = 0, maxError = 0;
+
+    for (int i = 0; i < image.width*image.height; i++)
+    {
+        int error = 0;
+        for (int c = 0; c < 4; c++)
+        {
+            int d = abs((int)a[4*i + c] - (int)b[4*i + c]);
+            if (d > error) error = d;
+        }
+        if (error > maxError) maxError = error;
+        if (error > tolerance) mismatches++;
+    }
+
+    if (mismatches == 0) TraceLog(LOG_INFO, "CHECK: [%s] Matches golden image (max channel error %i)", goldenPath, maxError);
+    else TraceLog(LOG_WARNING, "CHECK: [%s] %i pixels off by more than %i (max channel error %i)", goldenPath, mismatches, tolerance, maxError);
+
+    UnloadImage(current);
+    UnloadImage(golden);
+    return mismatches;
+}
+
+// Benchmark rasterizer on a lit scene, 1 thread vs all
+void BenchmarkSoftRaster(int width, int height, int frames)
+{
+    SoftContext ctx = LoadSoftContext(width, height);
+    Camera3D camera = { { 25.0f, 6.0f, 25.0f }, { 0.0f, 3.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, 45.0f, CAMERA_PERSPECTIVE };
+    SoftLight light = { true, { 10.0f, 10.0f, 10.0f }, { 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f } };
+    SoftMaterial material = { { 0.1745f, 0.01175f, 0.01175f }, { 0.61424f, 0.04136f, 0.04136f }, { 0.727811f, 0.626959f, 0.626959f }, 76.8f, 1.0f };
+
+    Image checker = GenImageChecked(64, 64, 8, 8, ORANGE, DARKBLUE);
+    ImageFormat(&checker, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+    int threadCount = GetJobsThreadCount();
+    double times[2] = { 0 };
+    SoftStats stats = { 0 };
+    Image first = { 0 };
+
+    for (int test = 0; test < 2; test++)
+    {
+        InitJobs((test == 0)? 1 : threadCount);
+
+        for (int frame = -1; frame < frames; frame++)
+        {
+            double start = SoftGetTime();
+
+            SoftClear(&ctx, LIGHTGRAY);
+            SoftBeginMode3D(&ctx, camera);
+
+            SoftSetLighting(&ctx, false, light, material);
+            SoftSetTexture(&ctx, &checker);
+            SoftDrawPlane(&ctx, (Vector3){ 0.0f, 0.0f, 0.0f }, (Vector2){ 40.0f, 40.0f }, WHITE);
+            SoftSetTexture(&ctx, NULL);
+
+            // Lit grid like the lab7 stress mode, every fourth object translucent
+            SoftSetLighting(&ctx, true, light, material);
+            for (int i = 0; i < 50*50; i++)
+            {
+                Vector3 position = { -19.6f + 0.8f*(i%50), 0.5f, -19.6f + 0.8f*(i/50) };
+                material.transparency = (i%4 == 3)? 0.5f : 1.0f;
+                SoftSetLighting(&ctx, true, light, material);
+
+                if (i%2 == 0) SoftDrawCube(&ctx, position, 0.4f, 0.4f, 0.4f, WHITE);
+                else SoftDrawSphere(&ctx, position, 0.25f, 8, 8, WHITE);
+            }
+            material.transparency = 1.0f;
+            SoftSetLighting(&ctx, true, light, material);
+            SoftDrawSphere(&ctx, light.position, 2.0f, 16, 16, WHITE);
+            SoftDrawCube(&ctx, (Vector3){ 7.0f, 2.5f, 0.0f }, 5.0f, 5.0f, 5.0f, WHITE);
+
+            SoftEndMode3D(&ctx);
+
+            if (frame >= 0) times[test] += SoftGetTime() - start;
+            if (frame == frames - 1) stats = GetSoftStats(&ctx);
+        }
+
+        if (test == 0) first = LoadImageFromSoftContext(&ctx);
+    }
+
+    // Same pixels whatever the thread count
+    int differences = 0;
+    for (int i = 0; i < width*height; i++)
+    {
+        Color a = ((Color *)first.data)[i], b = ctx.color[i];
+        if ((a.r != b.r) || (a.g != b.g) || (a.b != b.b) || (a.a != b.a)) differences++;
+    }
+
+    TraceLog(LOG_INFO, "BENCH: [%ix%i] %i triangles, %i culled, %i clipped, %i tile refs, %lld pixels", width, height,
+             stats.triangles, stats.culled, stats.clipped, stats.binned, stats.pixels);
+    TraceLog(LOG_INFO, "BENCH: [%ix%i] 1 thread:   %8.3f ms/frame (setup %.3f ms, raster %.3f ms last frame)", width, height,
+             times[0]*1000.0/frames, stats.setupTime*1000.0, stats.rasterTime*1000.0);
+    TraceLog(LOG_INFO, "BENCH: [%ix%i] %2i threads: %8.3f ms/frame (%.1fx, %i pixels differ)", width, height, threadCount,
+             times[1]*1000.0/frames, times[0]/times[1], differences);
+
+    UnloadImage(first);
+    UnloadImage(checker);
+    UnloadSoftContext(&ctx);
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Monotonic time in seconds, works without a window
+static double SoftGetTime(void)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Light, project, clip and bin one triangle of the current primitive
+static void SoftEmitTriangle(SoftContext *ctx, int i0, int i1, int i2)
+{
+    int indices[3] = { i0, i1, i2 };
+    SoftClipVertex in[3];
+
+    ctx->stats.triangles++;
+
+    for (int k = 0; k < 3; k++)
+    {
+        int i = indices[k];
+        in[k] = SoftShadeVertex(ctx, ctx->positions[i], ctx->normals[i], ctx->texcoords[i], ctx->colors[i]);
+    }
+
+    // Near plane (z > -w), the only plane that must be clipped, the rest is bounded by the tiles
+    bool inside[3];
+    int insideCount = 0;
+    for (int k = 0; k < 3; k++)
+    {
+        inside[k] = (in[k].clip.z > -in[k].clip.w) && (in[k].clip.w > SOFT_NEAR_EPSILON);
+        insideCount += inside[k];
+    }
+
+    if (insideCount == 3) SoftSetupTriangle(ctx, &in[0], &in[1], &in[2]);
+    else if (insideCount == 0) ctx->stats.culled++;
+    else
+    {
+        SoftClipVertex out[4];
+        int outCount = 0;
+
+        for (int k = 0; k < 3; k++)
+        {
+            const SoftClipVertex *a = &in[k], *b = &in[(k + 1)%3];
+            if (inside[k]) out[outCount++] = *a;
+            if (inside[k] != inside[(k + 1)%3])
+            {
+                float da = a->clip.z + a->clip.w, db = b->clip.z + b->clip.w;
+                out[outCount++] = SoftLerpVertex(*a, *b, da/(da - db));
+            }
+        }
+
+        ctx->stats.clipped++;
+        for (int k = 1; k + 1 < outCount; k++) SoftSetupTriangle(ctx, &out[0], &out[k], &out[k + 1]);
+    }
+}
+
+// Vertex stage: lighting (lab7 Phong per vertex) and projection
+static SoftClipVertex SoftShadeVertex(const SoftContext *ctx, Vector3 position, Vector3 normal, Vector2 texcoord, Color color)
+{
+    SoftClipVertex out;
+    Vector3 rgb = { color.r/255.0f, color.g/255.0f, color.b/255.0f };
+    float alpha = color.a/255.0f;
+
+    if (ctx->lighting)
+    {
+        const SoftLight *light = &ctx->light;
+        const SoftMaterial *material = &ctx->material;
+        Matrix m = ctx->transform;
+        Vector3 n = Vector3Normalize((Vector3){ m.m0*normal.x + m.m4*normal.y + m.m8*normal.z,
+                                                m.m1*normal.x + m.m5*normal.y + m.m9*normal.z,
+                                                m.m2*normal.x + m.m6*normal.y + m.m10*normal.z });
+
+        Vector3 result = Vector3Multiply(light->ambient, material->ambient);
+        if (light->enabled)
+        {
+            Vector3 lightDir = Vector3Normalize(Vector3Subtract(light->position, position));
+            Vector3 viewDir = Vector3Normalize(Vector3Subtract(ctx->viewPosition, position));
+            float diff = fmaxf(Vector3DotProduct(n, lightDir), 0.0f);
+            Vector3 reflectDir = Vector3Reflect(Vector3Negate(lightDir), n);
+            float spec = powf(fmaxf(Vector3DotProduct(viewDir, reflectDir), 0.0f), material->shininess);
+
+            result = Vector3Add(result, Vector3Scale(Vector3Multiply(light->diffuse, material->diffuse), diff));
+            result = Vector3Add(result, Vector3Scale(Vector3Multiply(light->specular, material->specular), spec));
+        }
+
+        rgb = Vector3Multiply(rgb, result);
+        alpha *= material->transparency;
+    }
+
+    Matrix vp = ctx->viewProjection;
+    out.clip = (Vector4){ vp.m0*position.x + vp.m4*position.y + vp.m8*position.z + vp.m12,
+                          vp.m1*position.x + vp.m5*position.y + vp.m9*position.z + vp.m13,
+                          vp.m2*position.x + vp.m6*position.y + vp.m10*position.z + vp.m14,
+                          vp.m3*position.x + vp.m7*position.y + vp.m11*position.z + vp.m15 };
+    out.u = texcoord.x;
+    out.v = texcoord.y;
+    out.c[0] = Clamp(rgb.x, 0.0f, 1.0f);
+    out.c[1] = Clamp(rgb.y, 0.0f, 1.0f);
+    out.c[2] = Clamp(rgb.z, 0.0f, 1.0f);
+    out.c[3] = Clamp(alpha, 0.0f, 1.0f);
+
+    return out;
+}
+
+// Clip space interpolation for near plane clipping
+static SoftClipVertex SoftLerpVertex(SoftClipVertex a, SoftClipVertex b, float t)
+{
+    SoftClipVertex out;
+
+    out.clip = (Vector4){ a.clip.x + (b.clip.x - a.clip.x)*t, a.clip.y + (b.clip.y - a.clip.y)*t,
+                          a.clip.z + (b.clip.z - a.clip.z)*t, a.clip.w + (b.clip.w - a.clip.w)*t };
+    out.u = a.u + (b.u - a.u)*t;
+    out.v = a.v + (b.v - a.v)*t;
+    for (int c = 0; c < 4; c++) out.c[c] = a.c[c] + (b.c[c] - a.c[c])*t;
+
+    return out;
+}
+
+// Perspective divide, viewport, culling and binning
+static void SoftSetupTriangle(SoftContext *ctx, const SoftClipVertex *a, const SoftClipVertex *b, const SoftClipVertex *c)
+{
+    const SoftClipVertex *v[3] = { a, b, c };
+    SoftTriangle tri;
+
+    for (int k = 0; k < 3; k++)
+    {
+        float invW = 1.0f/v[k]->clip.w;
+        tri.x[k] = (v[k]->clip.x*invW*0.5f + 0.5f)*ctx->width;
+        tri.y[k] = (0.5f - v[k]->clip.y*invW*0.5f)*ctx->height;
+        tri.z[k] = v[k]->clip.z*invW*0.5f + 0.5f;
+        tri.w[k] = invW;
+        tri.u[k] = v[k]->u*invW;
+        tri.v[k] = v[k]->v*invW;
+        for (int i = 0; i < 4; i++) tri.c[k][i] = v[k]->c[i]*invW;
+    }
+
+    // Screen y goes down: counter-clockwise front faces have negative area here
+    float area = (tri.x[1] - tri.x[0])*(tri.y[2] - tri.y[0]) - (tri.x[2] - tri.x[0])*(tri.y[1] - tri.y[0]);
+    if ((area == 0.0f) || (ctx->backfaceCulling && (area > 0.0f)))
+    {
+        ctx->stats.culled++;
+        return;
+    }
+
+    // Rasterizer expects positive area, swap two vertices otherwise
+    if (area < 0.0f)
+    {
+        float *fields[6] = { tri.x, tri.y, tri.z, tri.w, tri.u, tri.v };
+        for (int f = 0; f < 6; f++) { float t = fields[f][1]; fields[f][1] = fields[f][2]; fields[f][2] = t; }
+        for (int i = 0; i < 4; i++) { float t = tri.c[1][i]; tri.c[1][i] = tri.c[2][i]; tri.c[2][i] = t; }
+    }
+
+    // Pixel centers at +0.5 covered by the bounds
+    float minX = fminf(tri.x[0], fminf(tri.x[1], tri.x[2]));
+    float maxX = fmaxf(tri.x[0], fmaxf(tri.x[1], tri.x[2]));
+    float minY = fminf(tri.y[0], fminf(tri.y[1], tri.y[2]));
+    float maxY = fmaxf(tri.y[0], fmaxf(tri.y[1], tri.y[2]));
+
+    tri.minX = (int)fmaxf(ceilf(minX - 0.5f), 0.0f);
+    tri.minY = (int)fmaxf(ceilf(minY - 0.5f), 0.0f);
+    tri.maxX = (int)fminf(floorf(maxX - 0.5f), (float)(ctx->width - 1));
+    tri.maxY = (int)fminf(floorf(maxY - 0.5f), (float)(ctx->height - 1));
+    if ((tri.minX > tri.maxX) || (tri.minY > tri.maxY))
+    {
+        ctx->stats.culled++;
+        return;
+    }
+
+    tri.texture = ctx->texture;
+    tri.blendMode = ctx->blendMode;
+    tri.depthWrite = ctx->depthWrite;
+    if (!ctx->depthTest)
+    {
+        tri.z[0] = tri.z[1] = tri.z[2] = -1.0f;     // Always passes, no writes like glDisable(GL_DEPTH_TEST)
+        tri.depthWrite = false;
+    }
+
+    if (ctx->triangleCount >= ctx->triangleCapacity)
+    {
+        ctx->triangleCapacity = (ctx->triangleCapacity == 0)? 4096 : 2*ctx->triangleCapacity;
+        ctx->triangles = (SoftTriangle *)realloc(ctx->triangles, ctx->triangleCapacity*sizeof(SoftTriangle));
+    }
+    int index = ctx->triangleCount++;
+    ctx->triangles[index] = tri;
+
+    for (int ty = tri.minY/SOFT_TILE_SIZE; ty <= tri.maxY/SOFT_TILE_SIZE; ty++)
+    {
+        for (int tx = tri.minX/SOFT_TILE_SIZE; tx <= tri.maxX/SOFT_TILE_SIZE; tx++)
+        {
+            int tile = ty*ctx->tilesX + tx;
+            if (ctx->binCounts[tile] >= ctx->binCapacities[tile])
+            {
+                ctx->binCapacities[tile] = (ctx->binCapacities[tile] == 0)? 256 : 2*ctx->binCapacities[tile];
+                ctx->bins[tile] = (int *)realloc(ctx->bins[tile], ctx->binCapacities[tile]*sizeof(int));
+            }
+            ctx->bins[tile][ctx->binCounts[tile]++] = index;
+            ctx->stats.binned++;
+        }
+    }
+}
+
+// Job: rasterize tiles [begin, end), each tile in submission order
+static void SoftRasterTiles(int begin, int end, void *userData)
+{
+    SoftContext *ctx = (SoftContext *)userData;
+
+    for (int tile = begin; tile < end; tile++)
+    {
+        int tileX = tile%ctx->tilesX, tileY = tile/ctx->tilesX;
+        ctx->tilePixels[tile] = 0;
+        for (int i = 0; i < ctx->binCounts[tile]; i++) SoftRasterTriangle(ctx, &ctx->triangles[ctx->bins[tile][i]], tileX, tileY, &ctx->tilePixels[tile]);
+    }
+}
+
+// Coverage of one triangle inside one tile, 4 pixels per step
+static void SoftRasterTriangle(SoftContext *ctx, const SoftTriangle *tri, int tileX, int tileY, long long *pixels)
+{
+    int x0 = tileX*SOFT_TILE_SIZE, y0 = tileY*SOFT_TILE_SIZE;
+    int minX = (tri->minX > x0)? tri->minX : x0;
+    int minY = (tri->minY > y0)? tri->minY : y0;
+    int maxX = (tri->maxX < x0 + SOFT_TILE_SIZE - 1)? tri->maxX : x0 + SOFT_TILE_SIZE - 1;
+    int maxY = (tri->maxY < y0 + SOFT_TILE_SIZE - 1)? tri->maxY : y0 + SOFT_TILE_SIZE - 1;
+    if ((minX > maxX) || (minY > maxY)) return;
+
+    // Edge k is opposite to vertex k: E(p) = A*px + B*py + C, positive inside
+    float A[3], B[3], C[3];
+    bool topLeft[3];
+    for (int k = 0; k < 3; k++)
+    {
+        int i = (k + 1)%3, j = (k + 2)%3;
+        A[k] = tri->y[i] - tri->y[j];
+        B[k] = tri->x[j] - tri->x[i];
+        C[k] = tri->x[i]*tri->y[j] - tri->x[j]*tri->y[i];
+        topLeft[k] = (A[k] > 0.0f) || ((A[k] == 0.0f) && (B[k] < 0.0f));    // Pixels on shared edges go to one triangle only
+    }
+    float area = C[0] + C[1] + C[2];
+    float invArea = 1.0f/area;
+
+    minX &= ~3;     // Aligned 4 pixel steps, lanes outside bounds are masked out
+
+#if defined(RSOFTGL_SSE2)
+    __m128 a[3], b[3], c[3];
+    for (int k = 0; k < 3; k++) { a[k] = _mm_set1_ps(A[k]); b[k] = _mm_set1_ps(B[k]); c[k] = _mm_set1_ps(C[k]); }
+    __m128 zero = _mm_setzero_ps();
+    __m128 lane = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+
+    for (int py = minY; py <= maxY; py++)
+    {
+        __m128 y = _mm_set1_ps(py + 0.5f);
+
+        for (int px = minX; px <= maxX; px += 4)
+        {
+            __m128 x = _mm_add_ps(_mm_set1_ps((float)px), lane);
+            __m128 e[3];
+            int mask = 0xf;
+
+            for (int k = 0; k < 3; k++)
+            {
+                e[k] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a[k], x), _mm_mul_ps(b[k], y)), c[k]);
+                mask &= _mm_movemask_ps(topLeft[k]? _mm_cmpge_ps(e[k], zero) : _mm_cmpgt_ps(e[k], zero));
+            }
+            if (mask == 0) continue;
+
+            float w[3][4];
+            for (int k = 0; k < 3; k++) _mm_storeu_ps(w[k], e[k]);
+
+            for (int l = 0; l < 4; l++)
+            {
+                if (!(mask & (1 << l)) || (px + l < tri->minX) || (px + l > maxX)) continue;
+                SoftShadePixel(ctx, tri, px + l, py, w[0][l]*invArea, w[1][l]*invArea, w[2][l]*invArea);
+                (*pixels)++;
+            }
+        }
+    }
+#else
+    for (int py = minY; py <= maxY; py++)
+    {
+        float y = py + 0.5f;
+
+        for (int px = minX; px <= maxX; px += 4)
+        {
+            for (int l = 0; l < 4; l++)
+            {
+                if ((px + l < tri->minX) || (px + l > maxX)) continue;
+
+                float x = (float)px + (l + 0.5f);
+                float w[3];
+                bool inside = true;
+                for (int k = 0; k < 3; k++)
+                {
+                    w[k] = A[k]*x + B[k]*y + C[k];
+                    inside = inside && (topLeft[k]? (w[k] >= 0.0f) : (w[k] > 0.0f));
+                }
+                if (!inside) continue;
+
+                SoftShadePixel(ctx, tri, px + l, py, w[0]*invArea, w[1]*invArea, w[2]*invArea);
+                (*pixels)++;
+            }
+        }
+    }
+#endif
+}
+
+// Depth test, interpolation, texture, blending for one covered pixel
+static void SoftShadePixel(SoftContext *ctx, const SoftTriangle *tri, int px, int py, float b0, float b1, float b2)
+{
+    int index = py*ctx->width + px;
+
+    float z = tri->z[0]*b0 + tri->z[1]*b1 + tri->z[2]*b2;
+    if (z > ctx->depth[index]) return;
+
+    // Perspective correct: attributes/w interpolate linearly in screen space
+    float invW = tri->w[0]*b0 + tri->w[1]*b1 + tri->w[2]*b2;
+    float w = 1.0f/invW;
+    float color[4];
+    for (int i = 0; i < 4; i++) color[i] = (tri->c[0][i]*b0 + tri->c[1][i]*b1 + tri->c[2][i]*b2)*w;
+
+    if (tri->texture != NULL)
+    {
+        const Image *texture = tri->texture;
+        float u = (tri->u[0]*b0 + tri->u[1]*b1 + tri->u[2]*b2)*w;
+        float v = (tri->v[0]*b0 + tri->v[1]*b1 + tri->v[2]*b2)*w;
+        int tx = (int)floorf((u - floorf(u))*texture->width);
+        int ty = (int)floorf((v - floorf(v))*texture->height);
+        if (tx >= texture->width) tx = texture->width - 1;
+        if (ty >= texture->height) ty = texture->height - 1;
+
+        Color texel = ((const Color *)texture->data)[ty*texture->width + tx];
+        color[0] *= texel.r/255.0f;
+        color[1] *= texel.g/255.0f;
+        color[2] *= texel.b/255.0f;
+        color[3] *= texel.a/255.0f;
+    }
+
+    Color *target = &ctx->color[index];
+    float dst[4] = { target->r/255.0f, target->g/255.0f, target->b/255.0f, target->a/255.0f };
+    float out[4];
+
+    switch (tri->blendMode)
+    {
+        case BLEND_ALPHA:
+        {
+            for (int i = 0; i < 3; i++) out[i] = color[i]*color[3] + dst[i]*(1.0f - color[3]);
+            out[3] = color[3] + dst[3]*(1.0f - color[3]);
+        } break;
+        case BLEND_ADDITIVE:
+        {
+            for (int i = 0; i < 3; i++) out[i] = color[i]*color[3] + dst[i];
+            out[3] = color[3] + dst[3];
+        } break;
+        case BLEND_MULTIPLIED:
+        {
+            for (int i = 0; i < 3; i++) out[i] = color[i]*dst[i] + dst[i]*(1.0f - color[3]);
+            out[3] = color[3]*dst[3] + dst[3]*(1.0f - color[3]);
+        } break;
+        default:
+        {
+            for (int i = 0; i < 4; i++) out[i] = color[i];
+        } break;
+    }
+
+    target->r = (unsigned char)(Clamp(out[0], 0.0f, 1.0f)*255.0f + 0.5f);
+    target->g = (unsigned char)(Clamp(out[1], 0.0f, 1.0f)*255.0f + 0.5f);
+    target->b = (unsigned char)(Clamp(out[2], 0.0f, 1.0f)*255.0f + 0.5f);
+    target->a = (unsigned char)(Clamp(out[3], 0.0f, 1.0f)*255.0f + 0.5f);
+
+    if (tri->depthWrite) ctx->depth[index] = z;
+}
+
+#endif // RSOFTGL_IMPLEMENTATION
@@ -0,0 +1,344 @@
+/**********************************************************************************************
+*
+*   raylib.sort - Back to front depth sorting for transparent objects
+*
+*   DESCRIPTION:
+*       Objects are ordered farthest first by squared distance to the view position.
+*       Full sorts are a stable LSD radix sort on the float key bits, four 8-bit passes,
+*       passes where all keys share the same byte are skipped.
+*       As the order barely changes between frames, UpdateDepthSort() starts from the
+*       previous order and fixes it with insertion sort, falling back to the radix sort
+*       when too many objects moved.
+*
+*   CONFIGURATION:
+*
+*   #define RSORT_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+**********************************************************************************************/
+
+#ifndef RSORT_H
+#define RSORT_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#define DEPTH_SORT_MAX_SHIFTS   4       // Insertion pass gives up after count*4 moves
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Depth order kept between frames
+typedef struct {
+    int count;
+    int capacity;
+    int *order;                     // Object indices, farthest first
+    unsigned int *keys;             // Sort key per object index, smaller is farther
+    unsigned long long *items;      // Radix sort items: key << 32 | index
+    unsigned long long *temp;       // Radix sort scratch
+
+    int radixSorts;                 // Full sorts done
+    int incrementalSorts;           // Insertion sorts done
+} DepthSort;
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+const int *UpdateDepthSort(DepthSort *sort, const Vector3 *positions, int count, Vector3 viewPos);  // Sort starting from last order, returns indices farthest first
+const int *RadixDepthSort(DepthSort *sort, const Vector3 *positions, int count, Vector3 viewPos);   // Full radix sort, returns indices farthest first
+void UnloadDepthSort(DepthSort *sort);                                                              // Unload sort buffers
+int CheckDepthSort(const DepthSort *sort);                                                          // Count neighbours out of back to front order
+void BenchmarkDepthSort(int count, int frames);                                                     // Compare qsort, radix and incremental sorts and log results
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RSORT_H
+
+
+/***********************************************************************************
+*
+*   RSORT IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RSORT_IMPLEMENTATION)
+
+#include "raymath.h"
+
+#include <stdlib.h>             // Required for: realloc(), free(), qsort(), rand()
+#include <string.h>             // Required for: memset(), memcpy()
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Declaration
+//----------------------------------------------------------------------------------
+static void ReserveDepthSort(DepthSort *sort, int count);
+static void ComputeDepthKeys(DepthSort *sort, const Vector3 *positions, int count, Vector3 viewPos);
+static void RadixSortKeys(DepthSort *sort);
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Sort starting from last order, returns indices farthest first
+// NOTE: A changed object count forces a full sort
+const int *UpdateDepthSort(DepthSort *sort, const Vector3 *positions, int count, Vector3 viewPos)
+{
+    if ((count != sort->count) || (sort->order == NULL)) return RadixDepthSort(sort, positions, count, viewPos);
+
+    ComputeDepthKeys(sort, positions, count, viewPos);
+
+    int *order = sort->order;
+    const unsigned int *keys = sort->keys;
+    int maxShifts = count*DEPTH_SORT_MAX_SHIFTS;
+    int shifts = 0;
+
+    for (int i = 1; i < count; i++)
+    {
+        int index = order[i];
+        unsigned int key = keys[index];
+        int j = i - 1;
+
+        while ((j >= 0) && (keys[order[j]] > key))
+        {
+            order[j + 1] = order[j];
+            j--;
+        }
+        order[j + 1] = index;
+
+        shifts += i - 1 - j;
+        if (shifts > maxShifts)
+        {
+            // Order changed too much, partial result is dropped
+            RadixSortKeys(sort);
+            return sort->order;
+        }
+    }
+
+    sort->incrementalSorts++;
+
+    return sort->order;
+}
+
+// Full radix sort, returns indices farthest first
+const int *RadixDepthSort(DepthSort *sort, const Vector3 *positions, int count, Vector3 viewPos)
+{
+    ReserveDepthSort(sort, count);
+    sort->count = count;
+
+    ComputeDepthKeys(sort, positions, count, viewPos);
+    RadixSortKeys(sort);
+
+    return sort->order;
+}
+
+// Unload sort buffers
+void UnloadDepthSort(DepthSort *sort)
+{
+    free(sort->order);
+    free(sort->keys);
+    free(sort->items);
+    free(sort->temp);
+
+    memset(sort, 0, sizeof(DepthSort));
+}
+
+// Count neighbours out of back to front order
+int CheckDepthSort(const DepthSort *sort)
+{
+    int errors = 0;
+
+    for (int i = 1; i < sort->count; i++)
+    {
+        if (sort->keys[sort->order[i - 1]] > sort->keys[sort->order[i]]) errors++;
+    }
+
+    return errors;
+}
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+static void ReserveDepthSort(DepthSort *sort, int count)
+{
+    if (count <= sort->capacity) return;
+
+    sort->capacity = count;
+    sort->order = (int *)realloc(sort->order, count*sizeof(int));
+    sort->keys = (unsigned int *)realloc(sort->keys, count*sizeof(unsigned int));
+    sort->items = (unsigned long long *)realloc(sort->items, count*sizeof(unsigned long long));
+    sort->temp = (unsigned long long *)realloc(sort->temp, count*sizeof(unsigned long long));
+}
+
+// Float bits as an unsigned key in ascending order, inverted so the farthest comes first
+// NOTE: Squared distance avoids sqrtf() and keeps the same order
+static void ComputeDepthKeys(DepthSort *sort, const Vector3 *positions, int count, Vector3 viewPos)
+{
+    for (int i = 0; i < count; i++)
+    {
+        float distance = Vector3DistanceSqr(positions[i], viewPos);
+
+        unsigned int bits = 0;
+        memcpy(&bits, &distance, sizeof(float));
+        bits ^= (bits & 0x80000000u)? 0xffffffffu : 0x80000000u;
+
+        sort->keys[i] = ~bits;
+    }
+}
+
+// Stable LSD radix sort of the current keys into order, equal keys keep index order
+static void RadixSortKeys(DepthSort *sort)
+{
+    int count = sort->count;
+    unsigned long long *items = sort->items;
+    unsigned long long *temp = sort->temp;
+
+    sort->radixSorts++;
+    if (count <= 0) return;     // Nothing reserved, items is NULL
+
+    for (int i = 0; i < count; i++) items[i] = ((unsigned long long)sort->keys[i] << 32) | (unsigned int)i;
+
+    for (int shift = 32; shift < 64; shift += 8)
+    {
+        int histogram[256] = { 0 };
+        for (int i = 0; i < count; i++) histogram[(items[i] >> shift) & 0xff]++;
+
+        // All keys share this byte, order would not change
+        if (histogram[(items[0] >> shift) & 0xff] == count) continue;
+
+        int offset = 0;
+        for (int b = 0; b < 256; b++)
+        {
+            int size = histogram[b];
+            histogram[b] = offset;
+            offset += size;
+        }
+
+        for (int i = 0; i < count; i++) temp[histogram[(items[i] >> shift) & 0xff]++] = items[i];
+
+        unsigned long long *swap = items;
+        items = temp;
+        temp = swap;
+    }
+
+    for (int i = 0; i < count; i++) sort->order[i] = (int)(items[i] & 0xffffffffu);
+}
+
+//----------------------------------------------------------------------------------
+// Benchmark
+//----------------------------------------------------------------------------------
+
+typedef struct {
+    Vector3 position;
+    float viewDistance;
+} DepthSortBenchObject;
+
+// Previous lab7 comparator, the int cast merges distances closer than 1.0
+static int DepthSortBenchCompare(const void *l, const void *r)
+{
+    return (int)(((DepthSortBenchObject *)r)->viewDistance - ((DepthSortBenchObject *)l)->viewDistance);
+}
+
+// Count neighbours out of back to front order in a qsort result
+static int CheckDepthSortBench(const DepthSortBenchObject *objects, int count)
+{
+    int errors = 0;
+    for (int i = 1; i < count; i++) if (objects[i - 1].viewDistance < objects[i].viewDistance) errors++;
+    return errors;
+}
+
+// Compare qsort, radix and incremental sorts and log results
+// NOTE: Camera orbits the objects a little every frame
+void BenchmarkDepthSort(int count, int frames)
+{
+    // Near-equal distances: 0.01 apart, all of them within 1.0 of each other
+    {
+        const int nearCount = 64;
+        DepthSortBenchObject nearObjects[64];
+        Vector3 nearPositions[64];
+
+        for (int i = 0; i < nearCount; i++)
+        {
+            int k = (i*37)%nearCount;     // Shuffled
+            nearPositions[i] = (Vector3){ 10.0f + 0.01f*k, 0.0f, 0.0f };
+            nearObjects[i].position = nearPositions[i];
+            nearObjects[i].viewDistance = Vector3Distance(nearPositions[i], Vector3Zero());
+        }
+
+        qsort(nearObjects, nearCount, sizeof(DepthSortBenchObject), DepthSortBenchCompare);
+
+        DepthSort nearSort = { 0 };
+        RadixDepthSort(&nearSort, nearPositions, nearCount, Vector3Zero());
+        int radixErrors = CheckDepthSort(&nearSort);
+
+        // Swap neighbours by 0.01, small enough for the insertion pass
+        for (int i = 0; i < nearCount; i++) nearPositions[i].x += (((int)(nearPositions[i].x*100.0f + 0.5f))%2 == 0)? 0.01f : -0.01f;
+        UpdateDepthSort(&nearSort, nearPositions, nearCount, Vector3Zero());
+        int incrementalErrors = CheckDepthSort(&nearSort) + ((nearSort.incrementalSorts == 1)? 0 : 1);
+        UnloadDepthSort(&nearSort);
+
+        TraceLog((radixErrors + incrementalErrors == 0)? LOG_INFO : LOG_WARNING,
+                 "BENCH: [depthsort] near-equal distances: qsort %i, radix %i, incremental %i misordered of %i",
+                 CheckDepthSortBench(nearObjects, nearCount), radixErrors, incrementalErrors, nearCount - 1);
+    }
+
+    Vector3 *positions = (Vector3 *)malloc(count*sizeof(Vector3));
+    DepthSortBenchObject *objects = (DepthSortBenchObject *)malloc(count*sizeof(DepthSortBenchObject));
+
+    srand(1);
+    for (int i = 0; i < count; i++)
+    {
+        positions[i] = (Vector3){ (rand()%20000)/100.0f - 100.0f, (rand()%2000)/100.0f, (rand()%20000)/100.0f - 100.0f };
+        objects[i].position = positions[i];
+    }
+
+    DepthSort radix = { 0 };
+    DepthSort incremental = { 0 };
+    double qsortTime = 0.0, radixTime = 0.0, incrementalTime = 0.0;
+    int errors = 0;
+
+    for (int frame = 0; frame < frames; frame++)
+    {
+        float angle = 0.002f*frame;
+        Vector3 viewPos = { 150.0f*cosf(angle), 10.0f, 150.0f*sinf(angle) };
+
+        double start = GetTime();
+        for (int i = 0; i < count; i++) objects[i].viewDistance = Vector3Distance(viewPos, objects[i].position);
+        qsort(objects, count, sizeof(DepthSortBenchObject), DepthSortBenchCompare);
+        qsortTime += GetTime() - start;
+
+        start = GetTime();
+        RadixDepthSort(&radix, positions, count, viewPos);
+        radixTime += GetTime() - start;
+
+        start = GetTime();
+        UpdateDepthSort(&incremental, positions, count, viewPos);
+        incrementalTime += GetTime() - start;
+
+        errors += CheckDepthSort(&radix) + CheckDepthSort(&incremental);
+    }
+
+    TraceLog(LOG_INFO, "BENCH: [depthsort] %i objects, %i frames, %i misordered", count, frames, errors);
+    TraceLog(LOG_INFO, "BENCH: [depthsort] qsort:       %8.3f ms/frame", qsortTime*1000.0/frames);
+    TraceLog(LOG_INFO, "BENCH: [depthsort] radix:       %8.3f ms/frame (%.1fx)", radixTime*1000.0/frames, qsortTime/radixTime);
+    TraceLog(LOG_INFO, "BENCH: [depthsort] incremental: %8.3f ms/frame (%.1fx, %i of %i frames fell back to radix)",
+             incrementalTime*1000.0/frames, qsortTime/incrementalTime, incremental.radixSorts - 1, frames);
+
+    UnloadDepthSort(&radix);
+    UnloadDepthSort(&incremental);
+    free(positions);
+    free(objects);
+}
+
+#endif // RSORT_IMPLEMENTATION
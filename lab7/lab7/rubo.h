@@ -0,0 +1,254 @@
+/**********************************************************************************************
+*
+*   raylib.ubo - Uniform buffer objects (std140 uniform blocks) and shader storage buffers
+*
+*   DESCRIPTION:
+*       rlgl has no uniform buffer calls, so this module loads the few GL 3.1 entry points
+*       it needs through glfwGetProcAddress() on first use. A buffer is bound to a binding
+*       point, and a shader uniform block is pointed at the same binding point, so a whole
+*       block of values goes up with one UpdateUniformBuffer() call.
+*       Shader storage buffers (std430 buffer blocks, OpenGL 4.3) work the same way with the
+*       *StorageBuffer() calls, for arrays too big or too variable for a uniform block.
+*
+*       C structs mirroring a block must follow std140 layout: vec3 and vec4 members are
+*       16-byte aligned, a vec3 may be followed by one float or int in the same 16 bytes,
+*       and every array element is padded to 16 bytes.
+*
+*   CONFIGURATION:
+*
+*   #define RUBO_IMPLEMENTATION
+*       Generates the implementation of the library into the included file.
+*       If not defined, the library is in header only mode and can be included in other headers
+*       or source files without problems. But only ONE file should hold the implementation.
+*
+*   NOTE: Requires OpenGL 3.1 or later, the lab shaders are #version 330 and up
+*
+**********************************************************************************************/
+
+#ifndef RUBO_H
+#define RUBO_H
+
+#include "raylib.h"
+
+#ifdef __cplusplus
+extern "C" {            // Prevents name mangling of functions
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+unsigned int LoadUniformBuffer(const void *data, int size);                     // Load uniform buffer, data can be NULL (returns 0 on failure)
+void UpdateUniformBuffer(unsigned int id, const void *data, int size, int offset); // Update uniform buffer data
+void BindUniformBuffer(unsigned int id, int bindingPoint);                      // Bind uniform buffer to binding point
+void UnloadUniformBuffer(unsigned int id);                                      // Unload uniform buffer
+bool SetShaderUniformBlock(Shader shader, const char *blockName, int bindingPoint); // Point shader uniform block at binding point, false if block not found
+
+unsigned int LoadStorageBuffer(const void *data, int size);                     // Load shader storage buffer, data can be NULL (returns 0 on failure)
+void UpdateStorageBuffer(unsigned int id, const void *data, int size, int offset); // Update shader storage buffer data
+void BindStorageBuffer(unsigned int id, int bindingPoint);                      // Bind shader storage buffer to binding point
+void UnloadStorageBuffer(unsigned int id);                                      // Unload shader storage buffer
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RUBO_H
+
+
+/***********************************************************************************
+*
+*   RUBO IMPLEMENTATION
+*
+************************************************************************************/
+
+#if defined(RUBO_IMPLEMENTATION) && !defined(RUBO_IMPLEMENTATION_DEFINED)
+#define RUBO_IMPLEMENTATION_DEFINED     // Other modules include this header too
+
+#include <stddef.h>             // Required for: ptrdiff_t
+
+//----------------------------------------------------------------------------------
+// Defines and Macros
+//----------------------------------------------------------------------------------
+#if defined(_WIN32) && !defined(_WIN64)
+    #define RUBO_APIENTRY __stdcall
+#else
+    #define RUBO_APIENTRY
+#endif
+
+#define RUBO_GL_UNIFORM_BUFFER      0x8A11
+#define RUBO_GL_SHADER_STORAGE_BUFFER   0x90D2
+#define RUBO_GL_DYNAMIC_DRAW        0x88E8
+#define RUBO_GL_INVALID_INDEX       0xFFFFFFFFu
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef void (*RuboGLProc)(void);
+
+typedef void (RUBO_APIENTRY *RuboGenBuffersProc)(int n, unsigned int *buffers);
+typedef void (RUBO_APIENTRY *RuboDeleteBuffersProc)(int n, const unsigned int *buffers);
+typedef void (RUBO_APIENTRY *RuboBindBufferProc)(unsigned int target, unsigned int buffer);
+typedef void (RUBO_APIENTRY *RuboBufferDataProc)(unsigned int target, ptrdiff_t size, const void *data, unsigned int usage);
+typedef void (RUBO_APIENTRY *RuboBufferSubDataProc)(unsigned int target, ptrdiff_t offset, ptrdiff_t size, const void *data);
+typedef void (RUBO_APIENTRY *RuboBindBufferBaseProc)(unsigned int target, unsigned int index, unsigned int buffer);
+typedef unsigned int (RUBO_APIENTRY *RuboGetUniformBlockIndexProc)(unsigned int program, const char *name);
+typedef void (RUBO_APIENTRY *RuboUniformBlockBindingProc)(unsigned int program, unsigned int blockIndex, unsigned int binding);
+
+#ifdef __cplusplus
+extern "C" RuboGLProc glfwGetProcAddress(const char *procname);    // Provided by GLFW inside raylib
+#else
+RuboGLProc glfwGetProcAddress(const char *procname);
+#endif
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static RuboGenBuffersProc uboGenBuffers = NULL;
+static RuboDeleteBuffersProc uboDeleteBuffers = NULL;
+static RuboBindBufferProc uboBindBuffer = NULL;
+static RuboBufferDataProc uboBufferData = NULL;
+static RuboBufferSubDataProc uboBufferSubData = NULL;
+static RuboBindBufferBaseProc uboBindBufferBase = NULL;
+static RuboGetUniformBlockIndexProc uboGetUniformBlockIndex = NULL;
+static RuboUniformBlockBindingProc uboUniformBlockBinding = NULL;
+static int uboState = 0;        // 0: not loaded, 1: ready, -1: not supported
+
+//----------------------------------------------------------------------------------
+// Module specific Functions Definition
+//----------------------------------------------------------------------------------
+
+// Load GL entry points, needs a current context (after InitWindow())
+static bool LoadUniformBufferFunctions(void)
+{
+    if (uboState != 0) return (uboState == 1);
+
+    uboGenBuffers = (RuboGenBuffersProc)glfwGetProcAddress("glGenBuffers");
+    uboDeleteBuffers = (RuboDeleteBuffersProc)glfwGetProcAddress("glDeleteBuffers");
+    uboBindBuffer = (RuboBindBufferProc)glfwGetProcAddress("glBindBuffer");
+    uboBufferData = (RuboBufferDataProc)glfwGetProcAddress("glBufferData");
+    uboBufferSubData = (RuboBufferSubDataProc)glfwGetProcAddress("glBufferSubData");
+    uboBindBufferBase = (RuboBindBufferBaseProc)glfwGetProcAddress("glBindBufferBase");
+    uboGetUniformBlockIndex = (RuboGetUniformBlockIndexProc)glfwGetProcAddress("glGetUniformBlockIndex");
+    uboUniformBlockBinding = (RuboUniformBlockBindingProc)glfwGetProcAddress("glUniformBlockBinding");
+
+    bool ready = (uboGenBuffers != NULL) && (uboDeleteBuffers != NULL) && (uboBindBuffer != NULL) &&
+                 (uboBufferData != NULL) && (uboBufferSubData != NULL) && (uboBindBufferBase != NULL) &&
+                 (uboGetUniformBlockIndex != NULL) && (uboUniformBlockBinding != NULL);
+
+    if (!ready) TraceLog(LOG_WARNING, "UBO: Uniform buffers not supported (OpenGL 3.1 required)");
+
+    uboState = ready? 1 : -1;
+    return ready;
+}
+
+// Load buffer for target
+static unsigned int LoadBuffer(unsigned int target, const void *data, int size)
+{
+    if (!LoadUniformBufferFunctions()) return 0;
+
+    unsigned int id = 0;
+    uboGenBuffers(1, &id);
+    uboBindBuffer(target, id);
+    uboBufferData(target, size, data, RUBO_GL_DYNAMIC_DRAW);
+    uboBindBuffer(target, 0);
+
+    return id;
+}
+
+// Update buffer data for target
+static void UpdateBuffer(unsigned int target, unsigned int id, const void *data, int size, int offset)
+{
+    if ((id == 0) || (uboState != 1)) return;
+
+    uboBindBuffer(target, id);
+    uboBufferSubData(target, offset, size, data);
+    uboBindBuffer(target, 0);
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+// Load uniform buffer, data can be NULL
+unsigned int LoadUniformBuffer(const void *data, int size)
+{
+    unsigned int id = LoadBuffer(RUBO_GL_UNIFORM_BUFFER, data, size);
+
+    if (id > 0) TraceLog(LOG_INFO, "UBO: [ID %i] Uniform buffer loaded successfully (%i bytes)", id, size);
+
+    return id;
+}
+
+// Update uniform buffer data
+void UpdateUniformBuffer(unsigned int id, const void *data, int size, int offset)
+{
+    UpdateBuffer(RUBO_GL_UNIFORM_BUFFER, id, data, size, offset);
+}
+
+// Bind uniform buffer to binding point
+void BindUniformBuffer(unsigned int id, int bindingPoint)
+{
+    if (uboState != 1) return;
+
+    uboBindBufferBase(RUBO_GL_UNIFORM_BUFFER, bindingPoint, id);
+}
+
+// Unload uniform buffer
+void UnloadUniformBuffer(unsigned int id)
+{
+    if ((id == 0) || (uboState != 1)) return;
+
+    uboDeleteBuffers(1, &id);
+}
+
+// Point shader uniform block at binding point
+// NOTE: Not needed when the shader sets layout(binding = N), kept for #version 330 shaders
+bool SetShaderUniformBlock(Shader shader, const char *blockName, int bindingPoint)
+{
+    if (!LoadUniformBufferFunctions()) return false;
+
+    unsigned int blockIndex = uboGetUniformBlockIndex(shader.id, blockName);
+
+    if (blockIndex == RUBO_GL_INVALID_INDEX)
+    {
+        TraceLog(LOG_WARNING, "SHADER: [ID %i] Failed to find uniform block: %s", shader.id, blockName);
+        return false;
+    }
+
+    uboUniformBlockBinding(shader.id, blockIndex, bindingPoint);
+
+    return true;
+}
+
+// Load shader storage buffer, data can be NULL
+// NOTE: Buffer calls are OpenGL 1.5, only the shader reading it needs 4.3
+unsigned int LoadStorageBuffer(const void *data, int size)
+{
+    unsigned int id = LoadBuffer(RUBO_GL_SHADER_STORAGE_BUFFER, data, size);
+
+    if (id > 0) TraceLog(LOG_INFO, "SSBO: [ID %i] Storage buffer loaded successfully (%i bytes)", id, size);
+
+    return id;
+}
+
+// Update shader storage buffer data
+void UpdateStorageBuffer(unsigned int id, const void *data, int size, int offset)
+{
+    UpdateBuffer(RUBO_GL_SHADER_STORAGE_BUFFER, id, data, size, offset);
+}
+
+// Bind shader storage buffer to binding point
+void BindStorageBuffer(unsigned int id, int bindingPoint)
+{
+    if (uboState != 1) return;
+
+    uboBindBufferBase(RUBO_GL_SHADER_STORAGE_BUFFER, bindingPoint, id);
+}
+
+// Unload shader storage buffer
+void UnloadStorageBuffer(unsigned int id)
+{
+    UnloadUniformBuffer(id);
+}
+
+#endif // RUBO_IMPLEMENTATION